@@ -0,0 +1,128 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include "../libAudio/console.hxx"
+#include "../libAudio/emulator/memoryMap.hxx"
+#include "../libAudio/emulator/ram.hxx"
+#include "../libAudio/emulator/atariSTeROMs.hxx"
+#include "../libAudio/emulator/cpu/m68k.hxx"
+#include "../libAudio/emulator/unitsHelpers.hxx"
+
+using namespace std::chrono;
+using m68kMemoryMap_t = memoryMap_t<uint32_t, 0x00ffffffU>;
+
+constexpr static uint32_t defaultIterations{8U};
+constexpr static uint32_t passes{100U};
+constexpr static uint32_t programAddress{0x001000U};
+constexpr static uint32_t stackAddress{0x080000U};
+
+// Stands in for the PSG, DMA sound and MFP registers, so the map has as many peripherals as the real machine
+struct ioRegister_t final : public peripheral_t<uint32_t>
+{
+	uint8_t value{};
+
+	void readAddress(const uint32_t, substrate::span<uint8_t> data) const noexcept override
+	{
+		for (auto &byte : data)
+			byte = value;
+	}
+
+	void writeAddress(const uint32_t, const substrate::span<uint8_t> &data) noexcept override
+		{ value = data[0]; }
+};
+
+// Mapped out the way atariSTe_t maps the machine, with a program that makes a GEMDOS call into the ROMs and then
+// sums 64KiB of RAM, writing the running total back over it and out to one of the registers as it goes
+struct benchMachine_t final : public m68kMemoryMap_t
+{
+	motorola68000_t cpu{*this, 8_MHz};
+
+	benchMachine_t() noexcept
+	{
+		mapPeripheral({0x000000U, 0x800000U}, std::make_unique<ram_t<uint32_t, 8_MiB>>());
+		mapPeripheral({0xe00000U, 0xf00000U}, std::make_unique<atariSTeROMs_t>(cpu,
+			static_cast<m68kMemoryMap_t &>(*this), 0x700000U, 0x100000U));
+		mapPeripheral({0xff8800U, 0xff8804U}, std::make_unique<ioRegister_t>());
+		mapPeripheral({0xff8900U, 0xff8926U}, std::make_unique<ioRegister_t>());
+		mapPeripheral({0xfffa00U, 0xfffa40U}, std::make_unique<ioRegister_t>());
+		writeAddress(0x000084U, uint32_t{0xe00000U + atariSTeROMs_t::handlerAddressGEMDOS});
+
+		constexpr static std::array<uint16_t, 24U> program
+		{{
+			0x2f3cU, 0xffffU, 0xffffU, // move.l #-1, -(sp)
+			0x3f3cU, 0x0048U, // move.w #$48, -(sp)
+			0x4e41U, // trap #1
+			0x5c8fU, // addq.l #6, sp
+			0x7000U, // moveq #0, d0
+			0x41f9U, 0x0002U, 0x0000U, // lea $20000, a0
+			0x43f9U, 0x00ffU, 0x8800U, // lea $ff8800, a1
+			0x343cU, 0x3fffU, // move.w #$3fff, d2
+			0x2218U, // loop: move.l (a0)+, d1
+			0xd081U, // add.l d1, d0
+			0x2140U, 0xfffcU, // move.l d0, -4(a0)
+			0x1280U, // move.b d0, (a1)
+			0x51caU, 0xfff6U, // dbra d2, loop
+			0x4e75U, // rts
+		}};
+		uint32_t address{programAddress};
+		for (const auto word : program)
+		{
+			writeAddress(address, word);
+			address += 2U;
+		}
+	}
+
+	// Runs the program through the given number of times, returning how many instructions that took
+	uint64_t run(const uint32_t count) noexcept
+	{
+		uint64_t instructions{};
+		for (uint32_t pass{}; pass < count; ++pass)
+		{
+			cpu.executeFrom(programAddress, stackAddress, false);
+			while (cpu.readProgramCounter() != 0xffffffffU)
+			{
+				if (!cpu.step().validInsn)
+					return 0U;
+				++instructions;
+			}
+		}
+		return instructions;
+	}
+};
+
+int main(int32_t argc, char **argv)
+{
+	console = {stdout, stderr};
+	uint32_t iterations{defaultIterations};
+	if (argc == 3 && argv[1][0] == '-' && argv[1][1] == 'n' && argv[1][2] == '\0')
+		iterations = std::max(uint32_t(strtoul(argv[2], nullptr, 10)), 1U);
+	else if (argc != 1)
+	{
+		fprintf(stderr, "Usage: %s [-n iterations]\n", argv[0]);
+		return -1;
+	}
+
+	double fastest{};
+	double total{};
+	for (uint32_t iteration{}; iteration < iterations; ++iteration)
+	{
+		benchMachine_t machine{};
+		const auto start{steady_clock::now()};
+		const auto instructions{machine.run(passes)};
+		const duration<double> time{steady_clock::now() - start};
+		if (!instructions)
+		{
+			printf("Invalid instruction at %08x\n", machine.cpu.readProgramCounter());
+			return 1;
+		}
+		const auto rate{double(instructions) / time.count() / 1e6};
+		fastest = std::max(fastest, rate);
+		total += rate;
+	}
+	printf("mean %.2fM, fastest %.2fM instructions/s over %u runs\n", total / iterations, fastest, iterations);
+	return 0;
+}
@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+
+#include <libAudio.h>
+#include "../libAudio/libAudio.hxx"
+#include "../libAudio/console.hxx"
+
+using namespace std::chrono;
+
+constexpr static uint32_t defaultIterations{32U};
+
+int main(int32_t argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s [-n iterations] file [file ...]\n", argv[0]);
+		return -1;
+	}
+	console = {stdout, stderr};
+	ExternalPlayback = 1;
+	// Every load after the first would otherwise take its samples from the caches, and not parse or decode anything
+	moduleFile_t::sampleCacheBudget(0U);
+	moduleFile_t::renderCacheBudget(0U);
+
+	int32_t firstFile{1};
+	uint32_t iterations{defaultIterations};
+	if (argc > 3 && argv[1][0] == '-' && argv[1][1] == 'n' && argv[1][2] == '\0')
+	{
+		iterations = std::max(uint32_t(strtoul(argv[2], nullptr, 10)), 1U);
+		firstFile = 3;
+	}
+
+	for (int32_t i = firstFile; i < argc; ++i)
+	{
+		nanoseconds total{};
+		nanoseconds fastest{nanoseconds::max()};
+		uint32_t loads{};
+		for (; loads < iterations; ++loads)
+		{
+			const auto start{steady_clock::now()};
+			void *audioFile = audioOpenR(argv[i]);
+			const auto end{steady_clock::now()};
+			if (!audioFile)
+				break;
+			audioCloseFile(audioFile);
+			total += end - start;
+			fastest = std::min<nanoseconds>(fastest, end - start);
+		}
+
+		if (loads != iterations)
+		{
+			printf("%s: failed to load\n", argv[i]);
+			continue;
+		}
+		printf("%s: mean %.3fms, fastest %.3fms over %u loads\n", argv[i],
+			duration<double, std::milli>{total}.count() / iterations,
+			duration<double, std::milli>{fastest}.count(), iterations);
+	}
+	return 0;
+}
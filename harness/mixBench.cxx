@@ -0,0 +1,111 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <array>
+#include <vector>
+#include <algorithm>
+
+#include <libAudio.h>
+#include "../libAudio/libAudio.hxx"
+#include "../libAudio/console.hxx"
+
+using namespace std::chrono;
+
+constexpr static uint32_t defaultIterations{4U};
+constexpr static uint32_t defaultSeconds{60U};
+constexpr static std::array<uint32_t, 9> blockSizes{{32U, 64U, 128U, 256U, 512U, 1024U, 2048U, 4096U, 8192U}};
+// Block sizes past the length of a tick make no further difference, so the buffer only needs to fit the largest
+constexpr static uint32_t bufferLength{8192U * 4U};
+
+// Mixes up to the given number of seconds of the song, returning how many sample frames that came to
+static uint64_t mixSong(moduleFile_t &file, const uint32_t seconds, const bool tickAligned, std::vector<uint8_t> &buffer)
+{
+	const auto &info{file.fileInfo()};
+	const uint32_t frameSize{(info.bitsPerSample() / 8U) * info.channels()};
+	const uint64_t limit{uint64_t{info.bitRate()} * seconds * frameSize};
+	uint64_t total{};
+	while (total < limit)
+	{
+		const auto result
+		{
+			tickAligned ? file.fillTick(buffer.data(), bufferLength) : file.fillBuffer(buffer.data(), bufferLength)
+		};
+		if (result <= 0)
+			break;
+		total += static_cast<uint64_t>(result);
+	}
+	return total / frameSize;
+}
+
+// Opens the file afresh for each run so every block size mixes exactly the same stretch of the song
+static bool benchmark(const char *const fileName, const uint32_t blockSize, const bool tickAligned,
+	const uint32_t iterations, const uint32_t seconds)
+{
+	std::vector<uint8_t> buffer(bufferLength);
+	nanoseconds fastest{nanoseconds::max()};
+	uint64_t frames{};
+	uint32_t sampleRate{};
+	for (uint32_t run{}; run < iterations; ++run)
+	{
+		void *const audioFile{audioOpenR(fileName)};
+		auto *const file{dynamic_cast<moduleFile_t *>(static_cast<audioFile_t *>(audioFile))};
+		if (!file || !file->mixBlockSize(blockSize))
+		{
+			audioCloseFile(audioFile);
+			return false;
+		}
+		sampleRate = file->fileInfo().bitRate();
+		const auto start{steady_clock::now()};
+		frames = mixSong(*file, seconds, tickAligned, buffer);
+		const auto end{steady_clock::now()};
+		audioCloseFile(audioFile);
+		fastest = std::min<nanoseconds>(fastest, end - start);
+	}
+
+	const auto elapsed{duration<double>{fastest}.count()};
+	const auto audio{double(frames) / sampleRate};
+	printf("  %5u frames%s: %8.3fms for %.1fs of audio, %7.1fx realtime\n", blockSize,
+		tickAligned ? " per tick" : "         ", elapsed * 1000.0, audio, audio / elapsed);
+	return true;
+}
+
+int main(int32_t argc, char **argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "Usage: %s [-n iterations] [-s seconds] file [file ...]\n", argv[0]);
+		return -1;
+	}
+	console = {stdout, stderr};
+	ExternalPlayback = 1;
+
+	int32_t firstFile{1};
+	uint32_t iterations{defaultIterations};
+	uint32_t seconds{defaultSeconds};
+	while (firstFile + 1 < argc && argv[firstFile][0] == '-' && argv[firstFile][2] == '\0')
+	{
+		const auto value{std::max(uint32_t(strtoul(argv[firstFile + 1], nullptr, 10)), 1U)};
+		if (argv[firstFile][1] == 'n')
+			iterations = value;
+		else if (argv[firstFile][1] == 's')
+			seconds = value;
+		else
+			break;
+		firstFile += 2;
+	}
+
+	for (int32_t i = firstFile; i < argc; ++i)
+	{
+		printf("%s:\n", argv[i]);
+		bool ok{true};
+		for (const auto blockSize : blockSizes)
+			ok = ok && benchmark(argv[i], blockSize, false, iterations, seconds);
+		// Tick aligned output at the default block size, to see what handing back a tick at a time costs
+		ok = ok && benchmark(argv[i], 512U, true, iterations, seconds);
+		if (!ok)
+			printf("  failed to load or not a module\n");
+	}
+	return 0;
+}
@@ -5,7 +5,7 @@ include $(call my-dir)/*/Android.mk
 SRC_WMA =
 #SRC_OPTIMFROG = loadOptimFROG.cpp
 SRC_OPTIMFROG =
-#SRC_FC1x = loadFC1x.cpp
+#SRC_FC1x = loadFC1x.cpp moduleMixer/fc1x.cxx
 SRC_FC1x =
 SRC_MOD = loadMOD.cpp loadS3M.cpp loadSTM.cpp loadAON.cpp $(SRC_FC1x) loadIT.cpp
 #SRC_SHDN = loadSHDN.cpp
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include "cpuFeatures.hxx"
+#if defined(LIBAUDIO_SIMD_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace libAudio
+{
+	static cpuFeatures_t detectFeatures() noexcept
+	{
+		cpuFeatures_t features{};
+#if defined(LIBAUDIO_SIMD_X86)
+#if defined(_MSC_VER)
+		int registers[4]{};
+		__cpuid(registers, 0);
+		const auto maxLeaf{registers[0]};
+		if (maxLeaf >= 1)
+		{
+			__cpuid(registers, 1);
+			features.sse2 = registers[3] & (1 << 26);
+			features.sse41 = registers[2] & (1 << 19);
+			const bool osxsave{(registers[2] & (1 << 27)) != 0};
+			// AVX2 is only usable if the OS saves the YMM register state for us
+			if (osxsave && maxLeaf >= 7 && (_xgetbv(0) & 0x06U) == 0x06U)
+			{
+				__cpuidex(registers, 7, 0);
+				features.avx2 = registers[1] & (1 << 5);
+			}
+		}
+#else
+		__builtin_cpu_init();
+		features.sse2 = __builtin_cpu_supports("sse2");
+		features.sse41 = __builtin_cpu_supports("sse4.1");
+		features.avx2 = __builtin_cpu_supports("avx2");
+#endif
+#elif defined(LIBAUDIO_SIMD_NEON)
+		features.neon = true;
+#endif
+		return features;
+	}
+
+	const cpuFeatures_t &cpuFeatures() noexcept
+	{
+		static const cpuFeatures_t features{detectFeatures()};
+		return features;
+	}
+} // namespace libAudio
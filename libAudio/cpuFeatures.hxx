@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#ifndef CPU_FEATURES_HXX
+#define CPU_FEATURES_HXX
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define LIBAUDIO_SIMD_X86 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define LIBAUDIO_SIMD_NEON 1
+#endif
+
+namespace libAudio
+{
+	// The vector instruction sets the mixer has kernels for, in order of preference
+	struct cpuFeatures_t
+	{
+		bool sse2{false};
+		bool sse41{false};
+		bool avx2{false};
+		bool neon{false};
+	};
+
+	// Detected once on first use and cached for the life of the process
+	[[nodiscard]] const cpuFeatures_t &cpuFeatures() noexcept;
+} // namespace libAudio
+
+#endif /*CPU_FEATURES_HXX*/
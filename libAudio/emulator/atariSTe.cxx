@@ -1,5 +1,6 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <algorithm>
 #include <string_view>
 #include <type_traits>
 #include "atariSTe.hxx"
@@ -60,25 +61,19 @@ atariSTe_t::atariSTe_t() noexcept :
 			// Make sure we're invoked only with a std::unique_ptr<> of some kind of clockedPeripheral_t
 			static_assert(isUniquePtr_v<decltype(peripheral)> && isClockedPeripheral_v<decltype(peripheral)>);
 
-			// Extract a pointer to the device
-			auto *const ptr{peripheral.get()};
-
 			// Add the device to the clocking map according to the clocking ratio set up
-			clockedPeripherals[ptr] = {systemClockFrequency, peripheral->clockFrequency()};
-			// Add the device to the address map
-			addressMap[addressRange] = std::move(peripheral);
-
-			// Return that pointer for use externally
-			return ptr;
+			clockedPeripherals[peripheral.get()] = {systemClockFrequency, peripheral->clockFrequency()};
+			// Add the device to the address map, returning the pointer to it for use externally
+			return mapPeripheral(addressRange, std::move(peripheral));
 		}
 	};
 
 	// Build the system memory map
-	addressMap[{0x000000U, 0x800000U}] = std::make_unique<stRAM_t>();
-	addressMap[{0xe00000U, 0xf00000U}] = std::make_unique<atariSTeROMs_t>
+	mapPeripheral({0x000000U, 0x800000U}, std::make_unique<stRAM_t>());
+	mapPeripheral({0xe00000U, 0xf00000U}, std::make_unique<atariSTeROMs_t>
 	(
 		cpu, static_cast<memoryMap_t<uint32_t, 0x00ffffffU> &>(*this), heapBase, heapSize
-	);
+	));
 	// Cartridge ROM at 0xfa0000, 128KiB
 	// pre-TOS 2.0 OS ROMs at 0xfc0000, 128KiB
 	psg = addClockedPeripheral({0xff8800U, 0xff8804U}, std::make_unique<ym2149_t>(2_MHz, sampleRate));
@@ -133,7 +128,7 @@ void atariSTe_t::configureTimer(const char timer, const uint16_t timerFrequency)
 // Copy the contents of a decrunched SNDH into the ST's RAM
 bool atariSTe_t::copyToRAM(sndhDecruncher_t &data) noexcept
 {
-	stRAM_t &systemRAM{*dynamic_cast<stRAM_t *>(addressMap[{0x000000U, 0x800000U}].get())};
+	stRAM_t &systemRAM{*dynamic_cast<stRAM_t *>(peripheral({0x000000U, 0x800000U}))};
 	// Get a span that's past the end of the system variables space, and the length of the decrunched SNDH file
 	// But that also excludes the heap and stack spaces
 	auto destination{systemRAM.subspan(0U, stackBase).subspan(0x010000U, data.length())};
@@ -164,6 +159,52 @@ bool atariSTe_t::exit() noexcept
 	{ return cpu.executeToReturn(0x010004U, stackTop, false); }
 
 bool atariSTe_t::advanceClock() noexcept
+{
+	// Rather than step every cycle of the 32MHz clock, skip straight over all the ones on
+	// which nothing observable happens, up to the cycle on which something next does
+	if (const auto cycles{cyclesTillEvent()}; cycles > 1U && !skipCycles(cycles - 1U))
+		return false;
+	return runCycle();
+}
+
+// Work out how many cycles it is till the next cycle on which something has to be run properly
+uint32_t atariSTe_t::cyclesTillEvent() const noexcept
+{
+	// If there are interrupts waiting to be staged, that happens on the very next cycle
+	if (mfp->pendingInterrupts())
+		return 1U;
+	// Otherwise it's whichever comes first out of the next call to the play routine,
+	auto cycles{playRoutineManager.cyclesTillAdvance()};
+	// the next time a peripheral does something observable,
+	for (const auto &[peripheral, clockManager] : clockedPeripherals)
+		cycles = std::min(cycles, clockManager.cyclesTillAdvance(peripheral->cyclesTillEvent()));
+	// and the CPU's next instruction if it isn't halted (noting it runs on every 4th cycle)
+	if (cpu.readProgramCounter() != 0xffffffffU)
+		cycles = std::min(cycles, (cpu.cyclesTillInstruction() * 4U) - timeSinceLastCPUCycle);
+	return cycles;
+}
+
+// Run a span of cycles in one go, which must be fewer than cyclesTillEvent()
+bool atariSTe_t::skipCycles(const uint32_t cycles) noexcept
+{
+	// Have each peripheral run however many of its own cycles happen in the span
+	for (auto &[peripheral, clockManager] : clockedPeripherals)
+	{
+		if (!peripheral->clockCycles(clockManager.advanceCycles(cycles)))
+			return false;
+	}
+	// The play routine isn't due in this span, so just keep its clock in step
+	playRoutineManager.advanceCycles(cycles);
+
+	// Work out how many of the CPU's cycles happened in the span, letting them pass if the CPU isn't halted
+	const auto cpuCycles{(timeSinceLastCPUCycle + cycles) / 4U};
+	if (cpu.readProgramCounter() != 0xffffffffU)
+		cpu.idleCycles(cpuCycles);
+	timeSinceLastCPUCycle = (timeSinceLastCPUCycle + cycles) & 3U;
+	return true;
+}
+
+bool atariSTe_t::runCycle() noexcept
 {
 	// The machine runs on a 32MHz (ish) clock, advance a cycle and run
 	// any events on any hardware that needs it
@@ -26,6 +26,10 @@ private:
 	clockManager_t playRoutineManager;
 	std::map<clockedPeripheral_t<uint32_t> *, clockManager_t> clockedPeripherals{};
 
+	[[nodiscard]] uint32_t cyclesTillEvent() const noexcept;
+	[[nodiscard]] bool skipCycles(uint32_t cycles) noexcept;
+	[[nodiscard]] bool runCycle() noexcept;
+
 public:
 	constexpr static uint32_t sampleRate{48_kHz};
 
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <cmath>
 #include <tuple>
+#include <algorithm>
 #include "memoryMap.hxx"
 
 clockManager_t::clockManager_t(const uint32_t baseClockFrequency, const uint32_t targetClockFrequency) noexcept :
@@ -22,3 +23,36 @@ bool clockManager_t::advanceCycle() noexcept
 	}
 	return false;
 }
+
+// The cycle counter always sits in the range (-targetFrequency, baseFrequency - targetFrequency] when treated
+// as signed, and the managed clock advances on the base cycle that takes it past baseFrequency - targetFrequency.
+// That makes where the n'th managed cycle lands, and how many land in a span of base cycles, simple divisions.
+
+uint32_t clockManager_t::cyclesTillAdvance(const uint32_t cycles) const noexcept
+{
+	// A manager with no target clock never advances
+	if (targetFrequency == 0U)
+		return UINT32_MAX;
+	// If the target clock is faster than the base, it could advance on any cycle
+	if (targetFrequency > baseFrequency)
+		return 1U;
+	const auto counter{static_cast<int64_t>(static_cast<int32_t>(cycleCounter))};
+	const auto result{((int64_t{cycles} * baseFrequency) - counter) / targetFrequency};
+	return static_cast<uint32_t>(std::min<int64_t>(result, UINT32_MAX));
+}
+
+uint32_t clockManager_t::advanceCycles(const uint32_t cycles) noexcept
+{
+	if (targetFrequency == 0U || targetFrequency > baseFrequency)
+	{
+		uint32_t advanced{0U};
+		for (uint32_t cycle{0U}; cycle < cycles; ++cycle)
+			advanced += advanceCycle() ? 1U : 0U;
+		return advanced;
+	}
+	const auto counter{static_cast<int64_t>(static_cast<int32_t>(cycleCounter))};
+	const auto elapsed{counter + (int64_t{cycles} * targetFrequency)};
+	const auto advanced{static_cast<uint32_t>((elapsed + targetFrequency - 1) / baseFrequency)};
+	cycleCounter = static_cast<uint32_t>(elapsed - (int64_t{advanced} * baseFrequency));
+	return advanced;
+}
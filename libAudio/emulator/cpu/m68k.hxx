@@ -179,6 +179,10 @@ public:
 	void writeStatus(uint16_t value) noexcept;
 	[[nodiscard]] stepResult_t step() noexcept;
 	[[nodiscard]] bool advanceClock() noexcept;
+	// How many clock cycles until the next instruction runs, including the cycle it runs on
+	[[nodiscard]] uint32_t cyclesTillInstruction() const noexcept { return waitCycles + 1U; }
+	// Let a number of clock cycles pass in one go, which must be fewer than cyclesTillInstruction()
+	void idleCycles(const uint32_t cycles) noexcept { waitCycles -= cycles; }
 	[[nodiscard]] bool trapped() const noexcept { return trapState; }
 
 	void displayRegs() const noexcept;
@@ -3,9 +3,17 @@
 #ifndef EMULATOR_MEMORY_MAP_HXX
 #define EMULATOR_MEMORY_MAP_HXX
 
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 #include <limits>
+#include <type_traits>
+#if defined(_MSC_VER)
+#include <cstdlib>
+#endif
 #include <substrate/span>
 #include <substrate/buffer_utils>
 
@@ -50,6 +58,33 @@ namespace std
 	};
 }
 
+// Swap a value between the host's byte order and the big-endian order of the emulated bus
+template<typename value_t> inline value_t swapBusOrder(const value_t value) noexcept
+{
+	[[maybe_unused]] const auto bits{static_cast<std::make_unsigned_t<value_t>>(value)};
+#if defined(_MSC_VER)
+	if constexpr (sizeof(value_t) == 2U)
+		return static_cast<value_t>(_byteswap_ushort(bits));
+	else if constexpr (sizeof(value_t) == 4U)
+		return static_cast<value_t>(_byteswap_ulong(bits));
+	else if constexpr (sizeof(value_t) == 8U)
+		return static_cast<value_t>(_byteswap_uint64(bits));
+	else
+		return value;
+#elif __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if constexpr (sizeof(value_t) == 2U)
+		return static_cast<value_t>(__builtin_bswap16(bits));
+	else if constexpr (sizeof(value_t) == 4U)
+		return static_cast<value_t>(__builtin_bswap32(bits));
+	else if constexpr (sizeof(value_t) == 8U)
+		return static_cast<value_t>(__builtin_bswap64(bits));
+	else
+		return value;
+#else
+	return value;
+#endif
+}
+
 // A generic clockless peripheral
 template<typename address_t> struct peripheral_t
 {
@@ -67,6 +102,8 @@ public:
 
 	virtual void readAddress(address_t address, substrate::span<uint8_t> data) const noexcept = 0;
 	virtual void writeAddress(address_t address, const substrate::span<uint8_t> &data) noexcept = 0;
+	// Peripherals that are plain memory hand that out so accesses can go straight to it
+	[[nodiscard]] virtual substrate::span<uint8_t> directMemory() noexcept { return {}; }
 };
 
 // A peripheral that requires clocking at some frequency
@@ -89,36 +126,155 @@ public:
 
 	[[nodiscard]] uint32_t clockFrequency() const noexcept { return _clockFrequency; }
 	[[nodiscard]] virtual bool clockCycle() noexcept = 0;
+	// How many of the peripheral's clock cycles until it next does something observable from outside it
+	[[nodiscard]] virtual uint32_t cyclesTillEvent() const noexcept { return 1U; }
+	// Run a number of clock cycles in one go, which must not be more than cyclesTillEvent()
+	[[nodiscard]] virtual bool clockCycles(const uint32_t cycles) noexcept
+	{
+		for (uint32_t cycle{0U}; cycle < cycles; ++cycle)
+		{
+			if (!clockCycle())
+				return false;
+		}
+		return true;
+	}
+};
+
+// A peripheral along with the address range it is mapped into
+template<typename address_t> struct memoryMapping_t
+{
+	memoryRange_t<address_t> range{0U, 0U};
+	peripheral_t<address_t> *peripheral{nullptr};
+	// The peripheral's memory if it can be accessed directly, covering the whole range
+	uint8_t *memory{nullptr};
+
+	// Check if an access of a given width at an address relative to the range can go straight to memory
+	[[nodiscard]] bool direct(const address_t address, const size_t width) const noexcept
+		{ return memory && address + width <= static_cast<size_t>(range.end() - range.begin()); }
 };
 
 template<typename address_t, address_t validAddressMask = std::numeric_limits<address_t>::max()> struct memoryMap_t
 {
-protected:
+private:
+	// The address space is split into 4KiB pages for lookup
+	constexpr static size_t pageBits{12U};
+	constexpr static size_t pageCount{(static_cast<size_t>(validAddressMask) >> pageBits) + 1U};
+	// Pages more than one peripheral is mapped into, needing the mappings searched through
+	constexpr static uint8_t sharedPage{std::numeric_limits<uint8_t>::max()};
+
 	// Use 16 buckets at minimum.
 	std::unordered_map<memoryRange_t<address_t>, std::unique_ptr<peripheral_t<address_t>>> addressMap{16U};
+	// Every mapping made, after an empty one at the front that no address is ever in range of
+	std::vector<memoryMapping_t<address_t>> mappings{1U};
+	// The index into mappings of the one peripheral mapped into each page, kept to a byte a page so the whole
+	// table stays in cache and looking up an address is (almost always) a single index and range check
+	std::vector<uint8_t> pageTable{};
+
+	// The mapping the last access found, which the next access is almost always to as well. Not shared between
+	// threads, as a machine and its memory map only ever get run from one thread at a time
+	mutable memoryMapping_t<address_t> lastMapping{};
+
+	[[nodiscard]] const memoryMapping_t<address_t> *findMapping(const address_t address) const noexcept
+	{
+		// Checking the last mapping first costs no more than the page lookup would have, and saves the page
+		// lookup's dependent loads whenever the access is to the same peripheral as the last one
+		if (lastMapping.range.inRange(address))
+			return &lastMapping;
+		if (pageTable.empty())
+			return nullptr;
+		const auto page{pageTable[static_cast<size_t>(address) >> pageBits]};
+		// If the page is shared, search through the peripherals mapped to find the one (if any) that has this address
+		if (page == sharedPage)
+		{
+			for (const auto &mapping : mappings)
+			{
+				if (mapping.range.inRange(address))
+				{
+					lastMapping = mapping;
+					return &lastMapping;
+				}
+			}
+			return nullptr;
+		}
+		// Otherwise the page only has to be checked to see if its peripheral (if any) covers the address
+		const auto &mapping{mappings[page]};
+		if (!mapping.range.inRange(address))
+			return nullptr;
+		lastMapping = mapping;
+		return &lastMapping;
+	}
+
+protected:
+	// Map a peripheral into the address space, taking ownership of it and returning a pointer for use externally
+	template<typename device_t> device_t *mapPeripheral(const memoryRange_t<address_t> range,
+		std::unique_ptr<device_t> peripheral) noexcept
+	{
+		auto *const device{peripheral.get()};
+		addressMap[range] = std::move(peripheral);
+		// The last mapping found may be the one being replaced, so forget it
+		lastMapping = {};
+
+		// Only take the peripheral's memory for direct access if there's enough of it to back the whole range
+		const auto directMemory{static_cast<peripheral_t<address_t> *>(device)->directMemory()};
+		const memoryMapping_t<address_t> newMapping
+		{
+			range, device,
+			directMemory.size() >= static_cast<size_t>(range.end() - range.begin()) ? directMemory.data() : nullptr
+		};
+
+		// If this replaces something already mapped to this range, update that mapping, otherwise add a new one
+		const auto existing{std::find_if(mappings.begin() + 1, mappings.end(),
+			[&](const memoryMapping_t<address_t> &mapping) { return mapping.range == range; })};
+		const auto index{static_cast<size_t>(existing - mappings.begin())};
+		if (existing != mappings.end())
+			*existing = newMapping;
+		else
+			mappings.push_back(newMapping);
+
+		if (pageTable.empty())
+			pageTable.resize(pageCount);
+		// Now put the peripheral in all the pages its range covers, marking any that are already in use as shared.
+		// Should there ever be more peripherals than a page can index, the ones past that get searched for instead.
+		const auto firstPage{static_cast<size_t>(range.begin()) >> pageBits};
+		const auto lastPage{static_cast<size_t>(range.end() - 1U) >> pageBits};
+		for (size_t pageIndex{firstPage}; pageIndex <= lastPage && pageIndex < pageCount; ++pageIndex)
+		{
+			auto &page{pageTable[pageIndex]};
+			if (page == sharedPage)
+				continue;
+			if ((page && page != index) || index >= sharedPage)
+				page = sharedPage;
+			else
+				page = static_cast<uint8_t>(index);
+		}
+		return device;
+	}
+
+	// Look up the peripheral mapped to exactly the given range, if there is one
+	[[nodiscard]] peripheral_t<address_t> *peripheral(const memoryRange_t<address_t> &range) const noexcept
+	{
+		const auto mapping{addressMap.find(range)};
+		return mapping != addressMap.end() ? mapping->second.get() : nullptr;
+	}
 
 public:
 	template<typename value_t> value_t readAddress(const address_t address) const noexcept
 	{
 		const auto adjustedAddres{address & validAddressMask};
 		// Try to find a peripheral mapped for the address
-		for (const auto &[mapping, peripheral] : addressMap)
+		if (const auto *const mapping{findMapping(adjustedAddres)}; mapping)
 		{
-			// If the peripheral's mapping contains this address
-			if (mapping.inRange(adjustedAddres))
-			{
-				// Convert the address to a relative one
-				const auto relativeAddress{mapping.relative(adjustedAddres)};
-				std::array<uint8_t, sizeof(value_t)> value{};
-				// Read the data associated with that address in the peripheral
-				peripheral->readAddress(relativeAddress, value);
-
-				// Now we have data, convert it endian-appropriately to a value_t
-				if constexpr (sizeof(value_t) == 1U)
-					return static_cast<value_t>(value[0]);
-				else
-					return readBE<value_t>(value);
-			}
+			// Convert the address to a relative one
+			const auto relativeAddress{mapping->range.relative(adjustedAddres)};
+			value_t value{};
+			const substrate::span<uint8_t> bytes{reinterpret_cast<uint8_t *>(&value), sizeof(value_t)};
+			// Read the data associated with that address, straight from memory if we can, otherwise from the peripheral
+			if (mapping->direct(relativeAddress, sizeof(value_t)))
+				std::memcpy(bytes.data(), mapping->memory + relativeAddress, sizeof(value_t));
+			else
+				mapping->peripheral->readAddress(relativeAddress, bytes);
+			// Now we have data in bus order, convert it to the host's
+			return swapBusOrder(value);
 		}
 
 		// If we couldn't find the address in any known peripheral, synthesise a value
@@ -129,24 +285,18 @@ public:
 	{
 		const auto adjustedAddres{address & validAddressMask};
 		// Try to find a peripheral to write the value to
-		for (auto &[mapping, peripheral] : addressMap)
+		if (const auto *const mapping{findMapping(adjustedAddres)}; mapping)
 		{
-			// If the peripheral's mapping contains this address
-			if (mapping.inRange(adjustedAddres))
-			{
-				// Convert the address to a relative one
-				const auto relativeAddress{mapping.relative(adjustedAddres)};
-				std::array<uint8_t, sizeof(value_t)> value{};
-				// Convert the data to write in an endian-appropriate manner from a value_t
-				if constexpr (sizeof(value_t) == 1U)
-					value[0] = static_cast<uint8_t>(data);
-				else
-					writeBE(data, value);
-
-				// Now write the data to the peripheral and get done
-				peripheral->writeAddress(relativeAddress, value);
-				break;
-			}
+			// Convert the address to a relative one
+			const auto relativeAddress{mapping->range.relative(adjustedAddres)};
+			// Convert the data to write to bus order
+			auto value{swapBusOrder(data)};
+			const substrate::span<uint8_t> bytes{reinterpret_cast<uint8_t *>(&value), sizeof(value_t)};
+			// Now write the data to memory or the peripheral and get done
+			if (mapping->direct(relativeAddress, sizeof(value_t)))
+				std::memcpy(mapping->memory + relativeAddress, bytes.data(), sizeof(value_t));
+			else
+				mapping->peripheral->writeAddress(relativeAddress, bytes);
 		}
 	}
 };
@@ -165,6 +315,10 @@ public:
 	clockManager_t(uint32_t baseClockFrequency, uint32_t targetClockFrequency) noexcept;
 	// Returns true if the clock being managed by this should advance a cycle, false otherwise
 	bool advanceCycle() noexcept;
+	// Returns how many base clock cycles it will take for the managed clock to advance the given number of cycles
+	[[nodiscard]] uint32_t cyclesTillAdvance(uint32_t cycles = 1U) const noexcept;
+	// Advances the base clock by a number of cycles in one go, returning how many cycles the managed clock advanced
+	uint32_t advanceCycles(uint32_t cycles) noexcept;
 };
 
 #endif /*EMULATOR_MEMORY_MAP_HXX*/
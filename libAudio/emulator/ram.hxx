@@ -27,6 +27,8 @@ private:
 			memory[address + idx] = byte;
 	}
 
+	substrate::span<uint8_t> directMemory() noexcept override { return memory; }
+
 public:
 	ram_t() noexcept = default;
 	ram_t(const ram_t &) = default;
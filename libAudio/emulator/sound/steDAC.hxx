@@ -32,6 +32,9 @@ public:
 	~steDAC_t() noexcept final = default;
 
 	[[nodiscard]] bool clockCycle() noexcept final;
+	// Nothing happens on the DAC's clock yet, so there's never anything to wait for
+	[[nodiscard]] uint32_t cyclesTillEvent() const noexcept final { return UINT32_MAX; }
+	[[nodiscard]] bool clockCycles(uint32_t) noexcept final { return true; }
 	[[nodiscard]] uint8_t outputLevel() const noexcept { return mainVolume; }
 };
 
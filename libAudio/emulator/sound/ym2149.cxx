@@ -195,6 +195,32 @@ bool ym2149_t::clockCycle() noexcept
 	return true;
 }
 
+// The only thing observable from outside the chip is a new sample becoming ready
+uint32_t ym2149_t::cyclesTillEvent() const noexcept
+	{ return clockManager.cyclesTillAdvance(); }
+
+bool ym2149_t::clockCycles(const uint32_t cycles) noexcept
+{
+	if (cycles == 0U)
+		return true;
+	// Reset the channel states if ready was true, as the first of these cycles would
+	if (ready)
+	{
+		read = false;
+		for (auto &state : channelState)
+			state = false;
+	}
+
+	// A sample can only become ready on the last of the cycles, so see if it is
+	ready = clockManager.advanceCycles(cycles) != 0U;
+
+	// Run the FSM for every cycle in this span that it would have been updated on
+	for (auto cycle{(8U - cyclesTillUpdate) & 7U}; cycle < cycles; cycle += 8U)
+		updateFSM();
+	cyclesTillUpdate = (cyclesTillUpdate + cycles) & 7U;
+	return true;
+}
+
 void ym2149_t::updateFSM() noexcept
 {
 	// Update the channel states to reflect the current chip state
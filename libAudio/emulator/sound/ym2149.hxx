@@ -83,6 +83,8 @@ public:
 	~ym2149_t() noexcept final = default;
 
 	[[nodiscard]] bool clockCycle() noexcept final;
+	[[nodiscard]] uint32_t cyclesTillEvent() const noexcept final;
+	[[nodiscard]] bool clockCycles(uint32_t cycles) noexcept final;
 	[[nodiscard]] bool sampleReady() const noexcept;
 	[[nodiscard]] int16_t sample() noexcept;
 
@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
 #include <cstdint>
+#include <algorithm>
 #include <substrate/span>
 #include <substrate/index_sequence>
 #include "mc68901.hxx"
@@ -254,38 +255,61 @@ void mc68901_t::writeAddress(const uint32_t address, const substrate::span<uint8
 	}
 }
 
+// Translate a timer number into an interrupt register bit
+static uint32_t timerInterruptBit(const size_t timer) noexcept
+{
+	// Dispatch the timer to the bit number for it
+	switch (timer)
+	{
+		case 0U:
+			return 1U << 13U;
+		case 1U:
+			return 1U << 8U;
+		case 2U:
+			return 1U << 5U;
+		case 3U:
+			return 1U << 4U;
+	}
+	// This should never happen, but just in case.. this selects one past the end
+	// of the itr registers so it's a safe no-op
+	return 1U << 16U;
+}
+
 bool mc68901_t::clockCycle() noexcept
 {
 	// Go through each timer and try to advance them a clock cycle
 	for (const auto idx : substrate::indexSequence_t{timers.size()})
 	{
-		auto &timer{timers[idx]};
-		// Translate the timer number into an interrupt register bit
-		const auto itrBit
-		{
-			1U << [&]()
-			{
-				// Dispatch the timer to the bit number for it
-				switch (idx)
-				{
-					case 0U:
-						return 13U;
-					case 1U:
-						return 8U;
-					case 2U:
-						return 5U;
-					case 3U:
-						return 4U;
-				}
-				// This should never happen, but just in case.. this selects one past the end
-				// of the itr registers so it's a safe no-op
-				return 16U;
-			}()
-		};
 		// If the clock cycle on the timer triggered an interrupt causing event
-		if (timer.clockCycle())
+		if (timers[idx].clockCycle())
+		{
+			// If interrupts are enabled for the timer, set the pending bit
+			const auto itrBit{timerInterruptBit(idx)};
+			if (itrEnable & itrBit)
+				itrPending |= itrBit;
+		}
+	}
+	return true;
+}
+
+// The only thing observable from outside is a timer running down and generating an interrupt
+uint32_t mc68901_t::cyclesTillEvent() const noexcept
+{
+	uint32_t cycles{UINT32_MAX};
+	for (const auto &timer : timers)
+		cycles = std::min(cycles, timer.cyclesTillInterrupt());
+	return cycles;
+}
+
+bool mc68901_t::clockCycles(const uint32_t cycles) noexcept
+{
+	for (const auto idx : substrate::indexSequence_t{timers.size()})
+	{
+		// If the timer ran down in this span of cycles
+		if (timers[idx].clockCycles(cycles))
 		{
 			// If interrupts are enabled for the timer, set the pending bit
+			const auto itrBit{timerInterruptBit(idx)};
 			if (itrEnable & itrBit)
 				itrPending |= itrBit;
 		}
@@ -379,4 +403,35 @@ namespace mc68901
 		// Signal that this was not an interrupt generating cycle
 		return false;
 	}
+
+	uint32_t timer_t::cyclesTillInterrupt() const noexcept
+	{
+		// Stopped timers, and ones not in a counting mode, never generate interrupts
+		if ((control & 0x0fU) == 0U || (control & 0x08U) != 0U)
+			return UINT32_MAX;
+		// Otherwise it's how long it takes to count the counter down to 0 (where 0 counts down from 256)
+		return clockManager.cyclesTillAdvance(counter ? counter : 256U);
+	}
+
+	bool timer_t::clockCycles(const uint32_t cycles) noexcept
+	{
+		// Check if the timer is stopped
+		if ((control & 0x0fU) == 0U)
+			return false;
+		// If it is not, work out how many clock pulses the counter got in this span
+		const auto pulses{clockManager.advanceCycles(cycles)};
+		// Check if the timer is in a counting mode
+		if ((control & 0x08U) != 0U || pulses == 0U)
+			return false;
+		// Apply the clock pulses to the counter - this can only reach 0 on the last of the pulses, and if it does
+		// reload it to the value in reloadValue
+		counter = static_cast<uint8_t>(counter - pulses);
+		if (counter == 0U)
+		{
+			counter = reloadValue;
+			// Signal that this was an interrupt generating span
+			return true;
+		}
+		return false;
+	}
 } // namespace mc68901
@@ -27,6 +27,10 @@ namespace mc68901
 		void data(uint8_t value) noexcept;
 
 		[[nodiscard]] bool clockCycle() noexcept;
+		// How many cycles until the timer next generates an interrupt, if it will at all
+		[[nodiscard]] uint32_t cyclesTillInterrupt() const noexcept;
+		// Run a number of cycles in one go, which must not be more than cyclesTillInterrupt()
+		[[nodiscard]] bool clockCycles(uint32_t cycles) noexcept;
 	};
 } // namespace mc68901
 
@@ -61,6 +65,8 @@ public:
 	~mc68901_t() noexcept final = default;
 
 	[[nodiscard]] bool clockCycle() noexcept final;
+	[[nodiscard]] uint32_t cyclesTillEvent() const noexcept final;
+	[[nodiscard]] bool clockCycles(uint32_t cycles) noexcept final;
 	[[nodiscard]] uint16_t pendingInterrupts() const noexcept;
 	void clearInterrupts(uint16_t interrupts) noexcept;
 };
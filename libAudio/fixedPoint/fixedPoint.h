@@ -19,18 +19,22 @@ public:
 	constexpr fixed64_t(const uint32_t a, const uint32_t b = 0, const int8_t _sign = 1) noexcept :
 		i{a}, d{b}, sign{_sign} { }
 
-	fixed64_t exp() const noexcept;
+	constexpr fixed64_t exp() const noexcept;
 	//fixed64_t ln();
 
-	fixed64_t pow2() const noexcept;
+	constexpr fixed64_t pow2() const noexcept;
 
-	fixed64_t operator *(const fixed64_t &b) const;
-	fixed64_t &operator *=(const fixed64_t &b);
-	fixed64_t operator /(const fixed64_t &b) const;
+	constexpr fixed64_t operator *(const fixed64_t &b) const;
+	constexpr fixed64_t &operator *=(const fixed64_t &b);
+	constexpr fixed64_t operator /(const fixed64_t &b) const;
 	fixed64_t &operator /=(const fixed64_t &b);
 
 	fixed64_t operator +(const fixed64_t &b) const;
-	fixed64_t &operator +=(const fixed64_t &b);
+	constexpr fixed64_t &operator +=(const fixed64_t &b);
+
+	// The value as a raw 32.32 fixed-point number, ignoring the sign
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	[[nodiscard]] constexpr uint64_t raw() const noexcept { return (uint64_t{i} << 32U) | d; }
 
 	operator uint32_t() const;
 	operator int32_t() const;
@@ -38,9 +42,120 @@ public:
 	operator double() const;
 };
 
-inline fixed64_t operator *(const uint32_t a, const fixed64_t &b)
+// These are defined here rather than in fixedPoint.cpp so tables can be generated from them at compile time
+constexpr inline fixed64_t fixed64_t::exp() const noexcept
+{
+	fixed64_t ret{1};
+	fixed64_t x{1};
+	uint32_t offset{1};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	for (uint8_t bit{1}; bit <= 32U; ++bit)
+	{
+		offset *= bit;
+		x *= *this;
+		ret += x / fixed64_t{offset};
+	}
+	return ret;
+}
+
+constexpr inline fixed64_t fixed64_t::pow2() const noexcept
+{
+	constexpr fixed64_t ln2{0, 2977044472U}; // ln(2) to 9dp
+	return (*this * ln2).exp();
+}
+
+constexpr inline fixed64_t fixed64_t::operator *(const fixed64_t &b) const
+{
+	uint64_t e = uint64_t{b.i} * uint64_t{d};
+	uint64_t f = uint64_t{i} * uint64_t{b.d};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	uint32_t g = (uint64_t{d} * uint64_t{b.d}) >> 32U;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	uint32_t h = uint64_t{i} * uint64_t{b.i} + uint32_t(e >> 32U) + uint32_t(f >> 32U);
+	g += uint32_t(e) + uint32_t(f);
+//	printf("% 2.9f * % 2.9f ?= % 2.9f\n", operator double(), b.operator double(), fixed64_t(h, g, sign * b.sign).operator double());
+	return {h, g, int8_t(sign * b.sign)};
+}
+
+constexpr inline fixed64_t &fixed64_t::operator *=(const fixed64_t &b)
+{
+	uint64_t e = uint64_t{b.i} * uint64_t{d};
+	uint64_t f = uint64_t{i} * uint64_t{b.d};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	uint32_t g = (uint64_t{d} * uint64_t{b.d}) >> 32U;
+	sign *= b.sign;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	i = i * b.i + uint32_t(e >> 32U) + uint32_t(f >> 32U);
+	d = uint32_t(e) + uint32_t(f) + g;
+	return *this;
+}
+
+// Quick and dirty code, it makes mistakes on occasion, but pumps the right sequence out for it's use
+constexpr inline fixed64_t fixed64_t::operator /(const fixed64_t &b) const
+{
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	uint64_t e = (uint64_t{i} << 32U) | uint64_t{d};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	uint64_t f = (uint64_t{b.i} << 32U) | uint64_t{b.d};
+
+	if (e == 0)
+		return {0};
+
+	auto q_i = uint32_t(e / f);
+//	printf("%llu %d\t", e, q_i);
+	e -= q_i * f;
+//	printf("%llu %llu", q_i * f, e);
+	uint8_t g{};
+	uint32_t q_d{};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	while (e > 0U && f > 0U && g < 32U)
+	{
+		q_d <<= 1U;
+		if (e >= f)
+		{
+			e -= f;
+			q_d |= 1U;
+		}
+		f >>= 1U;
+		g++;
+	}
+//	printf("\t% 2.9f\n", fixed64_t(q_i, q_d << (33 - g), sign * b.sign).operator double());
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	return {q_i, uint32_t(uint64_t{q_d} << (33U - g)), int8_t(sign * b.sign)};
+}
+
+constexpr inline fixed64_t &fixed64_t::operator +=(const fixed64_t &b)
+{
+	if (sign != b.sign)
+	{
+		int64_t decimal = int64_t{d} - int64_t{b.d};
+		int64_t integer = int64_t{i} - int64_t{b.i};
+		if (sign < 0)
+		{
+			decimal = -decimal;
+			integer = -integer;
+		}
+		const bool overflow = decimal < 0;
+		if (overflow)
+			// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+			decimal = (1ULL << 32U) + decimal;
+		sign = (integer < 0 ? -1 : 1);
+		i = uint32_t(integer < 0 ? -integer : integer) - (overflow ? 1 : 0);
+		d = uint32_t(decimal);
+	}
+	else
+	{
+		const uint32_t decimal = d + b.d;
+		const bool overflow = decimal < d;
+		i += b.i + (overflow ? 1 : 0);
+		d = decimal;
+	}
+	return *this;
+}
+
+constexpr inline fixed64_t operator *(const uint32_t a, const fixed64_t &b)
 	{ return fixed64_t{a} * b; }
-inline fixed64_t operator /(const uint8_t a, const fixed64_t &b)
+constexpr inline fixed64_t operator /(const uint8_t a, const fixed64_t &b)
 	{ return fixed64_t{a} / b; }
 
 #endif /*FIXED_POINT_H*/
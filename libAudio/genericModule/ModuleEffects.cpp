@@ -292,5 +292,11 @@ void command_t::setITEffect(uint8_t effect, uint8_t param)
 			Param = param;
 		return;
 	}
+	else if (effect == 26)
+	{
+		Effect = CMD_MIDI;
+		Param = param;
+		return;
+	}
 	Effect = CMD_NONE;
 }
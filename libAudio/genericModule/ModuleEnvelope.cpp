@@ -0,0 +1,61 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2014-2025 Rachel Mant <git@dragonmux.network>
+#include <algorithm>
+#include "genericModule.h"
+
+// Real envelopes stay well within this many ticks, so any going further are left to be interpolated as they're played
+constexpr static size_t envelopeTableTicks{10000U};
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+ModuleEnvelope::ModuleEnvelope(const envelopeType_t env, const uint8_t flags,
+	const std::array<envelopeNode_t, 25> &nodes, const uint8_t nodeCount) noexcept : Type{env}, Flags{flags},
+	nNodes{std::min<uint8_t>(nodeCount, nodes.size())}, LoopBegin{}, LoopEnd{}, SusLoopBegin{}, SusLoopEnd{},
+	Nodes{nodes}, Values{}
+	{ tabulate(); }
+
+// Works out the envelope's value at every tick up to its furthest node, so Apply() only has to look it up
+void ModuleEnvelope::tabulate() noexcept
+{
+	if (!nNodes)
+		return;
+	// Node ticks are not guaranteed to be in order, so the table has to run to whichever is furthest
+	uint16_t lastTick{};
+	for (uint8_t i = 0; i < nNodes; ++i)
+		lastTick = std::max(lastTick, Nodes[i].Tick);
+	if (lastTick >= envelopeTableTicks)
+		return;
+	// If there's no room for the table, Apply() interpolates instead, which gives the same values
+	Values = fixedVector_t<uint8_t>{size_t{lastTick} + 1U};
+	if (!Values.valid())
+		return;
+	for (size_t tick{}; tick < Values.size(); ++tick)
+		Values[tick] = interpolate(static_cast<uint16_t>(tick));
+}
+
+uint8_t ModuleEnvelope::interpolate(const uint16_t currentTick) const noexcept
+{
+	uint8_t pt = 0;
+	uint8_t ret = 0;
+	uint16_t n1 = 0;
+	for (; pt < (nNodes - 1); ++pt)
+	{
+		if (currentTick <= Nodes[pt].Tick)
+			break;
+	}
+	if (currentTick >= Nodes[pt].Tick)
+		return Nodes[pt].Value;
+	if (pt)
+	{
+		n1 = Nodes[pt - 1].Tick;
+		ret = Nodes[pt - 1].Value;
+	}
+	uint16_t n2 = Nodes[pt].Tick;
+	if (n2 > n1 && currentTick > n1)
+	{
+		int32_t val = currentTick - n1;
+		val *= int16_t(Nodes[pt].Value) - ret;
+		n2 -= n1;
+		return ret + (val / n2);
+	}
+	return ret;
+}
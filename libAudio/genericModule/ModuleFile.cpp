@@ -1,27 +1,57 @@
 // SPDX-License-Identifier: BSD-3-Clause
 // SPDX-FileCopyrightText: 2012-2023 Rachel Mant <git@dragonmux.network>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "genericModule.h"
+#include "../moduleMixer/mixThreads.hxx"
+#include "../moduleMixer/mixFunctionsSIMD.hxx"
+#include "../moduleMixer/samplePCM.hxx"
 
 using substrate::make_unique_nothrow;
 
 moduleFile_t::moduleFile_t(audioType_t type, fd_t &&fd) noexcept : audioFile_t{type, std::move(fd)},
 	ctx{make_unique_nothrow<decoderContext_t>()} { }
 
+void moduleFile_t::sampleCacheBudget(const size_t bytes) noexcept
+	{ pcmCache_t::instance().budget(bytes); }
+
+/*!
+ * Sets how many bytes of rendered songs may be kept around so that playing a module again, with the same
+ * mixer settings, replays what was mixed the first time rather than mixing it all over again. A song is only
+ * kept if it was played from start to end without seeking or changing settings part way through.
+ * @param bytes The most memory to use for rendered songs, or 0 (the default) to not keep any
+ * @param compress Whether to FLAC compress songs as they are rendered, trading CPU time for memory. This
+ *   has no effect if libAudio was built without FLAC support, or for songs rendered as float32
+ */
+void moduleFile_t::renderCacheBudget(const size_t bytes, const bool compress) noexcept
+{
+	auto &cache{renderCache_t::instance()};
+	cache.compress(compress);
+	cache.budget(bytes);
+}
+
 constexpr ModuleFile::ModuleFile(const uint8_t moduleType) noexcept : ModuleType{moduleType}, p_Header{nullptr},
-	p_Samples{nullptr}, p_Patterns{nullptr}, p_Instruments{nullptr}, p_PCM{nullptr}, lengthPCM{}, nPCM{},
-	MixSampleRate{}, MixBitsPerSample{}, TickCount{}, SamplesToMix{}, MinPeriod{}, MaxPeriod{}, MixChannels{},
-	Row{}, NextRow{}, Rows{}, MusicSpeed{}, MusicTempo{}, Pattern{}, NewPattern{}, NextPattern{}, RowsPerBeat{},
-	SamplesPerTick{}, Channels{nullptr}, nMixerChannels{}, MixerChannels{nullptr}, globalVolume{},
-	globalVolumeSlide{}, PatternDelay{}, FrameDelay{}, MixBuffer{}, DCOffsR{}, DCOffsL{} { }
+	p_Samples{nullptr}, p_Patterns{nullptr}, PatternStore{}, p_Instruments{nullptr}, p_PCM{nullptr}, lengthPCM{}, nPCM{},
+	FileID{}, MixSampleRate{}, MixBitsPerSample{}, TickCount{}, SamplesToMix{}, MinPeriod{}, MaxPeriod{},
+	MixChannels{}, Row{}, NextRow{}, Rows{}, MusicSpeed{}, MusicTempo{}, Pattern{}, NewPattern{}, NextPattern{},
+	RowsPerBeat{}, SamplesPerTick{}, Channels{nullptr}, nMixerChannels{}, MixerChannels{nullptr}, globalVolume{},
+	globalVolumeSlide{}, PatternDelay{}, FrameDelay{}, MixBuffer{}, MixBlockSize{mixBufferSize}, DCOffsR{}, DCOffsL{},
+	Interpolation{moduleInterpolation_t::none}, OutputFormat{moduleOutput_t::int16}, Dither{false},
+	DitherIndex{}, Effects{}, NoiseShaper{}, MixThreads{}, Stems{}, Snapshots{}, nSnapshots{}, SongSamples{}, SnapshotRate{},
+	MaxVoices{}, AudibilityThreshold{}, StolenVoices{}, CulledVoices{} { }
 
 ModuleFile::ModuleFile(const modMOD_t &file) : ModuleFile{MODULE_MOD}
 {
-	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_MOD};
 
 	p_Header = new ModuleHeader(file);
 	if (fd.seek(20, SEEK_SET) != 20)
 		throw ModuleLoaderError(E_BAD_MOD);
-	p_Samples = new ModuleSample *[p_Header->nSamples];
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
 	for (uint16_t i = 0; i < p_Header->nSamples; i++)
 		p_Samples[i] = ModuleSample::LoadSample(file, i);
 	if (!fd.seekRel(130 + (p_Header->nSamples != 15 ? 4 : 0)))
@@ -35,21 +65,25 @@ ModuleFile::ModuleFile(const modMOD_t &file) : ModuleFile{MODULE_MOD}
 			maxPattern = std::max<uint32_t>(maxPattern, p_Header->Orders[i]);
 	}
 	p_Header->nPatterns = maxPattern + 1;
-	p_Patterns = new pattern_t *[p_Header->nPatterns];
+	PatternStore = {size_t{p_Header->nPatterns} * 64U * p_Header->nChannels, E_BAD_MOD};
+	p_Patterns = new pattern_t *[p_Header->nPatterns]{};
 	for (uint16_t i = 0; i < p_Header->nPatterns; i++)
-		p_Patterns[i] = new pattern_t(file, p_Header->nChannels);
+		p_Patterns[i] = new pattern_t(file, p_Header->nChannels, PatternStore);
 
 	modLoadPCM(fd);
+	fd.release();
 	MinPeriod = 56;
 	MaxPeriod = 7040;
 }
 
 ModuleFile::ModuleFile(const modS3M_t &file) : ModuleFile{MODULE_S3M}
 {
-	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_S3M};
 
 	p_Header = new ModuleHeader(file);
-	p_Samples = new ModuleSample *[p_Header->nSamples];
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
 	uint16_t *const SamplePtrs = p_Header->SamplePtrs.get<uint16_t>();
 	for (uint16_t i = 0; i < p_Header->nSamples; ++i)
 	{
@@ -70,39 +104,45 @@ ModuleFile::ModuleFile(const modS3M_t &file) : ModuleFile{MODULE_S3M}
 		}
 	}
 
-	p_Patterns = new pattern_t *[p_Header->nPatterns];
+	PatternStore = {size_t{p_Header->nPatterns} * 64U * p_Header->nChannels, E_BAD_S3M};
+	p_Patterns = new pattern_t *[p_Header->nPatterns]{};
 	uint16_t *const PatternPtrs = p_Header->PatternPtrs.get<uint16_t>();
 	for (uint16_t i = 0; i < p_Header->nPatterns; ++i)
 	{
 		const uint32_t offset = uint32_t{PatternPtrs[i]} << 4;
 		if (fd.seek(offset, SEEK_SET) != offset)
 			throw ModuleLoaderError{E_BAD_S3M};
-		p_Patterns[i] = new pattern_t(file, p_Header->nChannels);
+		p_Patterns[i] = new pattern_t(file, p_Header->nChannels, PatternStore);
 	}
 
 	s3mLoadPCM(fd);
+	fd.release();
 	MinPeriod = 64;
 	MaxPeriod = 32767;
 }
 
 ModuleFile::ModuleFile(const modSTM_t &file) : ModuleFile{MODULE_STM}
 {
-	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_STM};
 
 	p_Header = new ModuleHeader(file);
-	p_Samples = new ModuleSample *[p_Header->nSamples];
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
 	for (uint16_t i = 0; i < p_Header->nSamples; i++)
 		p_Samples[i] = ModuleSample::LoadSample(file, i);
 	if (!fd.seekRel(128))
 		throw ModuleLoaderError(E_BAD_STM);
-	p_Patterns = new pattern_t *[p_Header->nPatterns];
+	PatternStore = {size_t{p_Header->nPatterns} * 64U * 4U, E_BAD_STM};
+	p_Patterns = new pattern_t *[p_Header->nPatterns]{};
 	for (uint16_t i = 0; i < p_Header->nPatterns; i++)
-		p_Patterns[i] = new pattern_t(file);
+		p_Patterns[i] = new pattern_t(file, PatternStore);
 	const uint32_t pcmOffset = 1104 + (1024 * p_Header->nPatterns);
 	if (fd.seek(pcmOffset, SEEK_SET) != pcmOffset)
 		throw ModuleLoaderError(E_BAD_STM);
 
 	stmLoadPCM(fd);
+	fd.release();
 	MinPeriod = 64;
 	MaxPeriod = 32767;
 }
@@ -117,7 +157,9 @@ ModuleFile::ModuleFile(const modAON_t &file) : ModuleFile{MODULE_AON}
 	uint32_t blockLen = 0;
 	uint32_t i, SampleLengths;
 	uint8_t ChannelMul;
-	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_AON};
 
 	p_Header = new ModuleHeader(file);
 
@@ -132,9 +174,10 @@ ModuleFile::ModuleFile(const modAON_t &file) : ModuleFile{MODULE_AON}
 	if ((blockLen % (1 << ChannelMul)) != 0)
 		throw ModuleLoaderError(E_BAD_AON);
 	p_Header->nPatterns = blockLen >> ChannelMul;
-	p_Patterns = new pattern_t *[p_Header->nPatterns];
+	PatternStore = {size_t{p_Header->nPatterns} * 64U * p_Header->nChannels, E_BAD_AON};
+	p_Patterns = new pattern_t *[p_Header->nPatterns]{};
 	for (i = 0; i < p_Header->nPatterns; i++)
-		p_Patterns[i] = new pattern_t(file, p_Header->nChannels);
+		p_Patterns[i] = new pattern_t(file, p_Header->nChannels, PatternStore);
 
 	if (!fd.read(blockName) ||
 		memcmp(blockName.data(), "INST", 4) != 0 ||
@@ -170,7 +213,7 @@ ModuleFile::ModuleFile(const modAON_t &file) : ModuleFile{MODULE_AON}
 	}
 	const off_t PCMPos = fd.tell();
 
-	p_Samples = new ModuleSample *[p_Header->nSamples];
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
 	for (i = 0; i < p_Header->nSamples; i++)
 	{
 		const off_t offset = InstrPos + (i << 5);
@@ -187,28 +230,67 @@ ModuleFile::ModuleFile(const modAON_t &file) : ModuleFile{MODULE_AON}
 		throw ModuleLoaderError(E_BAD_AON);
 
 	aonLoadPCM(fd);
+	fd.release();
 	MinPeriod = 56;
 	MaxPeriod = 7040;
 }
 #endif // ENABLE_AON
 
 #ifdef ENABLE_FC1x
+// Future Composer's sequence, patterns and macros are kept as they are in the file, for fc1xTick() to play from
 ModuleFile::ModuleFile(const modFC1x_t &file) : ModuleFile{MODULE_FC1x}
 {
-//	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_FC1x};
 
 	p_Header = new ModuleHeader(file);
+	// FC1.3's waveforms are built into the replayer, where FC1.4 files carry theirs after the samples.
+	// The sub-samples of any sample packs come after those.
+	const bool builtinWaves{p_Header->FormatVersion != 14};
+	const auto waves{uint16_t(fc1xSamples + (builtinWaves ? fc1xBuiltinWaves : fc1xMaxWaves))};
+	p_Header->nSamples = waves + (fc1xSamples * fc1xPackSamples);
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
+	for (uint16_t i = 0; i < waves; ++i)
+		p_Samples[i] = ModuleSample::LoadSample(file, i, builtinWaves);
+
+	const auto readBlock{[&](const off_t offset, const size_t length)
+	{
+		if (!length)
+			return fixedVector_t<uint8_t>{};
+		fixedVector_t<uint8_t> block{length};
+		if (!block.valid() ||
+			fd.seek(offset, SEEK_SET) != offset ||
+			!fd.read(block.data(), length))
+			throw ModuleLoaderError{E_BAD_FC1x};
+		return block;
+	}};
+	// The sequence follows straight on from the tables
+	FCSong.sequence = readBlock(fd.tell(), size_t{p_Header->nOrders} * fc1xStepLength);
+	FCSong.patterns = readBlock(p_Header->PatternOffs, p_Header->PatLength);
+	FCSong.frequencyMacros = readBlock(p_Header->FrequenciesOffs, p_Header->FrequenciesLength);
+	FCSong.volumeMacros = readBlock(p_Header->VolumeOffs, p_Header->VolumeLength);
+	const auto speed{FCSong.speed(0U)};
+	p_Header->InitialSpeed = speed ? speed : 3U;
+
+	fc1xLoadPacks(file);
+	fc1xLoadPCM(fd);
+	fd.release();
+	MinPeriod = fc1xMinPeriod << 2U;
+	MaxPeriod = fc1xMaxPeriod << 2U;
 }
 #endif
 
 ModuleFile::ModuleFile(const modIT_t &file) : ModuleFile{MODULE_IT}
 {
-	const fd_t &fd = file.fd();
+	auto &fd{file.context()->reader};
+	if (!fd.load(file.fd()))
+		throw ModuleLoaderError{E_BAD_IT};
 
 	p_Header = new ModuleHeader(file);
 	if (p_Header->nInstruments)
 	{
-		p_Instruments = new ModuleInstrument *[p_Header->nInstruments];
+		p_Instruments = new ModuleInstrument *[p_Header->nInstruments]{};
 		auto *const instrOffsets = p_Header->InstrumentPtrs.get<uint32_t>();
 		for (uint16_t i = 0; i < p_Header->nInstruments; ++i)
 		{
@@ -217,7 +299,7 @@ ModuleFile::ModuleFile(const modIT_t &file) : ModuleFile{MODULE_IT}
 			p_Instruments[i] = ModuleInstrument::LoadInstrument(file, i, p_Header->FormatVersion).release();
 		}
 	}
-	p_Samples = new ModuleSample *[p_Header->nSamples];
+	p_Samples = new ModuleSample *[p_Header->nSamples]{};
 	auto *const sampleOffsets = p_Header->SamplePtrs.get<uint32_t>();
 	for (uint16_t i = 0; i < p_Header->nSamples; ++i)
 	{
@@ -244,8 +326,19 @@ ModuleFile::ModuleFile(const modIT_t &file) : ModuleFile{MODULE_IT}
 		}
 	}
 
-	p_Patterns = new pattern_t *[p_Header->nPatterns];
+	// Patterns vary in length, so total up their rows to size the pattern store
 	uint32_t *const PatternPtrs = p_Header->PatternPtrs.get<uint32_t>();
+	size_t patternRows{};
+	for (uint16_t i = 0; i < p_Header->nPatterns; i++)
+	{
+		std::array<uint8_t, 2> rows{};
+		if (PatternPtrs[i] != 0 && !fd.readAt(PatternPtrs[i] + 2U, rows.data(), rows.size()))
+			throw ModuleLoaderError(E_BAD_IT);
+		patternRows += uint16_t((uint16_t(rows[1]) << 8U) | rows[0]);
+	}
+	PatternStore = {patternRows * p_Header->nChannels, E_BAD_IT};
+
+	p_Patterns = new pattern_t *[p_Header->nPatterns]{};
 	for (uint16_t i = 0; i < p_Header->nPatterns; i++)
 	{
 		if (PatternPtrs[i] == 0)
@@ -254,11 +347,12 @@ ModuleFile::ModuleFile(const modIT_t &file) : ModuleFile{MODULE_IT}
 		{
 			if (fd.seek(PatternPtrs[i], SEEK_SET) != PatternPtrs[i])
 				throw ModuleLoaderError(E_BAD_IT);
-			p_Patterns[i] = new pattern_t(file, p_Header->nChannels);
+			p_Patterns[i] = new pattern_t(file, p_Header->nChannels, PatternStore);
 		}
 	}
 
 	itLoadPCM(fd);
+	fd.release();
 	MinPeriod = 8;
 	MaxPeriod = 61440;//32767;
 }
@@ -269,20 +363,15 @@ ModuleFile::~ModuleFile()
 
 	DeinitMixer();
 
-	if (ModuleType != MODULE_AON && p_Header)
-		nPCM = p_Header->nSamples;
-	for (i = 0; i < nPCM; i++)
-		delete [] p_PCM[i];
-	delete [] p_PCM;
 	if (p_Header)
 	{
-		for (i = 0; i < p_Header->nPatterns; i++)
+		for (i = 0; p_Patterns && i < p_Header->nPatterns; i++)
 			delete p_Patterns[i];
 		delete [] p_Patterns;
-		for (i = 0; i < p_Header->nInstruments; i++)
+		for (i = 0; p_Instruments && i < p_Header->nInstruments; i++)
 			delete p_Instruments[i];
 		delete [] p_Instruments;
-		for (i = 0; i < p_Header->nSamples; i++)
+		for (i = 0; p_Samples && i < p_Header->nSamples; i++)
 			delete p_Samples[i];
 	}
 	delete [] p_Samples;
@@ -305,146 +394,346 @@ uint8_t ModuleFile::channels() const noexcept
 	return (p_Header->MasterVolume & 0x80) ? 2 : 1;
 }
 
-void ModuleFile::modLoadPCM(const fd_t &fd)
+// Hashing the whole file is only worth it if one of the caches is going to use the result
+static pcmFileID_t identifyFile(const moduleReader_t &fd) noexcept
+{
+	if (!pcmCache_t::instance().budget() && !renderCache_t::instance().budget())
+		return {};
+	return pcmCache_t::identify(fd.data(), fd.length());
+}
+
+// How many bytes the padded 16-bit form of a sample's PCM takes up, guard frames included
+static size_t paddedPCMBytes(const size_t frames, const bool stereo) noexcept
+{
+	const size_t channels{stereo ? 2U : 1U};
+	return sizeof(int16_t) * ((frames + (sampleGuard * 2U)) * channels);
+}
+
+// Picks the sample's PCM up from the shared cache if another load of the same file already decoded it.
+// The PCM found has to be the size the sample needs, as anything else would leave the mixer reading past its end
+bool ModuleFile::cachedPCM(const pcmFileID_t &file, const uint32_t i, const size_t frames, const bool stereo)
 {
-	p_PCM = new uint8_t *[p_Header->nSamples];
+	// A file that was not identified would match every other such file
+	if (!file.length)
+		return false;
+	p_PCM[i] = pcmCache_t::instance().find(file, i, paddedPCMBytes(frames, stereo));
+	return bool(p_PCM[i]);
+}
+
+/*!
+ * Converts the freshly decoded, signed, PCM for a sample into the padded 16-bit form the mixer takes, hands that
+ * over to the module and offers it up to the shared cache.
+ * @return \c false if there was not the memory to convert the PCM into, otherwise \c true
+ */
+template<typename T> bool ModuleFile::sharePCM(const pcmFileID_t &file, const uint32_t i, const T *const pcm,
+	const size_t frames, const bool stereo)
+{
+	const size_t channels{stereo ? 2U : 1U};
+	const size_t guard{sampleGuard * channels};
+	const size_t length{(frames * channels) + (guard * 2U)};
+	auto buffer{make_unique_nothrow<int16_t []>(length)};
+	if (!buffer)
+		return false;
+	auto *const data{buffer.get() + guard};
+	if constexpr (sizeof(T) == 1U)
+		selectSamplePCM().widen8(data, pcm, frames * channels);
+	else
+		std::memcpy(data, pcm, sizeof(int16_t) * frames * channels);
+	pcmFillGuards(data, frames, channels);
+	if (frames == p_Samples[i]->GetLength())
+	{
+		const auto loop{p_Samples[i]->guardLoop()};
+		if (loop.start < frames)
+			pcmUnrollLoop(data, frames, channels, loop.start, loop.pingPong);
+	}
+
+	// Release before wrapping as, should allocating the control block fail, the deleter gets run for us
+	const pcmPtr_t owner{reinterpret_cast<const uint8_t *>(buffer.release()),
+		[](const uint8_t *const block) noexcept { delete [] reinterpret_cast<const int16_t *>(block); }};
+	// The module gets pointed at the first real frame, leaving the guard frames either side of it
+	p_PCM[i] = pcmPtr_t{owner, owner.get() + (sizeof(int16_t) * guard)};
+	if (file.length)
+		pcmCache_t::instance().insert(file, i, p_PCM[i], paddedPCMBytes(frames, stereo));
+	return true;
+}
+
+void ModuleFile::modLoadPCM(const moduleReader_t &fd)
+{
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	p_PCM = std::make_unique<pcmPtr_t []>(p_Header->nSamples);
 	for (uint32_t i = 0; i < p_Header->nSamples; ++i)
 	{
 		uint32_t Length = p_Samples[i]->GetLength();
 		if (Length != 0)
 		{
-			p_PCM[i] = new uint8_t[Length];
-			if (!fd.read(p_PCM[i], Length))
+			if (cachedPCM(file, i, Length, false))
+			{
+				if (!fd.seekRel(Length))
+					throw ModuleLoaderError{E_BAD_MOD};
+				continue;
+			}
+			auto pcm{make_unique_nothrow<uint8_t []>(Length)};
+			if (!pcm || !fd.read(pcm, Length))
 				throw ModuleLoaderError{E_BAD_MOD};
 			// TODO: This is hard, ok? MPT does wierd stuff here on memory buffers.
 			// The decompression loop is now correct, as is the memory allocation.
 			// However, I do not think the seek is correct, nor some of the length compensation code.
 			// There really is no nice way either to express the sample's real length yet..
 			// not sure that rewriting it is even correct, seeing we over-read (according to MPT), not under.
-			/*if (strncasecmp(reinterpret_cast<char *>(p_PCM[i]), "ADPCM", 5) == 0)
+			/*if (strncasecmp(reinterpret_cast<char *>(pcm.get()), "ADPCM", 5) == 0)
 			{
-				const std::unique_ptr<uint8_t []> _(p_PCM[i]);
+				const std::unique_ptr<uint8_t []> _(pcm.release());
 				const uint8_t *const compressionTable = _.get() + 5;
 				const uint8_t *const compBuffer = _.get() + 5 + 16;
 				uint8_t delta = 0;
 				Length -= 16 + 5 - 1;
 				Length &= ~1;
-				p_PCM = new uint8_t[Length];
+				pcm = make_unique_nothrow<uint8_t []>(Length);
 				p_Samples[i]->Length = Length;
 				Length >>= 1;
 				for (uint32_t j = 0, k = 0; j < Length; ++j)
 				{
 					delta += compressionTable[compBuffer[j] & 0x0F];
-					p_PCM[i][k++] = delta;
+					pcm[k++] = delta;
 					delta += compressionTable[(compBuffer[j] >> 4) & 0x0F];
-					p_PCM[i][k++] = delta;
+					pcm[k++] = delta;
 				}
 				fseek(f_MOD, -Length, SEEK_CUR);
 			}*/
-			p_PCM[i][0] = p_PCM[i][1] = 0;
+			pcm[0] = pcm[1] = 0;
+			if (!sharePCM(file, i, pcm.get(), Length, false))
+				throw ModuleLoaderError{E_BAD_MOD};
 		}
-		else
-			p_PCM[i] = nullptr;
 	}
 }
 
-void ModuleFile::s3mLoadPCM(const fd_t &fd)
+void ModuleFile::s3mLoadPCM(const moduleReader_t &fd)
 {
-	p_PCM = new uint8_t *[p_Header->nSamples];
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	p_PCM = std::make_unique<pcmPtr_t []>(p_Header->nSamples);
 	for (uint32_t i = 0; i < p_Header->nSamples; ++i)
 	{
 		const uint32_t length = p_Samples[i]->GetLength() << (p_Samples[i]->Get16Bit() ? 1 : 0);
-		if (length != 0 && p_Samples[i]->GetType() == 1)
+		if (length != 0 && p_Samples[i]->GetType() == 1 &&
+			!cachedPCM(file, i, p_Samples[i]->GetLength(), false))
 		{
 			const auto *sample = dynamic_cast<ModuleSampleNative *>(p_Samples[i]);
 			const uint32_t offset = uint32_t{sample->SamplePos} << 4U;
-			p_PCM[i] = new uint8_t[length];
-			if (fd.seek(offset, SEEK_SET) != offset ||
-				!fd.read(p_PCM[i], length))
+			auto pcm{make_unique_nothrow<uint8_t []>(length)};
+			if (!pcm ||
+				fd.seek(offset, SEEK_SET) != offset ||
+				!fd.read(pcm, length))
 				throw ModuleLoaderError{E_BAD_S3M};
 			if (p_Header->FormatVersion == 2)
 			{
 				if (p_Samples[i]->Get16Bit())
 				{
-					auto *pcm = reinterpret_cast<uint16_t *>(p_PCM[i]);
+					auto *pcm16 = reinterpret_cast<uint16_t *>(pcm.get());
 					for (uint32_t j = 0; j < (length >> 1); j++)
-						pcm[j] ^= 0x8000U;
+						pcm16[j] ^= 0x8000U;
 				}
 				else
 				{
-					auto *pcm = reinterpret_cast<uint8_t *>(p_PCM[i]);
 					for (uint32_t j = 0; j < length; j++)
 						pcm[j] ^= 0x80U;
 				}
 			}
+			const bool shared
+			{
+				p_Samples[i]->Get16Bit() ?
+					sharePCM(file, i, reinterpret_cast<const uint16_t *>(pcm.get()), length >> 1U, false) :
+					sharePCM(file, i, pcm.get(), length, false)
+			};
+			if (!shared)
+				throw ModuleLoaderError{E_BAD_S3M};
 		}
-		else
-			p_PCM[i] = nullptr;
 	}
 }
 
-void ModuleFile::stmLoadPCM(const fd_t &fd)
+void ModuleFile::stmLoadPCM(const moduleReader_t &fd)
 {
-	p_PCM = new uint8_t *[p_Header->nSamples];
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	p_PCM = std::make_unique<pcmPtr_t []>(p_Header->nSamples);
 	for (uint16_t i = 0; i < p_Header->nSamples; i++)
 	{
 		const uint32_t length = p_Samples[i]->GetLength();
 		if (length != 0)
 		{
-			p_PCM[i] = new uint8_t[length];
-			if (!fd.read(p_PCM[i], length) ||
-				!fd.seekRel(length % 16))
+			if (cachedPCM(file, i, length, false))
+			{
+				if (!fd.seekRel(length + (length % 16)))
+					throw ModuleLoaderError{E_BAD_STM};
+				continue;
+			}
+			auto pcm{make_unique_nothrow<uint8_t []>(length)};
+			if (!pcm ||
+				!fd.read(pcm, length) ||
+				!fd.seekRel(length % 16) ||
+				!sharePCM(file, i, pcm.get(), length, false))
 				throw ModuleLoaderError{E_BAD_STM};
 		}
-		else
-			p_PCM[i] = nullptr;
 	}
 }
 
-void ModuleFile::aonLoadPCM(const fd_t &fd)
+void ModuleFile::aonLoadPCM(const moduleReader_t &fd)
 {
-	p_PCM = new uint8_t *[nPCM];
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	p_PCM = std::make_unique<pcmPtr_t []>(nPCM);
 	for (uint32_t i = 0; i < nPCM; i++)
 	{
 		uint32_t Length = lengthPCM[i];
 		if (Length != 0)
 		{
-			p_PCM[i] = new uint8_t[Length];
-			if (!fd.read(p_PCM[i], Length))
+			if (cachedPCM(file, i, Length, false))
+			{
+				if (!fd.seekRel(Length))
+					throw ModuleLoaderError{E_BAD_AON};
+				continue;
+			}
+			auto pcm{make_unique_nothrow<uint8_t []>(Length)};
+			if (!pcm || !fd.read(pcm, Length) || !sharePCM(file, i, pcm.get(), Length, false))
 				throw ModuleLoaderError{E_BAD_AON};
 		}
-		else
-			p_PCM[i] = nullptr;
 	}
 }
 
-uint32_t itBitstreamRead(uint8_t &buff, uint8_t &buffLen, const fd_t &fd, size_t bits)
+#ifdef ENABLE_FC1x
+// Every sample gets a slot for each sub-sample a pack can hold, which stays empty if the sample isn't a pack
+void ModuleFile::fc1xLoadPacks(const modFC1x_t &file)
 {
-	uint32_t ret = 0;
-	if (bits > 0)
+	const auto &fd{file.context()->reader};
+	const uint32_t subSamples = p_Header->nSamples - (fc1xSamples * fc1xPackSamples);
+	off_t offset{p_Header->SampleOffs};
+	for (uint32_t i = 0; i < fc1xSamples; ++i)
 	{
-		for (size_t i = 0; i < bits; ++i)
+		const uint32_t length = p_Samples[i]->GetLength();
+		std::array<char, 4> magic{};
+		const bool pack
 		{
-			if (buffLen == 0)
-			{
-				if (!fd.read(buff))
-					throw ModuleLoaderError{E_BAD_IT};
-				buffLen = 8;
-			}
-			ret |= (buff & 1U) << i;
-			buff >>= 1U;
-			buffLen--;
+			length >= fc1xPackHeader &&
+			fd.seek(offset, SEEK_SET) == offset &&
+			fd.read(magic) &&
+			memcmp(magic.data(), "SSMP", 4) == 0
+		};
+		const uint32_t packData{pack ? uint32_t(offset) + uint32_t{fc1xPackHeader} : 0U};
+		const uint32_t packLength{pack ? length - uint32_t{fc1xPackHeader} : 0U};
+		for (uint32_t subSample = 0; subSample < fc1xPackSamples; ++subSample)
+		{
+			const auto index{subSamples + (i * fc1xPackSamples) + subSample};
+			p_Samples[index] = ModuleSample::LoadSample(file, index, packData, packLength);
+		}
+		offset += length;
+	}
+}
+
+// The samples are stored one after the other, as are FC1.4's waveforms, while FC1.3's come from the replayer.
+// Sub-samples are read out of the sample packs they're part of.
+void ModuleFile::fc1xLoadPCM(const moduleReader_t &fd)
+{
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	p_PCM = std::make_unique<pcmPtr_t []>(p_Header->nSamples);
+	const bool builtinWaves{p_Header->FormatVersion != 14};
+	const uint32_t subSamples = p_Header->nSamples - (fc1xSamples * fc1xPackSamples);
+	off_t offset{p_Header->SampleOffs};
+	for (uint16_t i = 0; i < p_Header->nSamples; ++i)
+	{
+		if (i == fc1xSamples)
+			offset = p_Header->SampleLength;
+		else if (i >= subSamples)
+			offset = dynamic_cast<ModuleSampleNative *>(p_Samples[i])->SamplePos;
+		const uint32_t length = p_Samples[i]->GetLength();
+		if (length == 0 || cachedPCM(file, i, length, false))
+		{
+			offset += length;
+			continue;
+		}
+		if (i >= fc1xSamples && i < subSamples && builtinWaves)
+		{
+			const auto *const wave{reinterpret_cast<const uint8_t *>(fc1xBuiltinWave(uint8_t(i - fc1xSamples)))};
+			if (!sharePCM(file, i, wave, length, false))
+				throw ModuleLoaderError{E_BAD_FC1x};
+			continue;
 		}
+		auto pcm{make_unique_nothrow<uint8_t []>(length)};
+		if (!pcm ||
+			fd.seek(offset, SEEK_SET) != offset ||
+			!fd.read(pcm, length))
+			throw ModuleLoaderError{E_BAD_FC1x};
+		offset += length;
+		if (!sharePCM(file, i, pcm.get(), length, false))
+			throw ModuleLoaderError{E_BAD_FC1x};
 	}
-	return ret;
 }
+#endif
+
+// Reads the LSB-first bitstream of IT214/IT215 compressed samples straight out of the in-memory file.
+// The buffer is refilled 64 bits at a time; any bits above _count are always the stream's next bits,
+// so re-reading the bytes they came from on the next refill just ORs the same values back in.
+struct itBitstream_t final
+{
+private:
+	const uint8_t *const _data;
+	const size_t _length;
+	size_t _offset{};
+	uint64_t _bits{};
+	uint8_t _count{};
+
+	void refill() noexcept
+	{
+		if (_length - _offset >= 8U)
+		{
+			uint64_t value{};
+			for (size_t i{}; i < 8U; ++i)
+				value |= uint64_t{_data[_offset + i]} << (i * 8U);
+			_bits |= value << _count;
+			const auto bytes{static_cast<uint8_t>((63U - _count) >> 3U)};
+			_offset += bytes;
+			_count += bytes * 8U;
+		}
+		else
+		{
+			for (; _count <= 56U && _offset < _length; _count += 8U)
+				_bits |= uint64_t{_data[_offset++]} << _count;
+		}
+	}
+
+public:
+	itBitstream_t(const uint8_t *const data, const size_t length) noexcept : _data{data}, _length{length} { }
 
-template<typename T> void itUnpackPCM(ModuleSample *sample, T *PCM, const fd_t &fd, bool deltaComp);
+	// Compression blocks start on a byte boundary, so throw away what's left of the current byte
+	void align() noexcept
+	{
+		_bits >>= _count & 7U;
+		_count &= ~7U;
+	}
+
+	uint32_t read(uint8_t bits)
+	{
+		// Only corrupt data asks for more than 32 bits at once, and the decoders discard those values
+		for (; bits > 32U; bits -= 32U)
+			static_cast<void>(read(32U));
+		if (_count < bits)
+		{
+			refill();
+			if (_count < bits)
+				throw ModuleLoaderError{E_BAD_IT};
+		}
+		const auto value{static_cast<uint32_t>(_bits & ((uint64_t{1U} << bits) - 1U))};
+		_bits >>= bits;
+		_count -= bits;
+		return value;
+	}
+};
+
+template<typename T> void itUnpackPCM(ModuleSample *sample, T *PCM, itBitstream_t &stream, bool deltaComp);
 
-template<> void itUnpackPCM<uint8_t>(ModuleSample *sample, uint8_t *PCM, const fd_t &fd, const bool deltaComp)
+template<> void itUnpackPCM<uint8_t>(ModuleSample *sample, uint8_t *PCM, itBitstream_t &stream, const bool deltaComp)
 {
-	uint8_t buff = 0;
-	uint8_t buffLen = 0;
 	uint8_t bitWidth = 9;
 	int8_t delta = 0;
 	int8_t adjDelta = 0;
@@ -456,9 +745,9 @@ template<> void itUnpackPCM<uint8_t>(ModuleSample *sample, uint8_t *PCM, const f
 		if (blockLen == 0)
 		{
 			blockLen = 0x8000;
-			buffLen = 0;
+			stream.align();
 			// First we ignore 16 bits..
-			itBitstreamRead(buff, buffLen, fd, 16);
+			stream.read(16);
 			bitWidth = 9;
 			delta = 0;
 			adjDelta = 0;
@@ -477,15 +766,13 @@ template<> void itUnpackPCM<uint8_t>(ModuleSample *sample, uint8_t *PCM, const f
 		uint32_t offs = 0;
 		do
 		{
-			auto bits = itBitstreamRead(buff, buffLen, fd, bitWidth) & 0x0000FFFFU;
-			if (fd.isEOF())
-				return;
+			auto bits = stream.read(bitWidth) & 0x0000FFFFU;
 			if (bitWidth < 7)
 			{
 				uint16_t special = 1U << (bitWidth - 1U);
 				if (bits == special)
 				{
-					const auto bits = itBitstreamRead(buff, buffLen, fd, 3) + 1U;
+					const auto bits = stream.read(3) + 1U;
 					if (bits < bitWidth)
 						bitWidth = bits;
 					else
@@ -536,10 +823,8 @@ template<> void itUnpackPCM<uint8_t>(ModuleSample *sample, uint8_t *PCM, const f
 	}
 }
 
-template<> void itUnpackPCM<uint16_t>(ModuleSample *sample, uint16_t *PCM, const fd_t &fd, const bool deltaComp)
+template<> void itUnpackPCM<uint16_t>(ModuleSample *sample, uint16_t *PCM, itBitstream_t &stream, const bool deltaComp)
 {
-	uint8_t buff = 0;
-	uint8_t buffLen = 0;
 	uint8_t bitWidth = 17;
 	int16_t delta = 0;
 	int16_t adjDelta = 0;
@@ -551,9 +836,9 @@ template<> void itUnpackPCM<uint16_t>(ModuleSample *sample, uint16_t *PCM, const
 		if (blockLen == 0)
 		{
 			blockLen = 0x4000;
-			buffLen = 0;
+			stream.align();
 			// First we ignore 16 bits
-			itBitstreamRead(buff, buffLen, fd, 16);
+			stream.read(16);
 			bitWidth = 17;
 			delta = 0;
 			adjDelta = 0;
@@ -572,15 +857,13 @@ template<> void itUnpackPCM<uint16_t>(ModuleSample *sample, uint16_t *PCM, const
 		uint32_t offs = 0;
 		do
 		{
-			if (fd.isEOF())
-				return;
-			auto bits = itBitstreamRead(buff, buffLen, fd, bitWidth);
+			auto bits = stream.read(bitWidth);
 			if (bitWidth < 7)
 			{
 				uint32_t special = 1U << (bitWidth - 1U);
 				if (bits == special)
 				{
-					const auto bits = itBitstreamRead(buff, buffLen, fd, 4) + 1U;
+					const auto bits = stream.read(4) + 1U;
 					if (bits < bitWidth)
 						bitWidth = bits;
 					else
@@ -631,71 +914,120 @@ template<> void itUnpackPCM<uint16_t>(ModuleSample *sample, uint16_t *PCM, const
 	}
 }
 
-template<typename T> void fixSign(T *const pcm, const size_t length);
+template<typename T> void fixSign(T *const pcm, const size_t length) noexcept;
 
-template<> void fixSign<uint8_t>(uint8_t *const pcm, const size_t length)
-{
-	for (size_t i = 0; i < length; ++i)
-		pcm[i] ^= 0x80U;
-}
+template<> void fixSign<uint8_t>(uint8_t *const pcm, const size_t length) noexcept
+	{ selectSamplePCM().fixSign8(pcm, length); }
 
-template<> void fixSign<uint16_t>(uint16_t *const pcm, const size_t length)
-{
-	for (size_t i = 0; i < length; ++i)
-		pcm[i] ^= 0x8000U;
-}
+template<> void fixSign<uint16_t>(uint16_t *const pcm, const size_t length) noexcept
+	{ selectSamplePCM().fixSign16(pcm, length); }
 
-template<typename T> void stereoInterleave(T *pcmIn, T *pcmOut, const size_t length)
-{
-	for (size_t i = 0; i < length; ++i)
-	{
-		pcmOut[(i << 1U) + 0U] = pcmIn[i];
-		pcmOut[(i << 1U) + 1U] = pcmIn[i + length];
-	}
-}
+template<typename T> void stereoInterleave(T *pcmIn, T *pcmOut, const size_t length) noexcept;
+
+template<> void stereoInterleave<uint8_t>(uint8_t *const pcmIn, uint8_t *const pcmOut, const size_t length) noexcept
+	{ selectSamplePCM().interleave8(pcmOut, pcmIn, pcmIn + length, length); }
 
-template<typename T> void ModuleFile::itLoadPCMSample(const fd_t &fd, const uint32_t i)
+template<> void stereoInterleave<uint16_t>(uint16_t *const pcmIn, uint16_t *const pcmOut, const size_t length) noexcept
+	{ selectSamplePCM().interleave16(pcmOut, pcmIn, pcmIn + length, length); }
+
+// NB: This must leave fd's cursor alone as itLoadPCM() may run it for several samples at once
+template<typename T> void ModuleFile::itLoadPCMSample(const moduleReader_t &fd, const pcmFileID_t &file,
+	const uint32_t i)
 {
 	auto *const Sample = dynamic_cast<ModuleSampleNative *>(p_Samples[i]);
 	const size_t Length = p_Samples[i]->GetLength() << (Sample->GetStereo() ? 1U : 0U);
-	if ((Sample->Flags & 0x01U) == 0U || Length == 0U)
-	{
-		p_PCM[i] = nullptr;
+	if ((Sample->Flags & 0x01U) == 0U || Length == 0U ||
+		cachedPCM(file, i, p_Samples[i]->GetLength(), Sample->GetStereo()))
 		return;
-	}
 	auto pcm = make_unique_nothrow<T []>(Length);
-	if (fd.seek(Sample->SamplePos, SEEK_SET) != Sample->SamplePos)
+	if (!pcm || Sample->SamplePos > fd.length())
 		throw ModuleLoaderError{E_BAD_IT};
 	if (Sample->Flags & 0x08U)
 	{
-		itUnpackPCM(Sample, pcm.get(), fd, p_Header->FormatVersion > 214 && Sample->Packing & 0x04U);
+		itBitstream_t stream{fd.data() + Sample->SamplePos, fd.length() - Sample->SamplePos};
+		itUnpackPCM(Sample, pcm.get(), stream, p_Header->FormatVersion > 214 && Sample->Packing & 0x04U);
 		if (Sample->GetStereo())
-			itUnpackPCM(Sample, pcm.get() + Sample->GetLength(), fd, p_Header->FormatVersion > 214 && Sample->Packing & 0x04U);
+			itUnpackPCM(Sample, pcm.get() + Sample->GetLength(), stream, p_Header->FormatVersion > 214 && Sample->Packing & 0x04U);
 	}
-	else if (!fd.read(pcm, Length))
+	else if (!fd.readAt(Sample->SamplePos, pcm.get(), sizeof(T) * Length))
 		throw ModuleLoaderError{E_BAD_IT};
 	if (!(Sample->Packing & 0x01U))
 		fixSign(pcm.get(), Length);
 	if (Sample->GetStereo())
 	{
 		auto outBuff = make_unique_nothrow<T []>(Length);
+		if (!outBuff)
+			throw ModuleLoaderError{E_BAD_IT};
 		stereoInterleave(pcm.get(), outBuff.get(), p_Samples[i]->GetLength());
-		p_PCM[i] = reinterpret_cast<uint8_t *>(outBuff.release());
+		pcm = std::move(outBuff);
 	}
+	if (!sharePCM(file, i, pcm.get(), p_Samples[i]->GetLength(), Sample->GetStereo()))
+		throw ModuleLoaderError{E_BAD_IT};
+}
+
+void ModuleFile::itLoadPCMSample(const moduleReader_t &fd, const pcmFileID_t &file, const uint32_t i)
+{
+	if (p_Samples[i]->Get16Bit())
+		itLoadPCMSample<uint16_t>(fd, file, i);
 	else
-		p_PCM[i] = reinterpret_cast<uint8_t *>(pcm.release());
+		itLoadPCMSample<uint8_t>(fd, file, i);
 }
 
-void ModuleFile::itLoadPCM(const fd_t &fd)
+// Starting a thread to load samples on costs about as much as decompressing 3KiB of them, so each thread has to be
+// given a good deal more than that to unpack before loading on several pays off
+constexpr static size_t itParallelLoadBytes{65536U};
+
+void ModuleFile::itLoadPCM(const moduleReader_t &fd)
 {
-	p_PCM = new uint8_t *[p_Header->nSamples];
-	for (uint32_t i = 0; i < p_Header->nSamples; ++i)
+	const auto file{identifyFile(fd)};
+	FileID = file;
+	const uint16_t samples{p_Header->nSamples};
+	p_PCM = std::make_unique<pcmPtr_t []>(samples);
+
+	// Every sample records where its data starts, so they can be loaded independently of each other.
+	// Only the compressed ones take long enough to be worth farming out to other threads though.
+	size_t compressed{};
+	size_t unpackedBytes{};
+	for (uint16_t i = 0; i < samples; ++i)
 	{
-		if (p_Samples[i]->Get16Bit())
-			itLoadPCMSample<uint16_t>(fd, i);
-		else
-			itLoadPCMSample<uint8_t>(fd, i);
+		auto *const sample = dynamic_cast<ModuleSampleNative *>(p_Samples[i]);
+		if ((sample->Flags & 0x09U) == 0x09U && sample->GetLength())
+		{
+			++compressed;
+			unpackedBytes += size_t{sample->GetLength()} << ((sample->Get16Bit() ? 1U : 0U) +
+				(sample->GetStereo() ? 1U : 0U));
+		}
+	}
+
+	std::unique_ptr<mixThreads_t> threads{};
+	const auto workers{std::min({size_t{std::thread::hardware_concurrency()}, compressed,
+		unpackedBytes / itParallelLoadBytes})};
+	if (workers > 1U)
+	{
+		// If we can't have the threads, it just means everything gets loaded on this one.
+		// Nothing gets mixed here, so the workers need no room to mix into either.
+		try { threads = std::make_unique<mixThreads_t>(workers, 0U); }
+		catch (const std::exception &) { }
+	}
+
+	if (!threads)
+	{
+		for (uint16_t i = 0; i < samples; ++i)
+			itLoadPCMSample(fd, file, i);
+		return;
 	}
+
+	std::atomic<bool> failed{false};
+	threads->run([&](const size_t worker, const size_t workers) noexcept
+	{
+		for (size_t i{worker}; i < samples && !failed; i += workers)
+		{
+			try { itLoadPCMSample(fd, file, static_cast<uint32_t>(i)); }
+			catch (...) { failed = true; }
+		}
+	});
+	if (failed)
+		throw ModuleLoaderError{E_BAD_IT};
 }
 
 ModuleLoaderError::ModuleLoaderError(const uint32_t error) : _error(error) { }
@@ -14,7 +14,7 @@ ModuleHeader::ModuleHeader(const modMOD_t &file) : ModuleHeader{}
 	std::array<char, 4> magic{};
 	uint8_t orders_{};
 	uint8_t restartPos_{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	Name = make_unique<char []>(21);
 	Orders = make_unique<uint8_t []>(128);
@@ -74,7 +74,7 @@ ModuleHeader::ModuleHeader(const modS3M_t &file) : ModuleHeader{}
 	uint8_t Const{};
 	uint16_t Special{};
 	uint16_t rawFlags{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	Name = make_unique<char []>(29);
 	if (!Name ||
@@ -144,7 +144,7 @@ ModuleHeader::ModuleHeader(const modSTM_t &file) : ModuleHeader{}
 	std::array<char, 9> magic{};
 	std::array<char, 13> reserved{};
 	uint8_t patternCount_{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	nOrders = 128;
 	Name = make_unique<char []>(21);
@@ -186,7 +186,7 @@ ModuleHeader::ModuleHeader(const modAON_t &file) : ModuleHeader{}
 	std::array<char, 42> magic2{};
 	uint32_t blockLen = 0;
 	uint8_t Const{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(magic1) ||
 		!fd.read(magic2) ||
@@ -286,21 +286,27 @@ ModuleHeader::ModuleHeader(const modAON_t &file) : ModuleHeader{}
 ModuleHeader::ModuleHeader(const modFC1x_t &file) : ModuleHeader{}
 {
 	std::array<char, 4> fc1xMagic;
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(fc1xMagic) ||
 		(memcmp(fc1xMagic.data(), "SMOD", 4) != 0 &&
 		memcmp(fc1xMagic.data(), "FC14", 4) != 0) ||
-		!fd.read(SeqLength) ||
-		!fd.read(PatternOffs) ||
-		!fd.read(PatLength) ||
-		!fd.read(FrequenciesOffs) ||
-		!fd.read(FrequenciesLength) ||
-		!fd.read(VolumeOffs) ||
-		!fd.read(VolumeLength) ||
-		!fd.read(SampleOffs) ||
-		!fd.read(SampleLength))
+		!fd.readBE(SeqLength) ||
+		!fd.readBE(PatternOffs) ||
+		!fd.readBE(PatLength) ||
+		!fd.readBE(FrequenciesOffs) ||
+		!fd.readBE(FrequenciesLength) ||
+		!fd.readBE(VolumeOffs) ||
+		!fd.readBE(VolumeLength) ||
+		!fd.readBE(SampleOffs) ||
+		!fd.readBE(SampleLength))
 		throw ModuleLoaderError{E_BAD_FC1x};
+	FormatVersion = memcmp(fc1xMagic.data(), "FC14", 4) == 0 ? 14 : 13;
+	// Each step of the sequence is played as an order
+	nOrders = uint16_t(std::min<uint32_t>(SeqLength / fc1xStepLength, UINT16_MAX));
+	if (!nOrders)
+		throw ModuleLoaderError{E_BAD_FC1x};
+	nChannels = fc1xVoices;
 }
 #endif
 
@@ -311,7 +317,7 @@ ModuleHeader::ModuleHeader(const modIT_t &file) : ModuleHeader{}
 	uint16_t msgLength{};
 	uint16_t songFlags{};
 	uint8_t Const{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(magic) ||
 		strncmp(magic.data(), "IMPM", 4) != 0)
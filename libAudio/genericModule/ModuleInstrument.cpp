@@ -43,7 +43,7 @@ ModuleOldInstrument::ModuleOldInstrument(const modIT_t &file, const uint32_t i)
 	uint8_t Const{};
 	std::array<char, 6> DontCare{};
 	std::array<char, 4> magic{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(magic) ||
 		strncmp(magic.data(), "IMPI", 4) != 0)
@@ -94,6 +94,11 @@ uint8_t ModuleOldInstrument::GetVolume() const noexcept { return 0; }
 uint8_t ModuleOldInstrument::GetNNA() const noexcept { return NNA; }
 uint8_t ModuleOldInstrument::GetDCT() const noexcept { return DCT_OFF; }
 uint8_t ModuleOldInstrument::GetDNA() const noexcept { return DNA_NOTECUT; }
+// Instruments from before Impulse Tracker 2.0 have no filter settings
+bool ModuleOldInstrument::HasFilterCutoff() const noexcept { return false; }
+bool ModuleOldInstrument::HasFilterResonance() const noexcept { return false; }
+uint8_t ModuleOldInstrument::GetFilterCutoff() const noexcept { return filterCutoffMax; }
+uint8_t ModuleOldInstrument::GetFilterResonance() const noexcept { return 0U; }
 
 ModuleEnvelope &ModuleOldInstrument::GetEnvelope(const envelopeType_t env) const
 {
@@ -108,7 +113,7 @@ ModuleNewInstrument::ModuleNewInstrument(const modIT_t &file, const uint32_t i)
 	uint8_t Const{};
 	std::array<char, 6> DontCare{};
 	std::array<char, 4> magic{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(magic) || magic != itInstrumentMagic)
 		throw ModuleLoaderError{E_BAD_IT};
@@ -130,7 +135,9 @@ ModuleNewInstrument::ModuleNewInstrument(const modIT_t &file, const uint32_t i)
 		!fd.read(nSamples) ||
 		!fd.read<1>(DontCare) ||
 		!fd.read(Name, 26) ||
-		!fd.read(DontCare) ||
+		!fd.read(FilterCutoff) ||
+		!fd.read(FilterResonance) ||
+		!fd.read<4>(DontCare) ||
 		!fd.read(SampleMapping))
 		throw ModuleLoaderError{E_BAD_IT};
 
@@ -156,6 +163,11 @@ uint8_t ModuleNewInstrument::GetVolume() const noexcept { return Volume & 0x7FU;
 uint8_t ModuleNewInstrument::GetNNA() const noexcept { return NNA; }
 uint8_t ModuleNewInstrument::GetDCT() const noexcept { return DCT; }
 uint8_t ModuleNewInstrument::GetDNA() const noexcept { return DNA; }
+// The top bit of the initial filter cutoff and resonance says whether the instrument sets them
+bool ModuleNewInstrument::HasFilterCutoff() const noexcept { return FilterCutoff & 0x80U; }
+bool ModuleNewInstrument::HasFilterResonance() const noexcept { return FilterResonance & 0x80U; }
+uint8_t ModuleNewInstrument::GetFilterCutoff() const noexcept { return FilterCutoff & 0x7FU; }
+uint8_t ModuleNewInstrument::GetFilterResonance() const noexcept { return FilterResonance & 0x7FU; }
 
 bool ModuleNewInstrument::GetEnvEnabled(const envelopeType_t env) const noexcept
 {
@@ -187,7 +199,7 @@ ModuleEnvelope &ModuleNewInstrument::GetEnvelope(const envelopeType_t env) const
 
 ModuleEnvelope::ModuleEnvelope(const modIT_t &file, const envelopeType_t env) : Type{env}
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	uint8_t DontCare{};
 
 	if (!fd.read(Flags) ||
@@ -200,7 +212,8 @@ ModuleEnvelope::ModuleEnvelope(const modIT_t &file, const envelopeType_t env) :
 		!fd.read(DontCare))
 		throw ModuleLoaderError{E_BAD_IT};
 
-	if (LoopBegin > nNodes || LoopEnd > nNodes)
+	if (nNodes > Nodes.size() || LoopBegin > nNodes || LoopEnd > nNodes ||
+		SusLoopBegin > nNodes || SusLoopEnd > nNodes)
 		throw ModuleLoaderError{E_BAD_IT};
 
 	if (env != envelopeType_t::volume)
@@ -209,38 +222,12 @@ ModuleEnvelope::ModuleEnvelope(const modIT_t &file, const envelopeType_t env) :
 		for (uint8_t i = 0; i < nNodes; i++)
 			Nodes[i].Value ^= 0x80U;
 	}
+
+	tabulate();
 }
 
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
 ModuleEnvelope::ModuleEnvelope(const modIT_t &, const uint8_t flags, const uint8_t loopBegin,
 	const uint8_t loopEnd, const uint8_t susLoopBegin, const uint8_t susLoopEnd) noexcept :
 	Type{envelopeType_t::volume}, Flags{flags}, nNodes{}, LoopBegin{loopBegin}, LoopEnd{loopEnd},
-	SusLoopBegin{susLoopBegin}, SusLoopEnd{susLoopEnd}, Nodes{} { }
-
-uint8_t ModuleEnvelope::Apply(const uint16_t currentTick) noexcept
-{
-	uint8_t pt = 0;
-	uint8_t ret = 0;
-	uint16_t n1 = 0;
-	for (; pt < (nNodes - 1); ++pt)
-	{
-		if (currentTick <= Nodes[pt].Tick)
-			break;
-	}
-	if (currentTick >= Nodes[pt].Tick)
-		return Nodes[pt].Value;
-	if (pt)
-	{
-		n1 = Nodes[pt - 1].Tick;
-		ret = Nodes[pt - 1].Value;
-	}
-	uint16_t n2 = Nodes[pt].Tick;
-	if (n2 > n1 && currentTick > n1)
-	{
-		int32_t val = currentTick - n1;
-		val *= int16_t(Nodes[pt].Value) - ret;
-		n2 -= n1;
-		return ret + (val / n2);
-	}
-	return ret;
-}
+	SusLoopBegin{susLoopBegin}, SusLoopEnd{susLoopEnd}, Nodes{}, Values{} { }
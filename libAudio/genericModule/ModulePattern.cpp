@@ -3,9 +3,6 @@
 #include <substrate/promotion_helpers>
 #include "genericModule.h"
 
-using substrate::make_unique;
-using substrate::make_unique_nothrow;
-
 static const uint16_t Periods[60] =
 {
 	1712, 1616, 1525, 1440, 1357, 1281, 1209, 1141, 1077, 1017, 961, 907,
@@ -15,32 +12,39 @@ static const uint16_t Periods[60] =
 	107, 101, 95, 90, 85, 80, 76, 71, 67, 64, 60, 57
 };
 
-// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
-pattern_t::pattern_t(const uint32_t _channels, const uint16_t rows, const uint32_t type) :
-	Channels{_channels}, _commands{_channels}, _rows{rows}
+patternStore_t::patternStore_t(const size_t commands, const uint32_t type) : _commands{commands}
 {
-	if (!_commands.valid())
+	if (commands && !_commands.valid())
 		throw ModuleLoaderError{type};
 }
 
-pattern_t::pattern_t(const modMOD_t &file, const uint32_t channels) : pattern_t{channels, 64, E_BAD_MOD}
+command_t *patternStore_t::allocate(const size_t commands, const uint32_t type)
 {
-	const fd_t &fd = file.fd();
+	if (commands > _commands.size() - _used)
+		throw ModuleLoaderError{type};
+	auto *const result{_commands.data() + _used};
+	_used += commands;
+	return result;
+}
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+pattern_t::pattern_t(const uint32_t _channels, const uint16_t rows, patternStore_t &store, const uint32_t type) :
+	Channels{_channels}, _commands{store.allocate(size_t{rows} * _channels, type)}, _rows{rows} { }
+
+pattern_t::pattern_t(const modMOD_t &file, const uint32_t channels, patternStore_t &store) :
+	pattern_t{channels, 64, store, E_BAD_MOD}
+{
+	const auto &fd{file.context()->reader};
+	// The pattern data is stored row-major just like our commands, so this just walks through both
 	for (size_t row = 0; row < _rows; ++row)
 	{
 		for (size_t channel = 0; channel < channels; ++channel)
 		{
 			// Read 4 bytes of data and unpack it into the structure.
 			std::array<uint8_t, 4> data{};
-			if (row == 0)
-			{
-				_commands[channel] = make_unique_nothrow<command_t []>(_rows);
-				if (!_commands[channel])
-					throw ModuleLoaderError{E_BAD_MOD};
-			}
 			if (!fd.read(data))
 				throw ModuleLoaderError{E_BAD_MOD};
-			_commands[channel][row].setMODData(data);
+			command(channel, row).setMODData(data);
 		}
 	}
 }
@@ -50,17 +54,12 @@ pattern_t::pattern_t(const modMOD_t &file, const uint32_t channels) : pattern_t{
 	if ((cnt) + 1 >= (length)) \
 		break
 
-pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels) : pattern_t{channels, 64, E_BAD_S3M}
+pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels, patternStore_t &store) :
+	pattern_t{channels, 64, store, E_BAD_S3M}
 {
 	uint32_t length{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
-	for (uint32_t i = 0; i < channels; ++i)
-	{
-		_commands[i] = make_unique_nothrow<command_t []>(_rows);
-		if (!_commands[i])
-			throw ModuleLoaderError{E_BAD_S3M};
-	}
 	if (!fd.read(&length, sizeof(uint16_t)))
 		throw ModuleLoaderError{E_BAD_S3M};
 
@@ -85,7 +84,7 @@ pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels) : pattern_t{
 				!fd.read(sample))
 				throw ModuleLoaderError{E_BAD_S3M};
 			else if (channel < channels)
-				_commands[channel][row].setS3MNote(note, sample);
+				command(channel, row).setS3MNote(note, sample);
 			j += 2;
 			checkLength(j, length);
 		}
@@ -95,7 +94,7 @@ pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels) : pattern_t{
 			if (!fd.read(volume))
 				throw ModuleLoaderError{E_BAD_S3M};
 			else if (channel < channels)
-				_commands[channel][row].setS3MVolume(volume);
+				command(channel, row).setS3MVolume(volume);
 			++j;
 			checkLength(j, length);
 		}
@@ -107,7 +106,7 @@ pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels) : pattern_t{
 				!fd.read(param))
 				throw ModuleLoaderError{E_BAD_S3M};
 			if (channel < channels)
-				_commands[channel][row].setS3MEffect(effect, param);
+				command(channel, row).setS3MEffect(effect, param);
 			j += 2;
 			checkLength(j, length);
 		}
@@ -116,57 +115,45 @@ pattern_t::pattern_t(const modS3M_t &file, const uint32_t channels) : pattern_t{
 
 #undef checkLength
 
-pattern_t::pattern_t(const modSTM_t &file) : pattern_t(4, 64, E_BAD_STM)
+pattern_t::pattern_t(const modSTM_t &file, patternStore_t &store) : pattern_t(4, 64, store, E_BAD_STM)
 {
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	for (size_t row{}; row < _rows; ++row)
 	{
 		for (size_t channel{}; channel < 4; ++channel)
 		{
-			if (row == 0)
-			{
-				_commands[channel] = make_unique_nothrow<command_t []>(_rows);
-				if (!_commands[channel])
-					throw ModuleLoaderError{E_BAD_STM};
-			}
-
 			uint8_t Note{};
 			uint8_t Param{};
 
 			if (!fd.read(Note) ||
 				!fd.read(Param))
 				throw ModuleLoaderError{E_BAD_STM};
-			_commands[channel][row].setSTMNote(Note);
+			command(channel, row).setSTMNote(Note);
 			uint8_t Volume = Param & 0x07U;
-			_commands[channel][row].setSample(Param >> 3U);
+			command(channel, row).setSample(Param >> 3U);
 			if (!fd.read(Param))
 				throw ModuleLoaderError{E_BAD_STM};
 			Volume += Param >> 1U;
-			_commands[channel][row].setVolume(Volume);
+			command(channel, row).setVolume(Volume);
 			const uint8_t Effect = Param & 0x0FU;
 			if (!fd.read(Param))
 				throw ModuleLoaderError{E_BAD_STM};
-			_commands[channel][row].setSTMEffect(Effect, Param);
+			command(channel, row).setSTMEffect(Effect, Param);
 		}
 	}
 }
 
 #ifdef ENABLE_AON
-pattern_t::pattern_t(const modAON_t &file, const uint32_t channels) : pattern_t{channels, 64, E_BAD_AON}
+pattern_t::pattern_t(const modAON_t &file, const uint32_t channels, patternStore_t &store) :
+	pattern_t{channels, 64, store, E_BAD_AON}
 {
 	using arithUInt = substrate::promoted_type_t<uint8_t>;
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 	for (size_t row{}; row < _rows; ++row)
 	{
 		for (size_t channel{}; channel < channels; ++channel)
 		{
-			if (row == 0)
-			{
-				_commands[channel] = make_unique<command_t []>(_rows);
-				if (!_commands[channel])
-					throw ModuleLoaderError{E_BAD_AON};
-			}
 			uint8_t note{};
 			uint8_t sample{};
 			uint8_t effect{};
@@ -177,16 +164,16 @@ pattern_t::pattern_t(const modAON_t &file, const uint32_t channels) : pattern_t{
 				!fd.read(param))
 				throw ModuleLoaderError{E_BAD_AON};
 			const uint8_t arpIndex = ((arithUInt{sample} >> 6U) & 0x03U) | ((arithUInt{effect} >> 4U) & 0x0CU);
-			_commands[channel][row].setAONNote(note);
-			_commands[channel][row].setSample(sample & 0x3FU);
-			_commands[channel][row].setAONArpIndex(arpIndex);
-			_commands[channel][row].setAONEffect(effect & 0x3FU, param);
+			command(channel, row).setAONNote(note);
+			command(channel, row).setSample(sample & 0x3FU);
+			command(channel, row).setAONArpIndex(arpIndex);
+			command(channel, row).setAONEffect(effect & 0x3FU, param);
 		}
 	}
 }
 #endif
 
-inline bool readInc(uint8_t &var, uint16_t &i, const uint16_t len, const fd_t &fd) noexcept
+inline bool readInc(uint8_t &var, uint16_t &i, const uint16_t len, const moduleReader_t &fd) noexcept
 {
 	if (i > len || !fd.read(var))
 		return true;
@@ -194,28 +181,32 @@ inline bool readInc(uint8_t &var, uint16_t &i, const uint16_t len, const fd_t &f
 	return false;
 }
 
-pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{channels}
+// The IT pattern header gives the number of rows in the pattern, which is needed before the rest can be read
+static uint16_t itPatternRows(const modIT_t &file)
+{
+	const auto &fd{file.context()->reader};
+	uint16_t rows{};
+	if (!fd.seekRel(2) ||
+		!fd.readLE(rows) ||
+		!fd.seekRel(-4))
+		throw ModuleLoaderError{E_BAD_IT};
+	return rows;
+}
+
+pattern_t::pattern_t(const modIT_t &file, const uint32_t channels, patternStore_t &store) :
+	pattern_t{channels, itPatternRows(file), store, E_BAD_IT}
 {
 	std::array<char, 4> dontCare{};
 	std::array<uint8_t, 64> channelMask{};
 	uint16_t len{};
 	std::array<command_t, 64> lastCmd{};
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
-	_commands = fixedVector_t<commandPtr_t>(channels);
-	if (!_commands.valid() ||
-		!fd.read(len) ||
-		!fd.read(&_rows, 2) ||
+	if (!fd.readLE(len) ||
+		!fd.seekRel(2) ||
 		!fd.read(dontCare))
 		throw ModuleLoaderError{E_BAD_IT};
 
-	for (size_t channel = 0; channel < channels; ++channel)
-	{
-		_commands[channel] = make_unique_nothrow<command_t []>(_rows);
-		if (!_commands[channel])
-			throw ModuleLoaderError{E_BAD_IT};
-	}
-
 	uint16_t row = 0;
 	uint16_t j = 0;
 	while (row < _rows)
@@ -235,7 +226,7 @@ pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{ch
 		if ((b & 0x80U) != 0 && readInc(channelMask[channel], j, len, fd))
 			break;
 		if (channel < channels)
-			_commands[channel][row].setITRepVal(channelMask[channel], lastCmd[channel]);
+			command(channel, row).setITRepVal(channelMask[channel], lastCmd[channel]);
 		if ((channelMask[channel] & 0x01U) != 0)
 		{
 			uint8_t note{};
@@ -243,7 +234,7 @@ pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{ch
 				break;
 			if (channel < channels)
 			{
-				_commands[channel][row].setITNote(note);
+				command(channel, row).setITNote(note);
 				lastCmd[channel].setITNote(note);
 			}
 		}
@@ -254,7 +245,7 @@ pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{ch
 				break;
 			if (channel < channels)
 			{
-				_commands[channel][row].setSample(sample);
+				command(channel, row).setSample(sample);
 				lastCmd[channel].setSample(sample);
 			}
 		}
@@ -265,7 +256,7 @@ pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{ch
 				break;
 			if (channel < channels)
 			{
-				_commands[channel][row].setITVolume(volume);
+				command(channel, row).setITVolume(volume);
 				lastCmd[channel].setITVolume(volume);
 			}
 		}
@@ -277,7 +268,7 @@ pattern_t::pattern_t(const modIT_t &file, const uint32_t channels) : Channels{ch
 				break;
 			if (channel < channels)
 			{
-				_commands[channel][row].setITEffect(effect, param);
+				command(channel, row).setITEffect(effect, param);
 				lastCmd[channel].setITEffect(effect, param);
 			}
 		}
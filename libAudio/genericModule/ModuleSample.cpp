@@ -13,7 +13,7 @@ ModuleSample *ModuleSample::LoadSample(const modMOD_t &file, const uint32_t i)
 
 ModuleSample *ModuleSample::LoadSample(const modS3M_t &file, const uint32_t i)
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	uint8_t type{};
 
 	if (!fd.read(type))
@@ -32,6 +32,16 @@ ModuleSample *ModuleSample::LoadSample(const modAON_t &file, const uint32_t i, c
 	{ return new ModuleSampleNative(file, i, Name, pcmLengths); }
 #endif
 
+#ifdef ENABLE_FC1x
+ModuleSample *ModuleSample::LoadSample(const modFC1x_t &file, const uint32_t i, const bool builtinWaves)
+	{ return new ModuleSampleNative(file, i, builtinWaves); }
+
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+ModuleSample *ModuleSample::LoadSample(const modFC1x_t &file, const uint32_t i, const uint32_t packData,
+	const uint32_t packLength)
+	{ return new ModuleSampleNative(file, i, packData, packLength); }
+#endif
+
 ModuleSample *ModuleSample::LoadSample(const modIT_t &file, const uint32_t i)
 	{ return new ModuleSampleNative(file, i); }
 
@@ -40,7 +50,7 @@ ModuleSampleNative::ModuleSampleNative(const modMOD_t &file, const uint32_t i) :
 	SamplePos{}, Packing{}, Flags{}, SampleFlags{}, C4Speed{8363U}, DefaultPan{}, VibratoSpeed{},
 	VibratoDepth{}, VibratoType{}, VibratoRate{}, SusLoopBegin{}, SusLoopEnd{}
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	uint16_t length16{};
 	uint16_t loopStart16{};
 	uint16_t loopEnd16{};
@@ -68,7 +78,7 @@ ModuleSampleNative::ModuleSampleNative(const modMOD_t &file, const uint32_t i) :
 		SampleFlags |= SAMPLE_FLAGS_LOOP;
 }
 
-bool readLE24b(const fd_t &fd, uint32_t &dest) noexcept
+bool readLE24b(const moduleReader_t &fd, uint32_t &dest) noexcept
 {
 	std::array<uint8_t, 3> data{};
 	if (!fd.read(data))
@@ -83,7 +93,7 @@ ModuleSampleNative::ModuleSampleNative(const modS3M_t &file, const uint32_t i, c
 	FileName{make_unique_nothrow<char []>(13)}, SampleFlags{}, DefaultPan{}, VibratoSpeed{},
 	VibratoDepth{}, VibratoType{}, VibratoRate{}, SusLoopBegin{}, SusLoopEnd{}
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	std::array<uint8_t, 12> dontCare{};
 	std::array<char, 4> magic{};
 
@@ -128,7 +138,7 @@ ModuleSampleNative::ModuleSampleNative(const modSTM_t &file, const uint32_t i) :
 	Flags{}, SampleFlags{}, DefaultPan{}, VibratoSpeed{}, VibratoDepth{}, VibratoType{}, VibratoRate{},
 	SusLoopBegin{}, SusLoopEnd{}
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	uint8_t id{};
 	uint8_t disk{};
 	uint8_t reserved2{};
@@ -178,7 +188,7 @@ ModuleSampleNative::ModuleSampleNative(const modSTM_t &file, const uint32_t i) :
 ModuleSampleNative::ModuleSampleNative(const modAON_t &file, const uint32_t i, char *name, const uint32_t *const pcmLengths) : ModuleSample(i, 1), Name(name)
 {
 	uint8_t Type, ID;
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	if (!fd.read(Type) ||
 		!fd.read(Volume) ||
@@ -292,11 +302,88 @@ ModuleSampleNative::ModuleSampleNative(const modAON_t &file, const uint32_t i, c
 }
 #endif
 
+#ifdef ENABLE_FC1x
+// The first 10 are the song's samples, the rest its waveforms, which always loop the whole way through
+ModuleSampleNative::ModuleSampleNative(const modFC1x_t &file, const uint32_t i, const bool builtinWaves) :
+	ModuleSample(i, 1), Name{}, Length{}, FineTune{}, Volume{64U}, InstrVol{64U}, LoopStart{}, LoopEnd{},
+	FileName{}, SamplePos{}, Packing{}, Flags{}, SampleFlags{}, C4Speed{8363U}, DefaultPan{}, VibratoSpeed{},
+	VibratoDepth{}, VibratoType{}, VibratoRate{}, SusLoopBegin{}, SusLoopEnd{}
+{
+	const auto &fd{file.context()->reader};
+	if (i < fc1xSamples)
+	{
+		uint16_t length16{};
+		uint16_t loopStart16{};
+		uint16_t loopLength16{};
+		if (!fd.readBE(length16) ||
+			!fd.readBE(loopStart16) ||
+			!fd.readBE(loopLength16))
+			throw ModuleLoaderError{E_BAD_FC1x};
+		// The lengths are in words, but the loop start is in bytes
+		Length = length16 * 2U;
+		LoopStart = loopStart16;
+		LoopEnd = LoopStart < Length && loopLength16 > 1U ? std::min(LoopStart + (loopLength16 * 2U), Length) : 0U;
+	}
+	else
+	{
+		if (builtinWaves)
+			Length = fc1xBuiltinWaveLength(uint8_t(i - fc1xSamples));
+		else
+		{
+			uint8_t length8{};
+			if (!fd.read(length8))
+				throw ModuleLoaderError{E_BAD_FC1x};
+			Length = length8 * 2U;
+		}
+		LoopEnd = Length;
+	}
+
+	if (LoopEnd != 0)
+		SampleFlags |= SAMPLE_FLAGS_LOOP;
+}
+
+/*!
+ * Reads the sample pack entry for one of its sub-samples, which gives where the sub-sample starts in the pack's data
+ * as well as its length and loop. Samples that aren't packs still get a sub-sample slot for each entry, left empty.
+ * @param packData Where the pack's data starts in the file, after its tag and entries
+ * @param packLength How long the pack's data is, or 0 for a sample that's not a pack
+ */
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+ModuleSampleNative::ModuleSampleNative(const modFC1x_t &file, const uint32_t i, const uint32_t packData,
+	const uint32_t packLength) : ModuleSample(i, 1), Name{}, Length{}, FineTune{}, Volume{64U}, InstrVol{64U},
+	LoopStart{}, LoopEnd{}, FileName{}, SamplePos{}, Packing{}, Flags{}, SampleFlags{}, C4Speed{8363U}, DefaultPan{},
+	VibratoSpeed{}, VibratoDepth{}, VibratoType{}, VibratoRate{}, SusLoopBegin{}, SusLoopEnd{}
+{
+	if (!packLength)
+		return;
+	const auto &fd{file.context()->reader};
+	uint32_t offset{};
+	uint16_t length16{};
+	uint16_t loopStart16{};
+	uint16_t loopLength16{};
+	if (!fd.readBE(offset) ||
+		!fd.readBE(length16) ||
+		!fd.readBE(loopStart16) ||
+		!fd.readBE(loopLength16) ||
+		!fd.seekRel(fc1xPackEntryLength - 10U))
+		throw ModuleLoaderError{E_BAD_FC1x};
+	// As with the samples themselves, the lengths are in words and the loop start in bytes
+	Length = length16 * 2U;
+	if (offset > packLength || Length > packLength - offset)
+		throw ModuleLoaderError{E_BAD_FC1x};
+	SamplePos = packData + offset;
+	LoopStart = loopStart16;
+	LoopEnd = LoopStart < Length && loopLength16 > 1U ? std::min(LoopStart + (loopLength16 * 2U), Length) : 0U;
+	if (LoopEnd != 0)
+		SampleFlags |= SAMPLE_FLAGS_LOOP;
+}
+#endif
+
 ModuleSampleNative::ModuleSampleNative(const modIT_t &file, const uint32_t i) : ModuleSample(i, 1),
 	Name{make_unique_nothrow<char []>(27)}, FineTune{}, FileName{make_unique_nothrow<char []>(13)},
 	SampleFlags{}
 {
-	const auto &fd{file.fd()};
+	const auto &fd{file.context()->reader};
 	uint8_t _const{};
 	std::array<char, 4> magic{};
 
@@ -380,7 +467,7 @@ ModuleSampleAdlib::ModuleSampleAdlib(const modS3M_t &file, const uint32_t i, con
 	std::array<char, 4> magic;
 	std::array<uint8_t, 12> dontCare;
 	uint32_t zero;
-	const fd_t &fd = file.fd();
+	const auto &fd{file.context()->reader};
 
 	Name = new char[29];
 	FileName = new char[13];
@@ -422,6 +509,16 @@ ModuleSampleAdlib::~ModuleSampleAdlib()
 	delete [] FileName;
 }
 
+// The instrument is stored as the OPL2 registers for the modulator and carrier interleaved, then register 0xC0
+opl2Patch_t ModuleSampleAdlib::patch() const noexcept
+{
+	opl2Patch_t result{};
+	result.operators[0] = {D00, D02, D04, D06, D08};
+	result.operators[1] = {D01, D03, D05, D07, D09};
+	result.feedbackConnection = D0A;
+	return result;
+}
+
 uint32_t ModuleSampleAdlib::GetLength()
 {
 	return 0;
@@ -464,7 +561,7 @@ uint8_t ModuleSampleAdlib::GetVolume()
 
 uint8_t ModuleSampleAdlib::GetSampleVolume()
 {
-	return 0;
+	return 64;
 }
 
 uint8_t ModuleSampleAdlib::GetVibratoSpeed()
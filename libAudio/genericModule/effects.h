@@ -33,6 +33,7 @@
 #define CMD_PANBRELLO			0x1B
 #define CMD_TONEPORTAVOLUP		0x1C
 #define CMD_TONEPORTAVOLDOWN	0x1D
+#define CMD_MIDI				0x1E
 
 #define VOLCMD_NONE			0x00
 #define VOLCMD_VOLUME		0x01
@@ -7,6 +7,16 @@
 #include <substrate/managed_ptr>
 #include "../libAudio.hxx"
 #include "../string.hxx"
+#include "moduleReader.hxx"
+#include "pcmCache.hxx"
+#include "renderCache.hxx"
+#include "../moduleMixer/resonantFilter.hxx"
+#include "../moduleMixer/mixEffects.hxx"
+#include "../moduleMixer/mixOutput.hxx"
+#include "../moduleMixer/opl2.hxx"
+#ifdef ENABLE_FC1x
+#include "../moduleMixer/fc1x.hxx"
+#endif
 #include <array>
 #include <exception>
 
@@ -26,12 +36,19 @@ struct ModuleFile;
 struct channel_t;
 struct ModuleSample;
 struct pattern_t;
+struct mixThreads_t;
+struct mixAccumulator_t;
 
 using stringPtr_t = std::unique_ptr<char []>;
 
 #include "effects.h"
 
+// How many sample frames get mixed at a time unless a ModuleFile is told otherwise, and the range that can be set
 constexpr static inline size_t mixBufferSize{512U};
+constexpr static inline size_t mixBlockSizeMin{16U};
+constexpr static inline size_t mixBlockSizeMax{32768U};
+// Parallel mixing only kicks in once there are at least this many active voices per mixer thread
+constexpr static inline size_t minimumChannelsPerWorker{4U};
 
 constexpr static inline uint8_t MODULE_MOD{1U};
 constexpr static inline uint8_t MODULE_S3M{2U};
@@ -128,6 +145,7 @@ private:
 	uint32_t VolumeOffs{};
 	uint32_t VolumeLength{};
 	uint32_t SampleOffs{};
+	// FC1.3 gives the length of the sample data here, where FC1.4 gives the offset to its waveforms
 	uint32_t SampleLength{};
 #endif
 
@@ -157,6 +175,13 @@ public:
 	~ModuleHeader() noexcept = default;
 };
 
+// The loop unrolled in to the guard frames after a sample's PCM - see ModuleSample::guardLoop()
+struct sampleGuardLoop_t
+{
+	uint32_t start;
+	bool pingPong;
+};
+
 struct ModuleSample
 {
 protected:
@@ -176,12 +201,18 @@ public:
 #ifdef ENABLE_AON
 	static ModuleSample *LoadSample(const modAON_t &file, uint32_t i,
 		char *Name, const uint32_t *const pcmLengths);
+#endif
+#ifdef ENABLE_FC1x
+	static ModuleSample *LoadSample(const modFC1x_t &file, uint32_t i, bool builtinWaves);
+	static ModuleSample *LoadSample(const modFC1x_t &file, uint32_t i, uint32_t packData, uint32_t packLength);
 #endif
 	static ModuleSample *LoadSample(const modIT_t &file, uint32_t i);
 
 	virtual ~ModuleSample() noexcept = default;
 	[[nodiscard]] uint8_t GetType() const noexcept { return _type; }
 	[[nodiscard]] uint32_t id() const noexcept { return _id; }
+	// S3M's AdLib instruments are types 2 and up, and are synthesised rather than played from PCM
+	[[nodiscard]] bool isAdlib() const noexcept { return _type > 1U; }
 	[[nodiscard]] virtual uint32_t GetLength() = 0;
 	[[nodiscard]] virtual uint32_t GetLoopStart() = 0;
 	[[nodiscard]] virtual uint32_t GetLoopEnd() = 0;
@@ -202,6 +233,26 @@ public:
 	[[nodiscard]] virtual bool GetSustainLooped() = 0;
 	[[nodiscard]] virtual bool GetBidiLoop() = 0;
 	[[nodiscard]] virtual bool GetPanned() = 0;
+
+	/*!
+	 * Works out which loop the guard frames after the sample's PCM get unrolled from - the loop a note starts out
+	 * playing, so long as that runs right up to the end of the sample. A loop that finishes any sooner has the rest
+	 * of the sample after it, not the guard frames.
+	 * @return Where the loop starts and whether it plays ping-pong, with the start at the sample's length if there's
+	 *   no such loop and the guard frames just repeat the last frame
+	 */
+	[[nodiscard]] sampleGuardLoop_t guardLoop()
+	{
+		const auto length{GetLength()};
+		if (GetSustainLooped())
+		{
+			if (GetSustainLoopEnd() >= length && GetSustainLoopBegin() < length)
+				return {GetSustainLoopBegin(), GetBidiLoop()};
+		}
+		else if (GetLooped() && GetLoopEnd() >= length && GetLoopStart() < length)
+			return {GetLoopStart(), false};
+		return {length, false};
+	}
 };
 
 struct ModuleSampleNative final : public ModuleSample
@@ -237,6 +288,10 @@ public:
 	ModuleSampleNative(const modSTM_t &file, uint32_t i);
 #ifdef ENABLE_AON
 	ModuleSampleNative(const modAON_t &file, uint32_t i, char *Name, const uint32_t *pcmLengths);
+#endif
+#ifdef ENABLE_FC1x
+	ModuleSampleNative(const modFC1x_t &file, uint32_t i, bool builtinWaves);
+	ModuleSampleNative(const modFC1x_t &file, uint32_t i, uint32_t packData, uint32_t packLength);
 #endif
 	ModuleSampleNative(const modIT_t &file, uint32_t i);
 	~ModuleSampleNative() noexcept = default;
@@ -287,6 +342,7 @@ private:
 public:
 	ModuleSampleAdlib(const modS3M_t &file, uint32_t i, uint8_t Type);
 	~ModuleSampleAdlib();
+	[[nodiscard]] opl2Patch_t patch() const noexcept;
 
 	[[nodiscard]] uint32_t GetLength() final;
 	[[nodiscard]] uint32_t GetLoopStart() final;
@@ -329,12 +385,22 @@ private:
 	uint8_t SusLoopBegin;
 	uint8_t SusLoopEnd;
 	std::array<envelopeNode_t, 25> Nodes;
+	// The envelope's value at every tick up to its furthest node, so applying it is a lookup. Envelopes running
+	// implausibly far don't get one, so a broken file can't have this take 64KiB per envelope.
+	fixedVector_t<uint8_t> Values;
+
+	[[nodiscard]] uint8_t interpolate(uint16_t currentTick) const noexcept;
+	void tabulate() noexcept;
 
 public:
 	ModuleEnvelope(const modIT_t &file, envelopeType_t env);
 	ModuleEnvelope(const modIT_t &file, uint8_t Flags, uint8_t LoopBegin, uint8_t LoopEnd,
 		uint8_t SusLoopBegin, uint8_t SusLoopEnd) noexcept;
-	[[nodiscard]] uint8_t Apply(uint16_t Tick) noexcept;
+	ModuleEnvelope(envelopeType_t env, uint8_t flags, const std::array<envelopeNode_t, 25> &nodes,
+		uint8_t nodeCount) noexcept;
+	// Past the furthest node the envelope holds at the last node's value, which interpolate() also gives
+	[[nodiscard]] uint8_t Apply(const uint16_t currentTick) const noexcept
+		{ return currentTick < Values.size() ? Values[currentTick] : interpolate(currentTick); }
 	[[nodiscard]] bool GetEnabled() const noexcept { return Flags & 0x01U; }
 	[[nodiscard]] bool GetLooped() const noexcept { return Flags & 0x02U; }
 	[[nodiscard]] bool GetSustained() const noexcept { return Flags & 0x04U; }
@@ -346,7 +412,7 @@ public:
 	[[nodiscard]] uint16_t GetLoopBegin() const noexcept { return Nodes[LoopBegin].Tick; }
 	[[nodiscard]] uint16_t GetLoopEnd() const noexcept { return Nodes[LoopEnd].Tick; }
 	[[nodiscard]] uint16_t GetSustainBegin() const noexcept { return Nodes[SusLoopBegin].Tick; }
-	[[nodiscard]] uint16_t GetSustainEnd() const noexcept { return Nodes[SusLoopBegin].Tick; }
+	[[nodiscard]] uint16_t GetSustainEnd() const noexcept { return Nodes[SusLoopEnd].Tick; }
 	[[nodiscard]] uint16_t GetLastTick() const noexcept { return Nodes[nNodes - 1].Tick; }
 };
 
@@ -384,6 +450,10 @@ public:
 	[[nodiscard]] virtual uint8_t GetNNA() const noexcept = 0;
 	[[nodiscard]] virtual uint8_t GetDCT() const noexcept = 0;
 	[[nodiscard]] virtual uint8_t GetDNA() const noexcept = 0;
+	[[nodiscard]] virtual bool HasFilterCutoff() const noexcept = 0;
+	[[nodiscard]] virtual bool HasFilterResonance() const noexcept = 0;
+	[[nodiscard]] virtual uint8_t GetFilterCutoff() const noexcept = 0;
+	[[nodiscard]] virtual uint8_t GetFilterResonance() const noexcept = 0;
 };
 
 struct ModuleOldInstrument final : public ModuleInstrument
@@ -419,6 +489,10 @@ public:
 	[[nodiscard]] uint8_t GetNNA() const noexcept final;
 	[[nodiscard]] uint8_t GetDCT() const noexcept final;
 	[[nodiscard]] uint8_t GetDNA() const noexcept final;
+	[[nodiscard]] bool HasFilterCutoff() const noexcept final;
+	[[nodiscard]] bool HasFilterResonance() const noexcept final;
+	[[nodiscard]] uint8_t GetFilterCutoff() const noexcept final;
+	[[nodiscard]] uint8_t GetFilterResonance() const noexcept final;
 };
 
 struct ModuleNewInstrument final : public ModuleInstrument
@@ -438,6 +512,8 @@ private:
 	uint16_t TrackerVersion{};
 	uint8_t nSamples{};
 	std::unique_ptr<char []> Name;
+	uint8_t FilterCutoff{};
+	uint8_t FilterResonance{};
 	std::array<std::unique_ptr<ModuleEnvelope>, static_cast<size_t>(envelopeType_t::count)> Envelopes{};
 
 public:
@@ -460,18 +536,24 @@ public:
 	[[nodiscard]] uint8_t GetNNA() const noexcept final;
 	[[nodiscard]] uint8_t GetDCT() const noexcept final;
 	[[nodiscard]] uint8_t GetDNA() const noexcept final;
+	[[nodiscard]] bool HasFilterCutoff() const noexcept final;
+	[[nodiscard]] bool HasFilterResonance() const noexcept final;
+	[[nodiscard]] uint8_t GetFilterCutoff() const noexcept final;
+	[[nodiscard]] uint8_t GetFilterResonance() const noexcept final;
 };
 
+// Commands get walked a whole row at a time during playback, so keep them small.
+// The volume column effects and AON arpeggio indexes both fit in a nibble, so they share a byte.
 struct command_t final
 {
 private:
 	uint8_t Sample{};
 	uint8_t Note{};
-	uint8_t VolEffect{};
+	uint8_t VolEffect : 4;
+	uint8_t ArpIndex : 4;
 	uint8_t VolParam{};
 	uint8_t Effect{};
 	uint8_t Param{};
-	uint8_t ArpIndex{};
 
 	inline uint8_t modPeriodToNoteIndex(uint16_t period) noexcept;
 	void translateMODEffect(uint8_t effect, uint8_t param) noexcept;
@@ -479,6 +561,8 @@ private:
 	friend struct channel_t;
 
 public:
+	constexpr command_t() noexcept : VolEffect{VOLCMD_NONE}, ArpIndex{0U} { }
+
 	void setSample(const uint8_t _sample) noexcept { Sample = _sample; }
 	void setVolume(uint8_t volume) noexcept;
 	void setMODData(const std::array<uint8_t, 4> &data) noexcept;
@@ -488,7 +572,7 @@ public:
 	void setSTMNote(uint8_t note);
 	void setSTMEffect(uint8_t effect, uint8_t param);
 	void setAONNote(const uint8_t note) noexcept { Note = note; }
-	void setAONArpIndex(const uint8_t index) noexcept { ArpIndex = index; }
+	void setAONArpIndex(const uint8_t index) noexcept { ArpIndex = index & 0x0FU; }
 	void setAONEffect(uint8_t effect, uint8_t param);
 	void setITRepVal(uint8_t channelMask, const command_t &lastCommand) noexcept;
 	void setITNote(uint8_t note) noexcept;
@@ -496,28 +580,46 @@ public:
 	void setITEffect(uint8_t effect, uint8_t param);
 };
 
-struct pattern_t final
+static_assert(sizeof(command_t) == 6U, "command_t is expected to pack down to 6 bytes");
+
+// Holds the commands for all of a module's patterns in one contiguous block, handing out
+// a row-major (row x channel) slice of it to each pattern as it gets loaded
+struct patternStore_t final
 {
+private:
+	fixedVector_t<command_t> _commands{};
+	size_t _used{};
+
 public:
-	using commandPtr_t = std::unique_ptr<command_t []>;
+	patternStore_t() noexcept = default;
+	patternStore_t(size_t commands, uint32_t type);
 
+	[[nodiscard]] command_t *allocate(size_t commands, uint32_t type);
+};
+
+struct pattern_t final
+{
 private:
 	const uint32_t Channels;
-	fixedVector_t<commandPtr_t> _commands;
+	command_t *_commands;
 	uint16_t _rows;
 
-	pattern_t(uint32_t _channels, uint16_t rows, uint32_t type);
+	pattern_t(uint32_t _channels, uint16_t rows, patternStore_t &store, uint32_t type);
+	[[nodiscard]] command_t &command(const size_t channel, const size_t row) noexcept
+		{ return _commands[(row * Channels) + channel]; }
 
 public:
-	pattern_t(const modMOD_t &file, uint32_t channels);
-	pattern_t(const modS3M_t &file, uint32_t channels);
-	pattern_t(const modSTM_t &file);
+	pattern_t(const modMOD_t &file, uint32_t channels, patternStore_t &store);
+	pattern_t(const modS3M_t &file, uint32_t channels, patternStore_t &store);
+	pattern_t(const modSTM_t &file, patternStore_t &store);
 #ifdef ENABLE_AON
-	pattern_t(const modAON_t &file, uint32_t channels);
+	pattern_t(const modAON_t &file, uint32_t channels, patternStore_t &store);
 #endif
-	pattern_t(const modIT_t &file, uint32_t channels);
+	pattern_t(const modIT_t &file, uint32_t channels, patternStore_t &store);
 
-	[[nodiscard]] const fixedVector_t<commandPtr_t> &commands() const { return _commands; }
+	// Returns the commands for all the pattern's channels on the given row, in channel order
+	[[nodiscard]] const command_t *row(const uint16_t row) const noexcept
+		{ return _commands + (size_t{row} * Channels); }
 	[[nodiscard]] uint16_t rows() const noexcept { return _rows; }
 };
 
@@ -536,8 +638,8 @@ union int16dot16
 struct channel_t final
 {
 public:
-	uint8_t *SampleData;
-	uint8_t *NewSampleData;
+	const uint8_t *SampleData;
+	const uint8_t *NewSampleData;
 	uint8_t Note, RampLength;
 	uint8_t NewNote, NewSample;
 	uint32_t LoopStart, LoopEnd, Length;
@@ -568,8 +670,12 @@ public:
 	short LeftRamp, RightRamp;
 	uint8_t patternLoopCount;
 	uint16_t patternLoopStart;
-	int Filter_Y1, Filter_Y2, Filter_Y3, Filter_Y4;
-	int Filter_A0, Filter_B0, Filter_B1, Filter_HP;
+	// The resonant filter as set by the instrument and Zxx, and the coefficients and history it's being run with
+	uint8_t FilterCutoff, FilterResonance;
+	int16_t FilterModifier;
+	filterSettings_t FilterSettings;
+	filterCoefficients_t FilterCoefficients;
+	std::array<filterState_t, 2> FilterState;
 	uint8_t tremoloDepth;
 	uint8_t tremoloSpeed;
 	uint8_t tremoloPos;
@@ -584,10 +690,20 @@ public:
 	uint8_t panbrelloType;
 	uint16_t EnvVolumePos, EnvPanningPos, EnvPitchPos, FadeOutVol;
 	int DCOffsL, DCOffsR;
+	// The pattern channel this voice was started on, which NNA voices keep so they mix into their parent's stem
+	uint8_t ParentChannel;
+	// Set when the voice limits have taken the voice, which then fades out over the tick before being cut
+	bool stolen;
+	// The OPL2 voice that plays the channel's AdLib instruments in place of sample data
+	opl2Voice_t Adlib;
+#ifdef ENABLE_FC1x
+	// The macros and pitch effects of a Future Composer voice, which pick what the channel plays each tick
+	fc1xVoice_t FC;
+#endif
 
 public:
 	channel_t() noexcept;
-	void SetData(command_t *Command, ModuleHeader *p_Header);
+	void SetData(const command_t &command, ModuleHeader *p_Header);
 
 	// Channel effects
 	void noteChange(ModuleFile &module, uint8_t note, bool handlePorta = false);
@@ -615,12 +731,52 @@ public:
 	[[nodiscard]] uint16_t applyVolumeEnvelope(const ModuleFile &module, uint16_t volume) noexcept;
 	void applyPanningEnvelope() noexcept;
 	[[nodiscard]] uint32_t applyPitchEnvelope(uint32_t period) noexcept;
+	void applyFilter(uint32_t sampleRate) noexcept;
+	[[nodiscard]] bool filtered() const noexcept { return FilterSettings.active(); }
 	[[nodiscard]] int16_t applyVibrato(const ModuleFile &module, uint32_t period) noexcept;
 	[[nodiscard]] int16_t applyAutoVibrato(const ModuleFile &module, uint32_t period, int8_t &fractionalPeriod) noexcept;
 	void applyPanbrello() noexcept;
 
 	// Channel mixing processing
 	uint32_t GetSampleCount(uint32_t Samples);
+	void fadeOut() noexcept;
+	// AdLib voices stay in the mix for the whole of a tick they start playing, even if they finish part way through
+	[[nodiscard]] bool synthesised() const noexcept { return Sample && Sample->isAdlib(); }
+	[[nodiscard]] bool mixable() const noexcept { return SampleData || synthesised(); }
+};
+
+inline channel_t::channel_t() noexcept : SampleData{nullptr}, NewSampleData{nullptr}, Note{}, RampLength{},
+	NewNote{}, NewSample{}, LoopStart{}, LoopEnd{}, Length{}, RawVolume{}, volume{},
+	_sampleVolumeSlide{}, _fineSampleVolumeSlide{}, channelVolume{64}, sampleVolume{},
+	autoVibratoDepth{}, autoVibratoPos{}, Sample{nullptr}, Instrument{nullptr}, FineTune{},
+	_panningSlide{}, RawPanning{}, panning{}, RowNote{}, RowSample{}, RowVolEffect{}, Flags{},
+	Period{}, C4Speed{}, Pos{}, PosLo{}, startTick{}, increment{}, portamentoTarget{},
+	portamento{}, portamentoSlide{}, Arpeggio{}, extendedCommand{}, tremor{}, tremorCount{},
+	leftVol{}, rightVol{}, NewLeftVol{}, NewRightVol{}, LeftRamp{}, RightRamp{}, patternLoopCount{},
+	patternLoopStart{}, FilterCutoff{filterCutoffMax}, FilterResonance{},
+	FilterModifier{filterModifierNone}, FilterSettings{}, FilterCoefficients{}, FilterState{}, tremoloDepth{}, tremoloSpeed{}, tremoloPos{}, tremoloType{},
+	vibratoDepth{}, vibratoSpeed{}, vibratoPosition{}, vibratoType{}, panbrelloDepth{}, panbrelloSpeed{},
+	panbrelloPosition{}, panbrelloType{}, EnvVolumePos{}, EnvPanningPos{}, EnvPitchPos{}, FadeOutVol{},
+	DCOffsL{}, DCOffsR{}, ParentChannel{}, stolen{}, Adlib{} { }
+
+// Playback state going into an order, recorded while scanning the song so seeks only have to play forward from the
+// nearest one instead of from the start of the song
+struct moduleSnapshot_t final
+{
+	// Where in the song this is, in samples at the rate the song was scanned at
+	uint64_t time{};
+	uint16_t order{};
+	uint16_t row{};
+
+	uint32_t TickCount{}, SamplesToMix{};
+	uint32_t MusicSpeed{}, MusicTempo{};
+	uint16_t Row{}, NextRow{}, Rows{};
+	uint16_t Pattern{}, NewPattern{}, NextPattern{};
+	uint16_t globalVolume{};
+	uint8_t globalVolumeSlide{};
+	uint8_t PatternDelay{}, FrameDelay{};
+	// Only the pattern channels are kept, so voices left playing by NNAs do not carry across a seek
+	fixedVector_t<channel_t> channels{};
 };
 
 struct ModuleFile final
@@ -630,10 +786,13 @@ private:
 	ModuleHeader *p_Header;
 	ModuleSample **p_Samples;
 	pattern_t **p_Patterns;
+	patternStore_t PatternStore;
 	ModuleInstrument **p_Instruments;
-	uint8_t **p_PCM;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+	std::unique_ptr<pcmPtr_t []> p_PCM;
 	std::unique_ptr<uint32_t []> lengthPCM;
 	uint32_t nPCM;
+	pcmFileID_t FileID;
 
 	// Mixer info
 	uint32_t MixSampleRate, MixBitsPerSample;
@@ -648,8 +807,28 @@ private:
 	uint16_t globalVolume;
 	uint8_t globalVolumeSlide;
 	uint8_t PatternDelay, FrameDelay;
-	int32_t MixBuffer[mixBufferSize * 2];
+	fixedVector_t<int32_t> MixBuffer;
+	uint32_t MixBlockSize;
 	int DCOffsR, DCOffsL;
+	moduleInterpolation_t Interpolation;
+	moduleOutput_t OutputFormat;
+	bool Dither;
+	uint32_t DitherIndex;
+	mixEffects_t Effects;
+	noiseShaper_t NoiseShaper;
+	std::unique_ptr<mixThreads_t> MixThreads;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+	std::unique_ptr<mixAccumulator_t []> Stems;
+	fixedVector_t<moduleSnapshot_t> Snapshots;
+	size_t nSnapshots;
+	uint64_t SongSamples;
+	uint32_t SnapshotRate;
+	uint32_t MaxVoices;
+	uint8_t AudibilityThreshold;
+	uint64_t StolenVoices, CulledVoices;
+#ifdef ENABLE_FC1x
+	fc1xSong_t FCSong;
+#endif
 
 	constexpr ModuleFile(uint8_t moduleType) noexcept;
 
@@ -671,23 +850,51 @@ private:
 	[[nodiscard]] bool handleNavigationEffects(int32_t patternLoopRow, int16_t breakRow, int16_t positionJump) noexcept;
 	[[nodiscard]] uint32_t GetPeriodFromNote(uint8_t Note, uint8_t fineTune, uint32_t C4Speed);
 	[[nodiscard]] uint32_t GetFreqFromPeriod(uint32_t Period, uint32_t C4Speed, int8_t PeriodFrac);
+#ifdef ENABLE_FC1x
+	[[nodiscard]] bool fc1xTick();
+	void fc1xWaveChange(channel_t &channel);
+#endif
 
 	// Mixing functions
 	inline void FixDCOffset(int *p_DCOffsL, int *p_DCOffsR, int *buff, uint32_t samples);
-	void DCFixingFill(uint32_t samples);
+	void DCFixingFill(int32_t *buffer, uint32_t samples, int &dcOffsL, int &dcOffsR);
+	[[nodiscard]] uint32_t GetResamplingFlag() const noexcept;
+	void limitVoices() noexcept;
+	void stealVoice(uint32_t index) noexcept;
+	void MixChannel(channel_t &channel, int32_t *buff, uint32_t samples, uint32_t flags, int &dcOffsL, int &dcOffsR);
+	void skipVoices(uint32_t samples) noexcept;
 	void CreateStereoMix(uint32_t count);
-	inline void MonoFromStereo(uint32_t count);
+	void CreateStemMix(uint32_t count);
+	inline void MonoFromStereo(int32_t *buffer, uint32_t count);
+	[[nodiscard]] uint32_t ConvertOutput(uint8_t *buffer, const int32_t *mix, uint32_t sampleCount,
+		uint32_t ditherIndex, noiseShaper_t *shaper) const noexcept;
+	[[nodiscard]] bool noiseShaped() const noexcept
+		{ return OutputFormat == moduleOutput_t::int16 && Effects.effects().noiseShaping; }
+	template<typename mix_t> [[nodiscard]] uint32_t mixBlocks(uint32_t frames, mix_t &&mixBlock);
+	[[nodiscard]] uint32_t MixFrames(uint8_t *Buffer, uint32_t frames);
 
 private:
-	void modLoadPCM(const fd_t &fd);
-	void s3mLoadPCM(const fd_t &fd);
-	void stmLoadPCM(const fd_t &fd);
-	void aonLoadPCM(const fd_t &fd);
-	void itLoadPCM(const fd_t &fd);
+	void modLoadPCM(const moduleReader_t &fd);
+	void s3mLoadPCM(const moduleReader_t &fd);
+	void stmLoadPCM(const moduleReader_t &fd);
+	void aonLoadPCM(const moduleReader_t &fd);
+#ifdef ENABLE_FC1x
+	void fc1xLoadPacks(const modFC1x_t &file);
+	void fc1xLoadPCM(const moduleReader_t &fd);
+#endif
+	void itLoadPCM(const moduleReader_t &fd);
+	void resetPlayback();
+	[[nodiscard]] moduleSnapshot_t snapshot(uint64_t time, size_t channels) const noexcept;
+	void restore(const moduleSnapshot_t &snapshot) noexcept;
+	void resetEffects() noexcept;
 	void DeinitMixer();
 	friend struct channel_t;
 
-	template<typename T> void itLoadPCMSample(const fd_t &fd, uint32_t i);
+	template<typename T> void itLoadPCMSample(const moduleReader_t &fd, const pcmFileID_t &file, uint32_t i);
+	void itLoadPCMSample(const moduleReader_t &fd, const pcmFileID_t &file, uint32_t i);
+	[[nodiscard]] bool cachedPCM(const pcmFileID_t &file, uint32_t i, size_t frames, bool stereo);
+	template<typename T> [[nodiscard]] bool sharePCM(const pcmFileID_t &file, uint32_t i, const T *pcm, size_t frames,
+		bool stereo);
 
 public:
 	ModuleFile(const modMOD_t &file);
@@ -711,9 +918,36 @@ public:
 	[[nodiscard]] stringPtr_t remark() const noexcept;
 	[[nodiscard]] uint8_t channels() const noexcept;
 	void InitMixer(fileInfo_t &info);
+	[[nodiscard]] uint64_t songLength(uint32_t sampleRate);
+	[[nodiscard]] bool seek(uint64_t milliseconds) noexcept;
+	[[nodiscard]] bool seek(uint16_t order, uint16_t row) noexcept;
+	[[nodiscard]] bool seekSamples(uint64_t samples) noexcept;
 	[[nodiscard]] int32_t Mix(uint8_t *Buffer, uint32_t BuffLen);
+	[[nodiscard]] int32_t MixTick(uint8_t *Buffer, uint32_t BuffLen);
+	[[nodiscard]] int32_t MixStems(uint8_t *const *buffers, uint32_t BuffLen);
+	[[nodiscard]] uint8_t stems() const noexcept { return p_Header->nChannels; }
+	void interpolation(const moduleInterpolation_t mode) noexcept { Interpolation = mode; }
+	[[nodiscard]] moduleInterpolation_t interpolation() const noexcept { return Interpolation; }
+	void outputFormat(moduleOutput_t format, bool dither) noexcept;
+	[[nodiscard]] moduleOutput_t outputFormat() const noexcept { return OutputFormat; }
+	[[nodiscard]] bool mixThreads(uint32_t threads) noexcept;
+	[[nodiscard]] bool mixBlockSize(uint32_t frames) noexcept;
+	[[nodiscard]] uint32_t mixBlockSize() const noexcept { return MixBlockSize; }
+	[[nodiscard]] bool effects(const moduleEffects_t &settings) noexcept;
+	[[nodiscard]] const moduleEffects_t &effects() const noexcept { return Effects.effects(); }
+	void voiceLimit(const uint32_t voices) noexcept { MaxVoices = voices; }
+	void audibilityThreshold(const uint8_t volume) noexcept { AudibilityThreshold = volume; }
+	[[nodiscard]] uint64_t stolenVoices() const noexcept { return StolenVoices; }
+	[[nodiscard]] uint64_t culledVoices() const noexcept { return CulledVoices; }
+	[[nodiscard]] renderKey_t renderKey() const noexcept
+	{
+		return {FileID, MixSampleRate, MixChannels, OutputFormat, Dither, Interpolation, MaxVoices,
+			AudibilityThreshold, Effects.effects()};
+	}
 
 	[[nodiscard]] uint32_t ticks() const noexcept { return TickCount; }
+	// How many sample frames of the current tick are still to be mixed
+	[[nodiscard]] uint32_t tickRemaining() const noexcept { return SamplesToMix; }
 	[[nodiscard]] uint32_t speed() const noexcept { return MusicSpeed; }
 	[[nodiscard]] uint32_t tempo() const noexcept { return MusicTempo; }
 	[[nodiscard]] uint32_t minimumPeriod() const noexcept { return MinPeriod; }
@@ -736,6 +970,21 @@ struct moduleFile_t::decoderContext_t
 {
 	uint8_t playbackBuffer[8192];
 	std::unique_ptr<ModuleFile> mod;
+	// Only holds the file contents while the ModuleFile is being constructed
+	moduleReader_t reader;
+	// Whether this play through has decided whether to use the render cache, which it does on the first fill
+	bool renderStarted{false};
+	renderKey_t renderKey{};
+	std::unique_ptr<renderCapture_t> renderCapture{};
+	std::unique_ptr<renderReader_t> renderReader{};
+
+	[[nodiscard]] int64_t fillBuffer(uint8_t *buffer, uint32_t length, bool tickAligned = false) noexcept;
+	void renderSettingsChanged() noexcept;
+	void renderSeeked() noexcept;
+	void stopRender() noexcept;
+
+private:
+	void startRender() noexcept;
 };
 
 #endif /*GENERIC_MODULE_H*/
@@ -0,0 +1,177 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#ifndef GENERIC_MODULE_READER_HXX
+#define GENERIC_MODULE_READER_HXX
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <array>
+#include <type_traits>
+#include <substrate/fd>
+#include <substrate/fixed_vector>
+#include <substrate/managed_ptr>
+
+using substrate::fd_t;
+using substrate::fixedVector_t;
+using substrate::managedPtr_t;
+
+/*!
+ * @internal
+ * In-memory view of a module file used by the loaders. The file is read in one go by load() and then
+ * parsed through the same interface as fd_t, but with every read bounds-checked against the buffer
+ * instead of costing a system call. Like fd_t, the cursor may be moved past the end of the data and
+ * only the following read fails, at which point isEOF() becomes true.
+ */
+struct moduleReader_t final
+{
+private:
+	fixedVector_t<uint8_t> _data{};
+	mutable size_t _offset{};
+	mutable bool _eof{false};
+
+public:
+	moduleReader_t() noexcept = default;
+
+	[[nodiscard]] bool load(const fd_t &file) noexcept
+	{
+		const auto fileLength{file.length()};
+		_offset = 0U;
+		_eof = false;
+		if (fileLength <= 0 || file.seek(0, SEEK_SET) != 0)
+			return false;
+		_data = fixedVector_t<uint8_t>{static_cast<size_t>(fileLength)};
+		return _data.valid() && file.read(_data.data(), _data.size());
+	}
+
+	void release() noexcept
+	{
+		_data = {};
+		_offset = 0U;
+		_eof = false;
+	}
+
+	[[nodiscard]] bool valid() const noexcept { return _data.valid(); }
+	[[nodiscard]] const uint8_t *data() const noexcept { return _data.data(); }
+	[[nodiscard]] size_t length() const noexcept { return _data.size(); }
+	[[nodiscard]] size_t tell() const noexcept { return _offset; }
+	[[nodiscard]] bool isEOF() const noexcept { return _eof; }
+
+	off_t seek(const off_t offset, const int32_t whence) const noexcept
+	{
+		off_t newOffset{offset};
+		if (whence == SEEK_CUR)
+			newOffset += static_cast<off_t>(_offset);
+		else if (whence == SEEK_END)
+			newOffset += static_cast<off_t>(_data.size());
+		else if (whence != SEEK_SET)
+			return -1;
+		if (newOffset < 0)
+			return -1;
+		_offset = static_cast<size_t>(newOffset);
+		return newOffset;
+	}
+
+	[[nodiscard]] bool seekRel(const off_t offset) const noexcept
+	{
+		const auto currentOffset{static_cast<off_t>(_offset)};
+		return seek(offset, SEEK_CUR) == currentOffset + offset;
+	}
+
+	[[nodiscard]] bool read(void *const value, const size_t valueLen) const noexcept
+	{
+		if (_offset > _data.size() || valueLen > _data.size() - _offset)
+		{
+			_eof = true;
+			return false;
+		}
+		std::memcpy(value, _data.data() + _offset, valueLen);
+		_offset += valueLen;
+		return true;
+	}
+
+	// Reads from the given offset without touching the cursor, so several threads may do this at once
+	[[nodiscard]] bool readAt(const size_t offset, void *const value, const size_t valueLen) const noexcept
+	{
+		if (offset > _data.size() || valueLen > _data.size() - offset)
+			return false;
+		std::memcpy(value, _data.data() + offset, valueLen);
+		return true;
+	}
+
+	template<typename T> bool read(T &value) const noexcept
+		{ return read(&value, sizeof(T)); }
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+	template<typename T> bool read(const std::unique_ptr<T []> &value, const size_t valueCount) const noexcept
+		{ return read(value.get(), sizeof(T) * valueCount); }
+	template<typename T> bool read(managedPtr_t<T> &value, const size_t valueLen) const noexcept
+		{ return read(value.template get<void>(), valueLen); }
+	template<typename T, size_t N> bool read(std::array<T, N> &value) const noexcept
+		{ return read(value.data(), sizeof(T) * N); }
+
+	template<size_t length, typename T, size_t N> bool read(std::array<T, N> &value) const noexcept
+	{
+		static_assert(length <= N, "Can't request to read more than the std::array<> length");
+		return read(value.data(), sizeof(T) * length);
+	}
+
+	[[nodiscard]] bool readLE(uint16_t &value) const noexcept
+	{
+		std::array<uint8_t, 2> data{};
+		const bool result = read(data);
+		value = uint16_t((uint16_t(data[1]) << 8U) | data[0]);
+		return result;
+	}
+
+	[[nodiscard]] bool readLE(uint32_t &value) const noexcept
+	{
+		std::array<uint8_t, 4> data{};
+		const bool result = read(data);
+		value = (uint32_t(data[3]) << 24U) | (uint32_t(data[2]) << 16U) |
+			(uint32_t(data[1]) << 8U) | data[0];
+		return result;
+	}
+
+	template<typename T, typename = typename std::enable_if<
+		std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+		std::is_signed<T>::value && sizeof(T) >= 2>::type
+	>
+	bool readLE(T &value) const noexcept
+	{
+		typename std::make_unsigned<T>::type data{};
+		const auto result = readLE(data);
+		value = static_cast<T>(data);
+		return result;
+	}
+
+	[[nodiscard]] bool readBE(uint16_t &value) const noexcept
+	{
+		std::array<uint8_t, 2> data{};
+		const bool result = read(data);
+		value = uint16_t((uint16_t(data[0]) << 8U) | data[1]);
+		return result;
+	}
+
+	[[nodiscard]] bool readBE(uint32_t &value) const noexcept
+	{
+		std::array<uint8_t, 4> data{};
+		const bool result = read(data);
+		value = (uint32_t(data[0]) << 24U) | (uint32_t(data[1]) << 16U) |
+			(uint32_t(data[2]) << 8U) | data[3];
+		return result;
+	}
+
+	template<typename T, typename = typename std::enable_if<
+		std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+		std::is_signed<T>::value && sizeof(T) >= 2>::type
+	>
+	bool readBE(T &value) const noexcept
+	{
+		typename std::make_unsigned<T>::type data{};
+		const auto result = readBE(data);
+		value = static_cast<T>(data);
+		return result;
+	}
+};
+
+#endif /*GENERIC_MODULE_READER_HXX*/
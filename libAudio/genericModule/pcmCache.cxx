@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <array>
+#include <new>
+#include "pcmCache.hxx"
+
+// xxHash64's primes
+constexpr static uint64_t prime1{UINT64_C(0x9E3779B185EBCA87)};
+constexpr static uint64_t prime2{UINT64_C(0xC2B2AE3D27D4EB4F)};
+constexpr static uint64_t prime3{UINT64_C(0x165667B19E3779F9)};
+constexpr static uint64_t prime4{UINT64_C(0x85EBCA77C2B2AE63)};
+constexpr static uint64_t prime5{UINT64_C(0x27D4EB2F165667C5)};
+
+constexpr static uint64_t rotateLeft(const uint64_t value, const uint32_t bits) noexcept
+	{ return (value << bits) | (value >> (64U - bits)); }
+
+// Reads a little endian value out of the file, which compilers turn into a plain load where they can
+template<typename T> static T readWord(const uint8_t *const data) noexcept
+{
+	T value{};
+	for (size_t i{sizeof(T)}; i--;)
+		value = static_cast<T>((value << 8U) | data[i]);
+	return value;
+}
+
+constexpr static uint64_t hashRound(const uint64_t accumulator, const uint64_t input) noexcept
+	{ return rotateLeft(accumulator + (input * prime2), 31U) * prime1; }
+
+constexpr static uint64_t hashMerge(const uint64_t hash, const uint64_t accumulator) noexcept
+	{ return ((hash ^ hashRound(0U, accumulator)) * prime1) + prime4; }
+
+pcmCache_t &pcmCache_t::instance() noexcept
+{
+	static pcmCache_t cache{};
+	return cache;
+}
+
+// This runs over the whole file on each load that uses the caches, so it takes xxHash64 of the file in place
+pcmFileID_t pcmCache_t::identify(const void *const data, const size_t length) noexcept
+{
+	const auto *const bytes{static_cast<const uint8_t *>(data)};
+	size_t offset{};
+	uint64_t hash{prime5};
+	if (length >= 32U)
+	{
+		std::array<uint64_t, 4U> lanes{prime1 + prime2, prime2, 0U, 0U - prime1};
+		for (; offset + 32U <= length; offset += 32U)
+		{
+			for (size_t lane{}; lane < lanes.size(); ++lane)
+				lanes[lane] = hashRound(lanes[lane], readWord<uint64_t>(bytes + offset + (lane * 8U)));
+		}
+		hash = rotateLeft(lanes[0], 1U) + rotateLeft(lanes[1], 7U) + rotateLeft(lanes[2], 12U) +
+			rotateLeft(lanes[3], 18U);
+		for (const auto lane : lanes)
+			hash = hashMerge(hash, lane);
+	}
+
+	hash += length;
+	for (; offset + 8U <= length; offset += 8U)
+		hash = (rotateLeft(hash ^ hashRound(0U, readWord<uint64_t>(bytes + offset)), 27U) * prime1) + prime4;
+	if (offset + 4U <= length)
+	{
+		hash = (rotateLeft(hash ^ (readWord<uint32_t>(bytes + offset) * prime1), 23U) * prime2) + prime3;
+		offset += 4U;
+	}
+	for (; offset < length; ++offset)
+		hash = rotateLeft(hash ^ (bytes[offset] * prime5), 11U) * prime1;
+
+	hash ^= hash >> 33U;
+	hash *= prime2;
+	hash ^= hash >> 29U;
+	hash *= prime3;
+	hash ^= hash >> 32U;
+	return {hash, length};
+}
+
+pcmPtr_t pcmCache_t::find(const pcmFileID_t &file, const uint32_t sample, const size_t bytes) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	const auto entry{entries.find({file, sample})};
+	// If the PCM held is not the size the caller needs, using it would have the mixer run off the end of it
+	if (entry == entries.end() || entry->second.bytes != bytes)
+		return nullptr;
+	lru.splice(lru.begin(), lru, entry->second.lruPosition);
+	return entry->second.pcm;
+}
+
+void pcmCache_t::insert(const pcmFileID_t &file, const uint32_t sample, pcmPtr_t pcm, const size_t bytes) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	// Something that can never fit would only push everything else out for nothing
+	if (!pcm || bytes > _budget)
+		return;
+	const key_t key{file, sample};
+	if (const auto entry{entries.find(key)}; entry != entries.end())
+	{
+		if (entry->second.bytes == bytes)
+			return;
+		// find() turned the old PCM down for being the wrong size, so replace it with the freshly decoded PCM
+		_used -= entry->second.bytes;
+		lru.erase(entry->second.lruPosition);
+		entries.erase(entry);
+	}
+	// If there's not enough memory to track the entry, the PCM just doesn't get cached
+	try
+		{ lru.push_front(key); }
+	catch (const std::bad_alloc &)
+		{ return; }
+	try
+		{ entries.emplace(key, entry_t{std::move(pcm), bytes, lru.begin()}); }
+	catch (const std::bad_alloc &)
+	{
+		lru.pop_front();
+		return;
+	}
+	_used += bytes;
+	trim(_budget);
+}
+
+// Drops the least recently used entries until the cache fits in the budget. Must be called with the lock held.
+void pcmCache_t::trim(const size_t budget) noexcept
+{
+	while (_used > budget)
+	{
+		const auto oldest{entries.find(lru.back())};
+		_used -= oldest->second.bytes;
+		entries.erase(oldest);
+		lru.pop_back();
+	}
+}
+
+void pcmCache_t::budget(const size_t bytes) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	_budget = bytes;
+	trim(_budget);
+}
+
+void pcmCache_t::clear() noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	entries.clear();
+	lru.clear();
+	_used = 0U;
+}
+
+size_t pcmCache_t::budget() const noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	return _budget;
+}
+
+size_t pcmCache_t::used() const noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	return _used;
+}
@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Process-wide cache of decoded module sample PCM
+#ifndef GENERIC_MODULE_PCM_CACHE_HXX
+#define GENERIC_MODULE_PCM_CACHE_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+using pcmPtr_t = std::shared_ptr<const uint8_t []>;
+
+// Identifies a module file by a hash of its contents along with its length, so the same module opened via
+// different paths still matches. The hash is not cryptographic, so a crafted file could collide with another, but
+// the cache checks the size of every sample's PCM before handing it out, so that can at worst play the wrong audio.
+// A length of 0 means the file was not identified, as is the case when the caches are turned off.
+struct pcmFileID_t final
+{
+	uint64_t hash{};
+	uint64_t length{};
+
+	bool operator ==(const pcmFileID_t &other) const noexcept
+		{ return hash == other.hash && length == other.length; }
+};
+
+/*!
+ * @internal
+ * Holds the decoded PCM of module samples so every ModuleFile opened on the same file shares one read-only
+ * copy instead of loading and decompressing its own. Entries are kept in least recently used order and the
+ * oldest are dropped once the total size exceeds the byte budget. Dropping an entry only drops the cache's
+ * reference - any ModuleFile still using the PCM keeps it alive until it is done with it.
+ */
+struct pcmCache_t final
+{
+private:
+	struct key_t final
+	{
+		pcmFileID_t file{};
+		uint32_t sample{};
+
+		bool operator ==(const key_t &other) const noexcept
+			{ return file == other.file && sample == other.sample; }
+	};
+
+	struct keyHash_t final
+	{
+		size_t operator ()(const key_t &key) const noexcept
+		{
+			return static_cast<size_t>(key.file.hash ^ (key.sample * UINT64_C(0x9E3779B97F4A7C15)));
+		}
+	};
+
+	struct entry_t final
+	{
+		pcmPtr_t pcm;
+		size_t bytes;
+		std::list<key_t>::iterator lruPosition;
+	};
+
+	mutable std::mutex lock{};
+	std::list<key_t> lru{};
+	std::unordered_map<key_t, entry_t, keyHash_t> entries{};
+	size_t _budget;
+	size_t _used{0U};
+
+	void trim(size_t budget) noexcept;
+
+public:
+	constexpr static size_t defaultBudget{64U * 1024U * 1024U};
+
+	pcmCache_t(size_t budget = defaultBudget) noexcept : _budget{budget} { }
+	pcmCache_t(const pcmCache_t &) noexcept = delete;
+	pcmCache_t(pcmCache_t &&) noexcept = delete;
+	~pcmCache_t() noexcept = default;
+	pcmCache_t &operator =(const pcmCache_t &) noexcept = delete;
+	pcmCache_t &operator =(pcmCache_t &&) noexcept = delete;
+
+	// The cache shared by every module loaded in this process
+	static pcmCache_t &instance() noexcept;
+	[[nodiscard]] static pcmFileID_t identify(const void *data, size_t length) noexcept;
+
+	// Returns the cached PCM for the sample, or nullptr if the cache does not have it or has a different
+	// amount of it than the caller expects to be there
+	[[nodiscard]] pcmPtr_t find(const pcmFileID_t &file, uint32_t sample, size_t bytes) noexcept;
+	void insert(const pcmFileID_t &file, uint32_t sample, pcmPtr_t pcm, size_t bytes) noexcept;
+	void budget(size_t bytes) noexcept;
+	[[nodiscard]] size_t budget() const noexcept;
+	[[nodiscard]] size_t used() const noexcept;
+	void clear() noexcept;
+};
+
+#endif /*GENERIC_MODULE_PCM_CACHE_HXX*/
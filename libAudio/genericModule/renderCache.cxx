@@ -0,0 +1,411 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <new>
+#include <substrate/utility>
+#include "renderCache.hxx"
+#ifdef ENABLE_FLAC
+#include <FLAC/all.h>
+#endif
+
+using substrate::make_unique_nothrow;
+
+uint8_t renderKey_t::bytesPerSample() const noexcept
+{
+	if (format == moduleOutput_t::int24)
+		return 3U;
+	else if (format == moduleOutput_t::float32)
+		return 4U;
+	return 2U;
+}
+
+#ifdef ENABLE_FLAC
+// The mixer's output is in the machine's byte order for 16-bit, and always little endian for 24-bit
+static int32_t readSample(const uint8_t *const buffer, const uint8_t bytesPerSample) noexcept
+{
+	if (bytesPerSample == 3U)
+	{
+		const auto sample{uint32_t{buffer[0]} | (uint32_t{buffer[1]} << 8U) | (uint32_t{buffer[2]} << 16U)};
+		// Sign extend from 24 bits
+		return static_cast<int32_t>(sample << 8U) >> 8;
+	}
+	int16_t sample{};
+	std::memcpy(&sample, buffer, sizeof(sample));
+	return sample;
+}
+
+static void writeSample(uint8_t *const buffer, const int32_t sample, const uint8_t bytesPerSample) noexcept
+{
+	if (bytesPerSample == 3U)
+	{
+		buffer[0] = static_cast<uint8_t>(sample);
+		buffer[1] = static_cast<uint8_t>(sample >> 8U);
+		buffer[2] = static_cast<uint8_t>(sample >> 16U);
+		return;
+	}
+	const auto value{static_cast<int16_t>(sample)};
+	std::memcpy(buffer, &value, sizeof(value));
+}
+
+struct renderCapture_t::encoder_t final
+{
+	FLAC__StreamEncoder *streamEncoder{FLAC__stream_encoder_new()};
+	std::vector<uint8_t> &data;
+	size_t budget;
+	std::array<int32_t, 1024> samples{};
+
+	encoder_t(std::vector<uint8_t> &output, const renderKey_t &key, const size_t maximum) noexcept :
+		data{output}, budget{maximum}
+	{
+		if (!streamEncoder)
+			return;
+		FLAC__stream_encoder_set_channels(streamEncoder, key.channels);
+		FLAC__stream_encoder_set_bits_per_sample(streamEncoder, key.bytesPerSample() * 8U);
+		FLAC__stream_encoder_set_sample_rate(streamEncoder, key.sampleRate);
+		FLAC__stream_encoder_set_compression_level(streamEncoder, 4);
+		if (FLAC__stream_encoder_init_stream(streamEncoder, write, nullptr, nullptr, nullptr, this) !=
+			FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+		{
+			FLAC__stream_encoder_delete(streamEncoder);
+			streamEncoder = nullptr;
+		}
+	}
+
+	encoder_t(const encoder_t &) noexcept = delete;
+	encoder_t(encoder_t &&) noexcept = delete;
+	encoder_t &operator =(const encoder_t &) noexcept = delete;
+	encoder_t &operator =(encoder_t &&) noexcept = delete;
+
+	~encoder_t() noexcept
+	{
+		if (streamEncoder)
+			FLAC__stream_encoder_delete(streamEncoder);
+	}
+
+	static FLAC__StreamEncoderWriteStatus write(const FLAC__StreamEncoder *, const FLAC__byte *const buffer,
+		const size_t bytes, uint32_t, uint32_t, void *const ctx) noexcept
+	{
+		auto &encoder{*static_cast<encoder_t *>(ctx)};
+		if (encoder.data.size() + bytes > encoder.budget)
+			return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR;
+		try
+			{ encoder.data.insert(encoder.data.end(), buffer, buffer + bytes); }
+		catch (const std::bad_alloc &)
+			{ return FLAC__STREAM_ENCODER_WRITE_STATUS_FATAL_ERROR; }
+		return FLAC__STREAM_ENCODER_WRITE_STATUS_OK;
+	}
+
+	[[nodiscard]] bool encode(const uint8_t *const buffer, const size_t bytes, const renderKey_t &key) noexcept
+	{
+		const auto bytesPerSample{key.bytesPerSample()};
+		// Only ever hand the encoder whole frames at a time
+		const size_t chunkSamples{samples.size() - (samples.size() % key.channels)};
+		const size_t totalSamples{bytes / bytesPerSample};
+		for (size_t offset{}; offset < totalSamples; offset += chunkSamples)
+		{
+			const auto count{std::min(chunkSamples, totalSamples - offset)};
+			for (size_t i{}; i < count; ++i)
+				samples[i] = readSample(buffer + ((offset + i) * bytesPerSample), bytesPerSample);
+			if (!FLAC__stream_encoder_process_interleaved(streamEncoder, samples.data(),
+				static_cast<uint32_t>(count / key.channels)))
+				return false;
+		}
+		return true;
+	}
+};
+
+struct renderReader_t::decoder_t final
+{
+	FLAC__StreamDecoder *streamDecoder{FLAC__stream_decoder_new()};
+	const renderedSong_t &song;
+	size_t readOffset{};
+	std::vector<uint8_t> pending{};
+	size_t pendingOffset{};
+	bool failed{};
+
+	decoder_t(const renderedSong_t &source) noexcept : song{source}
+	{
+		if (!streamDecoder)
+			return;
+		if (FLAC__stream_decoder_init_stream(streamDecoder, read, nullptr, nullptr, nullptr, nullptr, write,
+			nullptr, error, this) != FLAC__STREAM_DECODER_INIT_STATUS_OK)
+		{
+			FLAC__stream_decoder_delete(streamDecoder);
+			streamDecoder = nullptr;
+		}
+	}
+
+	decoder_t(const decoder_t &) noexcept = delete;
+	decoder_t(decoder_t &&) noexcept = delete;
+	decoder_t &operator =(const decoder_t &) noexcept = delete;
+	decoder_t &operator =(decoder_t &&) noexcept = delete;
+
+	~decoder_t() noexcept
+	{
+		if (streamDecoder)
+			FLAC__stream_decoder_delete(streamDecoder);
+	}
+
+	static FLAC__StreamDecoderReadStatus read(const FLAC__StreamDecoder *, FLAC__byte *const buffer,
+		size_t *const bytes, void *const ctx) noexcept
+	{
+		auto &decoder{*static_cast<decoder_t *>(ctx)};
+		const auto count{std::min(*bytes, decoder.song.data.size() - decoder.readOffset)};
+		std::memcpy(buffer, decoder.song.data.data() + decoder.readOffset, count);
+		decoder.readOffset += count;
+		*bytes = count;
+		return count ? FLAC__STREAM_DECODER_READ_STATUS_CONTINUE : FLAC__STREAM_DECODER_READ_STATUS_END_OF_STREAM;
+	}
+
+	static FLAC__StreamDecoderWriteStatus write(const FLAC__StreamDecoder *, const FLAC__Frame *const frame,
+		const FLAC__int32 *const *const buffer, void *const ctx) noexcept
+	{
+		auto &decoder{*static_cast<decoder_t *>(ctx)};
+		const auto &key{decoder.song.key};
+		const auto bytesPerSample{key.bytesPerSample()};
+		const auto samples{frame->header.blocksize};
+		try
+			{ decoder.pending.resize(size_t{samples} * key.frameSize()); }
+		catch (const std::bad_alloc &)
+			{ return FLAC__STREAM_DECODER_WRITE_STATUS_ABORT; }
+		decoder.pendingOffset = 0U;
+		auto *output{decoder.pending.data()};
+		for (uint32_t sample{}; sample < samples; ++sample)
+		{
+			for (uint16_t channel{}; channel < key.channels; ++channel)
+			{
+				writeSample(output, buffer[channel][sample], bytesPerSample);
+				output += bytesPerSample;
+			}
+		}
+		return FLAC__STREAM_DECODER_WRITE_STATUS_CONTINUE;
+	}
+
+	static void error(const FLAC__StreamDecoder *, FLAC__StreamDecoderErrorStatus, void *const ctx) noexcept
+		{ static_cast<decoder_t *>(ctx)->failed = true; }
+
+	[[nodiscard]] size_t decode(uint8_t *const buffer, const size_t bytes) noexcept
+	{
+		size_t produced{};
+		while (produced < bytes)
+		{
+			if (pendingOffset < pending.size())
+			{
+				const auto count{std::min(bytes - produced, pending.size() - pendingOffset)};
+				std::memcpy(buffer + produced, pending.data() + pendingOffset, count);
+				pendingOffset += count;
+				produced += count;
+				continue;
+			}
+			if (failed || FLAC__stream_decoder_get_state(streamDecoder) == FLAC__STREAM_DECODER_END_OF_STREAM ||
+				!FLAC__stream_decoder_process_single(streamDecoder))
+				break;
+		}
+		return produced;
+	}
+};
+#else
+struct renderCapture_t::encoder_t final { };
+struct renderReader_t::decoder_t final { };
+#endif
+
+renderCapture_t::renderCapture_t(const renderKey_t &key, const bool compress, const size_t maximum) noexcept :
+	song{make_unique_nothrow<renderedSong_t>()}, encoder{}, budget{maximum}
+{
+	if (!song)
+		return;
+	song->key = key;
+#ifdef ENABLE_FLAC
+	// FLAC has no way to hold floating point samples, so those are always kept as-is
+	if (!compress || key.format == moduleOutput_t::float32)
+		return;
+	encoder = make_unique_nothrow<encoder_t>(song->data, key, budget);
+	if (!encoder || !encoder->streamEncoder)
+	{
+		song.reset();
+		return;
+	}
+	song->compressed = true;
+#else
+	static_cast<void>(compress);
+#endif
+}
+
+renderCapture_t::~renderCapture_t() noexcept = default;
+
+bool renderCapture_t::append(const uint8_t *const buffer, const size_t bytes) noexcept
+{
+	if (!song)
+		return false;
+	song->length += bytes;
+#ifdef ENABLE_FLAC
+	if (encoder)
+		return encoder->encode(buffer, bytes, song->key);
+#endif
+	if (song->data.size() + bytes > budget)
+		return false;
+	try
+		{ song->data.insert(song->data.end(), buffer, buffer + bytes); }
+	catch (const std::bad_alloc &)
+		{ return false; }
+	return true;
+}
+
+renderedSongPtr_t renderCapture_t::finish() noexcept
+{
+	if (!song)
+		return nullptr;
+#ifdef ENABLE_FLAC
+	if (encoder && !FLAC__stream_encoder_finish(encoder->streamEncoder))
+		return nullptr;
+	encoder.reset();
+#endif
+	// Don't hold on to more memory than the song needs, as that would not be accounted for in the budget
+	try
+		{ song->data.shrink_to_fit(); }
+	catch (const std::bad_alloc &)
+		{ }
+	return renderedSongPtr_t{song.release()};
+}
+
+renderReader_t::renderReader_t(renderedSongPtr_t source) noexcept : song{std::move(source)}, decoder{}
+{
+#ifdef ENABLE_FLAC
+	if (song && song->compressed)
+		decoder = make_unique_nothrow<decoder_t>(*song);
+#endif
+}
+
+renderReader_t::~renderReader_t() noexcept = default;
+
+bool renderReader_t::valid() const noexcept
+{
+	if (!song)
+		return false;
+#ifdef ENABLE_FLAC
+	if (song->compressed)
+		return decoder && decoder->streamDecoder;
+#endif
+	return !song->compressed;
+}
+
+int64_t renderReader_t::read(uint8_t *const buffer, const uint32_t length) noexcept
+{
+	const auto frameSize{song->key.frameSize()};
+	const auto bytes{std::min<uint64_t>(length - (length % frameSize), song->length - offset)};
+	if (!bytes)
+		return -2;
+	uint64_t produced{bytes};
+#ifdef ENABLE_FLAC
+	if (decoder)
+		produced = decoder->decode(buffer, bytes);
+	else
+#endif
+		std::memcpy(buffer, song->data.data() + offset, bytes);
+	offset += produced;
+	return produced ? static_cast<int64_t>(produced) : -2;
+}
+
+size_t renderCache_t::keyHash_t::operator ()(const renderKey_t &key) const noexcept
+{
+	uint64_t hash{key.file.hash};
+	hash = (hash ^ key.sampleRate) * UINT64_C(0x9E3779B97F4A7C15);
+	hash = (hash ^ key.voiceLimit) * UINT64_C(0x9E3779B97F4A7C15);
+	hash ^= uint64_t{key.channels} | (uint64_t(key.format) << 16U) | (uint64_t{key.dither} << 24U) |
+		(uint64_t(key.interpolation) << 32U) | (uint64_t{key.audibilityThreshold} << 40U);
+	return static_cast<size_t>(hash * UINT64_C(0xC2B2AE3D27D4EB4F));
+}
+
+renderCache_t &renderCache_t::instance() noexcept
+{
+	static renderCache_t cache{};
+	return cache;
+}
+
+renderedSongPtr_t renderCache_t::find(const renderKey_t &key) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	const auto entry{entries.find(key)};
+	if (entry == entries.end())
+		return nullptr;
+	lru.splice(lru.begin(), lru, entry->second.lruPosition);
+	return entry->second.song;
+}
+
+void renderCache_t::insert(renderedSongPtr_t song) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	if (!song || song->data.size() > _budget)
+		return;
+	const auto &key{song->key};
+	if (entries.find(key) != entries.end())
+		return;
+	// If there's not enough memory to track the entry, the song just doesn't get cached
+	try
+		{ lru.push_front(key); }
+	catch (const std::bad_alloc &)
+		{ return; }
+	const auto bytes{song->data.size()};
+	try
+		{ entries.emplace(key, entry_t{std::move(song), lru.begin()}); }
+	catch (const std::bad_alloc &)
+	{
+		lru.pop_front();
+		return;
+	}
+	_used += bytes;
+	trim(_budget);
+}
+
+// Drops the least recently used entries until the cache fits in the budget. Must be called with the lock held.
+void renderCache_t::trim(const size_t budget) noexcept
+{
+	while (_used > budget)
+	{
+		const auto oldest{entries.find(lru.back())};
+		_used -= oldest->second.song->data.size();
+		entries.erase(oldest);
+		lru.pop_back();
+	}
+}
+
+void renderCache_t::budget(const size_t bytes) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	_budget = bytes;
+	trim(_budget);
+}
+
+size_t renderCache_t::budget() const noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	return _budget;
+}
+
+void renderCache_t::compress(const bool enable) noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	_compress = enable;
+}
+
+bool renderCache_t::compress() const noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	return _compress;
+}
+
+size_t renderCache_t::used() const noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	return _used;
+}
+
+void renderCache_t::clear() noexcept
+{
+	std::lock_guard<std::mutex> guard{lock};
+	entries.clear();
+	lru.clear();
+	_used = 0U;
+}
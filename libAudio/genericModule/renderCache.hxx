@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Process-wide cache of fully rendered module songs
+#ifndef GENERIC_MODULE_RENDER_CACHE_HXX
+#define GENERIC_MODULE_RENDER_CACHE_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "../libAudio.hxx"
+#include "pcmCache.hxx"
+
+// Everything that goes into what the mixer produces for a module - a change to any of it must miss the cache
+struct renderKey_t final
+{
+	pcmFileID_t file{};
+	uint32_t sampleRate{};
+	uint16_t channels{};
+	moduleOutput_t format{};
+	bool dither{};
+	moduleInterpolation_t interpolation{};
+	uint32_t voiceLimit{};
+	uint8_t audibilityThreshold{};
+	moduleEffects_t effects{};
+
+	bool operator ==(const renderKey_t &other) const noexcept
+	{
+		return file == other.file && sampleRate == other.sampleRate && channels == other.channels &&
+			format == other.format && dither == other.dither && interpolation == other.interpolation &&
+			voiceLimit == other.voiceLimit && audibilityThreshold == other.audibilityThreshold &&
+			effects == other.effects;
+	}
+	bool operator !=(const renderKey_t &other) const noexcept { return !(*this == other); }
+
+	[[nodiscard]] uint8_t bytesPerSample() const noexcept;
+	[[nodiscard]] uint32_t frameSize() const noexcept { return bytesPerSample() * channels; }
+};
+
+// A module's output from the start of the song to its end, either as-is or FLAC compressed
+struct renderedSong_t final
+{
+	renderKey_t key{};
+	std::vector<uint8_t> data{};
+	// How many bytes of output the song decodes to
+	uint64_t length{};
+	bool compressed{};
+};
+
+using renderedSongPtr_t = std::shared_ptr<const renderedSong_t>;
+
+/*!
+ * @internal
+ * Records the output of a module as it plays for the first time so it can be put in the render cache
+ * once the song ends. If the capture outgrows the budget it was started with, or anything goes wrong,
+ * append() returns false and the capture should be thrown away.
+ */
+struct renderCapture_t final
+{
+private:
+	struct encoder_t;
+	std::unique_ptr<renderedSong_t> song;
+	std::unique_ptr<encoder_t> encoder;
+	size_t budget;
+
+public:
+	renderCapture_t(const renderKey_t &key, bool compress, size_t budget) noexcept;
+	renderCapture_t(const renderCapture_t &) noexcept = delete;
+	renderCapture_t(renderCapture_t &&) noexcept = delete;
+	~renderCapture_t() noexcept;
+	renderCapture_t &operator =(const renderCapture_t &) noexcept = delete;
+	renderCapture_t &operator =(renderCapture_t &&) noexcept = delete;
+
+	[[nodiscard]] bool valid() const noexcept { return bool(song); }
+	[[nodiscard]] bool append(const uint8_t *buffer, size_t bytes) noexcept;
+	// Completes the capture, returning nullptr if it could not be finished
+	[[nodiscard]] renderedSongPtr_t finish() noexcept;
+};
+
+/*!
+ * @internal
+ * Plays a song back out of the render cache, producing exactly what the mixer did when it was captured
+ */
+struct renderReader_t final
+{
+private:
+	struct decoder_t;
+	renderedSongPtr_t song;
+	std::unique_ptr<decoder_t> decoder;
+	uint64_t offset{};
+
+public:
+	renderReader_t(renderedSongPtr_t song) noexcept;
+	renderReader_t(const renderReader_t &) noexcept = delete;
+	renderReader_t(renderReader_t &&) noexcept = delete;
+	~renderReader_t() noexcept;
+	renderReader_t &operator =(const renderReader_t &) noexcept = delete;
+	renderReader_t &operator =(renderReader_t &&) noexcept = delete;
+
+	[[nodiscard]] bool valid() const noexcept;
+	// Works the same as ModuleFile::Mix(), returning -2 once the song has ended
+	[[nodiscard]] int64_t read(uint8_t *buffer, uint32_t length) noexcept;
+	// How many sample frames into the song playback has got to
+	[[nodiscard]] uint64_t position() const noexcept { return offset / song->key.frameSize(); }
+};
+
+/*!
+ * @internal
+ * Holds whole rendered songs so a module played again with the same mixer settings is served from memory
+ * rather than mixed all over again. Like the PCM cache, entries are kept in least recently used order and
+ * the oldest dropped once the total size exceeds the byte budget. The budget starts at 0, which disables
+ * the cache entirely, as a single song can easily run to tens of megabytes.
+ */
+struct renderCache_t final
+{
+private:
+	struct keyHash_t final
+	{
+		size_t operator ()(const renderKey_t &key) const noexcept;
+	};
+
+	struct entry_t final
+	{
+		renderedSongPtr_t song;
+		std::list<renderKey_t>::iterator lruPosition;
+	};
+
+	mutable std::mutex lock{};
+	std::list<renderKey_t> lru{};
+	std::unordered_map<renderKey_t, entry_t, keyHash_t> entries{};
+	size_t _budget;
+	size_t _used{0U};
+	bool _compress{false};
+
+	void trim(size_t budget) noexcept;
+
+public:
+	renderCache_t(size_t budget = 0U) noexcept : _budget{budget} { }
+	renderCache_t(const renderCache_t &) noexcept = delete;
+	renderCache_t(renderCache_t &&) noexcept = delete;
+	~renderCache_t() noexcept = default;
+	renderCache_t &operator =(const renderCache_t &) noexcept = delete;
+	renderCache_t &operator =(renderCache_t &&) noexcept = delete;
+
+	// The cache shared by every module loaded in this process
+	static renderCache_t &instance() noexcept;
+
+	// Returns the cached render for the key, or nullptr if the cache does not have it
+	[[nodiscard]] renderedSongPtr_t find(const renderKey_t &key) noexcept;
+	void insert(renderedSongPtr_t song) noexcept;
+	void budget(size_t bytes) noexcept;
+	[[nodiscard]] size_t budget() const noexcept;
+	// Whether new renders get FLAC compressed. Only takes effect when libAudio is built with FLAC support
+	void compress(bool enable) noexcept;
+	[[nodiscard]] bool compress() const noexcept;
+	[[nodiscard]] size_t used() const noexcept;
+	void clear() noexcept;
+};
+
+#endif /*GENERIC_MODULE_RENDER_CACHE_HXX*/
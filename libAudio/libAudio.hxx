@@ -64,6 +64,47 @@ enum class audioType_t : uint8_t
 	sid = 20
 };
 
+enum class moduleInterpolation_t : uint8_t
+{
+	none = 0,
+	linear = 1,
+	cubic = 2,
+	sinc = 3
+};
+
+enum class moduleOutput_t : uint8_t
+{
+	int16 = 0,
+	int24 = 1,
+	float32 = 2
+};
+
+// Effects run over a module's mix before it is converted to the output format. Each is off while its depth is 0.
+struct moduleEffects_t final
+{
+	// How much reverb to mix in, 0-100, and how large a room it sounds like, 0-100
+	uint8_t reverbDepth{};
+	uint8_t reverbRoomSize{50U};
+	// How much of the difference between the left and right channels to matrix encode into
+	// the rear channels, 0-100, and how many milliseconds to delay it by, 5-40
+	uint8_t surroundDepth{};
+	uint8_t surroundDelay{20U};
+	// How much to boost the bass by, 0-100, and the frequency in Hz below which counts as bass, 20-200
+	uint8_t bassDepth{};
+	uint8_t bassCutoff{60U};
+	// Whether to shape the dither noise of 16-bit output up and out of the range of frequencies hearing is most
+	// sensitive to. This has no effect on 24-bit or float output.
+	bool noiseShaping{};
+
+	bool operator ==(const moduleEffects_t &other) const noexcept
+	{
+		return reverbDepth == other.reverbDepth && reverbRoomSize == other.reverbRoomSize &&
+			surroundDepth == other.surroundDepth && surroundDelay == other.surroundDelay &&
+			bassDepth == other.bassDepth && bassCutoff == other.bassCutoff && noiseShaping == other.noiseShaping;
+	}
+	bool operator !=(const moduleEffects_t &other) const noexcept { return !(*this == other); }
+};
+
 using fileIs_t = bool (*)(const char *);
 using fileOpenR_t = void *(*)(const char *);
 using fileOpenW_t = void *(*)(const char *);
@@ -308,6 +349,30 @@ public:
 	bool valid() const noexcept { return bool(ctx) && _fd.valid(); }
 
 	int64_t fillBuffer(void *buffer, uint32_t length) final;
+	libAUDIO_CLS_API bool interpolation(moduleInterpolation_t mode) noexcept;
+	libAUDIO_CLS_API moduleInterpolation_t interpolation() const noexcept;
+	libAUDIO_CLS_API bool outputFormat(moduleOutput_t format, bool dither = false) noexcept;
+	libAUDIO_CLS_API bool effects(const moduleEffects_t &settings) noexcept;
+	libAUDIO_CLS_API moduleEffects_t effects() const noexcept;
+	libAUDIO_CLS_API bool mixThreads(uint32_t threads) noexcept;
+	libAUDIO_CLS_API bool mixBlockSize(uint32_t frames) noexcept;
+	libAUDIO_CLS_API uint32_t mixBlockSize() const noexcept;
+	libAUDIO_CLS_API bool voiceLimit(uint32_t voices) noexcept;
+	libAUDIO_CLS_API bool audibilityThreshold(uint8_t volume) noexcept;
+	// How many voices have been cut for going over the voice limit, and for falling below the audibility threshold
+	libAUDIO_CLS_API uint64_t stolenVoices() const noexcept;
+	libAUDIO_CLS_API uint64_t culledVoices() const noexcept;
+	libAUDIO_CLS_API bool seek(uint64_t milliseconds) noexcept;
+	libAUDIO_CLS_API bool seek(uint16_t order, uint16_t row) noexcept;
+	// How many stems fillStems() splits the mix into - one per pattern channel
+	libAUDIO_CLS_API uint8_t stems() const noexcept;
+	libAUDIO_CLS_API int64_t fillStems(void *const *buffers, uint32_t length) noexcept;
+	libAUDIO_CLS_API int64_t fillTick(void *buffer, uint32_t length) noexcept;
+	libAUDIO_CLS_API uint32_t tickRemaining() const noexcept;
+	// Sets how many bytes of decoded sample data may be kept around for reuse by later opens of the same module
+	libAUDIO_CLS_API static void sampleCacheBudget(size_t bytes) noexcept;
+	// Sets how many bytes of fully rendered songs may be kept around to serve replays of the same module from
+	libAUDIO_CLS_API static void renderCacheBudget(size_t bytes, bool compress = false) noexcept;
 };
 
 struct modMOD_t final : public moduleFile_t
@@ -42,6 +42,7 @@ modAON_t *modAON_t::openR(const char *const fileName) noexcept
 	if (remark)
 		info.addOtherComment(std::move(remark));
 	//info.channels = ctx.mod->channels();
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
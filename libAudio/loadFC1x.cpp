@@ -24,6 +24,7 @@ modFC1x_t *modFC1x_t::openR(const char *const fileName) noexcept
 
 	info.bitRate(44100U);
 	info.bitsPerSample(16U);
+	info.channels(2U);
 	try { ctx.mod = make_unique_nothrow<ModuleFile>(*file); }
 	catch (const ModuleLoaderError &e)
 	{
@@ -31,7 +32,7 @@ modFC1x_t *modFC1x_t::openR(const char *const fileName) noexcept
 		return nullptr;
 	}
 	info.title(ctx.mod->title());
-	info.channels(ctx.mod->channels());
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
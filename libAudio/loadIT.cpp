@@ -32,6 +32,7 @@ modIT_t *modIT_t::openR(const char *const fileName) noexcept
 	}
 	info.title(ctx.mod->title());
 	info.artist(ctx.mod->author());
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
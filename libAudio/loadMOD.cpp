@@ -45,6 +45,7 @@ modMOD_t *modMOD_t::openR(const char *const fileName) noexcept
 		return nullptr;
 	}
 	info.title(ctx.mod->title());
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
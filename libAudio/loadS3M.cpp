@@ -32,6 +32,7 @@ modS3M_t *modS3M_t::openR(const char *const fileName) noexcept
 	}
 	info.title(ctx.mod->title());
 	info.channels(ctx.mod->channels());
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
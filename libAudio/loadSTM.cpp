@@ -31,6 +31,7 @@ modSTM_t *modSTM_t::openR(const char *const fileName) noexcept
 		return nullptr;
 	}
 	info.title(ctx.mod->title());
+	info.totalTime(ctx.mod->songLength(info.bitRate()) / 1000U);
 
 	if (ToPlayback)
 	{
@@ -149,6 +149,7 @@ void channel_t::applyPanningEnvelope() noexcept
 
 uint32_t channel_t::applyPitchEnvelope(const uint32_t period) noexcept
 {
+	FilterModifier = filterModifierNone;
 	if (!Instrument)
 		return period;
 	auto &envelope{Instrument->GetEnvelope(envelopeType_t::pitch)};
@@ -157,9 +158,9 @@ uint32_t channel_t::applyPitchEnvelope(const uint32_t period) noexcept
 	auto pitchValue{int8_t(envelope.Apply(EnvPitchPos) - 128)};
 	clipInt<int8_t>(pitchValue, -32, 32);
 	auto result{period};
+	// A filter envelope sweeps the cutoff between nothing at the bottom and its set value at the top
 	if (envelope.IsFilter())
-	{
-	}
+		FilterModifier = int16_t(pitchValue * 8);
 	else
 	{
 		if (pitchValue < 0)
@@ -195,6 +196,19 @@ uint32_t channel_t::applyPitchEnvelope(const uint32_t period) noexcept
 	return result;
 }
 
+void channel_t::applyFilter(const uint32_t sampleRate) noexcept
+{
+	const filterSettings_t settings{FilterCutoff, FilterResonance, FilterModifier, sampleRate};
+	if (settings == FilterSettings)
+		return;
+	// Going from unfiltered to filtered, start the filter from silence rather than stale history
+	if (!FilterSettings.active())
+		FilterState = {};
+	FilterSettings = settings;
+	if (settings.active())
+		FilterCoefficients = filterCoefficients(settings);
+}
+
 int16_t channel_t::applyVibrato(const ModuleFile &module, const uint32_t period) noexcept
 {
 	if (Flags & CHN_VIBRATO)
@@ -328,8 +342,14 @@ void channel_t::noteCut(ModuleFile &module, uint32_t tick) noexcept
 		return;*/
 	if (module.ticks() == tick)
 	{
-		RawVolume = 0;
-		Flags |= CHN_FASTVOLRAMP;
+		// Scream Tracker lets go of the key on AdLib voices rather than cutting them, so their release still plays
+		if (Adlib.playing())
+			Adlib.keyOff();
+		else
+		{
+			RawVolume = 0;
+			Flags |= CHN_FASTVOLRAMP;
+		}
 	}
 }
 
@@ -339,6 +359,7 @@ void channel_t::noteOff() noexcept
 	Flags |= CHN_NOTEOFF;
 	if (Instrument && !Instrument->GetEnvEnabled(envelopeType_t::volume))
 		Flags |= CHN_NOTEFADE;
+	Adlib.keyOff();
 	if (!Length)
 		return;
 	if ((Flags & CHN_SUSTAINLOOP) && Sample && noteOn)
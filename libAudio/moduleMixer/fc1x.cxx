@@ -0,0 +1,427 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <array>
+#include <algorithm>
+#include "fc1x.hxx"
+
+namespace libAudio::fc1x
+{
+	// FC's period table runs 5 octaves up from 1712, then an octave down from 3424 and the same 5 octaves again,
+	// with the top of each run padded out with the highest period
+	constexpr static std::array<uint16_t, 128> periods
+	{{
+		1712U, 1616U, 1524U, 1440U, 1356U, 1280U, 1208U, 1140U, 1076U, 1016U, 960U, 906U,
+		856U, 808U, 762U, 720U, 678U, 640U, 604U, 570U, 538U, 508U, 480U, 453U,
+		428U, 404U, 381U, 360U, 339U, 320U, 302U, 285U, 269U, 254U, 240U, 226U,
+		214U, 202U, 190U, 180U, 170U, 160U, 151U, 143U, 135U, 127U, 120U, 113U,
+		113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U,
+		3424U, 3232U, 3048U, 2880U, 2712U, 2560U, 2416U, 2280U, 2152U, 2032U, 1920U, 1812U,
+		1712U, 1616U, 1524U, 1440U, 1356U, 1280U, 1208U, 1140U, 1076U, 1016U, 960U, 906U,
+		856U, 808U, 762U, 720U, 678U, 640U, 604U, 570U, 538U, 508U, 480U, 453U,
+		428U, 404U, 381U, 360U, 339U, 320U, 302U, 285U, 269U, 254U, 240U, 226U,
+		214U, 202U, 190U, 180U, 170U, 160U, 151U, 143U, 135U, 127U, 120U, 113U,
+		113U, 113U, 113U, 113U, 113U, 113U, 113U, 113U
+	}};
+
+	// Macro commands, which all sit above the highest volume and note
+	constexpr static uint8_t macroLoop{0xe0U};
+	constexpr static uint8_t macroEnd{0xe1U};
+	constexpr static uint8_t macroSetWave{0xe2U};
+	constexpr static uint8_t macroVibrato{0xe3U};
+	constexpr static uint8_t macroChangeWave{0xe4U};
+	constexpr static uint8_t macroJump{0xe7U};
+	constexpr static uint8_t macroSustain{0xe8U};
+	constexpr static uint8_t macroSamplePack{0xe9U};
+	constexpr static uint8_t macroSlide{0xeaU};
+	// A transpose with this bit set is a fixed note rather than relative to the one played
+	constexpr static uint8_t fixedNote{0x80U};
+	// Info byte bits - the rest is the instrument
+	constexpr static uint8_t infoPortamento{0x80U};
+	constexpr static uint8_t infoInstrument{0x3fU};
+	// Portamento parameters slide down in pitch when this bit is set, and up otherwise
+	constexpr static uint8_t portamentoDown{0x20U};
+	constexpr static uint8_t portamentoSpeed{0x1fU};
+	// Macros that only jump about without ever getting to a value would otherwise hang the voice
+	constexpr static size_t maxMacroCommands{fc1xMacroLength};
+	constexpr static uint8_t maxVolume{64U};
+
+	// The lengths of FC1.3's waveforms in words: 32 pulse swept triangles, 8 pulses, then an assortment
+	constexpr static std::array<uint8_t, fc1xBuiltinWaves> builtinWaveLengths
+	{{
+		16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U,
+		16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U, 16U,
+		8U, 8U, 8U, 8U, 8U, 8U, 8U, 8U, 16U, 8U, 16U, 16U, 8U, 8U, 24U
+	}};
+	// The waveforms themselves, one after the other, as signed 8-bit PCM. Each of the first 32 takes one more byte
+	// of the first one down - its second half by 127, then its first half to the bottom.
+	constexpr static std::array<int8_t, 1344U> builtinWaveData
+	{{
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		63, 55, 47, 39, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, 55, 47, 39, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, 47, 39, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, 39, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, 7, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -1, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, 7, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, 15, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, 23, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, 31, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, 39, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, 47, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, 55,
+		-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, 0, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -8, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -16, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -24, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -32, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -40, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -48, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -56,
+		-64, -72, -80, -88, -96, -104, -112, -120, -128, -120, -112, -104, -96, -88, -80, -72,
+		-128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, -128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -128, -128, -128, -128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127,
+		-128, -120, -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8,
+		0, 8, 16, 24, 32, 40, 48, 56, 64, 72, 80, 88, 96, 104, 112, 120,
+		-128, -112, -96, -80, -64, -48, -32, -16, 0, 16, 32, 48, 64, 80, 96, 112,
+		69, 69, 121, 125, 122, 119, 112, 102, 97, 88, 83, 77, 44, 32, 24, 18,
+		4, -37, -45, -51, -58, -68, -75, -82, -88, -93, -99, -103, -109, -114, -117, -118,
+		69, 69, 121, 125, 122, 119, 112, 102, 91, 75, 67, 55, 44, 32, 24, 18,
+		4, -8, -24, -37, -49, -58, -66, -80, -88, -92, -98, -102, -107, -108, -115, -125,
+		0, 0, 64, 96, 127, 96, 64, 32, 0, -32, -64, -96, -128, -96, -64, -32,
+		-128, -128, -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8,
+		-128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+		-128, -128, -128, -128, -128, -128, -128, -128, 127, 127, 127, 127, 127, 127, 127, 127,
+		127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127, 127
+	}};
+} // namespace libAudio::fc1x
+
+using namespace libAudio::fc1x;
+
+fc1xStep_t fc1xSong_t::step(const size_t index, const size_t voice) const noexcept
+{
+	const size_t offset{(index * fc1xStepLength) + (voice * 3U)};
+	if (index >= steps() || voice >= fc1xVoices)
+		return {};
+	return {sequence[offset], int8_t(sequence[offset + 1U]), int8_t(sequence[offset + 2U])};
+}
+
+uint8_t fc1xSong_t::speed(const size_t index) const noexcept
+	{ return index < steps() ? sequence[(index * fc1xStepLength) + (fc1xVoices * 3U)] : 0U; }
+
+uint8_t fc1xSong_t::note(const uint8_t pattern, const size_t row) const noexcept
+{
+	const size_t offset{(size_t{pattern} * fc1xPatternLength) + (row * 2U)};
+	return row < fc1xPatternRows && offset < patterns.size() ? patterns[offset] : 0U;
+}
+
+uint8_t fc1xSong_t::info(const uint8_t pattern, const size_t row) const noexcept
+{
+	const size_t offset{(size_t{pattern} * fc1xPatternLength) + (row * 2U) + 1U};
+	return row < fc1xPatternRows && offset < patterns.size() ? patterns[offset] : 0U;
+}
+
+bool fc1xSong_t::hasInstrument(const uint8_t instrument) const noexcept
+	{ return (size_t{instrument} + 1U) * fc1xMacroLength <= volumeMacros.size(); }
+
+uint8_t fc1xSong_t::frequencyMacro(const uint8_t macro, const uint8_t position) const noexcept
+{
+	const size_t offset{(size_t{macro} * fc1xMacroLength) + position};
+	return position < fc1xMacroLength && offset < frequencyMacros.size() ? frequencyMacros[offset] : macroEnd;
+}
+
+uint8_t fc1xSong_t::volumeMacro(const uint8_t macro, const uint8_t position) const noexcept
+{
+	const size_t offset{(size_t{macro} * fc1xMacroLength) + position};
+	return position < fc1xMacroLength && offset < volumeMacros.size() ? volumeMacros[offset] : macroEnd;
+}
+
+void fc1xVoice_t::row(const fc1xSong_t &song, const uint8_t patternNote, const uint8_t info, const uint8_t nextInfo,
+	const fc1xStep_t &step) noexcept
+{
+	if (patternNote)
+		play(song, uint8_t(patternNote + step.transpose), uint8_t((info & infoInstrument) + step.soundTranspose));
+	// Portamento takes its parameter from the info byte of the row after, and a note without it stops any going
+	if (info & infoPortamento)
+		portamentoParam = nextInfo;
+	else if (patternNote)
+		portamentoParam = 0U;
+}
+
+void fc1xVoice_t::play(const fc1xSong_t &song, const uint8_t playNote, const uint8_t instrument) noexcept
+{
+	active = song.hasInstrument(instrument);
+	note = playNote & 0x7fU;
+	transpose = 0U;
+	volumeMacro = instrument;
+	volumeSpeed = std::max<uint8_t>(song.volumeMacro(instrument, 0U), 1U);
+	// Run the volume macro on the note's first tick
+	volumeCounter = 1U;
+	volumePosition = fc1xVolumeHeader;
+	volumeSustain = 0U;
+	volumeSlideTime = 0U;
+	volumeSlideTick = false;
+	frequencyMacro = song.volumeMacro(instrument, 1U);
+	frequencyPosition = 0U;
+	frequencySustain = 0U;
+	vibratoSpeed = song.volumeMacro(instrument, 2U);
+	vibratoDepth = song.volumeMacro(instrument, 3U);
+	vibratoDelay = song.volumeMacro(instrument, 4U);
+	vibratoPosition = vibratoDepth;
+	vibratoFalling = false;
+	bendTime = 0U;
+	bendTick = false;
+	bend = 0;
+	portamentoTick = false;
+	portamento = 0;
+	if (!active)
+	{
+		level = 0U;
+		currentPeriod = 0U;
+	}
+	waveChange = fc1xWaveChange_t::restart;
+}
+
+void fc1xVoice_t::stepFrequencyMacro(const fc1xSong_t &song) noexcept
+{
+	if (frequencySustain)
+	{
+		--frequencySustain;
+		return;
+	}
+	for (size_t commands{}; commands < maxMacroCommands; ++commands)
+	{
+		const auto value{song.frequencyMacro(frequencyMacro, frequencyPosition)};
+		const auto param{song.frequencyMacro(frequencyMacro, uint8_t(frequencyPosition + 1U))};
+		switch (value)
+		{
+			case macroEnd:
+				return;
+			case macroLoop:
+				frequencyPosition = param & 0x3fU;
+				break;
+			case macroJump:
+				frequencyMacro = param;
+				frequencyPosition = 0U;
+				break;
+			case macroSetWave:
+				waveIndex = param;
+				subSampleIndex = fc1xNoSubSample;
+				waveChange = fc1xWaveChange_t::restart;
+				frequencyPosition += 2U;
+				break;
+			// Picks out one of the sub-samples of the sample pack in the sample given
+			case macroSamplePack:
+				waveIndex = param;
+				subSampleIndex = song.frequencyMacro(frequencyMacro, uint8_t(frequencyPosition + 2U));
+				waveChange = fc1xWaveChange_t::restart;
+				frequencyPosition += 3U;
+				break;
+			case macroChangeWave:
+				waveIndex = param;
+				subSampleIndex = fc1xNoSubSample;
+				if (waveChange == fc1xWaveChange_t::none)
+					waveChange = fc1xWaveChange_t::change;
+				frequencyPosition += 2U;
+				break;
+			case macroVibrato:
+				vibratoSpeed = param;
+				vibratoDepth = song.frequencyMacro(frequencyMacro, uint8_t(frequencyPosition + 2U));
+				vibratoPosition = vibratoDepth;
+				vibratoFalling = false;
+				frequencyPosition += 3U;
+				break;
+			case macroSlide:
+				bendSpeed = int8_t(param);
+				bendTime = song.frequencyMacro(frequencyMacro, uint8_t(frequencyPosition + 2U));
+				bendTick = false;
+				frequencyPosition += 3U;
+				break;
+			case macroSustain:
+				frequencySustain = param;
+				frequencyPosition += 2U;
+				return;
+			default:
+				transpose = value;
+				++frequencyPosition;
+				return;
+		}
+	}
+}
+
+void fc1xVoice_t::stepVolumeMacro(const fc1xSong_t &song) noexcept
+{
+	if (volumeSustain)
+	{
+		--volumeSustain;
+		return;
+	}
+	if (volumeSlideTime)
+	{
+		volumeSlideTick = !volumeSlideTick;
+		if (volumeSlideTick)
+		{
+			--volumeSlideTime;
+			level = uint8_t(std::clamp<int32_t>(level + volumeSlideSpeed, 0, maxVolume));
+		}
+		return;
+	}
+	if (--volumeCounter)
+		return;
+	volumeCounter = volumeSpeed;
+	for (size_t commands{}; commands < maxMacroCommands; ++commands)
+	{
+		const auto value{song.volumeMacro(volumeMacro, volumePosition)};
+		const auto param{song.volumeMacro(volumeMacro, uint8_t(volumePosition + 1U))};
+		switch (value)
+		{
+			case macroEnd:
+				return;
+			case macroLoop:
+				volumePosition = std::max<uint8_t>(param & 0x3fU, fc1xVolumeHeader);
+				break;
+			case macroSustain:
+				volumeSustain = param;
+				volumePosition += 2U;
+				return;
+			case macroSlide:
+				volumeSlideSpeed = int8_t(param);
+				volumeSlideTime = song.volumeMacro(volumeMacro, uint8_t(volumePosition + 2U));
+				volumeSlideTick = false;
+				volumePosition += 3U;
+				return;
+			default:
+				level = std::min(value, maxVolume);
+				++volumePosition;
+				return;
+		}
+	}
+}
+
+// The vibrato is doubled for every octave the note is below the top one, so it's the same interval at any pitch
+int32_t fc1xVoice_t::vibrato(const uint16_t period) noexcept
+{
+	if (vibratoDelay)
+	{
+		--vibratoDelay;
+		return 0;
+	}
+	const uint16_t range{uint16_t(vibratoDepth * 2U)};
+	if (vibratoFalling)
+	{
+		if (vibratoPosition <= vibratoSpeed)
+		{
+			vibratoPosition = 0U;
+			vibratoFalling = false;
+		}
+		else
+			vibratoPosition -= vibratoSpeed;
+	}
+	else
+	{
+		if (vibratoPosition + vibratoSpeed >= range)
+		{
+			vibratoPosition = range;
+			vibratoFalling = true;
+		}
+		else
+			vibratoPosition += vibratoSpeed;
+	}
+	int32_t offset{int32_t(vibratoPosition) - vibratoDepth};
+	for (uint32_t octave{fc1xMinPeriod * 2U}; octave <= period; octave <<= 1U)
+		offset *= 2;
+	return offset;
+}
+
+void fc1xVoice_t::tick(const fc1xSong_t &song) noexcept
+{
+	if (!active)
+		return;
+	stepFrequencyMacro(song);
+	stepVolumeMacro(song);
+
+	uint8_t index{transpose};
+	if (!(index & fixedNote))
+		index += note;
+	const uint16_t notePeriod{periods[index & 0x7fU]};
+	if (portamentoParam)
+	{
+		portamentoTick = !portamentoTick;
+		if (portamentoTick)
+		{
+			const int16_t speed = portamentoParam & portamentoSpeed;
+			portamento += portamentoParam & portamentoDown ? speed : -speed;
+		}
+	}
+	if (bendTime)
+	{
+		bendTick = !bendTick;
+		if (bendTick)
+		{
+			--bendTime;
+			bend += bendSpeed;
+		}
+	}
+	const int32_t period{notePeriod + portamento - bend + vibrato(notePeriod)};
+	currentPeriod = uint16_t(std::clamp<int32_t>(period, fc1xMinPeriod, fc1xMaxPeriod));
+}
+
+uint32_t fc1xBuiltinWaveLength(const uint8_t wave) noexcept
+	{ return wave < fc1xBuiltinWaves ? uint32_t{builtinWaveLengths[wave]} * 2U : 0U; }
+
+const int8_t *fc1xBuiltinWave(const uint8_t wave) noexcept
+{
+	if (wave >= fc1xBuiltinWaves)
+		return nullptr;
+	size_t offset{};
+	for (uint8_t i{}; i < wave; ++i)
+		offset += fc1xBuiltinWaveLength(i);
+	return builtinWaveData.data() + offset;
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Sequencing of Future Composer 1.3 and 1.4 voices, whose volume and frequency macros decide what's heard every tick
+#ifndef LIBAUDIO_MODULEMIXER_FC1X_HXX
+#define LIBAUDIO_MODULEMIXER_FC1X_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <substrate/fixed_vector>
+
+using substrate::fixedVector_t;
+
+// Each step of the sequence gives every voice a pattern, a note transpose and an instrument transpose, then the speed
+constexpr static inline size_t fc1xVoices{4U};
+constexpr static inline size_t fc1xStepLength{13U};
+// Patterns are 32 rows of a note byte and an info byte per voice
+constexpr static inline size_t fc1xPatternRows{32U};
+constexpr static inline size_t fc1xPatternLength{fc1xPatternRows * 2U};
+constexpr static inline uint8_t fc1xPatternEnd{0x49U};
+// Both kinds of macro are 64 bytes long, with volume macros starting on a 5 byte header
+constexpr static inline size_t fc1xMacroLength{64U};
+constexpr static inline uint8_t fc1xVolumeHeader{5U};
+// The first 10 waves a macro can pick are the song's samples, the rest are its waveforms
+constexpr static inline uint8_t fc1xSamples{10U};
+// FC1.3 has its waveforms built into the replayer, where FC1.4 files carry up to 80 of their own
+constexpr static inline uint8_t fc1xBuiltinWaves{47U};
+constexpr static inline uint8_t fc1xMaxWaves{80U};
+// FC1.4 sample packs hold up to 20 sub-samples, after a "SSMP" tag and a 16 byte entry for each saying where it is
+constexpr static inline uint8_t fc1xPackSamples{20U};
+constexpr static inline size_t fc1xPackEntryLength{16U};
+constexpr static inline size_t fc1xPackHeader{4U + (fc1xPackSamples * fc1xPackEntryLength)};
+constexpr static inline uint8_t fc1xNoSubSample{0xffU};
+// The highest and lowest Amiga periods a voice can play at
+constexpr static inline uint16_t fc1xMinPeriod{113U};
+constexpr static inline uint16_t fc1xMaxPeriod{3424U};
+
+struct fc1xStep_t final
+{
+	uint8_t pattern{};
+	int8_t transpose{};
+	int8_t soundTranspose{};
+};
+
+// The song data as read from the file, which voices read their macros out of as they play
+struct fc1xSong_t final
+{
+	fixedVector_t<uint8_t> sequence;
+	fixedVector_t<uint8_t> patterns;
+	fixedVector_t<uint8_t> frequencyMacros;
+	fixedVector_t<uint8_t> volumeMacros;
+
+	[[nodiscard]] size_t steps() const noexcept { return sequence.size() / fc1xStepLength; }
+	[[nodiscard]] fc1xStep_t step(size_t index, size_t voice) const noexcept;
+	// The speed the step sets, or 0 if it leaves the speed alone
+	[[nodiscard]] uint8_t speed(size_t index) const noexcept;
+	// Patterns past the end of the data read as empty
+	[[nodiscard]] uint8_t note(uint8_t pattern, size_t row) const noexcept;
+	[[nodiscard]] uint8_t info(uint8_t pattern, size_t row) const noexcept;
+	[[nodiscard]] bool hasInstrument(uint8_t instrument) const noexcept;
+	// Macros read as ended anywhere past the end of the data
+	[[nodiscard]] uint8_t frequencyMacro(uint8_t macro, uint8_t position) const noexcept;
+	[[nodiscard]] uint8_t volumeMacro(uint8_t macro, uint8_t position) const noexcept;
+};
+
+// What a tick did to the wave a voice plays
+enum class fc1xWaveChange_t : uint8_t
+{
+	none,
+	// The voice moves on to the new wave from where it is
+	change,
+	// The voice starts its wave over from the beginning
+	restart
+};
+
+struct fc1xVoice_t final
+{
+private:
+	bool active{false};
+	// The note played, with the step's transpose applied, and the last transpose the frequency macro gave
+	uint8_t note{};
+	uint8_t transpose{};
+	uint8_t frequencyMacro{};
+	uint8_t frequencyPosition{};
+	uint8_t frequencySustain{};
+	uint8_t volumeMacro{};
+	uint8_t volumePosition{};
+	uint8_t volumeSpeed{};
+	uint8_t volumeCounter{};
+	uint8_t volumeSustain{};
+	int8_t volumeSlideSpeed{};
+	uint8_t volumeSlideTime{};
+	bool volumeSlideTick{false};
+	uint8_t level{};
+	// The vibrato runs as a triangle from 0 to twice its depth, centred on the note
+	uint8_t vibratoSpeed{};
+	uint8_t vibratoDepth{};
+	uint8_t vibratoDelay{};
+	uint16_t vibratoPosition{};
+	bool vibratoFalling{false};
+	// Pitch bends and portamento both step every other tick, building up an offset to the note's period
+	int8_t bendSpeed{};
+	uint8_t bendTime{};
+	bool bendTick{false};
+	int16_t bend{};
+	uint8_t portamentoParam{};
+	bool portamentoTick{false};
+	int16_t portamento{};
+	uint8_t waveIndex{};
+	// Which of the sub-samples in the sample pack waveIndex names is played, if it's played as a pack
+	uint8_t subSampleIndex{fc1xNoSubSample};
+	fc1xWaveChange_t waveChange{fc1xWaveChange_t::none};
+	uint16_t currentPeriod{};
+
+	void stepFrequencyMacro(const fc1xSong_t &song) noexcept;
+	void stepVolumeMacro(const fc1xSong_t &song) noexcept;
+	[[nodiscard]] int32_t vibrato(uint16_t period) noexcept;
+
+public:
+	// Takes on a row of the voice's pattern
+	void row(const fc1xSong_t &song, uint8_t patternNote, uint8_t info, uint8_t nextInfo, const fc1xStep_t &step) noexcept;
+	// Starts a note on an instrument, which restarts both macros
+	void play(const fc1xSong_t &song, uint8_t note, uint8_t instrument) noexcept;
+	// Runs the macros and pitch effects on for a tick
+	void tick(const fc1xSong_t &song) noexcept;
+
+	[[nodiscard]] bool playing() const noexcept { return active; }
+	// The Amiga period to play at, which is 0 while the voice has nothing to play
+	[[nodiscard]] uint16_t period() const noexcept { return currentPeriod; }
+	// 0 to 64, as on the Amiga
+	[[nodiscard]] uint8_t volume() const noexcept { return level; }
+	[[nodiscard]] uint8_t wave() const noexcept { return waveIndex; }
+	// fc1xNoSubSample unless the wave was picked out of a sample pack
+	[[nodiscard]] uint8_t subSample() const noexcept { return subSampleIndex; }
+	// Hands over what has happened to the wave since it was last asked, so each change gets acted on once
+	[[nodiscard]] fc1xWaveChange_t takeWaveChange() noexcept
+	{
+		const auto change{waveChange};
+		waveChange = fc1xWaveChange_t::none;
+		return change;
+	}
+};
+
+// Gives the length in bytes of one of FC1.3's waveforms, and the replayer's data for it
+[[nodiscard]] uint32_t fc1xBuiltinWaveLength(uint8_t wave) noexcept;
+[[nodiscard]] const int8_t *fc1xBuiltinWave(uint8_t wave) noexcept;
+
+#endif /*LIBAUDIO_MODULEMIXER_FC1X_HXX*/
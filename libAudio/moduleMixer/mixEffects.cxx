@@ -0,0 +1,262 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cmath>
+#include <algorithm>
+#include "mixEffects.hxx"
+
+namespace libAudio::mixEffects
+{
+	// Freeverb's tunings, which are in samples at 44.1kHz. The right channel's lines are longer by a
+	// stereo spread so the two channels' reverb doesn't correlate.
+	constexpr static std::array<uint32_t, 8> combTuning{{1116U, 1188U, 1277U, 1356U, 1422U, 1491U, 1557U, 1617U}};
+	constexpr static std::array<uint32_t, 4> allPassTuning{{556U, 441U, 341U, 225U}};
+	constexpr static uint32_t stereoSpread{23U};
+	constexpr static uint32_t tuningRate{44100U};
+	// Freeverb's input gain of 0.015 in 16-bit fixed point
+	constexpr static int64_t reverbInputGain{983};
+	// Its damping of 0.2, and room sizes mapping onto feedbacks of 0.7 to 0.98, all in 15-bit fixed point
+	constexpr static int32_t combDamping{6554};
+	constexpr static int32_t combFeedbackMin{22938};
+	constexpr static int32_t combFeedbackRange{9175};
+
+	// Pro Logic decoders only steer 100Hz to 7kHz to the rear
+	constexpr static uint32_t surroundHighPassFrequency{100U};
+	constexpr static uint32_t surroundLowPassFrequency{7000U};
+	constexpr static uint8_t surroundDelayMin{5U};
+	constexpr static uint8_t surroundDelayMax{40U};
+
+	constexpr static uint8_t bassCutoffMin{20U};
+	constexpr static uint8_t bassCutoffMax{200U};
+	constexpr static uint8_t depthMax{100U};
+
+	// Turns a 0-100 depth into an 8-bit fixed point gain of 0 to 1
+	inline int32_t depthGain(const uint8_t depth) noexcept
+		{ return (int32_t{depth} * 256) / depthMax; }
+
+	inline size_t scaleTuning(const uint32_t length, const uint32_t sampleRate) noexcept
+		{ return std::max<size_t>((uint64_t{length} * sampleRate) / tuningRate, 1U); }
+} // namespace libAudio::mixEffects
+
+using namespace libAudio::mixEffects;
+
+void onePole_t::configure(const uint32_t frequency, const uint32_t sampleRate) noexcept
+{
+	constexpr auto pi{3.14159265358979323846};
+	if (!sampleRate)
+	{
+		coefficient = 0;
+		return;
+	}
+	const auto limitedFrequency{std::min(frequency, sampleRate / 2U)};
+	coefficient = static_cast<int32_t>(std::lround(65536.0 *
+		(1.0 - std::exp((-2.0 * pi * double(limitedFrequency)) / double(sampleRate)))));
+}
+
+void onePole_t::process(int32_t *const samples, const size_t count) noexcept
+{
+	auto value{state};
+	for (size_t i{}; i < count; ++i)
+	{
+		value += static_cast<int32_t>(((int64_t{samples[i]} - value) * coefficient) >> 16);
+		samples[i] = value;
+	}
+	state = value;
+}
+
+void reverbComb_t::process(const int32_t *const input, int32_t *const output, const size_t count,
+	const int32_t feedback) noexcept
+{
+	auto filtered{damped};
+	for (size_t i{}; i < count; ++i)
+	{
+		const auto sample{delay.buffer[delay.position]};
+		filtered = static_cast<int32_t>(((int64_t{sample} * (32768 - combDamping)) +
+			(int64_t{filtered} * combDamping)) >> 15);
+		static_cast<void>(delay.exchange(input[i] + static_cast<int32_t>((int64_t{filtered} * feedback) >> 15)));
+		output[i] += sample;
+	}
+	damped = filtered;
+}
+
+void reverbAllPass_t::process(int32_t *const samples, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+	{
+		const auto input{samples[i]};
+		const auto delayed{delay.buffer[delay.position]};
+		static_cast<void>(delay.exchange(input + (delayed >> 1)));
+		samples[i] = delayed - input;
+	}
+}
+
+bool mixEffects_t::configure(const moduleEffects_t &effects, const uint32_t rate) noexcept
+{
+	moduleEffects_t newSettings{effects};
+	newSettings.reverbDepth = std::min(newSettings.reverbDepth, depthMax);
+	newSettings.reverbRoomSize = std::min(newSettings.reverbRoomSize, depthMax);
+	newSettings.surroundDepth = std::min(newSettings.surroundDepth, depthMax);
+	newSettings.surroundDelay = std::clamp(newSettings.surroundDelay, surroundDelayMin, surroundDelayMax);
+	newSettings.bassDepth = std::min(newSettings.bassDepth, depthMax);
+	newSettings.bassCutoff = std::clamp(newSettings.bassCutoff, bassCutoffMin, bassCutoffMax);
+	if (newSettings == settings && rate == sampleRate)
+		return true;
+
+	// Work out how much room the delay lines need in total, and allocate it before touching anything
+	std::array<std::array<size_t, combs>, 2> combLengths{};
+	std::array<std::array<size_t, allPasses>, 2> allPassLengths{};
+	size_t surroundLength{};
+	size_t length{};
+	if (rate && newSettings.reverbDepth)
+	{
+		for (size_t channel{}; channel < 2U; ++channel)
+		{
+			const auto spread{channel ? stereoSpread : 0U};
+			for (size_t comb{}; comb < combs; ++comb)
+				length += combLengths[channel][comb] = scaleTuning(combTuning[comb] + spread, rate);
+			for (size_t allPass{}; allPass < allPasses; ++allPass)
+				length += allPassLengths[channel][allPass] = scaleTuning(allPassTuning[allPass] + spread, rate);
+		}
+	}
+	if (rate && newSettings.surroundDepth)
+		length += surroundLength = std::max<size_t>((size_t{rate} * newSettings.surroundDelay) / 1000U, 1U);
+	fixedVector_t<int32_t> newArena{};
+	if (length)
+	{
+		newArena = fixedVector_t<int32_t>{length};
+		if (!newArena.valid())
+			return false;
+	}
+
+	settings = newSettings;
+	sampleRate = rate;
+	arena = std::move(newArena);
+	int32_t *storage{arena.data()};
+	const auto slice{[&](delayLine_t &delay, const size_t delayLength) noexcept
+	{
+		delay = {delayLength ? storage : nullptr, delayLength, 0U};
+		storage += delayLength;
+	}};
+	for (size_t channel{}; channel < 2U; ++channel)
+	{
+		for (size_t comb{}; comb < combs; ++comb)
+			slice(reverbCombs[channel][comb].delay, combLengths[channel][comb]);
+		for (size_t allPass{}; allPass < allPasses; ++allPass)
+			slice(reverbAllPasses[channel][allPass].delay, allPassLengths[channel][allPass]);
+	}
+	slice(surroundDelay, surroundLength);
+
+	reverbFeedback = combFeedbackMin + ((combFeedbackRange * settings.reverbRoomSize) / depthMax);
+	reverbGain = depthGain(settings.reverbDepth);
+	surroundHighPass.configure(surroundHighPassFrequency, rate);
+	surroundLowPass.configure(surroundLowPassFrequency, rate);
+	surroundGain = depthGain(settings.surroundDepth);
+	for (auto &filter : bassLowPass)
+		filter.configure(settings.bassCutoff, rate);
+	bassGain = depthGain(settings.bassDepth);
+	reset();
+	return true;
+}
+
+void mixEffects_t::reset() noexcept
+{
+	std::fill(arena.begin(), arena.end(), 0);
+	for (auto &channel : reverbCombs)
+	{
+		for (auto &comb : channel)
+		{
+			comb.delay.position = 0U;
+			comb.damped = 0;
+		}
+	}
+	for (auto &channel : reverbAllPasses)
+	{
+		for (auto &allPass : channel)
+			allPass.delay.position = 0U;
+	}
+	surroundDelay.position = 0U;
+	surroundHighPass.state = surroundLowPass.state = 0;
+	for (auto &filter : bassLowPass)
+		filter.state = 0;
+}
+
+/*!
+ * The effects run one after another over each block rather than all together a frame at a time. That keeps
+ * each filter's state in registers for the length of a block, and leaves the passes that aren't recurrences
+ * as plain loops over contiguous arrays, which the compiler can vectorise.
+ */
+void mixEffects_t::process(int32_t *const buffer, const size_t frames) noexcept
+{
+	if (!sampleRate)
+		return;
+	for (size_t offset{}; offset < frames; offset += effectBlockFrames)
+	{
+		const auto count{std::min(frames - offset, effectBlockFrames)};
+		int32_t *const block{buffer + (offset * 2U)};
+		if (settings.reverbDepth)
+			reverb(block, count);
+		if (settings.surroundDepth)
+			surround(block, count);
+		if (settings.bassDepth)
+			bassExpansion(block, count);
+	}
+}
+
+// Freeverb, fed from the mono sum of the mix, with its wet output mixed back in over the top
+void mixEffects_t::reverb(int32_t *const buffer, const size_t frames) noexcept
+{
+	for (size_t i{}; i < frames; ++i)
+		input[i] = static_cast<int32_t>(((int64_t{buffer[i * 2U]} + buffer[(i * 2U) + 1U]) * reverbInputGain) >> 16);
+	for (size_t channel{}; channel < 2U; ++channel)
+	{
+		auto &wet{output[channel]};
+		std::fill_n(wet.begin(), frames, 0);
+		for (auto &comb : reverbCombs[channel])
+			comb.process(input.data(), wet.data(), frames, reverbFeedback);
+		for (auto &allPass : reverbAllPasses[channel])
+			allPass.process(wet.data(), frames);
+		for (size_t i{}; i < frames; ++i)
+			buffer[(i * 2U) + channel] += static_cast<int32_t>((int64_t{wet[i]} * reverbGain) >> 8);
+	}
+}
+
+/*!
+ * Matrix encodes the difference between the channels into the rear the way Dolby Surround does, so a Pro Logic
+ * decoder steers it to the rear speakers. The difference is band limited to what the decoder steers, delayed so it
+ * arrives after the front, and then added to the left channel and taken from the right, putting it out of phase.
+ */
+void mixEffects_t::surround(int32_t *const buffer, const size_t frames) noexcept
+{
+	auto &lowFrequencies{output[0]};
+	for (size_t i{}; i < frames; ++i)
+		input[i] = static_cast<int32_t>((int64_t{buffer[i * 2U]} - buffer[(i * 2U) + 1U]) >> 1);
+	// Taking away what makes it through the low-pass high-passes the difference
+	std::copy_n(input.begin(), frames, lowFrequencies.begin());
+	surroundHighPass.process(lowFrequencies.data(), frames);
+	for (size_t i{}; i < frames; ++i)
+		input[i] -= lowFrequencies[i];
+	surroundLowPass.process(input.data(), frames);
+	for (size_t i{}; i < frames; ++i)
+		input[i] = surroundDelay.exchange(input[i]);
+	for (size_t i{}; i < frames; ++i)
+	{
+		const auto rear{static_cast<int32_t>((int64_t{input[i]} * surroundGain) >> 8)};
+		buffer[i * 2U] += rear;
+		buffer[(i * 2U) + 1U] -= rear;
+	}
+}
+
+// Adds a low-passed copy of the mono sum back to both channels, boosting everything below the cutoff
+void mixEffects_t::bassExpansion(int32_t *const buffer, const size_t frames) noexcept
+{
+	for (size_t i{}; i < frames; ++i)
+		input[i] = static_cast<int32_t>((int64_t{buffer[i * 2U]} + buffer[(i * 2U) + 1U]) >> 1);
+	// Two poles for a steeper roll off
+	for (auto &filter : bassLowPass)
+		filter.process(input.data(), frames);
+	for (size_t i{}; i < frames; ++i)
+	{
+		const auto bass{static_cast<int32_t>((int64_t{input[i]} * bassGain) >> 8)};
+		buffer[i * 2U] += bass;
+		buffer[(i * 2U) + 1U] += bass;
+	}
+}
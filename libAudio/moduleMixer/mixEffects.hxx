@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Effects run over the stereo mix of a module before it is converted to the output format
+#ifndef LIBAUDIO_MODULEMIXER_MIXEFFECTS_HXX
+#define LIBAUDIO_MODULEMIXER_MIXEFFECTS_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <substrate/fixed_vector>
+#include "../libAudio.hxx"
+
+using substrate::fixedVector_t;
+
+// The effects work through the mix this many frames at a time, so their scratch space never needs allocating
+constexpr static inline size_t effectBlockFrames{256U};
+
+// A one-pole low-pass filter, with its coefficient in 16-bit fixed point
+struct onePole_t final
+{
+	int32_t coefficient{};
+	int32_t state{};
+
+	void configure(uint32_t frequency, uint32_t sampleRate) noexcept;
+	// Filters a block in place. This is a recurrence, so it runs a sample at a time
+	void process(int32_t *samples, size_t count) noexcept;
+};
+
+// A delay line made of a ring buffer, with its storage in a slice of the effects' shared arena
+struct delayLine_t final
+{
+	int32_t *buffer{};
+	size_t length{};
+	size_t position{};
+
+	// Reads the sample written length samples ago and replaces it with the new one
+	int32_t exchange(const int32_t sample) noexcept
+	{
+		const auto result{buffer[position]};
+		buffer[position] = sample;
+		if (++position == length)
+			position = 0U;
+		return result;
+	}
+};
+
+// Freeverb's lowpass-feedback comb filter
+struct reverbComb_t final
+{
+	delayLine_t delay{};
+	int32_t damped{};
+
+	void process(const int32_t *input, int32_t *output, size_t count, int32_t feedback) noexcept;
+};
+
+// Freeverb's Schroeder all-pass filter
+struct reverbAllPass_t final
+{
+	delayLine_t delay{};
+
+	void process(int32_t *samples, size_t count) noexcept;
+};
+
+struct mixEffects_t final
+{
+private:
+	constexpr static size_t combs{8U};
+	constexpr static size_t allPasses{4U};
+
+	moduleEffects_t settings{};
+	uint32_t sampleRate{};
+	// Every delay line lives in here, so a change of settings is the only time anything gets allocated
+	fixedVector_t<int32_t> arena{};
+
+	// Reverb
+	std::array<std::array<reverbComb_t, combs>, 2> reverbCombs{};
+	std::array<std::array<reverbAllPass_t, allPasses>, 2> reverbAllPasses{};
+	int32_t reverbFeedback{};
+	int32_t reverbGain{};
+	// Surround, where the high-pass is made by taking the output of a low-pass away from its input
+	onePole_t surroundHighPass{};
+	onePole_t surroundLowPass{};
+	delayLine_t surroundDelay{};
+	int32_t surroundGain{};
+	// Bass expansion
+	std::array<onePole_t, 2> bassLowPass{};
+	int32_t bassGain{};
+
+	// Scratch space for one block
+	std::array<int32_t, effectBlockFrames> input{};
+	std::array<std::array<int32_t, effectBlockFrames>, 2> output{};
+
+	void reverb(int32_t *buffer, size_t frames) noexcept;
+	void surround(int32_t *buffer, size_t frames) noexcept;
+	void bassExpansion(int32_t *buffer, size_t frames) noexcept;
+
+public:
+	// Sets up the effects for the settings at the given mix rate, returning false if the delay lines can't be had
+	[[nodiscard]] bool configure(const moduleEffects_t &effects, uint32_t rate) noexcept;
+	// Clears out everything the effects remember of the mix so far, such as reverb tails
+	void reset() noexcept;
+	[[nodiscard]] const moduleEffects_t &effects() const noexcept { return settings; }
+	[[nodiscard]] bool active() const noexcept
+		{ return settings.reverbDepth || settings.surroundDepth || settings.bassDepth; }
+	// Runs the effects over frames of stereo mix in place
+	void process(int32_t *buffer, size_t frames) noexcept;
+};
+
+#endif /*LIBAUDIO_MODULEMIXER_MIXEFFECTS_HXX*/
@@ -5,8 +5,14 @@
 #define LIBAUDIO_MODULEMIXER_MIXFUNCTIONS_H 1
 
 #include <cstdint>
+#include <cstdlib>
+#include <cmath>
 #include <array>
-#include <utility>
+#include <memory>
+#include <algorithm>
+#include "moduleMixer.h"
+#include "samplePCM.hxx"
+#include "resonantFilter.hxx"
 
 typedef void (*MixInterface)(channel_t *, int *, int *);
 
@@ -80,7 +86,7 @@ const std::array<int16_t, 1024> FastSinc
    -1,   135, 16374,  -124,    -1,   100, 16378,   -93,     0,    65, 16381,   -63,     0,    32, 16383,   -31,
 }};
 
-double zero(double y)
+inline double zero(double y)
 {
 	double s = 1;
 	double ds = 1;
@@ -96,11 +102,13 @@ double zero(double y)
 	return s;
 }
 
-void getsinc(short **p_Sinc, double Beta, double LowPassFactor)
+inline void getsinc(short **p_Sinc, double Beta, double LowPassFactor)
 {
 	double ZeroBeta = zero(Beta);
 	double LPAt = 4.0 * atan(1.0) * LowPassFactor;
 	short *Sinc = *p_Sinc = (short *)malloc(sizeof(short) * syncPhases * 8);
+	if (!Sinc)
+		return;
 	for (uint32_t i = 0; i < 8U * syncPhases; i++)
 	{
 		double FSinc;
@@ -110,7 +118,7 @@ void getsinc(short **p_Sinc, double Beta, double LowPassFactor)
 			FSinc = 1.0;
 		else
 		{
-			double y = (x - (4 * syncPhases)) * (1.0 / syncPhases);
+			double y = (x - static_cast<int>(4 * syncPhases)) * (1.0 / syncPhases);
 			FSinc = sin(y * LPAt) * zero(Beta * sqrt(1 - y * y * (1.0 / 16.0))) / (ZeroBeta * y * LPAt);
 		}
 		n = (int)(FSinc * LowPassFactor * (16384 * 256));
@@ -119,86 +127,200 @@ void getsinc(short **p_Sinc, double Beta, double LowPassFactor)
 	}
 }
 
-using samplePair_t = std::pair<int16_t, int16_t>;
-template<typename T> using sampleFn_t = samplePair_t(const T *const, const uint32_t);
-using storeFn_t = void(const channel_t &, int32_t *const , const int16_t, const int16_t,
-	uint32_t &, uint32_t &);
-
-inline samplePair_t monoSample(const int8_t *const buffer, const uint32_t position) noexcept
+// Kaiser windowed 8-tap sinc table, syncPhases phases of 8 taps each, built on first use
+inline const int16_t *windowedSinc() noexcept
 {
-	const int16_t sample = static_cast<uint16_t>(buffer[position >> 16U]) << 8U;
-	return {sample, sample};
+	static const std::unique_ptr<short [], void (*)(void *)> sincTable
+	{
+		[]() noexcept -> short *
+		{
+			short *table{nullptr};
+			getsinc(&table, 9.6377, 0.97);
+			return table;
+		}(),
+		free
+	};
+	return sincTable.get();
 }
 
-inline samplePair_t monoSample(const int16_t *const buffer, const uint32_t position) noexcept
+// The range of frames, relative to the current mixing start point, that may be read from a sample
+struct sampleWindow_t
+{
+	int32_t first;
+	int32_t last;
+
+	[[nodiscard]] int32_t clamp(const int32_t index) const noexcept
+	{
+		if (index < first)
+			return first;
+		else if (index > last)
+			return last;
+		return index;
+	}
+};
+
+// Stands in for a sampleWindow_t over the frames where the sample's guard frames make clamping the reads unnecessary
+struct guardedWindow_t
+{
+	[[nodiscard]] constexpr static int32_t clamp(const int32_t index) noexcept { return index; }
+};
+
+// The output frames [begin, end) of a mixing run, every tap of which lands inside the sample or its guard frames
+struct guardedSpan_t
+{
+	uint32_t begin;
+	uint32_t end;
+};
+
+// Whether the guard frames after the sample hold what the channel goes on to play once it reaches its end
+inline bool tailGuarded(const channel_t &channel) noexcept
 {
-	const int16_t sample{buffer[position >> 16U]};
-	return {sample, sample};
+	auto &sample{*channel.Sample};
+	if (channel.Length != sample.GetLength())
+		return false;
+	const auto loop{sample.guardLoop()};
+	if (channel.Flags & CHN_LOOP)
+		return loop.start == channel.LoopStart && loop.pingPong == ((channel.Flags & CHN_LPINGPONG) != 0U);
+	return loop.start == channel.Length;
 }
 
-inline samplePair_t monoLinearSample(const int8_t *const buffer, const uint32_t position) noexcept
+inline int64_t floorDiv(const int64_t value, const int64_t divisor) noexcept
+	{ return (value / divisor) - ((value % divisor) < 0 ? 1 : 0); }
+
+/*!
+ * Works out which of the next frames output frames of the channel can be mixed without clamping their sample reads.
+ * Below the start of the sample, the guard frames repeat its first frame just as clamping would. Past the end they
+ * hold the loop that runs to the end of the sample unrolled, or repeat the last frame if there is none, so can be
+ * read straight through when that's what the voice plays. A loop which finishes short of the end of the sample, or
+ * one other than the loop unrolled, still has to be clamped to.
+ */
+template<int32_t tapsBefore, int32_t tapsAfter> inline guardedSpan_t guardedSpan(const channel_t &channel,
+	const uint32_t frames) noexcept
 {
-	const auto positionLow{uint8_t(position >> 8U)};
-	const auto firstSample{monoSample(buffer, position).first};
-	const auto secondSample{monoSample(buffer, position + (1U << 16U)).first};
-	const auto sample{(firstSample << 7U) + (positionLow * (secondSample - firstSample))};
-	return {sample, sample};
+	const int64_t length{channel.Length};
+	const int64_t last{length - 1 + (tailGuarded(channel) ? int64_t{sampleGuard} : 0)};
+	// The 16.16 positions relative to the current one that the play position has to stay within
+	const int64_t low{((tapsBefore - int64_t{sampleGuard} - channel.Pos) * 65536) - channel.PosLo};
+	const int64_t high{((last - tapsAfter - channel.Pos + 1) * 65536) - channel.PosLo};
+	const int64_t increment{channel.increment.iValue};
+	int64_t begin{};
+	int64_t end{frames};
+	if (increment > 0)
+	{
+		begin = -floorDiv(-low, increment);
+		end = std::min(end, -floorDiv(-high, increment));
+	}
+	else if (increment < 0)
+	{
+		begin = floorDiv(-high, -increment) + 1;
+		end = std::min(end, floorDiv(-low, -increment) + 1);
+	}
+	else if (low > 0 || high <= 0)
+		end = 0;
+	begin = std::max<int64_t>(begin, 0);
+	if (begin >= end)
+		return {0U, 0U};
+	return {static_cast<uint32_t>(begin), static_cast<uint32_t>(end)};
 }
 
-inline samplePair_t monoLinearSample(const int16_t *const buffer, const uint32_t position) noexcept
+using storeFn_t = void(const channel_t &, int32_t *const , const int16_t, const int16_t,
+	uint32_t &, uint32_t &);
+
+template<size_t stride, typename window_t> inline int32_t readSample(const int16_t *const buffer, const int32_t index,
+	const window_t &window) noexcept
+	{ return buffer[window.clamp(index) * int32_t{stride}]; }
+
+inline int16_t clipSample(const int32_t sample) noexcept
 {
-	const auto positionLow{uint8_t(position >> 8U)};
-	const auto firstSample{monoSample(buffer, position).first};
-	const auto secondSample{monoSample(buffer, position + (1U << 16U)).first};
-	const auto sample{firstSample + ((positionLow * (secondSample - firstSample)) >> 9U)};
-	return {sample, sample};
+	if (sample < INT16_MIN)
+		return INT16_MIN;
+	else if (sample > INT16_MAX)
+		return INT16_MAX;
+	return static_cast<int16_t>(sample);
 }
 
-inline samplePair_t monoHighQualitySample(const int8_t *const buffer, const uint32_t position) noexcept
+template<size_t stride, typename window_t> inline int16_t nearestTap(const int16_t *const buffer,
+	const uint32_t position, const window_t &window) noexcept
+	{ return readSample<stride>(buffer, static_cast<int32_t>(position) >> 16, window); }
+
+template<size_t stride, typename window_t> inline int16_t linearTap(const int16_t *const buffer,
+	const uint32_t position, const window_t &window) noexcept
 {
-	const auto positionHigh{uint16_t(position >> 16U)};
-	const auto positionLow{uint16_t((position >> 6U) & 0x03FCU)};
-	const auto sample
-	{
-		FastSinc[positionLow]      * buffer[positionHigh - 1U] +
-		FastSinc[positionLow + 1U] * buffer[positionHigh]      +
-		FastSinc[positionLow + 2U] * buffer[positionHigh + 1U] +
-		FastSinc[positionLow + 3U] * buffer[positionHigh + 2U]
-	};
-	return {sample >> 7U, sample >> 7U};
+	const auto positionHigh{static_cast<int32_t>(position) >> 16};
+	const auto positionLow{static_cast<int32_t>((position >> 8U) & 0xFFU)};
+	const auto firstSample{readSample<stride>(buffer, positionHigh, window)};
+	const auto secondSample{readSample<stride>(buffer, positionHigh + 1, window)};
+	return firstSample + ((positionLow * (secondSample - firstSample)) >> 8);
 }
 
-inline samplePair_t monoHighQualitySample(const int16_t *const buffer, const uint32_t position) noexcept
+// 4-tap cubic spline interpolation using the FastSinc table (256 phases)
+template<size_t stride, typename window_t> inline int16_t cubicTap(const int16_t *const buffer,
+	const uint32_t position, const window_t &window) noexcept
 {
-	const auto positionHigh{uint16_t(position >> 16U)};
+	const auto positionHigh{static_cast<int32_t>(position) >> 16};
 	const auto positionLow{uint16_t((position >> 6U) & 0x03FCU)};
 	const auto sample
 	{
-		FastSinc[positionLow]      * buffer[positionHigh - 1U] +
-		FastSinc[positionLow + 1U] * buffer[positionHigh]      +
-		FastSinc[positionLow + 2U] * buffer[positionHigh + 1U] +
-		FastSinc[positionLow + 3U] * buffer[positionHigh + 2U]
+		FastSinc[positionLow]      * readSample<stride>(buffer, positionHigh - 1, window) +
+		FastSinc[positionLow + 1U] * readSample<stride>(buffer, positionHigh, window)     +
+		FastSinc[positionLow + 2U] * readSample<stride>(buffer, positionHigh + 1, window) +
+		FastSinc[positionLow + 3U] * readSample<stride>(buffer, positionHigh + 2, window)
 	};
-	return {sample >> 15U, sample >> 15U};
+	return clipSample(sample >> 14);
 }
 
-inline samplePair_t stereoSample(const int8_t *const buffer, const uint32_t position) noexcept
+// 8-tap windowed sinc interpolation (syncPhases phases)
+template<size_t stride, typename window_t> inline int16_t sincTap(const int16_t *const buffer,
+	const uint32_t position, const window_t &window, const int16_t *const sinc) noexcept
 {
-	const auto shiftedPosition{(position >> 16U) << 1U};
-	return {
-		buffer[shiftedPosition + 0] << 8U,
-		buffer[shiftedPosition + 1] << 8U,
-	};
+	const auto positionHigh{static_cast<int32_t>(position) >> 16};
+	const auto *const taps{sinc + (((position & 0xFFFFU) >> 4U) << 3U)};
+	int32_t sample{};
+	for (int32_t tap{}; tap < 8; ++tap)
+		sample += taps[tap] * readSample<stride>(buffer, positionHigh + tap - 3, window);
+	return clipSample(sample >> 14);
 }
 
-inline samplePair_t stereoSample(const int16_t *const buffer, const uint32_t position) noexcept
+// Each interpolation mode, along with how many frames either side of the play position its taps reach
+struct nearestTaps_t
 {
-	const auto shiftedPosition{(position >> 16U) << 1U};
-	return {
-		buffer[shiftedPosition + 0],
-		buffer[shiftedPosition + 1],
-	};
-}
+	constexpr static int32_t tapsBefore{0};
+	constexpr static int32_t tapsAfter{0};
+
+	template<size_t stride, typename window_t> static int16_t sample(const int16_t *const buffer,
+		const uint32_t position, const window_t &window) noexcept
+		{ return nearestTap<stride>(buffer, position, window); }
+};
+
+struct linearTaps_t
+{
+	constexpr static int32_t tapsBefore{0};
+	constexpr static int32_t tapsAfter{1};
+
+	template<size_t stride, typename window_t> static int16_t sample(const int16_t *const buffer,
+		const uint32_t position, const window_t &window) noexcept
+		{ return linearTap<stride>(buffer, position, window); }
+};
+
+struct cubicTaps_t
+{
+	constexpr static int32_t tapsBefore{1};
+	constexpr static int32_t tapsAfter{2};
+
+	template<size_t stride, typename window_t> static int16_t sample(const int16_t *const buffer,
+		const uint32_t position, const window_t &window) noexcept
+		{ return cubicTap<stride>(buffer, position, window); }
+};
+
+struct sincTaps_t
+{
+	constexpr static int32_t tapsBefore{3};
+	constexpr static int32_t tapsAfter{4};
+
+	template<size_t stride, typename window_t> static int16_t sample(const int16_t *const buffer,
+		const uint32_t position, const window_t &window) noexcept
+		{ return sincTap<stride>(buffer, position, window, windowedSinc()); }
+};
 
 inline void storeMono(const channel_t &, int32_t *const buffer,
 	const int16_t sampleL, const int16_t sampleR, uint32_t &leftVol, uint32_t &rightVol) noexcept
@@ -230,145 +352,185 @@ inline void rampStereo(const channel_t &channel, int32_t *const buffer,
 	storeStereo(channel, buffer, sampleL, sampleR, leftVol, rightVol);
 }
 
-template<typename T> inline void sampleLoop(channel_t &channel, int32_t *begin, const int32_t *const end,
-	sampleFn_t<T> sample, storeFn_t store) noexcept
+// Sample data always comes as 16-bit PCM, with stride being how many channels its frames are made of
+template<typename taps_t, size_t stride> inline void sampleLoop(channel_t &channel, int32_t *begin,
+	int32_t *const end, storeFn_t store) noexcept
 {
 	auto position{channel.PosLo};
 	const auto increment{channel.increment.iValue};
-	const auto *sampleData = reinterpret_cast<T *>(channel.SampleData) + channel.Pos;
-	if (channel.Sample->GetStereo())
-		sampleData += channel.Pos;
+	const auto *const sampleData{reinterpret_cast<const int16_t *>(channel.SampleData) + (channel.Pos * stride)};
+	const sampleWindow_t window{-static_cast<int32_t>(channel.Pos),
+		static_cast<int32_t>(channel.Length) - static_cast<int32_t>(channel.Pos) - 1};
+	const auto span{guardedSpan<taps_t::tapsBefore, taps_t::tapsAfter>(channel,
+		static_cast<uint32_t>(end - begin) / 2U)};
+	int32_t *const guardedBegin{begin + (span.begin * 2U)};
+	int32_t *const guardedEnd{begin + (span.end * 2U)};
 	uint32_t leftVol{channel.leftVol};
 	uint32_t rightVol{channel.rightVol};
-	do
+	const auto mixFrames{[&](const auto &window, const int32_t *const stop) noexcept
 	{
-		const auto samples{sample(sampleData, position)};
-		store(channel, begin, samples.first, samples.second, leftVol, rightVol);
-		begin += 2U;
-		position += increment;
-	}
-	while (begin < end);
-	channel.Pos += position >> 16U;
+		for (; begin < stop; begin += 2U)
+		{
+			const int16_t sampleL{taps_t::template sample<stride>(sampleData, position, window)};
+			const int16_t sampleR
+				{stride == 1U ? sampleL : taps_t::template sample<stride>(sampleData + 1, position, window)};
+			store(channel, begin, sampleL, sampleR, leftVol, rightVol);
+			position += increment;
+		}
+	}};
+	mixFrames(window, guardedBegin);
+	mixFrames(guardedWindow_t{}, guardedEnd);
+	mixFrames(window, end);
+	channel.Pos += static_cast<int32_t>(position) >> 16;
 	channel.PosLo = position & 0xFFFFU;
 	channel.leftVol = leftVol;
 	channel.rightVol = rightVol;
 }
 
-template<typename T> inline void sampleFilterLoop(channel_t &channel, int32_t *begin, const int32_t *const end,
-	sampleFn_t<T> sample, storeFn_t store) noexcept
+// How many frames the filtering functions interpolate, filter and then mix in one go
+constexpr static inline uint32_t filterBlockFrames{64U};
+
+// Interpolates the channel's next frames into block, stride samples to a frame, moving the play position on past them
+template<typename taps_t, size_t stride> inline void interpolateBlock(channel_t &channel, int32_t *const block,
+	const uint32_t frames) noexcept
 {
 	auto position{channel.PosLo};
 	const auto increment{channel.increment.iValue};
-	const auto *sampleData = reinterpret_cast<T *>(channel.SampleData) + channel.Pos;
-	if (channel.Sample->GetStereo())
-		sampleData += channel.Pos;
+	const auto *const sampleData{reinterpret_cast<const int16_t *>(channel.SampleData) + (channel.Pos * stride)};
+	const sampleWindow_t window{-static_cast<int32_t>(channel.Pos),
+		static_cast<int32_t>(channel.Length) - static_cast<int32_t>(channel.Pos) - 1};
+	const auto span{guardedSpan<taps_t::tapsBefore, taps_t::tapsAfter>(channel, frames)};
+	uint32_t frame{};
+	const auto interpolate{[&](const auto &window, const uint32_t stop) noexcept
+	{
+		for (; frame < stop; ++frame)
+		{
+			for (size_t sample{}; sample < stride; ++sample)
+				block[(frame * stride) + sample] = taps_t::template sample<stride>(sampleData + sample, position, window);
+			position += increment;
+		}
+	}};
+	interpolate(window, span.begin);
+	interpolate(guardedWindow_t{}, span.end);
+	interpolate(window, frames);
+	channel.Pos += static_cast<int32_t>(position) >> 16;
+	channel.PosLo = position & 0xFFFFU;
+}
+
+/*!
+ * Mixes the channel through its resonant filter a block at a time: the block gets interpolated, then filtered,
+ * then mixed in, so each stage runs as its own tight loop rather than all three being interleaved per frame
+ */
+template<typename taps_t, size_t stride> inline void sampleFilterLoop(channel_t &channel, int32_t *begin,
+	int32_t *const end, storeFn_t store) noexcept
+{
+	std::array<int32_t, filterBlockFrames * stride> block{};
+	std::array<filterState_t, stride> state{};
+	std::copy_n(channel.FilterState.begin(), stride, state.begin());
 	uint32_t leftVol{channel.leftVol};
 	uint32_t rightVol{channel.rightVol};
-	auto fltY1{channel.Filter_Y1};
-	auto fltY2{channel.Filter_Y2};
-	do
+	while (begin < end)
 	{
-		auto samples{sample(sampleData, position)};
-
-		// TODO: Figure out how this is actually supposed to work and fix it up as this is terrible.
-		auto fltY
+		const auto frames{std::min<uint32_t>(filterBlockFrames, static_cast<uint32_t>(end - begin) / 2U)};
+		interpolateBlock<taps_t, stride>(channel, block.data(), frames);
+		filterBlock(block.data(), frames, channel.FilterCoefficients, state);
+		for (uint32_t frame{}; frame < frames; ++frame, begin += 2U)
 		{
-			(samples.first * channel.Filter_A0 + fltY1 * channel.Filter_B0 + fltY2 * channel.Filter_B1 + 4096) >> 13U
-		};
-
-		fltY2 = fltY1;
-		fltY1 = fltY - (samples.first & channel.Filter_HP);
-		samples = {fltY, fltY};
-
-		store(channel, begin, samples.first, samples.second, leftVol, rightVol);
-		begin += 2U;
-		position += increment;
+			const int16_t sampleL{clipSample(block[frame * stride])};
+			const int16_t sampleR{clipSample(block[(frame * stride) + stride - 1U])};
+			store(channel, begin, sampleL, sampleR, leftVol, rightVol);
+		}
 	}
-	while (begin < end);
-	channel.Pos += position >> 16U;
-	channel.PosLo = position & 0xFFFFU;
+	std::copy_n(state.begin(), stride, channel.FilterState.begin());
 	channel.leftVol = leftVol;
 	channel.rightVol = rightVol;
-	channel.Filter_Y1 = fltY1;
-	channel.Filter_Y2 = fltY2;
 }
 
 // Interfaces
-// Mono 8-bit
-static void Mono8BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoSample, storeMono); }
-static void Mono8BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoSample, rampMono); }
-
-static void Mono8BitLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoLinearSample, storeMono); }
-static void Mono8BitLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoLinearSample, rampMono); }
-
-static void Mono8BitHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoHighQualitySample, storeMono); }
-static void Mono8BitHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, monoHighQualitySample, rampMono); }
-
-// Mono 16-bit
-static void Mono16BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoSample, storeMono); }
-static void Mono16BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoSample, rampMono); }
-
-static void Mono16BitLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoLinearSample, storeMono); }
-static void Mono16BitLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoLinearSample, rampMono); }
-
-static void Mono16BitHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoHighQualitySample, storeMono); }
-static void Mono16BitHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, monoHighQualitySample, rampMono); }
+// Mono
+static void MonoMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<nearestTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void MonoRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<nearestTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void MonoLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<linearTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void MonoLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<linearTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void MonoHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<cubicTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void MonoHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<cubicTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void MonoSincMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<sincTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void MonoSincRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<sincTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+// Filter Interfaces
+// Mono
+static void FilterMonoMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<nearestTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void FilterMonoRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<nearestTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void FilterMonoLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<linearTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void FilterMonoLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<linearTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void FilterMonoHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<cubicTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void FilterMonoHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<cubicTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+static void FilterMonoSincMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<sincTaps_t, 1U>(*chn, Buff, BuffMax, storeMono); }
+static void FilterMonoSincRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<sincTaps_t, 1U>(*chn, Buff, BuffMax, rampMono); }
+
+// Stereo
+static void StereoMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<nearestTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void StereoRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<nearestTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void StereoLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<linearTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void StereoLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<linearTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void StereoHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<cubicTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void StereoHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<cubicTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void StereoSincMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<sincTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void StereoSincRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleLoop<sincTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
 
 // Filter Interfaces
-// Mono 8-bit
-static void FilterMono8BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoSample, storeMono); }
-static void FilterMono8BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoSample, rampMono); }
-
-static void FilterMono8BitLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoLinearSample, storeMono); }
-static void FilterMono8BitLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoLinearSample, rampMono); }
-
-static void FilterMono8BitHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoHighQualitySample, storeMono); }
-static void FilterMono8BitHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int8_t>(*chn, Buff, BuffMax, monoHighQualitySample, rampMono); }
-
-// Mono 16-bit
-static void FilterMono16BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoSample, storeMono); }
-static void FilterMono16BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoSample, rampMono); }
-
-static void FilterMono16BitLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoLinearSample, storeMono); }
-static void FilterMono16BitLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoLinearSample, rampMono); }
-
-static void FilterMono16BitHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoHighQualitySample, storeMono); }
-static void FilterMono16BitHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleFilterLoop<int16_t>(*chn, Buff, BuffMax, monoHighQualitySample, rampMono); }
-
-// Stereo 8-bit
-static void Stereo8BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, stereoSample, storeStereo); }
-static void Stereo8BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int8_t>(*chn, Buff, BuffMax, stereoSample, rampStereo); }
-
-// Stereo 16-bit
-static void Stereo16BitMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, stereoSample, storeStereo); }
-static void Stereo16BitRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
-	{ sampleLoop<int16_t>(*chn, Buff, BuffMax, stereoSample, rampStereo); }
+// Stereo
+static void FilterStereoMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<nearestTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void FilterStereoRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<nearestTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void FilterStereoLinearMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<linearTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void FilterStereoLinearRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<linearTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void FilterStereoHQMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<cubicTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void FilterStereoHQRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<cubicTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
+
+static void FilterStereoSincMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<sincTaps_t, 2U>(*chn, Buff, BuffMax, storeStereo); }
+static void FilterStereoSincRampMix(channel_t *chn, int *Buff, int *BuffMax) noexcept
+	{ sampleFilterLoop<sincTaps_t, 2U>(*chn, Buff, BuffMax, rampStereo); }
 
 #endif /*LIBAUDIO_MODULEMIXER_MIXFUNCTIONS_H*/
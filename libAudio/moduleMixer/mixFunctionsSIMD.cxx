@@ -0,0 +1,580 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include "../libAudio.hxx"
+#include "../genericModule/genericModule.h"
+#include "../cpuFeatures.hxx"
+#include "mixFunctions.h"
+#include "mixFunctionTables.h"
+#include "mixFunctionsSIMD.hxx"
+#include "mixOutput.hxx"
+#include "samplePCM.hxx"
+
+#if defined(LIBAUDIO_SIMD_X86)
+#include <immintrin.h>
+#elif defined(LIBAUDIO_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+using libAudio::cpuFeatures;
+
+/*
+ * Each instruction set's kernels are compiled inside a target region so that they may use that set's
+ * instructions, while everything outside (including the scalar kernels) stays on the baseline for the
+ * build. This keeps the selection entirely down to selectMixFunctionTable() at runtime.
+ */
+
+#if defined(LIBAUDIO_SIMD_X86)
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("sse2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace libAudio::moduleMixer::sse2
+{
+	struct sse2_t
+	{
+		using vec_t = __m128i;
+		constexpr static size_t lanes{4U};
+		constexpr static bool hasGather{false};
+		constexpr static bool hasShuffle{false};
+
+		static vec_t load(const int32_t *const values) noexcept
+			{ return _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)); }
+		static vec_t broadcast(const int32_t value) noexcept { return _mm_set1_epi32(value); }
+		static vec_t add(const vec_t a, const vec_t b) noexcept { return _mm_add_epi32(a, b); }
+		static vec_t sub(const vec_t a, const vec_t b) noexcept { return _mm_sub_epi32(a, b); }
+		static vec_t bitAnd(const vec_t a, const vec_t b) noexcept { return _mm_and_si128(a, b); }
+		static vec_t bitOr(const vec_t a, const vec_t b) noexcept { return _mm_or_si128(a, b); }
+		static vec_t bitXor(const vec_t a, const vec_t b) noexcept { return _mm_xor_si128(a, b); }
+		// Multiplies the 16-bit halves of each lane and sums each lane's two products
+		static vec_t madd16(const vec_t a, const vec_t b) noexcept { return _mm_madd_epi16(a, b); }
+		static void store(int32_t *const values, const vec_t a) noexcept
+			{ _mm_storeu_si128(reinterpret_cast<__m128i *>(values), a); }
+		// Values outside the range of an int16_t saturate
+		static void storeInt16(int16_t *const values, const vec_t a) noexcept
+			{ _mm_storel_epi64(reinterpret_cast<__m128i *>(values), _mm_packs_epi32(a, a)); }
+		static void storeFloat(float *const values, const vec_t a, const float scale) noexcept
+			{ _mm_storeu_ps(values, _mm_mul_ps(_mm_cvtepi32_ps(a), _mm_set1_ps(scale))); }
+		// Sums adjacent pairs of lanes, with a's pairs ending up in the low half and b's in the high
+		static vec_t pairwiseAdd(const vec_t a, const vec_t b) noexcept
+		{
+			const auto evens{_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0))};
+			const auto odds{_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(3, 1, 3, 1))};
+			return _mm_add_epi32(_mm_castps_si128(evens), _mm_castps_si128(odds));
+		}
+		template<uint8_t shift> static vec_t shiftLeft(const vec_t a) noexcept { return _mm_slli_epi32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightArith(const vec_t a) noexcept { return _mm_srai_epi32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightLogical(const vec_t a) noexcept
+			{ return _mm_srli_epi32(a, shift); }
+
+		// SSE2 has no 32-bit low multiply, so build it from the two 32x32->64 multiplies
+		static vec_t mul(const vec_t a, const vec_t b) noexcept
+		{
+			const auto even{_mm_mul_epu32(a, b)};
+			const auto odd{_mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32))};
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+				_mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		}
+
+		static vec_t min(const vec_t a, const vec_t b) noexcept
+		{
+			const auto mask{_mm_cmpgt_epi32(a, b)};
+			return _mm_or_si128(_mm_and_si128(mask, b), _mm_andnot_si128(mask, a));
+		}
+
+		static vec_t max(const vec_t a, const vec_t b) noexcept
+		{
+			const auto mask{_mm_cmpgt_epi32(a, b)};
+			return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+		}
+
+		// Interleaves the right and left channel results into frames and adds them into the mix buffer
+		static void accumulate(int32_t *const buffer, const vec_t right, const vec_t left) noexcept
+		{
+			auto *const frames{reinterpret_cast<__m128i *>(buffer)};
+			_mm_storeu_si128(frames, _mm_add_epi32(_mm_loadu_si128(frames), _mm_unpacklo_epi32(right, left)));
+			_mm_storeu_si128(frames + 1, _mm_add_epi32(_mm_loadu_si128(frames + 1), _mm_unpackhi_epi32(right, left)));
+		}
+
+		// Reads the two 16-bit values starting at each lane's index into base - there's no gather, so a lane at a time
+		static vec_t gatherPairs(const int16_t *const base, const vec_t indices) noexcept
+		{
+			const auto pair{[&](const vec_t index) noexcept
+			{
+				int32_t value{};
+				std::memcpy(&value, base + _mm_cvtsi128_si32(index), sizeof(value));
+				return value;
+			}};
+			return _mm_setr_epi32(pair(indices), pair(_mm_shuffle_epi32(indices, _MM_SHUFFLE(1, 1, 1, 1))),
+				pair(_mm_shuffle_epi32(indices, _MM_SHUFFLE(2, 2, 2, 2))),
+				pair(_mm_shuffle_epi32(indices, _MM_SHUFFLE(3, 3, 3, 3))));
+		}
+
+		/*!
+		 * Reads the 2, 4 or 8 consecutive pairs of 16-bit values starting at each lane's offset into base, loading
+		 * each lane's row and transposing them into a vector per pair in rows
+		 */
+		template<size_t pairs> static void pairRows(const int16_t *const base, const vec_t offsets,
+			vec_t *const rows) noexcept
+		{
+			static_assert(pairs == 2U || pairs == 4U || pairs == 8U);
+			if constexpr (pairs == 8U)
+			{
+				pairRows<4U>(base, offsets, rows);
+				pairRows<4U>(base + 8, offsets, rows + 4);
+			}
+			else
+			{
+				const auto row{[&](const vec_t offset) noexcept
+				{
+					const auto *const values{reinterpret_cast<const __m128i *>(base + _mm_cvtsi128_si32(offset))};
+					if constexpr (pairs == 2U)
+						return _mm_loadl_epi64(values);
+					else
+						return _mm_loadu_si128(values);
+				}};
+				const auto row0{row(offsets)};
+				const auto row1{row(_mm_shuffle_epi32(offsets, _MM_SHUFFLE(1, 1, 1, 1)))};
+				const auto row2{row(_mm_shuffle_epi32(offsets, _MM_SHUFFLE(2, 2, 2, 2)))};
+				const auto row3{row(_mm_shuffle_epi32(offsets, _MM_SHUFFLE(3, 3, 3, 3)))};
+				const auto low01{_mm_unpacklo_epi32(row0, row1)};
+				const auto low23{_mm_unpacklo_epi32(row2, row3)};
+				rows[0] = _mm_unpacklo_epi64(low01, low23);
+				rows[1] = _mm_unpackhi_epi64(low01, low23);
+				if constexpr (pairs == 4U)
+				{
+					const auto high01{_mm_unpackhi_epi32(row0, row1)};
+					const auto high23{_mm_unpackhi_epi32(row2, row3)};
+					rows[2] = _mm_unpacklo_epi64(high01, high23);
+					rows[3] = _mm_unpackhi_epi64(high01, high23);
+				}
+			}
+		}
+
+		// Weave the bytes or 16-bit halves of a and b together, storing the two vectors that makes
+		static void interleave8(int32_t *const values, const vec_t a, const vec_t b) noexcept
+		{
+			auto *const out{reinterpret_cast<__m128i *>(values)};
+			_mm_storeu_si128(out, _mm_unpacklo_epi8(a, b));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(a, b));
+		}
+
+		static void interleave16(int32_t *const values, const vec_t a, const vec_t b) noexcept
+		{
+			auto *const out{reinterpret_cast<__m128i *>(values)};
+			_mm_storeu_si128(out, _mm_unpacklo_epi16(a, b));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(a, b));
+		}
+	};
+
+	using simd_t = sse2_t;
+#include "mixKernels.hxx"
+#include "mixOutputKernels.hxx"
+#include "samplePCMKernels.hxx"
+} // namespace libAudio::moduleMixer::sse2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("sse4.1"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+namespace libAudio::moduleMixer::sse41
+{
+	struct sse41_t : sse2::sse2_t
+	{
+		constexpr static bool hasShuffle{true};
+
+		static vec_t mul(const vec_t a, const vec_t b) noexcept { return _mm_mullo_epi32(a, b); }
+		static vec_t min(const vec_t a, const vec_t b) noexcept { return _mm_min_epi32(a, b); }
+		static vec_t max(const vec_t a, const vec_t b) noexcept { return _mm_max_epi32(a, b); }
+
+		// Reads the two 16-bit values starting at each lane's offset (0-6) into the 8 values at window
+		static vec_t windowPairs(const int16_t *const window, const vec_t offsets) noexcept
+		{
+			const auto bytes{_mm_shuffle_epi8(_mm_slli_epi32(offsets, 1),
+				_mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12))};
+			return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(window)),
+				_mm_add_epi8(bytes, _mm_set1_epi32(0x03020100)));
+		}
+	};
+
+	using simd_t = sse41_t;
+#include "mixKernels.hxx"
+#include "mixOutputKernels.hxx"
+#include "samplePCMKernels.hxx"
+} // namespace libAudio::moduleMixer::sse41
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+namespace libAudio::moduleMixer::avx2
+{
+	struct avx2_t
+	{
+		using vec_t = __m256i;
+		constexpr static size_t lanes{8U};
+		constexpr static bool hasGather{true};
+		constexpr static bool hasShuffle{false};
+
+		static vec_t load(const int32_t *const values) noexcept
+			{ return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+		static vec_t broadcast(const int32_t value) noexcept { return _mm256_set1_epi32(value); }
+		static vec_t add(const vec_t a, const vec_t b) noexcept { return _mm256_add_epi32(a, b); }
+		static vec_t sub(const vec_t a, const vec_t b) noexcept { return _mm256_sub_epi32(a, b); }
+		static vec_t mul(const vec_t a, const vec_t b) noexcept { return _mm256_mullo_epi32(a, b); }
+		static vec_t min(const vec_t a, const vec_t b) noexcept { return _mm256_min_epi32(a, b); }
+		static vec_t max(const vec_t a, const vec_t b) noexcept { return _mm256_max_epi32(a, b); }
+		static vec_t bitAnd(const vec_t a, const vec_t b) noexcept { return _mm256_and_si256(a, b); }
+		static vec_t bitOr(const vec_t a, const vec_t b) noexcept { return _mm256_or_si256(a, b); }
+		static vec_t bitXor(const vec_t a, const vec_t b) noexcept { return _mm256_xor_si256(a, b); }
+		static vec_t madd16(const vec_t a, const vec_t b) noexcept { return _mm256_madd_epi16(a, b); }
+		static vec_t gatherPairs(const int16_t *const base, const vec_t indices) noexcept
+			{ return _mm256_i32gather_epi32(reinterpret_cast<const int *>(base), indices, 2); }
+		// With a gather to hand, each pair comes straight from the lanes' rows
+		template<size_t pairs> static void pairRows(const int16_t *const base, const vec_t offsets,
+			vec_t *const rows) noexcept
+		{
+			for (size_t pair{}; pair < pairs; ++pair)
+				rows[pair] = gatherPairs(base + (pair * 2U), offsets);
+		}
+		static void store(int32_t *const values, const vec_t a) noexcept
+			{ _mm256_storeu_si256(reinterpret_cast<__m256i *>(values), a); }
+		static void storeInt16(int16_t *const values, const vec_t a) noexcept
+		{
+			// The pack works within each 128-bit half, so gather the two useful quarters together
+			const auto packed{_mm256_permute4x64_epi64(_mm256_packs_epi32(a, a), 0xD8)};
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(values), _mm256_castsi256_si128(packed));
+		}
+		static void storeFloat(float *const values, const vec_t a, const float scale) noexcept
+			{ _mm256_storeu_ps(values, _mm256_mul_ps(_mm256_cvtepi32_ps(a), _mm256_set1_ps(scale))); }
+		// Like storeInt16(), the horizontal add works within each 128-bit half so needs putting back in order
+		static vec_t pairwiseAdd(const vec_t a, const vec_t b) noexcept
+			{ return _mm256_permute4x64_epi64(_mm256_hadd_epi32(a, b), 0xD8); }
+		template<uint8_t shift> static vec_t shiftLeft(const vec_t a) noexcept { return _mm256_slli_epi32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightArith(const vec_t a) noexcept
+			{ return _mm256_srai_epi32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightLogical(const vec_t a) noexcept
+			{ return _mm256_srli_epi32(a, shift); }
+
+		static void accumulate(int32_t *const buffer, const vec_t right, const vec_t left) noexcept
+		{
+			// The unpacks work within each 128-bit half, so put the frames back in order afterwards
+			const auto low{_mm256_unpacklo_epi32(right, left)};
+			const auto high{_mm256_unpackhi_epi32(right, left)};
+			auto *const frames{reinterpret_cast<__m256i *>(buffer)};
+			_mm256_storeu_si256(frames, _mm256_add_epi32(_mm256_loadu_si256(frames),
+				_mm256_permute2x128_si256(low, high, 0x20)));
+			_mm256_storeu_si256(frames + 1, _mm256_add_epi32(_mm256_loadu_si256(frames + 1),
+				_mm256_permute2x128_si256(low, high, 0x31)));
+		}
+
+		// As with accumulate(), the unpacks need putting back in order across the halves
+		static void interleave8(int32_t *const values, const vec_t a, const vec_t b) noexcept
+		{
+			const auto low{_mm256_unpacklo_epi8(a, b)};
+			const auto high{_mm256_unpackhi_epi8(a, b)};
+			auto *const out{reinterpret_cast<__m256i *>(values)};
+			_mm256_storeu_si256(out, _mm256_permute2x128_si256(low, high, 0x20));
+			_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(low, high, 0x31));
+		}
+
+		static void interleave16(int32_t *const values, const vec_t a, const vec_t b) noexcept
+		{
+			const auto low{_mm256_unpacklo_epi16(a, b)};
+			const auto high{_mm256_unpackhi_epi16(a, b)};
+			auto *const out{reinterpret_cast<__m256i *>(values)};
+			_mm256_storeu_si256(out, _mm256_permute2x128_si256(low, high, 0x20));
+			_mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(low, high, 0x31));
+		}
+	};
+
+	using simd_t = avx2_t;
+#include "mixKernels.hxx"
+#include "mixOutputKernels.hxx"
+#include "samplePCMKernels.hxx"
+} // namespace libAudio::moduleMixer::avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+const mixFunctionTable_t *mixFunctionTableSSE2() noexcept
+{
+	static const auto table{libAudio::moduleMixer::sse2::buildMixFunctionTable()};
+	return &table;
+}
+
+const mixOutputFunctions_t *mixOutputSSE2() noexcept
+	{ return &libAudio::moduleMixer::sse2::mixOutputFunctions; }
+
+const samplePCMFunctions_t *samplePCMSSE2() noexcept
+	{ return &libAudio::moduleMixer::sse2::samplePCMFunctions; }
+
+const mixFunctionTable_t *mixFunctionTableSSE41() noexcept
+{
+	static const auto table{libAudio::moduleMixer::sse41::buildMixFunctionTable()};
+	return &table;
+}
+
+const mixOutputFunctions_t *mixOutputSSE41() noexcept
+	{ return &libAudio::moduleMixer::sse41::mixOutputFunctions; }
+
+const samplePCMFunctions_t *samplePCMSSE41() noexcept
+	{ return &libAudio::moduleMixer::sse41::samplePCMFunctions; }
+
+const mixFunctionTable_t *mixFunctionTableAVX2() noexcept
+{
+	static const auto table{libAudio::moduleMixer::avx2::buildMixFunctionTable()};
+	return &table;
+}
+
+const mixOutputFunctions_t *mixOutputAVX2() noexcept
+	{ return &libAudio::moduleMixer::avx2::mixOutputFunctions; }
+
+const samplePCMFunctions_t *samplePCMAVX2() noexcept
+	{ return &libAudio::moduleMixer::avx2::samplePCMFunctions; }
+
+const mixFunctionTable_t *mixFunctionTableNEON() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputNEON() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMNEON() noexcept { return nullptr; }
+#elif defined(LIBAUDIO_SIMD_NEON)
+namespace libAudio::moduleMixer::neon
+{
+	struct neon_t
+	{
+		using vec_t = int32x4_t;
+		constexpr static size_t lanes{4U};
+		constexpr static bool hasGather{false};
+		constexpr static bool hasShuffle{true};
+
+		static vec_t load(const int32_t *const values) noexcept { return vld1q_s32(values); }
+		static vec_t broadcast(const int32_t value) noexcept { return vdupq_n_s32(value); }
+		static vec_t add(const vec_t a, const vec_t b) noexcept { return vaddq_s32(a, b); }
+		static vec_t sub(const vec_t a, const vec_t b) noexcept { return vsubq_s32(a, b); }
+		static vec_t mul(const vec_t a, const vec_t b) noexcept { return vmulq_s32(a, b); }
+		static vec_t min(const vec_t a, const vec_t b) noexcept { return vminq_s32(a, b); }
+		static vec_t max(const vec_t a, const vec_t b) noexcept { return vmaxq_s32(a, b); }
+		static vec_t bitAnd(const vec_t a, const vec_t b) noexcept { return vandq_s32(a, b); }
+		static vec_t bitOr(const vec_t a, const vec_t b) noexcept { return vorrq_s32(a, b); }
+		static vec_t bitXor(const vec_t a, const vec_t b) noexcept { return veorq_s32(a, b); }
+		static void store(int32_t *const values, const vec_t a) noexcept { vst1q_s32(values, a); }
+		static void storeInt16(int16_t *const values, const vec_t a) noexcept { vst1_s16(values, vqmovn_s32(a)); }
+		static void storeFloat(float *const values, const vec_t a, const float scale) noexcept
+			{ vst1q_f32(values, vmulq_n_f32(vcvtq_f32_s32(a), scale)); }
+		static vec_t pairwiseAdd(const vec_t a, const vec_t b) noexcept
+		{
+			const auto halves{vuzpq_s32(a, b)};
+			return vaddq_s32(halves.val[0], halves.val[1]);
+		}
+		template<uint8_t shift> static vec_t shiftLeft(const vec_t a) noexcept { return vshlq_n_s32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightArith(const vec_t a) noexcept { return vshrq_n_s32(a, shift); }
+		template<uint8_t shift> static vec_t shiftRightLogical(const vec_t a) noexcept
+			{ return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), shift)); }
+
+		static void accumulate(int32_t *const buffer, const vec_t right, const vec_t left) noexcept
+		{
+			auto frames{vld2q_s32(buffer)};
+			frames.val[0] = vaddq_s32(frames.val[0], right);
+			frames.val[1] = vaddq_s32(frames.val[1], left);
+			vst2q_s32(buffer, frames);
+		}
+
+		static vec_t madd16(const vec_t a, const vec_t b) noexcept
+		{
+			const auto halvesA{vreinterpretq_s16_s32(a)};
+			const auto halvesB{vreinterpretq_s16_s32(b)};
+			const auto low{vmull_s16(vget_low_s16(halvesA), vget_low_s16(halvesB))};
+			const auto high{vmull_s16(vget_high_s16(halvesA), vget_high_s16(halvesB))};
+			return vcombine_s32(vpadd_s32(vget_low_s32(low), vget_high_s32(low)),
+				vpadd_s32(vget_low_s32(high), vget_high_s32(high)));
+		}
+
+		static vec_t gatherPairs(const int16_t *const base, const vec_t indices) noexcept
+		{
+			std::array<int32_t, lanes> pairs{};
+			std::memcpy(&pairs[0], base + vgetq_lane_s32(indices, 0), sizeof(int32_t));
+			std::memcpy(&pairs[1], base + vgetq_lane_s32(indices, 1), sizeof(int32_t));
+			std::memcpy(&pairs[2], base + vgetq_lane_s32(indices, 2), sizeof(int32_t));
+			std::memcpy(&pairs[3], base + vgetq_lane_s32(indices, 3), sizeof(int32_t));
+			return vld1q_s32(pairs.data());
+		}
+
+		template<size_t pairs> static void pairRows(const int16_t *const base, const vec_t offsets,
+			vec_t *const rows) noexcept
+		{
+			static_assert(pairs == 2U || pairs == 4U || pairs == 8U);
+			if constexpr (pairs == 8U)
+			{
+				pairRows<4U>(base, offsets, rows);
+				pairRows<4U>(base + 8, offsets, rows + 4);
+			}
+			else
+			{
+				const auto *const row0{base + vgetq_lane_s32(offsets, 0)};
+				const auto *const row1{base + vgetq_lane_s32(offsets, 1)};
+				const auto *const row2{base + vgetq_lane_s32(offsets, 2)};
+				const auto *const row3{base + vgetq_lane_s32(offsets, 3)};
+				if constexpr (pairs == 2U)
+				{
+					const auto rows01
+						{vtrn_s32(vreinterpret_s32_s16(vld1_s16(row0)), vreinterpret_s32_s16(vld1_s16(row1)))};
+					const auto rows23
+						{vtrn_s32(vreinterpret_s32_s16(vld1_s16(row2)), vreinterpret_s32_s16(vld1_s16(row3)))};
+					rows[0] = vcombine_s32(rows01.val[0], rows23.val[0]);
+					rows[1] = vcombine_s32(rows01.val[1], rows23.val[1]);
+				}
+				else
+				{
+					const auto rows01{vtrnq_s32(vreinterpretq_s32_s16(vld1q_s16(row0)),
+						vreinterpretq_s32_s16(vld1q_s16(row1)))};
+					const auto rows23{vtrnq_s32(vreinterpretq_s32_s16(vld1q_s16(row2)),
+						vreinterpretq_s32_s16(vld1q_s16(row3)))};
+					rows[0] = vcombine_s32(vget_low_s32(rows01.val[0]), vget_low_s32(rows23.val[0]));
+					rows[1] = vcombine_s32(vget_low_s32(rows01.val[1]), vget_low_s32(rows23.val[1]));
+					rows[2] = vcombine_s32(vget_high_s32(rows01.val[0]), vget_high_s32(rows23.val[0]));
+					rows[3] = vcombine_s32(vget_high_s32(rows01.val[1]), vget_high_s32(rows23.val[1]));
+				}
+			}
+		}
+
+		static vec_t windowPairs(const int16_t *const window, const vec_t offsets) noexcept
+		{
+			const auto control{vreinterpretq_u8_u32(vmlaq_n_u32(vdupq_n_u32(0x03020100U),
+				vreinterpretq_u32_s32(vshlq_n_s32(offsets, 1)), 0x01010101U))};
+			const auto bytes{vreinterpretq_u8_s16(vld1q_s16(window))};
+#if defined(__aarch64__)
+			return vreinterpretq_s32_u8(vqtbl1q_u8(bytes, control));
+#else
+			const uint8x8x2_t table{{vget_low_u8(bytes), vget_high_u8(bytes)}};
+			return vreinterpretq_s32_u8(vcombine_u8(vtbl2_u8(table, vget_low_u8(control)),
+				vtbl2_u8(table, vget_high_u8(control))));
+#endif
+		}
+
+		static void interleave8(int32_t *const values, const vec_t a, const vec_t b) noexcept
+			{ vst2q_u8(reinterpret_cast<uint8_t *>(values), {{vreinterpretq_u8_s32(a), vreinterpretq_u8_s32(b)}}); }
+		static void interleave16(int32_t *const values, const vec_t a, const vec_t b) noexcept
+			{ vst2q_u16(reinterpret_cast<uint16_t *>(values), {{vreinterpretq_u16_s32(a), vreinterpretq_u16_s32(b)}}); }
+	};
+
+	using simd_t = neon_t;
+#include "mixKernels.hxx"
+#include "mixOutputKernels.hxx"
+#include "samplePCMKernels.hxx"
+} // namespace libAudio::moduleMixer::neon
+
+const mixFunctionTable_t *mixFunctionTableSSE2() noexcept { return nullptr; }
+const mixFunctionTable_t *mixFunctionTableSSE41() noexcept { return nullptr; }
+const mixFunctionTable_t *mixFunctionTableAVX2() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputSSE2() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputSSE41() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputAVX2() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMSSE2() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMSSE41() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMAVX2() noexcept { return nullptr; }
+
+const mixFunctionTable_t *mixFunctionTableNEON() noexcept
+{
+	static const auto table{libAudio::moduleMixer::neon::buildMixFunctionTable()};
+	return &table;
+}
+
+const mixOutputFunctions_t *mixOutputNEON() noexcept
+	{ return &libAudio::moduleMixer::neon::mixOutputFunctions; }
+
+const samplePCMFunctions_t *samplePCMNEON() noexcept
+	{ return &libAudio::moduleMixer::neon::samplePCMFunctions; }
+#else
+const mixFunctionTable_t *mixFunctionTableSSE2() noexcept { return nullptr; }
+const mixFunctionTable_t *mixFunctionTableSSE41() noexcept { return nullptr; }
+const mixFunctionTable_t *mixFunctionTableAVX2() noexcept { return nullptr; }
+const mixFunctionTable_t *mixFunctionTableNEON() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputSSE2() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputSSE41() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputAVX2() noexcept { return nullptr; }
+const mixOutputFunctions_t *mixOutputNEON() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMSSE2() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMSSE41() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMAVX2() noexcept { return nullptr; }
+const samplePCMFunctions_t *samplePCMNEON() noexcept { return nullptr; }
+#endif
+
+static const mixFunctionTable_t &detectMixFunctionTable() noexcept
+{
+	const auto &features{cpuFeatures()};
+	const mixFunctionTable_t *table{nullptr};
+	if (features.avx2)
+		table = mixFunctionTableAVX2();
+	else if (features.sse41)
+		table = mixFunctionTableSSE41();
+	else if (features.sse2)
+		table = mixFunctionTableSSE2();
+	else if (features.neon)
+		table = mixFunctionTableNEON();
+	return table ? *table : MixFunctionTable;
+}
+
+const mixFunctionTable_t &selectMixFunctionTable() noexcept
+{
+	static const auto &table{detectMixFunctionTable()};
+	return table;
+}
+
+static const mixOutputFunctions_t &detectMixOutput() noexcept
+{
+	const auto &features{cpuFeatures()};
+	const mixOutputFunctions_t *functions{nullptr};
+	if (features.avx2)
+		functions = mixOutputAVX2();
+	else if (features.sse41)
+		functions = mixOutputSSE41();
+	else if (features.sse2)
+		functions = mixOutputSSE2();
+	else if (features.neon)
+		functions = mixOutputNEON();
+	return functions ? *functions : scalarMixOutput;
+}
+
+const mixOutputFunctions_t &selectMixOutput() noexcept
+{
+	static const auto &functions{detectMixOutput()};
+	return functions;
+}
+
+static const samplePCMFunctions_t &detectSamplePCM() noexcept
+{
+	const auto &features{cpuFeatures()};
+	const samplePCMFunctions_t *functions{nullptr};
+	if (features.avx2)
+		functions = samplePCMAVX2();
+	else if (features.sse41)
+		functions = samplePCMSSE41();
+	else if (features.sse2)
+		functions = samplePCMSSE2();
+	else if (features.neon)
+		functions = samplePCMNEON();
+	return functions ? *functions : scalarSamplePCM;
+}
+
+const samplePCMFunctions_t &selectSamplePCM() noexcept
+{
+	static const auto &functions{detectSamplePCM()};
+	return functions;
+}
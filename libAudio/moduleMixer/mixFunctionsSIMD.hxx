@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Vectorised mixing functions and runtime kernel selection
+#ifndef LIBAUDIO_MODULEMIXER_MIXFUNCTIONSSIMD_HXX
+#define LIBAUDIO_MODULEMIXER_MIXFUNCTIONSSIMD_HXX
+
+#include <array>
+
+struct channel_t;
+typedef void (*MixInterface)(channel_t *, int *, int *);
+using mixFunctionTable_t = std::array<MixInterface, 32>;
+struct mixOutputFunctions_t;
+struct samplePCMFunctions_t;
+
+// These return nullptr when the instruction set in question is not built for the target.
+// They must only be called when cpuFeatures() reports the instruction set as present.
+[[nodiscard]] const mixFunctionTable_t *mixFunctionTableSSE2() noexcept;
+[[nodiscard]] const mixFunctionTable_t *mixFunctionTableSSE41() noexcept;
+[[nodiscard]] const mixFunctionTable_t *mixFunctionTableAVX2() noexcept;
+[[nodiscard]] const mixFunctionTable_t *mixFunctionTableNEON() noexcept;
+// Picks the best table for the CPU we're running on, falling back to the scalar MixFunctionTable
+[[nodiscard]] const mixFunctionTable_t &selectMixFunctionTable() noexcept;
+
+// As above, but for the final conversion of the mix buffer to the output format
+[[nodiscard]] const mixOutputFunctions_t *mixOutputSSE2() noexcept;
+[[nodiscard]] const mixOutputFunctions_t *mixOutputSSE41() noexcept;
+[[nodiscard]] const mixOutputFunctions_t *mixOutputAVX2() noexcept;
+[[nodiscard]] const mixOutputFunctions_t *mixOutputNEON() noexcept;
+[[nodiscard]] const mixOutputFunctions_t &selectMixOutput() noexcept;
+
+// And for fixing up sample data as it gets loaded
+[[nodiscard]] const samplePCMFunctions_t *samplePCMSSE2() noexcept;
+[[nodiscard]] const samplePCMFunctions_t *samplePCMSSE41() noexcept;
+[[nodiscard]] const samplePCMFunctions_t *samplePCMAVX2() noexcept;
+[[nodiscard]] const samplePCMFunctions_t *samplePCMNEON() noexcept;
+[[nodiscard]] const samplePCMFunctions_t &selectSamplePCM() noexcept;
+
+#endif /*LIBAUDIO_MODULEMIXER_MIXFUNCTIONSSIMD_HXX*/
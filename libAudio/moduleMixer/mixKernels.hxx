@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Vectorised mixing kernels
+// NB: There is deliberately no include guard here - mixFunctionsSIMD.cxx includes this once per
+// instruction set, inside a namespace which defines simd_t as that instruction set's operations.
+
+using vec_t = simd_t::vec_t;
+constexpr static size_t lanes{simd_t::lanes};
+template<typename T> using laneArray_t = std::array<T, lanes>;
+
+// How many samples windowPairs() takes its pairs from
+constexpr static int32_t pairWindow{8};
+
+// Sign extend the first or second 16-bit value of each lane's pair
+inline vec_t lowHalves(const vec_t pairs) noexcept
+	{ return simd_t::template shiftRightArith<16U>(simd_t::template shiftLeft<16U>(pairs)); }
+inline vec_t highHalves(const vec_t pairs) noexcept { return simd_t::template shiftRightArith<16U>(pairs); }
+
+/*!
+ * Reads 16-bit pairs out of a sample for every lane at once - two consecutive samples of a mono sample, or both
+ * channels of a frame of a stereo one. With a gather that's a single instruction. Without, when the lanes' frames are
+ * close enough together, the 8 samples around them are loaded and each lane's pair shuffled out of those, and only
+ * when they're spread too far apart for that does each lane's pair get fetched in turn. ops_t is only a parameter so
+ * that instruction sets without windowPairs() never have it looked up.
+ */
+template<size_t stride, typename ops_t = simd_t> struct pairReader_t final
+{
+	const int16_t *buffer;
+	// The furthest in a window can start and still stay inside the sample's guard frames
+	int32_t lastWindow;
+	bool windowed;
+	// The first sample of the lowest numbered frame the lanes are on
+	int32_t lowest{};
+
+	// Reads the pairs starting offset samples on from each lane's index
+	[[nodiscard]] vec_t read(const vec_t indices, const int32_t offset) const noexcept
+	{
+		const auto reads{ops_t::add(indices, ops_t::broadcast(offset))};
+		if constexpr (!ops_t::hasGather && ops_t::hasShuffle)
+		{
+			if (windowed)
+			{
+				const auto start{std::min(lowest + offset, lastWindow)};
+				return ops_t::windowPairs(buffer + start, ops_t::sub(reads, ops_t::broadcast(start)));
+			}
+		}
+		return ops_t::gatherPairs(buffer, reads);
+	}
+};
+
+inline vec_t clipSamples(const vec_t samples) noexcept
+	{ return simd_t::min(simd_t::max(samples, simd_t::broadcast(INT16_MIN)), simd_t::broadcast(INT16_MAX)); }
+
+/*!
+ * Runs pairs of taps through their weights, starting first frames before each lane's own. Both a lane's taps and
+ * its weights sit together in memory, so each comes out as a row of pairs, one vector per pair. For stereo the two
+ * frames of a pair of taps get split across the two channels by masking the weights.
+ */
+template<size_t pairs, size_t stride> inline void weightTaps(const pairReader_t<stride> &reader, const vec_t indices,
+	const int16_t *const table, const vec_t phases, const int32_t first, vec_t &left, vec_t &right) noexcept
+{
+	const auto lowMask{simd_t::broadcast(0x0000FFFF)};
+	const auto highMask{simd_t::broadcast(static_cast<int32_t>(0xFFFF0000U))};
+	vec_t weights[pairs];
+	vec_t taps[pairs * stride];
+	simd_t::template pairRows<pairs>(table, phases, weights);
+	simd_t::template pairRows<pairs * stride>(reader.buffer + (first * int32_t{stride}), indices, taps);
+	auto sumL{simd_t::broadcast(0)};
+	auto sumR{simd_t::broadcast(0)};
+	for (size_t pair{}; pair < pairs; ++pair)
+	{
+		if constexpr (stride == 1U)
+			sumL = simd_t::add(sumL, simd_t::madd16(taps[pair], weights[pair]));
+		else
+		{
+			const auto &frameA{taps[pair * 2U]};
+			const auto &frameB{taps[(pair * 2U) + 1U]};
+			sumL = simd_t::add(sumL, simd_t::add(simd_t::madd16(frameA, simd_t::bitAnd(weights[pair], lowMask)),
+				simd_t::madd16(frameB, simd_t::template shiftRightLogical<16U>(weights[pair]))));
+			sumR = simd_t::add(sumR, simd_t::add(simd_t::madd16(frameA, simd_t::template shiftLeft<16U>(weights[pair])),
+				simd_t::madd16(frameB, simd_t::bitAnd(weights[pair], highMask))));
+		}
+	}
+	left = clipSamples(simd_t::template shiftRightArith<14U>(sumL));
+	right = stride == 1U ? left : clipSamples(simd_t::template shiftRightArith<14U>(sumR));
+}
+
+// A mono pair always takes in the sample after the one wanted too, so that has to be inside the guard frames
+struct nearest_t final : nearestTaps_t
+{
+	constexpr static int32_t vectorTapsAfter{1};
+
+	template<size_t stride> static void samples(const pairReader_t<stride> &reader, const vec_t,
+		const vec_t indices, vec_t &left, vec_t &right) noexcept
+	{
+		const auto frames{reader.read(indices, 0)};
+		left = lowHalves(frames);
+		right = stride == 1U ? left : highHalves(frames);
+	}
+};
+
+// The fraction between the two taps gets applied as a -fraction, fraction pair of weights
+struct linear_t final : linearTaps_t
+{
+	constexpr static int32_t vectorTapsAfter{tapsAfter};
+
+	template<size_t stride> static void samples(const pairReader_t<stride> &reader, const vec_t positions,
+		const vec_t indices, vec_t &left, vec_t &right) noexcept
+	{
+		const auto fractions
+		{
+			simd_t::bitAnd(simd_t::template shiftRightLogical<8U>(positions), simd_t::broadcast(0xFF))
+		};
+		const auto weights
+		{
+			simd_t::bitOr(simd_t::bitAnd(simd_t::sub(simd_t::broadcast(0), fractions), simd_t::broadcast(0xFFFF)),
+				simd_t::template shiftLeft<16U>(fractions))
+		};
+		const auto first{reader.read(indices, 0)};
+		if constexpr (stride == 1U)
+		{
+			left = right = simd_t::add(lowHalves(first),
+				simd_t::template shiftRightArith<8U>(simd_t::madd16(first, weights)));
+		}
+		else
+		{
+			// Pair each channel's sample up with its next one
+			const auto second{reader.read(indices, 2)};
+			const auto leftPairs
+			{
+				simd_t::bitOr(simd_t::bitAnd(first, simd_t::broadcast(0xFFFF)), simd_t::template shiftLeft<16U>(second))
+			};
+			const auto rightPairs
+			{
+				simd_t::bitOr(simd_t::template shiftRightLogical<16U>(first),
+					simd_t::bitAnd(second, simd_t::broadcast(static_cast<int32_t>(0xFFFF0000U))))
+			};
+			left = simd_t::add(lowHalves(first),
+				simd_t::template shiftRightArith<8U>(simd_t::madd16(leftPairs, weights)));
+			right = simd_t::add(highHalves(first),
+				simd_t::template shiftRightArith<8U>(simd_t::madd16(rightPairs, weights)));
+		}
+	}
+};
+
+struct cubic_t final : cubicTaps_t
+{
+	constexpr static int32_t vectorTapsAfter{tapsAfter};
+
+	template<size_t stride> static void samples(const pairReader_t<stride> &reader, const vec_t positions,
+		const vec_t indices, vec_t &left, vec_t &right) noexcept
+	{
+		const auto phases
+		{
+			simd_t::bitAnd(simd_t::template shiftRightLogical<6U>(positions), simd_t::broadcast(0x03FC))
+		};
+		weightTaps<2U>(reader, indices, FastSinc.data(), phases, -1, left, right);
+	}
+};
+
+struct sinc_t final : sincTaps_t
+{
+	constexpr static int32_t vectorTapsAfter{tapsAfter};
+
+	template<size_t stride> static void samples(const pairReader_t<stride> &reader, const vec_t positions,
+		const vec_t indices, vec_t &left, vec_t &right) noexcept
+	{
+		const auto phases
+		{
+			simd_t::template shiftLeft<3U>(simd_t::bitAnd(simd_t::template shiftRightLogical<4U>(positions),
+				simd_t::broadcast(0x0FFF)))
+		};
+		weightTaps<4U>(reader, indices, windowedSinc(), phases, -3, left, right);
+	}
+};
+
+/*!
+ * Interpolates the channel's next frames, handing them `lanes` at a time to mixFrames() and any left over one at a
+ * time to mixFrame(), then moves the play position on past them. Only the frames whose reads all land inside the
+ * sample or its guard frames get vectorised, which leaves the clamping needed at the end of a loop finishing short
+ * of the end of the sample to the scalar path. The results are bit-for-bit those of the scalar interpolation.
+ */
+template<size_t stride, typename interp_t, typename mixFrames_t, typename mixFrame_t>
+	inline void interpolateFrames(channel_t &channel, const uint32_t frames, mixFrames_t &&mixFrames,
+	mixFrame_t &&mixFrame) noexcept
+{
+	auto position{channel.PosLo};
+	const auto increment{static_cast<uint32_t>(channel.increment.iValue)};
+	const auto *const sampleData{reinterpret_cast<const int16_t *>(channel.SampleData) + (channel.Pos * stride)};
+	const sampleWindow_t window{-static_cast<int32_t>(channel.Pos),
+		static_cast<int32_t>(channel.Length) - static_cast<int32_t>(channel.Pos) - 1};
+	const auto span{guardedSpan<interp_t::tapsBefore, interp_t::vectorTapsAfter>(channel, frames)};
+
+	// The lanes can only share a window if every lane's pair fits in it, however the frames fall
+	const auto laneSpread
+		{(static_cast<uint64_t>(std::abs(channel.increment.iValue)) * (lanes - 1U) + 0xFFFFU) >> 16U};
+	pairReader_t<stride> reader
+	{
+		sampleData,
+		static_cast<int32_t>(((int64_t{channel.Length} + sampleGuard - channel.Pos) * int64_t{stride}) - pairWindow),
+		(laneSpread * stride) + 2U <= pairWindow,
+	};
+	laneArray_t<int32_t> laneSteps{};
+	for (size_t lane{}; lane < lanes; ++lane)
+		laneSteps[lane] = static_cast<int32_t>(increment * static_cast<uint32_t>(lane));
+	const auto laneIncrements{simd_t::load(laneSteps.data())};
+
+	uint32_t frame{};
+	const auto interpolate{[&](const auto &window, const uint32_t stop) noexcept
+	{
+		for (; frame < stop; ++frame)
+		{
+			const int16_t sampleL{interp_t::template sample<stride>(sampleData, position, window)};
+			const int16_t sampleR
+				{stride == 1U ? sampleL : interp_t::template sample<stride>(sampleData + 1, position, window)};
+			mixFrame(sampleL, sampleR, frame);
+			position += increment;
+		}
+	}};
+
+	interpolate(window, span.begin);
+	for (; frame < span.end && span.end - frame >= lanes; frame += lanes)
+	{
+		const auto positions{simd_t::add(simd_t::broadcast(static_cast<int32_t>(position)), laneIncrements)};
+		auto indices{simd_t::template shiftRightArith<16U>(positions)};
+		if constexpr (stride == 2U)
+			indices = simd_t::template shiftLeft<1U>(indices);
+		if constexpr (!simd_t::hasGather && simd_t::hasShuffle)
+		{
+			const auto lastPosition{position + (increment * static_cast<uint32_t>(lanes - 1U))};
+			const auto firstFrame{static_cast<int32_t>(position) >> 16};
+			const auto lastFrame{static_cast<int32_t>(lastPosition) >> 16};
+			reader.lowest = std::min(firstFrame, lastFrame) * static_cast<int32_t>(stride);
+		}
+		vec_t left{};
+		vec_t right{};
+		interp_t::template samples<stride>(reader, positions, indices, left, right);
+		mixFrames(left, right, frame);
+		position += increment * static_cast<uint32_t>(lanes);
+	}
+	interpolate(guardedWindow_t{}, span.end);
+	interpolate(window, frames);
+
+	channel.Pos += static_cast<int32_t>(position) >> 16;
+	channel.PosLo = position & 0xFFFFU;
+}
+
+// Scales interpolated frames by the channel's volumes, ramping them if asked to, and adds them into the mix
+template<size_t stride, bool ramp> struct volume_t final
+{
+	constexpr static uint8_t volumeShift{stride == 1U ? 4U : 3U};
+	uint32_t leftVol;
+	uint32_t rightVol;
+	int32_t leftRamp;
+	int32_t rightRamp;
+	vec_t rampSteps{};
+
+	volume_t(const channel_t &channel) noexcept : leftVol{channel.leftVol}, rightVol{channel.rightVol},
+		leftRamp{ramp ? channel.LeftRamp : 0}, rightRamp{ramp ? channel.RightRamp : 0}
+	{
+		laneArray_t<int32_t> laneSteps{};
+		for (size_t lane{}; lane < lanes; ++lane)
+			laneSteps[lane] = static_cast<int32_t>(lane + 1U);
+		rampSteps = simd_t::load(laneSteps.data());
+	}
+
+	void mix(int32_t *const buffer, const vec_t left, const vec_t right) noexcept
+	{
+		auto leftVolumes{simd_t::broadcast(static_cast<int32_t>(leftVol))};
+		auto rightVolumes{simd_t::broadcast(static_cast<int32_t>(rightVol))};
+		if constexpr (ramp)
+		{
+			leftVolumes = simd_t::add(leftVolumes, simd_t::mul(simd_t::broadcast(leftRamp), rampSteps));
+			rightVolumes = simd_t::add(rightVolumes, simd_t::mul(simd_t::broadcast(rightRamp), rampSteps));
+			leftVol += static_cast<uint32_t>(leftRamp) * static_cast<uint32_t>(lanes);
+			rightVol += static_cast<uint32_t>(rightRamp) * static_cast<uint32_t>(lanes);
+		}
+		simd_t::accumulate(buffer,
+			simd_t::mul(right, simd_t::template shiftLeft<volumeShift>(rightVolumes)),
+			simd_t::mul(left, simd_t::template shiftLeft<volumeShift>(leftVolumes)));
+	}
+
+	void mix(int32_t *const buffer, const int16_t sampleL, const int16_t sampleR) noexcept
+	{
+		leftVol += leftRamp;
+		rightVol += rightRamp;
+		buffer[0] += sampleR * (rightVol << volumeShift);
+		buffer[1] += sampleL * (leftVol << volumeShift);
+	}
+
+	void store(channel_t &channel) const noexcept
+	{
+		channel.leftVol = leftVol;
+		channel.rightVol = rightVol;
+	}
+};
+
+// Computes `lanes` output frames per iteration, bit-for-bit those of sampleLoop() with the equivalent functions
+template<size_t stride, typename interp_t, bool ramp>
+	void mixKernel(channel_t *const chn, int *const begin, int *const end) noexcept
+{
+	auto &channel{*chn};
+	volume_t<stride, ramp> volume{channel};
+	interpolateFrames<stride, interp_t>(channel, static_cast<uint32_t>(end - begin) / 2U,
+		[&](const vec_t left, const vec_t right, const uint32_t frame) noexcept
+			{ volume.mix(begin + (frame * 2U), left, right); },
+		[&](const int16_t sampleL, const int16_t sampleR, const uint32_t frame) noexcept
+			{ volume.mix(begin + (frame * 2U), sampleL, sampleR); });
+	volume.store(channel);
+}
+
+/*!
+ * The resonant filter has to run through the frames one after the other, so these interpolate a block of each
+ * channel with the vector kernels, run the filter over each block, and then mix the result in with the vector kernels.
+ * The results are bit-for-bit those of sampleFilterLoop() with the equivalent functions.
+ */
+template<size_t stride, typename interp_t, bool ramp>
+	void filterKernel(channel_t *const chn, int *begin, int *const end) noexcept
+{
+	auto &channel{*chn};
+	volume_t<stride, ramp> volume{channel};
+	std::array<std::array<int32_t, filterBlockFrames>, stride> blocks{};
+	std::array<std::array<filterState_t, 1U>, stride> state{};
+	for (size_t i{}; i < stride; ++i)
+		state[i][0] = channel.FilterState[i];
+	while (begin < end)
+	{
+		const auto frames{std::min<uint32_t>(filterBlockFrames, static_cast<uint32_t>(end - begin) / 2U)};
+		interpolateFrames<stride, interp_t>(channel, frames,
+			[&](const vec_t left, const vec_t right, const uint32_t frame) noexcept
+			{
+				simd_t::store(blocks[0].data() + frame, left);
+				if constexpr (stride == 2U)
+					simd_t::store(blocks[1].data() + frame, right);
+			},
+			[&](const int16_t sampleL, const int16_t sampleR, const uint32_t frame) noexcept
+			{
+				blocks[0][frame] = sampleL;
+				if constexpr (stride == 2U)
+					blocks[1][frame] = sampleR;
+			});
+		for (size_t i{}; i < stride; ++i)
+			filterBlock(blocks[i].data(), frames, channel.FilterCoefficients, state[i]);
+
+		uint32_t frame{};
+		for (; frames - frame >= lanes; frame += lanes)
+		{
+			const auto left{clipSamples(simd_t::load(blocks[0].data() + frame))};
+			const auto right{stride == 1U ? left : clipSamples(simd_t::load(blocks[stride - 1U].data() + frame))};
+			volume.mix(begin + (frame * 2U), left, right);
+		}
+		for (; frame < frames; ++frame)
+		{
+			volume.mix(begin + (frame * 2U), clipSample(blocks[0][frame]),
+				clipSample(blocks[stride - 1U][frame]));
+		}
+		begin += frames * 2U;
+	}
+	for (size_t i{}; i < stride; ++i)
+		channel.FilterState[i] = state[i][0];
+	volume.store(channel);
+}
+
+template<size_t stride, template<size_t, typename, bool> typename kernel_t> struct kernelGroup_t final
+{
+	constexpr static std::array<MixInterface, 8> kernels
+	{{
+		kernel_t<stride, nearest_t, false>::run, kernel_t<stride, nearest_t, true>::run,
+		kernel_t<stride, linear_t, false>::run, kernel_t<stride, linear_t, true>::run,
+		kernel_t<stride, cubic_t, false>::run, kernel_t<stride, cubic_t, true>::run,
+		kernel_t<stride, sinc_t, false>::run, kernel_t<stride, sinc_t, true>::run,
+	}};
+};
+
+template<size_t stride, typename interp_t, bool ramp> struct mixKernel_t final
+	{ constexpr static MixInterface run{mixKernel<stride, interp_t, ramp>}; };
+template<size_t stride, typename interp_t, bool ramp> struct filterKernel_t final
+	{ constexpr static MixInterface run{filterKernel<stride, interp_t, ramp>}; };
+
+inline mixFunctionTable_t buildMixFunctionTable() noexcept
+{
+	mixFunctionTable_t table{};
+	const auto fill{[&](const size_t base, const std::array<MixInterface, 8> &kernels)
+	{
+		for (size_t i{}; i < kernels.size(); ++i)
+			table[base + i] = kernels[i];
+	}};
+	fill(MIX_NOSRC, kernelGroup_t<1U, mixKernel_t>::kernels);
+	fill(MIX_FILTER, kernelGroup_t<1U, filterKernel_t>::kernels);
+	fill(MIX_STEREO, kernelGroup_t<2U, mixKernel_t>::kernels);
+	fill(MIX_STEREO | MIX_FILTER, kernelGroup_t<2U, filterKernel_t>::kernels);
+	return table;
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Conversion of the 32-bit mix buffer into the requested output sample format
+#ifndef LIBAUDIO_MODULEMIXER_MIXOUTPUT_HXX
+#define LIBAUDIO_MODULEMIXER_MIXOUTPUT_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <algorithm>
+
+// The mix buffer carries 28 bits of signal, so clip to that before reducing to the output format
+constexpr static int32_t mixSampleMin{-0x07FFFFFF};
+constexpr static int32_t mixSampleMax{0x07FFFFFF};
+constexpr static float mixSampleScale{1.0F / 134217728.0F};
+
+inline int32_t clipMixSample(const int32_t sample) noexcept
+{
+	if (sample < mixSampleMin)
+		return mixSampleMin;
+	else if (sample > mixSampleMax)
+		return mixSampleMax;
+	return sample;
+}
+
+// This is counter-based rather than stateful so the vector kernels can compute any run of it in parallel
+inline uint32_t ditherHash(uint32_t value) noexcept
+{
+	value ^= value >> 16U;
+	value *= 0x7FEB352DU;
+	value ^= value >> 15U;
+	value *= 0x846CA68BU;
+	value ^= value >> 16U;
+	return value;
+}
+
+// Triangular PDF dither spanning +/-1 LSB of 16-bit output (which is 12 bits down in the mix buffer)
+inline int32_t tpdfDither(const uint32_t index) noexcept
+{
+	const auto value{ditherHash(index)};
+	return static_cast<int32_t>(value & 0x0FFFU) + static_cast<int32_t>((value >> 12U) & 0x0FFFU) - 0x0FFF;
+}
+
+// Clipping to the mix range before the shift is equivalent to a saturating pack of the shifted sample
+inline void mixToInt16(int16_t *const out, const int32_t *const in, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		out[i] = static_cast<int16_t>(clipMixSample(in[i]) >> 12);
+}
+
+inline void mixToInt16Dithered(int16_t *const out, const int32_t *const in, const size_t count,
+	const uint32_t ditherIndex) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+	{
+		const auto sample{clipMixSample(clipMixSample(in[i]) + tpdfDither(ditherIndex + static_cast<uint32_t>(i)))};
+		out[i] = static_cast<int16_t>(sample >> 12);
+	}
+}
+
+// The rounding errors of the last two samples of each channel, for noise shaping
+struct noiseShaper_t final
+{
+	std::array<std::array<int32_t, 2>, 2> errors{};
+};
+
+/*!
+ * Reduces the mix to 16-bit with TPDF dither, feeding the error left by each sample back into the next two of its
+ * channel so the noise comes out shaped by (1 - z^-1)^2. That makes for a little more noise than dither alone,
+ * but moves it up towards the Nyquist frequency and away from the frequencies hearing is most sensitive to.
+ * The feedback is a recurrence along each channel, so unlike the other conversions this has no vector form.
+ */
+inline void mixToInt16NoiseShaped(int16_t *const out, const int32_t *const in, const size_t count,
+	const uint32_t ditherIndex, const size_t channels, noiseShaper_t &shaper) noexcept
+{
+	// Clipping makes for errors far bigger than the rounding, which would throw the feedback off for a long time after
+	constexpr int32_t errorLimit{0x2000};
+	for (size_t i{}; i < count; ++i)
+	{
+		auto &[lastError, olderError]{shaper.errors[i % channels]};
+		const auto wanted{clipMixSample(in[i]) - (2 * lastError) + olderError};
+		const auto sample{clipMixSample(wanted + tpdfDither(ditherIndex + static_cast<uint32_t>(i))) >> 12};
+		out[i] = static_cast<int16_t>(sample);
+		olderError = lastError;
+		lastError = std::clamp((sample * 4096) - wanted, -errorLimit, errorLimit);
+	}
+}
+
+// 24-bit output is packed little endian, 3 bytes per sample
+inline void mixToInt24(uint8_t *const out, const int32_t *const in, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+	{
+		const auto sample{static_cast<uint32_t>(clipMixSample(in[i]) >> 4)};
+		out[(i * 3U) + 0U] = static_cast<uint8_t>(sample);
+		out[(i * 3U) + 1U] = static_cast<uint8_t>(sample >> 8U);
+		out[(i * 3U) + 2U] = static_cast<uint8_t>(sample >> 16U);
+	}
+}
+
+// Float output is not clipped so that over-range mixes survive into float pipelines intact
+inline void mixToFloat(float *const out, const int32_t *const in, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		out[i] = static_cast<float>(in[i]) * mixSampleScale;
+}
+
+// Downmixes count stereo frames to mono in place by averaging the two channels.
+// Each half is taken before the sum so this can never overflow.
+inline void mixMonoFromStereo(int32_t *const buffer, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		buffer[i] = (buffer[i * 2U] >> 1) + (buffer[(i * 2U) + 1U] >> 1);
+}
+
+struct mixOutputFunctions_t
+{
+	void (*toInt16)(int16_t *out, const int32_t *in, size_t count) noexcept;
+	void (*toInt16Dithered)(int16_t *out, const int32_t *in, size_t count, uint32_t ditherIndex) noexcept;
+	void (*toInt24)(uint8_t *out, const int32_t *in, size_t count) noexcept;
+	void (*toFloat)(float *out, const int32_t *in, size_t count) noexcept;
+	void (*monoFromStereo)(int32_t *buffer, size_t count) noexcept;
+};
+
+constexpr static mixOutputFunctions_t scalarMixOutput
+	{mixToInt16, mixToInt16Dithered, mixToInt24, mixToFloat, mixMonoFromStereo};
+
+#endif /*LIBAUDIO_MODULEMIXER_MIXOUTPUT_HXX*/
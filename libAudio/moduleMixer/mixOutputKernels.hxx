@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Vectorised output conversion kernels
+// NB: Like mixKernels.hxx, this is included once per instruction set by mixFunctionsSIMD.cxx and
+// relies on the definitions that file makes first. Each kernel finishes off with the scalar version.
+
+inline vec_t clipMixSamples(const vec_t samples) noexcept
+	{ return simd_t::min(simd_t::max(samples, simd_t::broadcast(mixSampleMin)), simd_t::broadcast(mixSampleMax)); }
+
+inline vec_t tpdfDithers(const uint32_t index) noexcept
+{
+	laneArray_t<int32_t> indices{};
+	for (size_t lane{}; lane < lanes; ++lane)
+		indices[lane] = static_cast<int32_t>(index + static_cast<uint32_t>(lane));
+	auto value{simd_t::load(indices.data())};
+	value = simd_t::bitXor(value, simd_t::template shiftRightLogical<16U>(value));
+	value = simd_t::mul(value, simd_t::broadcast(0x7FEB352D));
+	value = simd_t::bitXor(value, simd_t::template shiftRightLogical<15U>(value));
+	value = simd_t::mul(value, simd_t::broadcast(static_cast<int32_t>(0x846CA68BU)));
+	value = simd_t::bitXor(value, simd_t::template shiftRightLogical<16U>(value));
+	const auto mask{simd_t::broadcast(0x0FFF)};
+	return simd_t::sub(simd_t::add(simd_t::bitAnd(value, mask),
+		simd_t::bitAnd(simd_t::template shiftRightLogical<12U>(value), mask)), mask);
+}
+
+// The saturating pack does the clipping for us, the shift of the clip bounds being the int16_t range
+inline void toInt16(int16_t *const out, const int32_t *const in, const size_t count) noexcept
+{
+	size_t i{};
+	for (; i + lanes <= count; i += lanes)
+		simd_t::storeInt16(out + i, simd_t::template shiftRightArith<12U>(simd_t::load(in + i)));
+	mixToInt16(out + i, in + i, count - i);
+}
+
+inline void toInt16Dithered(int16_t *const out, const int32_t *const in, const size_t count,
+	const uint32_t ditherIndex) noexcept
+{
+	size_t i{};
+	for (; i + lanes <= count; i += lanes)
+	{
+		const auto index{ditherIndex + static_cast<uint32_t>(i)};
+		const auto samples{clipMixSamples(simd_t::add(clipMixSamples(simd_t::load(in + i)), tpdfDithers(index)))};
+		simd_t::storeInt16(out + i, simd_t::template shiftRightArith<12U>(samples));
+	}
+	mixToInt16Dithered(out + i, in + i, count - i, ditherIndex + static_cast<uint32_t>(i));
+}
+
+inline void toInt24(uint8_t *const out, const int32_t *const in, const size_t count) noexcept
+{
+	size_t i{};
+	for (; i + lanes <= count; i += lanes)
+	{
+		laneArray_t<int32_t> samples{};
+		simd_t::store(samples.data(), simd_t::template shiftRightArith<4U>(clipMixSamples(simd_t::load(in + i))));
+		for (size_t lane{}; lane < lanes; ++lane)
+		{
+			const auto sample{static_cast<uint32_t>(samples[lane])};
+			auto *const bytes{out + ((i + lane) * 3U)};
+			bytes[0] = static_cast<uint8_t>(sample);
+			bytes[1] = static_cast<uint8_t>(sample >> 8U);
+			bytes[2] = static_cast<uint8_t>(sample >> 16U);
+		}
+	}
+	mixToInt24(out + (i * 3U), in + i, count - i);
+}
+
+inline void toFloat(float *const out, const int32_t *const in, const size_t count) noexcept
+{
+	size_t i{};
+	for (; i + lanes <= count; i += lanes)
+		simd_t::storeFloat(out + i, simd_t::load(in + i), mixSampleScale);
+	mixToFloat(out + i, in + i, count - i);
+}
+
+// The output always trails the input here, and each input vector is fully loaded before the
+// output vector covering it is stored, so running this in place is safe
+inline void monoFromStereo(int32_t *const buffer, const size_t count) noexcept
+{
+	size_t i{};
+	for (; i + lanes <= count; i += lanes)
+	{
+		const auto first{simd_t::template shiftRightArith<1U>(simd_t::load(buffer + (i * 2U)))};
+		const auto second{simd_t::template shiftRightArith<1U>(simd_t::load(buffer + (i * 2U) + lanes))};
+		simd_t::store(buffer + i, simd_t::pairwiseAdd(first, second));
+	}
+	// The scalar tail works relative to its base pointer, so do it by hand to keep the frame indexing right
+	for (; i < count; ++i)
+		buffer[i] = (buffer[i * 2U] >> 1) + (buffer[(i * 2U) + 1U] >> 1);
+}
+
+constexpr mixOutputFunctions_t mixOutputFunctions{toInt16, toInt16Dithered, toInt24, toFloat, monoFromStereo};
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <new>
+#include "mixThreads.hxx"
+
+mixThreads_t::mixThreads_t(const size_t workers, const size_t frames) :
+	accumulators{std::make_unique<mixAccumulator_t []>(workers > 1U ? workers - 1U : 0U)}
+{
+	for (size_t index{1U}; index < workers; ++index)
+	{
+		if (!accumulators[index - 1U].reserve(frames))
+			throw std::bad_alloc{};
+	}
+	threads.reserve(workers - 1U);
+	try
+	{
+		for (size_t index{1U}; index < workers; ++index)
+			threads.emplace_back([this, index]() noexcept { worker(index); });
+	}
+	catch (...)
+	{
+		stop();
+		throw;
+	}
+}
+
+mixThreads_t::~mixThreads_t() noexcept { stop(); }
+
+bool mixThreads_t::reserve(const size_t frames) noexcept
+{
+	for (size_t index{}; index < threads.size(); ++index)
+	{
+		if (!accumulators[index].reserve(frames))
+			return false;
+	}
+	return true;
+}
+
+void mixThreads_t::stop() noexcept
+{
+	std::unique_lock<std::mutex> lock{stateMutex};
+	stopping = true;
+	lock.unlock();
+	jobReady.notify_all();
+	for (auto &thread : threads)
+	{
+		if (thread.joinable())
+			thread.join();
+	}
+	threads.clear();
+}
+
+void mixThreads_t::worker(const size_t index) noexcept
+{
+	uint64_t lastGeneration{0U};
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock{stateMutex};
+		jobReady.wait(lock, [&]() noexcept { return stopping || generation != lastGeneration; });
+		if (stopping)
+			return;
+		lastGeneration = generation;
+		const auto &work{*job};
+		lock.unlock();
+
+		work(index, workers());
+
+		lock.lock();
+		if (--pending == 0U)
+			jobDone.notify_one();
+	}
+}
+
+void mixThreads_t::run(const job_t &work) noexcept
+{
+	std::unique_lock<std::mutex> lock{stateMutex};
+	job = &work;
+	pending = threads.size();
+	++generation;
+	lock.unlock();
+	jobReady.notify_all();
+
+	work(0U, workers());
+
+	lock.lock();
+	jobDone.wait(lock, [&]() noexcept { return pending == 0U; });
+	job = nullptr;
+}
@@ -0,0 +1,78 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Worker threads for mixing a module's voices in parallel
+#ifndef LIBAUDIO_MODULEMIXER_MIXTHREADS_HXX
+#define LIBAUDIO_MODULEMIXER_MIXTHREADS_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "../genericModule/genericModule.h"
+
+// Each worker mixes its share of the voices into one of these, and the results then get summed.
+// As the mix is integer addition, the sum comes out the same no matter how the voices are split.
+struct mixAccumulator_t final
+{
+	fixedVector_t<int32_t> buffer{};
+	int DCOffsL{};
+	int DCOffsR{};
+
+	// Makes sure the buffer holds at least a block of frames. This never shrinks it, so on failure it still fits
+	// every block size it did before.
+	[[nodiscard]] bool reserve(const size_t frames) noexcept
+	{
+		if (buffer.size() >= frames * 2U)
+			return true;
+		fixedVector_t<int32_t> newBuffer{frames * 2U};
+		if (!newBuffer.valid())
+			return false;
+		buffer = std::move(newBuffer);
+		return true;
+	}
+};
+
+struct mixThreads_t final
+{
+public:
+	using job_t = std::function<void (size_t worker, size_t workers)>;
+
+private:
+	std::vector<std::thread> threads{};
+	std::unique_ptr<mixAccumulator_t []> accumulators;
+	std::mutex stateMutex{};
+	std::condition_variable jobReady{};
+	std::condition_variable jobDone{};
+	const job_t *job{nullptr};
+	uint64_t generation{0U};
+	size_t pending{0U};
+	bool stopping{false};
+
+	void worker(size_t index) noexcept;
+	void stop() noexcept;
+
+public:
+	// The calling thread is used as worker 0, so this creates workers - 1 threads, each mixing blocks of up to frames
+	mixThreads_t(size_t workers, size_t frames);
+	~mixThreads_t() noexcept;
+
+	[[nodiscard]] size_t workers() const noexcept { return threads.size() + 1U; }
+	// Worker 0 mixes straight into the module's own buffer, so it has no accumulator
+	[[nodiscard]] mixAccumulator_t &accumulator(const size_t worker) noexcept { return accumulators[worker - 1U]; }
+	// Makes sure every worker's accumulator can hold a block of frames
+	[[nodiscard]] bool reserve(size_t frames) noexcept;
+	// Runs the job on every worker, returning when they have all finished
+	void run(const job_t &work) noexcept;
+
+	mixThreads_t(const mixThreads_t &) noexcept = delete;
+	mixThreads_t(mixThreads_t &&) noexcept = delete;
+	mixThreads_t &operator =(const mixThreads_t &) noexcept = delete;
+	mixThreads_t &operator =(mixThreads_t &&) noexcept = delete;
+};
+
+#endif /*LIBAUDIO_MODULEMIXER_MIXTHREADS_HXX*/
@@ -5,6 +5,9 @@
 #include <cstdlib>
 #include <cmath>
 #include <string_view>
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 #include "../libAudio.hxx"
 #include "../genericModule/genericModule.h"
@@ -13,35 +16,339 @@
 #include "moduleMixer.h"
 #include "mixFunctions.h"
 #include "mixFunctionTables.h"
+#include "mixFunctionsSIMD.hxx"
+#include "mixOutput.hxx"
+#include "mixThreads.hxx"
 #include "frequencyTables.h"
 #include "../console.hxx"
 
 using namespace std::literals::string_view_literals;
+using substrate::make_unique_nothrow;
 
-uint32_t Convert32to16(void *_out, int32_t *_in, uint32_t SampleCount)
+int64_t moduleFile_t::fillBuffer(void *const bufferPtr, const uint32_t length)
+{
+	const auto buffer = static_cast<uint8_t *>(bufferPtr);
+	return ctx->fillBuffer(buffer, length);
+}
+
+/*!
+ * Mixes the song the same way fillBuffer() does, but never past the end of the current tick, starting the next
+ * tick only once the current one has been completely mixed. Given a buffer long enough for a whole tick, each
+ * call therefore mixes exactly one tick, so the audio comes back in blocks lined up with the song's events.
+ * A shorter buffer gets filled and the rest of the tick comes back from the next call, which tickRemaining()
+ * tells apart. Where the ticks fall is not kept in the render cache, so a song being played from the cache
+ * drops out of it for the rest of the play through. This can only be done when the library is not doing the
+ * playback itself.
+ * @param buffer The buffer to mix into
+ * @param length How many bytes long the buffer is
+ * @return The number of bytes written to the buffer, -2 once the song has ended, or -1 if the
+ *   library is doing the playback
+ */
+int64_t moduleFile_t::fillTick(void *const buffer, const uint32_t length) noexcept
+{
+	if (_player)
+		return -1;
+	return ctx->fillBuffer(static_cast<uint8_t *>(buffer), length, true);
+}
+
+/*!
+ * How much of the current tick is still to come from fillTick() or fillBuffer()
+ * @return The number of sample frames left in the tick, 0 if the last call finished it
+ */
+uint32_t moduleFile_t::tickRemaining() const noexcept
+	{ return ctx->mod->tickRemaining(); }
+
+int64_t moduleFile_t::decoderContext_t::fillBuffer(uint8_t *const buffer, const uint32_t length,
+	const bool tickAligned) noexcept
+{
+	if (!renderStarted)
+		startRender();
+	if (renderReader && tickAligned)
+		stopRender();
+	if (renderReader)
+		return renderReader->read(buffer, length);
+	const auto result{tickAligned ? mod->MixTick(buffer, length) : mod->Mix(buffer, length)};
+	if (renderCapture)
+	{
+		if (result > 0)
+		{
+			if (!renderCapture->append(buffer, static_cast<size_t>(result)))
+				renderCapture.reset();
+		}
+		// Mix() also returns -2 when asked for less than a sample frame, which isn't the song ending
+		else if (length >= renderKey.frameSize())
+		{
+			renderCache_t::instance().insert(renderCapture->finish());
+			renderCapture.reset();
+		}
+	}
+	return result;
+}
+
+// Decides, at the start of the song, whether to play it out of the render cache or render it into the cache
+void moduleFile_t::decoderContext_t::startRender() noexcept
 {
-	uint32_t i;
-	int16_t *out = (int16_t *)_out;
-	for (i = 0; i < SampleCount; i++)
+	renderStarted = true;
+	auto &cache{renderCache_t::instance()};
+	const auto budget{cache.budget()};
+	renderKey = mod->renderKey();
+	// A module we could not identify the file contents of would match every other such module
+	if (!budget || !renderKey.file.length)
+		return;
+	if (auto song{cache.find(renderKey)})
 	{
-		int32_t samp = _in[i]/* + (1 << 11)*/;
-		clipInt<int32_t>(samp, 0xF8000001, 0x07FFFFFF);
-		out[i] = samp >> 12U;
+		renderReader = make_unique_nothrow<renderReader_t>(std::move(song));
+		if (renderReader && renderReader->valid())
+			return;
+		renderReader.reset();
 	}
-	return SampleCount << 1U;
+	renderCapture = make_unique_nothrow<renderCapture_t>(renderKey, cache.compress(), budget);
+	if (renderCapture && !renderCapture->valid())
+		renderCapture.reset();
 }
 
-int64_t moduleFile_t::fillBuffer(void *const bufferPtr, const uint32_t length)
+// Something that changes the output was set, so what is in or going in to the render cache no longer applies
+void moduleFile_t::decoderContext_t::renderSettingsChanged() noexcept
 {
-	const auto buffer = static_cast<uint8_t *>(bufferPtr);
-	return ctx->mod->Mix(buffer, length);
+	if (!renderStarted || mod->renderKey() == renderKey)
+		return;
+	stopRender();
+}
+
+// Hands playback back to the mixer for the rest of this play through, leaving the render cache out of it
+void moduleFile_t::decoderContext_t::stopRender() noexcept
+{
+	renderStarted = true;
+	renderCapture.reset();
+	if (!renderReader)
+		return;
+	// The mixer has not moved while the song came from the cache, so catch it up to where playback got to
+	const auto position{renderReader->position()};
+	renderReader.reset();
+	static_cast<void>(mod->seekSamples(position));
+}
+
+// Playback has been moved by a seek, which the mixer takes care of so the render cache is simply left
+void moduleFile_t::decoderContext_t::renderSeeked() noexcept
+{
+	renderStarted = true;
+	renderCapture.reset();
+	renderReader.reset();
+}
+
+/*!
+ * Mixes the song the same way fillBuffer() does, but with each of the module's pattern channels
+ * written out to a buffer of its own. Voices left playing by New Note Actions go in with the
+ * channel that started them. The ticks and effects are only processed once for all the stems,
+ * and each stem comes out in the same sample format and channel count fillBuffer() would produce.
+ * When dithering, each stem gets its own stretch of the dither sequence so the noise doesn't build up
+ * coherently when the stems are summed back together; noise shaping is never applied to stems.
+ * Stems do not come from or go in to the render cache, so this drops out of it for the rest of the song.
+ * This can only be done when the library is not doing the playback itself.
+ * @param buffers An array of stems() buffers to mix into
+ * @param length How many bytes long each of the buffers is
+ * @return The number of bytes written to each buffer, -2 once the song has ended, or -1 if the
+ *   library is doing the playback
+ */
+int64_t moduleFile_t::fillStems(void *const *const buffers, const uint32_t length) noexcept
+{
+	if (_player)
+		return -1;
+	ctx->stopRender();
+	return ctx->mod->MixStems(reinterpret_cast<uint8_t *const *>(buffers), length);
+}
+
+uint8_t moduleFile_t::stems() const noexcept
+	{ return ctx->mod->stems(); }
+
+/*!
+ * Selects how the mixer interpolates between sample points. This can only be changed when the library
+ * is not doing the playback itself, as changing it restarts any render cache in use under the playback engine.
+ * @param mode The interpolation to use
+ * @return \c true if the interpolation could be changed, otherwise \c false
+ */
+bool moduleFile_t::interpolation(const moduleInterpolation_t mode) noexcept
+{
+	if (_player)
+		return false;
+	ctx->mod->interpolation(mode);
+	ctx->renderSettingsChanged();
+	return true;
+}
+
+moduleInterpolation_t moduleFile_t::interpolation() const noexcept
+	{ return ctx->mod->interpolation(); }
+
+/*!
+ * Selects the sample format fillBuffer() produces. This can only be changed when
+ * the library is not doing the playback itself, as the playback engine needs 16-bit samples.
+ * @param format The format to produce
+ * @param dither Whether to apply TPDF dither when reducing the mix to 16-bit
+ * @return \c true if the format could be changed, otherwise \c false
+ */
+bool moduleFile_t::outputFormat(const moduleOutput_t format, const bool dither) noexcept
+{
+	if (_player)
+		return false;
+	ctx->mod->outputFormat(format, dither);
+	if (format == moduleOutput_t::int24)
+		fileInfo().bitsPerSample(24U);
+	else if (format == moduleOutput_t::float32)
+		fileInfo().bitsPerSample(32U);
+	else
+		fileInfo().bitsPerSample(16U);
+	ctx->renderSettingsChanged();
+	return true;
+}
+
+/*!
+ * Sets how many threads are used to mix the module's voices. The result is identical
+ * however many are used, so this purely trades CPU cores for speed on dense modules.
+ * This can only be changed when the library is not doing the playback itself, as the playback engine
+ * may be mixing on the threads at the time.
+ * @param threads The number of threads to mix with, including the calling thread.
+ *   Passing 0 or 1 mixes everything on the calling thread
+ * @return \c true if the threads could be set up, otherwise \c false. If the library is doing the playback
+ *   the old threads remain, otherwise mixing continues on the calling thread
+ */
+bool moduleFile_t::mixThreads(const uint32_t threads) noexcept
+{
+	if (_player)
+		return false;
+	return ctx->mod->mixThreads(threads);
+}
+
+/*!
+ * Sets how many sample frames get mixed at a time. The mix comes out identical whatever this is set to,
+ * so it purely trades memory and cache footprint against the cost of going round the mixer once per block.
+ * Blocks also end at the end of each tick, so there is little to be gained from blocks longer than a tick.
+ * This can only be changed when the library is not doing the playback itself, as the playback engine
+ * may be mixing at the time.
+ * @param frames The number of frames to mix at a time, from mixBlockSizeMin to mixBlockSizeMax
+ * @return \c true if the block size could be changed, otherwise \c false, in which case the old size remains
+ */
+bool moduleFile_t::mixBlockSize(const uint32_t frames) noexcept
+{
+	if (_player)
+		return false;
+	return ctx->mod->mixBlockSize(frames);
+}
+
+uint32_t moduleFile_t::mixBlockSize() const noexcept
+	{ return ctx->mod->mixBlockSize(); }
+
+/*!
+ * Sets up the effects run over the mix before it is converted to the output format. Depths and other settings
+ * out of range are clamped, and changing the effects clears out anything left of the old ones, such as a reverb
+ * tail. Stems are always mixed without the effects. This can only be changed when the library is not doing
+ * the playback itself.
+ * @param settings The effects to use, where a depth of 0 turns that effect off
+ * @return \c true if the effects were changed, \c false if the library is doing the playback or the delay lines
+ *   the effects need could not be allocated
+ */
+bool moduleFile_t::effects(const moduleEffects_t &settings) noexcept
+{
+	if (_player || !ctx->mod->effects(settings))
+		return false;
+	ctx->renderSettingsChanged();
+	return true;
+}
+
+moduleEffects_t moduleFile_t::effects() const noexcept
+	{ return ctx->mod->effects(); }
+
+/*!
+ * Caps how many voices get mixed at once, bounding the worst case cost of mixing a tick.
+ * Once a tick has more voices than this, voices are stolen until it fits, starting with the
+ * quietest background voices left playing by New Note Actions. This can only be changed when
+ * the library is not doing the playback itself.
+ * @param voices The most voices to mix at once, or 0 for no limit
+ * @return \c true if the limit could be changed, otherwise \c false
+ */
+bool moduleFile_t::voiceLimit(const uint32_t voices) noexcept
+{
+	if (_player)
+		return false;
+	ctx->mod->voiceLimit(voices);
+	ctx->renderSettingsChanged();
+	return true;
+}
+
+/*!
+ * Sets the volume below which background voices left playing by New Note Actions are cut rather than mixed.
+ * This can only be changed when the library is not doing the playback itself.
+ * @param volume The threshold on the mixer's 0-128 voice volume scale, or 0 to mix every voice however quiet
+ * @return \c true if the threshold could be changed, otherwise \c false
+ */
+bool moduleFile_t::audibilityThreshold(const uint8_t volume) noexcept
+{
+	if (_player)
+		return false;
+	ctx->mod->audibilityThreshold(volume);
+	ctx->renderSettingsChanged();
+	return true;
+}
+
+uint64_t moduleFile_t::stolenVoices() const noexcept
+	{ return ctx->mod->stolenVoices(); }
+
+uint64_t moduleFile_t::culledVoices() const noexcept
+	{ return ctx->mod->culledVoices(); }
+
+/*!
+ * Moves playback to the given time into the song. This can only be done when the library
+ * is not doing the playback itself, as the playback engine may be mixing at the time.
+ * @param milliseconds How far into the song to move to
+ * @return \c true if playback was moved, otherwise \c false
+ */
+bool moduleFile_t::seek(const uint64_t milliseconds) noexcept
+{
+	if (_player || !ctx->mod->seek(milliseconds))
+		return false;
+	ctx->renderSeeked();
+	return true;
+}
+
+/*!
+ * Moves playback to the start of a row of the song. This can only be done when the library
+ * is not doing the playback itself, as the playback engine may be mixing at the time.
+ * @param order The index into the song's order list to move to
+ * @param row The row in that order's pattern to move to
+ * @return \c true if playback was moved, otherwise \c false
+ */
+bool moduleFile_t::seek(const uint16_t order, const uint16_t row) noexcept
+{
+	if (_player || !ctx->mod->seek(order, row))
+		return false;
+	ctx->renderSeeked();
+	return true;
 }
 
 void ModuleFile::InitMixer(fileInfo_t &info)
 {
 	MixSampleRate = info.bitRate();
 	MixChannels = info.channels();
-	MixBitsPerSample = info.bitsPerSample();
+	if (info.bitsPerSample() == 24U)
+		outputFormat(moduleOutput_t::int24, false);
+	else if (info.bitsPerSample() == 32U)
+		outputFormat(moduleOutput_t::float32, false);
+	else
+		outputFormat(moduleOutput_t::int16, Dither);
+	if (!MixBuffer.valid())
+		MixBuffer = fixedVector_t<int32_t>{size_t{MixBlockSize} * 2U};
+	// The delay lines are sized by the sample rate, so settings made before now get redone for the real one
+	if (!Effects.configure(Effects.effects(), MixSampleRate))
+	{
+		console.error("Could not allocate the mix effects, playing without them"sv);
+		static_cast<void>(Effects.configure({}, MixSampleRate));
+	}
+	resetPlayback();
+}
+
+// Puts playback back at the start of the song with a fresh set of channels
+void ModuleFile::resetPlayback()
+{
+	DeinitMixer();
 	MusicSpeed = p_Header->InitialSpeed;
 	MusicTempo = p_Header->InitialTempo;
 	TickCount = MusicSpeed;
@@ -49,7 +356,13 @@ void ModuleFile::InitMixer(fileInfo_t &info)
 		globalVolume = p_Header->GlobalVolume << 1U;
 	else
 		globalVolume = p_Header->GlobalVolume;
+	globalVolumeSlide = 0;
 	SamplesPerTick = (MixSampleRate * 640U) / (MusicTempo << 8U);
+	SamplesToMix = 0;
+	Row = NextRow = 0;
+	Pattern = NewPattern = NextPattern = 0;
+	PatternDelay = FrameDelay = 0;
+	resetEffects();
 	// If we have the possibility of NNAs, allocate a full set of channels.
 	if (p_Instruments != nullptr)
 	{
@@ -65,6 +378,8 @@ void ModuleFile::InitMixer(fileInfo_t &info)
 
 	for (uint8_t i = 0; i < p_Header->nChannels; ++i)
 	{
+		// Each pattern channel is a stem of its own, which NNA voices then inherit from the channel they came from
+		Channels[i].ParentChannel = i;
 		if (i >= 64U)
 			break;
 		Channels[i].channelVolume = p_Header->Volumes[i];
@@ -74,29 +389,305 @@ void ModuleFile::InitMixer(fileInfo_t &info)
 	ResetChannelPanning();
 }
 
-channel_t::channel_t() noexcept : SampleData{nullptr}, NewSampleData{nullptr}, Note{}, RampLength{},
-	NewNote{}, NewSample{}, LoopStart{}, LoopEnd{}, Length{}, RawVolume{}, volume{},
-	_sampleVolumeSlide{}, _fineSampleVolumeSlide{}, channelVolume{64}, sampleVolume{},
-	autoVibratoDepth{}, autoVibratoPos{}, Sample{nullptr}, Instrument{nullptr}, FineTune{},
-	_panningSlide{}, RawPanning{}, panning{}, RowNote{}, RowSample{}, RowVolEffect{}, Flags{},
-	Period{}, C4Speed{}, Pos{}, PosLo{}, startTick{}, increment{}, portamentoTarget{},
-	portamento{}, portamentoSlide{}, Arpeggio{}, extendedCommand{}, tremor{}, tremorCount{},
-	leftVol{}, rightVol{}, NewLeftVol{}, NewRightVol{}, LeftRamp{}, RightRamp{}, patternLoopCount{},
-	patternLoopStart{}, Filter_Y1{}, Filter_Y2{}, Filter_Y3{}, Filter_Y4{}, Filter_A0{},
-	Filter_B0{}, Filter_B1{}, Filter_HP{}, tremoloDepth{}, tremoloSpeed{}, tremoloPos{}, tremoloType{},
-	vibratoDepth{}, vibratoSpeed{}, vibratoPosition{}, vibratoType{}, panbrelloDepth{}, panbrelloSpeed{},
-	panbrelloPosition{}, panbrelloType{}, EnvVolumePos{}, EnvPanningPos{}, EnvPitchPos{}, FadeOutVol{},
-	DCOffsL{}, DCOffsR{} { }
+/*!
+ * Works out how long the song plays for by stepping through it a tick at a time with mixing skipped entirely.
+ * Only the speed, tempo and navigation effects decide how long that is, so this comes out the same as
+ * playing the song through. Songs that jump back into rows already played would go on forever, so the song
+ * is taken to end on the first row that gets played a second time outside of a pattern loop.
+ * Along the way, this snapshots the playback state going into each order for seek() to start from.
+ * @param sampleRate The rate to time ticks at - this must match the mixer's for the result to be exact
+ * @return The length of the song in milliseconds
+ */
+uint64_t ModuleFile::songLength(const uint32_t sampleRate)
+{
+	nSnapshots = 0U;
+	SongSamples = 0U;
+	SnapshotRate = 0U;
+	if (!sampleRate || !p_Header->nOrders)
+		return 0U;
+	// Ticks get timed at the rate asked for, and the voices stolen getting there are not the listener's concern
+	const auto mixSampleRate{std::exchange(MixSampleRate, sampleRate)};
+	const auto stolenVoices{StolenVoices};
+	const auto culledVoices{CulledVoices};
+	resetPlayback();
+	// Orders only ever get played in increasing order, so there's at most one snapshot per order
+	Snapshots = fixedVector_t<moduleSnapshot_t>{p_Header->nOrders};
+	size_t maxRows{1U};
+	for (uint16_t i = 0; i < p_Header->nPatterns; ++i)
+	{
+		if (p_Patterns[i])
+			maxRows = std::max<size_t>(maxRows, p_Patterns[i]->rows());
+	}
+#ifdef ENABLE_FC1x
+	if (typeIs<MODULE_FC1x>())
+		maxRows = fc1xPatternRows;
+#endif
+	std::vector<bool> rowsPlayed(size_t{p_Header->nOrders} * maxRows);
+
+	uint64_t samples{};
+	while (true)
+	{
+		// If this tick moves the song on to a new order, grab the state going into it
+		const bool newOrder{nSnapshots < Snapshots.size() && (!nSnapshots ||
+			(NextPattern != NewPattern && TickCount + 1U >= (MusicSpeed * (PatternDelay + 1U)) + FrameDelay))};
+		auto state{newOrder ? snapshot(samples, p_Instruments ? 128U : p_Header->nChannels) : moduleSnapshot_t{}};
+		if (!AdvanceTick())
+			break;
+		if (!TickCount)
+		{
+			const auto row{(size_t{NewPattern} * maxRows) + Row};
+			if (rowsPlayed[row])
+			{
+				const uint8_t nChannels = p_Instruments ? 128 : p_Header->nChannels;
+				const auto looping
+				{
+					std::any_of(Channels, Channels + nChannels,
+						[](const channel_t &channel) noexcept { return channel.patternLoopCount != 0; })
+				};
+				if (!looping)
+					break;
+			}
+			rowsPlayed[row] = true;
+			// A snapshot that could not be allocated just means seeks have further to play forward
+			if (newOrder && state.channels.valid())
+			{
+				state.order = NewPattern;
+				state.row = Row;
+				Snapshots[nSnapshots++] = std::move(state);
+			}
+		}
+		// Keep the voices moving so the snapshots catch notes where they would be part way through their samples
+		skipVoices(SamplesToMix);
+		samples += SamplesToMix;
+	}
+	DeinitMixer();
+	MixSampleRate = mixSampleRate;
+	StolenVoices = stolenVoices;
+	CulledVoices = culledVoices;
+	SongSamples = samples;
+	SnapshotRate = sampleRate;
+	return (samples * 1000U) / sampleRate;
+}
+
+moduleSnapshot_t ModuleFile::snapshot(const uint64_t time, const size_t channels) const noexcept
+{
+	moduleSnapshot_t state{};
+	state.time = time;
+	state.TickCount = TickCount;
+	state.SamplesToMix = SamplesToMix;
+	state.MusicSpeed = MusicSpeed;
+	state.MusicTempo = MusicTempo;
+	state.Row = Row;
+	state.NextRow = NextRow;
+	state.Rows = Rows;
+	state.Pattern = Pattern;
+	state.NewPattern = NewPattern;
+	state.NextPattern = NextPattern;
+	state.globalVolume = globalVolume;
+	state.globalVolumeSlide = globalVolumeSlide;
+	state.PatternDelay = PatternDelay;
+	state.FrameDelay = FrameDelay;
+	state.channels = fixedVector_t<channel_t>{channels};
+	if (state.channels.valid())
+		std::copy(Channels, Channels + channels, state.channels.begin());
+	return state;
+}
+
+void ModuleFile::restore(const moduleSnapshot_t &state) noexcept
+{
+	TickCount = state.TickCount;
+	SamplesToMix = state.SamplesToMix;
+	MusicSpeed = state.MusicSpeed;
+	MusicTempo = state.MusicTempo;
+	Row = state.Row;
+	NextRow = state.NextRow;
+	Rows = state.Rows;
+	Pattern = state.Pattern;
+	NewPattern = state.NewPattern;
+	NextPattern = state.NextPattern;
+	globalVolume = state.globalVolume;
+	globalVolumeSlide = state.globalVolumeSlide;
+	PatternDelay = state.PatternDelay;
+	FrameDelay = state.FrameDelay;
+	std::copy(state.channels.begin(), state.channels.end(), Channels);
+	// Any channels not in the snapshot are left free, ready for NNAs to use
+	const size_t nChannels = p_Instruments ? 128 : p_Header->nChannels;
+	if (state.channels.size() < nChannels)
+		std::fill(Channels + state.channels.size(), Channels + nChannels, channel_t{});
+	nMixerChannels = 0;
+}
+
+// Throws away what the effects, noise shaping and DC offset removal remember of the mix so far, for when playback jumps
+void ModuleFile::resetEffects() noexcept
+{
+	DCOffsL = DCOffsR = 0;
+	Effects.reset();
+	NoiseShaper = {};
+}
+
+/*!
+ * Moves playback to the given time into the song. This restores the state snapshotted going into the last order
+ * to start at or before that time and plays forward from there with mixing skipped, so the cost stays at a few
+ * rows no matter where in the song the seek goes to. The voices are kept moving through their samples on the
+ * way, so notes already playing at the seek point carry on from where they would have been.
+ * @param milliseconds How far into the song to move to
+ * @return \c true if playback was moved, \c false if the time is past the end of the song or the song has not
+ *   been scanned by songLength() at the mixer's sample rate, in which case playback is left where it was
+ */
+bool ModuleFile::seek(const uint64_t milliseconds) noexcept
+	{ return seekSamples((milliseconds * MixSampleRate) / 1000U); }
+
+/*!
+ * Moves playback to the given sample frame of the song, the same way seek() does for a time.
+ * @param target How many sample frames into the song to move to
+ * @return \c true if playback was moved, otherwise \c false
+ */
+bool ModuleFile::seekSamples(const uint64_t target) noexcept
+{
+	if (!Channels || !nSnapshots || SnapshotRate != MixSampleRate)
+		return false;
+	if (target >= SongSamples)
+		return false;
+	const auto state
+	{
+		std::prev(std::upper_bound(Snapshots.begin(), Snapshots.begin() + nSnapshots, target,
+			[](const uint64_t time, const moduleSnapshot_t &snapshot) noexcept { return time < snapshot.time; }))
+	};
+	restore(*state);
+	uint64_t time{state->time};
+	while (AdvanceTick())
+	{
+		// Once we reach the tick the target falls in, leave the rest of it to be mixed
+		if (time + SamplesToMix > target)
+		{
+			skipVoices(static_cast<uint32_t>(target - time));
+			SamplesToMix = static_cast<uint32_t>(time + SamplesToMix - target);
+			resetEffects();
+			return true;
+		}
+		skipVoices(SamplesToMix);
+		time += SamplesToMix;
+		SamplesToMix = 0;
+	}
+	return false;
+}
+
+/*!
+ * Moves playback to the start of the given row of the given order. This works the same way as seeking to a time,
+ * playing forward from the snapshot of the last order at or before the requested one.
+ * @param order The index into the song's order list to move to
+ * @param row The row in that order's pattern to move to
+ * @return \c true if playback was moved, \c false if the song never plays that row or has not been scanned by
+ *   songLength(), in which case playback is left where it was
+ */
+bool ModuleFile::seek(const uint16_t order, const uint16_t row) noexcept
+{
+	if (!Channels || !nSnapshots || SnapshotRate != MixSampleRate)
+		return false;
+	const auto state
+	{
+		std::upper_bound(Snapshots.begin(), Snapshots.begin() + nSnapshots, order,
+			[](const uint16_t order, const moduleSnapshot_t &snapshot) noexcept { return order < snapshot.order; })
+	};
+	if (state == Snapshots.begin())
+		return false;
+	// Hold on to exactly where we are in case the row turns out to never get played
+	const auto current{snapshot(0U, p_Instruments ? 128U : p_Header->nChannels)};
+	if (!current.channels.valid())
+		return false;
+	restore(*std::prev(state));
+	uint64_t time{std::prev(state)->time};
+	while (time < SongSamples && AdvanceTick())
+	{
+		if (NewPattern > order)
+			break;
+		if (!TickCount && NewPattern == order && Row == row)
+		{
+			resetEffects();
+			return true;
+		}
+		skipVoices(SamplesToMix);
+		time += SamplesToMix;
+		SamplesToMix = 0;
+	}
+	restore(current);
+	return false;
+}
+
+void ModuleFile::outputFormat(const moduleOutput_t format, const bool dither) noexcept
+{
+	OutputFormat = format;
+	Dither = dither && format == moduleOutput_t::int16;
+	if (format == moduleOutput_t::int24)
+		MixBitsPerSample = 24U;
+	else if (format == moduleOutput_t::float32)
+		MixBitsPerSample = 32U;
+	else
+		MixBitsPerSample = 16U;
+}
+
+bool ModuleFile::effects(const moduleEffects_t &settings) noexcept
+{
+	// Before InitMixer() there's no sample rate, so this only records the settings
+	if (!Effects.configure(settings, MixSampleRate))
+		return false;
+	NoiseShaper = {};
+	return true;
+}
+
+bool ModuleFile::mixThreads(const uint32_t threads) noexcept
+{
+	MixThreads.reset();
+	if (threads <= 1U)
+		return true;
+	try { MixThreads = std::make_unique<mixThreads_t>(threads, MixBlockSize); }
+	catch (const std::exception &e)
+	{
+		console.error("Could not start mixer threads: "sv, e.what());
+		return false;
+	}
+	return true;
+}
+
+bool ModuleFile::mixBlockSize(const uint32_t frames) noexcept
+{
+	if (frames < mixBlockSizeMin || frames > mixBlockSizeMax)
+		return false;
+	// The worker and stem accumulators only ever grow, so if any of them can't they still fit the current size
+	if (MixThreads && !MixThreads->reserve(frames))
+		return false;
+	if (Stems)
+	{
+		for (uint8_t stem = 0; stem < stems(); ++stem)
+		{
+			if (!Stems[stem].reserve(frames))
+				return false;
+		}
+	}
+	// Before the mixer is set up, InitMixer() allocates the buffer at whatever size is set by then
+	if (MixBuffer.valid())
+	{
+		fixedVector_t<int32_t> buffer{size_t{frames} * 2U};
+		if (!buffer.valid())
+			return false;
+		MixBuffer = std::move(buffer);
+	}
+	MixBlockSize = frames;
+	return true;
+}
 
 void ModuleFile::DeinitMixer()
 {
 	delete [] Channels;
 	delete [] MixerChannels;
+	Channels = nullptr;
+	MixerChannels = nullptr;
+	Stems.reset();
 }
 
 void ModuleFile::ResetChannelPanning()
 {
-	if (ModuleType == MODULE_MOD || ModuleType == MODULE_AON)
+	if (ModuleType == MODULE_MOD || ModuleType == MODULE_AON || ModuleType == MODULE_FC1x)
 	{
 		for (uint8_t i = 0; i < p_Header->nChannels; i++)
 		{
@@ -162,7 +753,7 @@ void ModuleFile::ReloadSample(channel_t &channel)
 		channel.LoopStart = 0;
 		channel.LoopEnd = channel.Length;
 	}
-	channel.NewSampleData = p_PCM[sample.id()];
+	channel.NewSampleData = p_PCM[sample.id()].get();
 	channel.FineTune = sample.GetFineTune();
 	channel.C4Speed = sample.GetC4Speed();
 	if (channel.LoopEnd > channel.Length)
@@ -211,6 +802,10 @@ void ModuleFile::SampleChange(channel_t &channel, const uint32_t sampleIndex, co
 				channel.sampleVolume = sample->GetSampleVolume();
 			if (instr->IsPanned())
 				channel.RawPanning = instr->GetPanning();
+			if (instr->HasFilterCutoff())
+				channel.FilterCutoff = instr->GetFilterCutoff();
+			if (instr->HasFilterResonance())
+				channel.FilterResonance = instr->GetFilterResonance();
 		}
 		else
 			channel.sampleVolume = sample->GetSampleVolume();
@@ -293,7 +888,7 @@ void ModuleFile::SampleChange(channel_t &channel, const uint32_t sampleIndex, co
 		channel.Length = channel.LoopEnd;
 	channel.C4Speed = sample->GetC4Speed();
 	channel.FineTune = sample->GetFineTune();
-	channel.NewSampleData = p_PCM[sample->id()];
+	channel.NewSampleData = p_PCM[sample->id()].get();
 }
 
 uint32_t ModuleFile::GetPeriodFromNote(uint8_t Note, uint8_t fineTune, uint32_t C4Speed)
@@ -325,7 +920,7 @@ uint32_t ModuleFile::GetFreqFromPeriod(uint32_t Period, uint32_t C4Speed, int8_t
 {
 	if (!Period)
 		return 0;
-	if (typeIs<MODULE_MOD>())
+	if (typeIs<MODULE_MOD, MODULE_FC1x>())
 		return 14187580UL / Period;
 	else
 	{
@@ -361,6 +956,12 @@ void channel_t::noteChange(ModuleFile &module, uint8_t note, bool handlePorta)
 	}
 	if (note >= 0x80U)
 	{
+		// Scream Tracker lets go of the key on AdLib voices rather than cutting them, so their release still plays
+		if (note == 0xFEU && Adlib.playing())
+		{
+			Adlib.keyOff();
+			return;
+		}
 		if (note == 0xFFU || !module.typeIs<MODULE_IT>())
 			noteOff();
 		else
@@ -390,8 +991,15 @@ void channel_t::noteChange(ModuleFile &module, uint8_t note, bool handlePorta)
 		if (!handlePorta || (!Length && !module.typeIs<MODULE_S3M>()))
 		{
 			Sample = sample;
-			NewSampleData = module.p_PCM[sample->id()];
+			NewSampleData = module.p_PCM[sample->id()].get();
 			Length = sample->GetLength();
+			if (sample->isAdlib())
+			{
+				Adlib.load(static_cast<ModuleSampleAdlib *>(sample)->patch());
+				Adlib.keyOn();
+			}
+			else
+				Adlib.cut();
 			Flags &= ~(CHN_LOOP | CHN_LPINGPONG);
 			if (sample->GetSustainLooped())
 			{
@@ -414,6 +1022,7 @@ void channel_t::noteChange(ModuleFile &module, uint8_t note, bool handlePorta)
 			}
 			Pos = 0;
 			PosLo = 0;
+			FilterState = {};
 			if (vibratoType < 4)
 				vibratoPosition = module.typeIs<MODULE_IT>() && module.useOldEffects() ? 0x10 : 0;
 			//if ((channel->tremoloType & 0x03) != 0)
@@ -508,7 +1117,7 @@ void ModuleFile::HandleNNA(channel_t *channel, uint32_t instrument, uint8_t note
 		channel->rightVol = 0;
 		return;
 	}
-	if (instrument >= totalInstruments())
+	if (instrument > totalInstruments())
 		instrument = 0;
 	auto *sample = channel->Sample;
 	auto *instr = channel->Instrument;
@@ -1092,6 +1701,16 @@ void ModuleFile::processEffects(channel_t &channel, uint8_t param, int16_t &brea
 		case CMD_PANBRELLO:
 			channel.panbrello(param);
 			break;
+		case CMD_MIDI:
+			// Only Impulse Tracker's default MIDI macros are supported: Z00-Z7F set the filter cutoff,
+			// and Z80-Z8F set the resonance in steps of 8
+			if (TickCount != 0)
+				break;
+			if (param < 0x80U)
+				channel.FilterCutoff = param;
+			else if (param < 0x90U)
+				channel.FilterResonance = (param & 0x0FU) << 3U;
+			break;
 		default:
 			break;
 	}
@@ -1137,17 +1756,17 @@ bool ModuleFile::handleNavigationEffects(const int32_t patternLoopRow, const int
 	return true;
 }
 
-void channel_t::SetData(command_t *Command, ModuleHeader *p_Header)
+void channel_t::SetData(const command_t &command, ModuleHeader *p_Header)
 {
 	uint8_t excmd;
-	RowNote = Command->Note;
-	RowSample = Command->Sample;
+	RowNote = command.Note;
+	RowSample = command.Sample;
 	if ((p_Header->nInstruments && RowSample > p_Header->nInstruments) || (!p_Header->nInstruments && RowSample > p_Header->nSamples))
 		RowSample = 0;
-	RowVolEffect = Command->VolEffect;
-	RowVolParam = Command->VolParam;
-	RowEffect = Command->Effect;
-	RowParam = Command->Param;
+	RowVolEffect = command.VolEffect;
+	RowVolParam = command.VolParam;
+	RowEffect = command.Effect;
+	RowParam = command.Param;
 	excmd = (RowParam & 0xF0U) >> 4U;
 	if ((RowEffect == CMD_MOD_EXTENDED && excmd == CMD_MODEX_DELAYSAMP) ||
 		(RowEffect == CMD_S3M_EXTENDED && excmd == CMD_S3MEX_DELAYSAMP))
@@ -1159,6 +1778,10 @@ void channel_t::SetData(command_t *Command, ModuleHeader *p_Header)
 
 bool ModuleFile::Tick()
 {
+#ifdef ENABLE_FC1x
+	if (typeIs<MODULE_FC1x>())
+		return fc1xTick();
+#endif
 	TickCount++;
 	if (TickCount >= (MusicSpeed * (PatternDelay + 1)) + FrameDelay)
 	{
@@ -1189,24 +1812,119 @@ bool ModuleFile::Tick()
 		if (!p_Patterns[Pattern])
 			return false;
 		const pattern_t &pattern = *p_Patterns[Pattern];
-		const auto &commands = pattern.commands();
 		Rows = pattern.rows();
+		// The commands for a row are stored contiguously in channel order
+		const command_t *const commands = pattern.row(Row);
 		for (uint32_t i = 0; i < p_Header->nChannels; ++i)
-			Channels[i].SetData(&commands[i][Row], p_Header);
+			Channels[i].SetData(commands[i], p_Header);
 	}
 	if (MusicSpeed == 0)
 		MusicSpeed = 1;
 	return ProcessEffects();
 }
 
+#ifdef ENABLE_FC1x
+/*!
+ * Future Composer songs are sequenced differently to the other formats: each step of the sequence gives every voice
+ * its own pattern and transposes, and the voices' macros then decide what is heard on every tick. The song is
+ * still timed through the same speed, row and order state as the others, so seeking and the song length work the
+ * same way, and what the voices pick to play is handed to the mixer through their channels as usual.
+ */
+bool ModuleFile::fc1xTick()
+{
+	TickCount++;
+	if (TickCount >= MusicSpeed)
+	{
+		TickCount = 0;
+		Row = NextRow;
+		Rows = fc1xPatternRows;
+		// A pattern end marker on any of the voices moves the song on to the next step early
+		while (NextPattern < p_Header->nOrders)
+		{
+			NewPattern = Pattern = NextPattern;
+			bool ended{false};
+			for (uint8_t i = 0; i < p_Header->nChannels; ++i)
+				ended |= FCSong.note(FCSong.step(NewPattern, i).pattern, Row) == fc1xPatternEnd;
+			if (!ended)
+				break;
+			++NextPattern;
+			Row = 0;
+		}
+		if (NextPattern >= p_Header->nOrders)
+			return false;
+		if (!Row && FCSong.speed(NewPattern))
+			MusicSpeed = FCSong.speed(NewPattern);
+		NextRow = Row + 1;
+		if (NextRow >= Rows)
+		{
+			NextPattern = NewPattern + 1;
+			NextRow = 0;
+		}
+		for (uint8_t i = 0; i < p_Header->nChannels; ++i)
+		{
+			const auto step{FCSong.step(NewPattern, i)};
+			Channels[i].FC.row(FCSong, FCSong.note(step.pattern, Row), FCSong.info(step.pattern, Row),
+				FCSong.info(step.pattern, Row + 1U), step);
+		}
+	}
+	for (uint8_t i = 0; i < p_Header->nChannels; ++i)
+	{
+		auto &channel{Channels[i]};
+		channel.FC.tick(FCSong);
+		fc1xWaveChange(channel);
+		// Periods are kept at 4 times the Amiga's, as for MODs, and the volume goes from 0-64 to 0-128
+		channel.Period = uint32_t{channel.FC.period()} << 2U;
+		channel.RawVolume = channel.FC.volume() << 1U;
+	}
+	return true;
+}
+
+// Points the channel at the sample or waveform its voice has moved on to, if it has
+void ModuleFile::fc1xWaveChange(channel_t &channel)
+{
+	const auto change{channel.FC.takeWaveChange()};
+	if (change == fc1xWaveChange_t::none)
+		return;
+	// Sub-samples of sample packs are kept after the waveforms, 20 slots to a sample
+	const auto subSample{channel.FC.subSample()};
+	const auto wave{channel.FC.wave()};
+	if (subSample == fc1xNoSubSample)
+		SampleChange(channel, wave + 1U, false);
+	else if (wave < fc1xSamples && subSample < fc1xPackSamples)
+		SampleChange(channel, p_Header->nSamples - ((fc1xSamples - wave) * fc1xPackSamples) + subSample + 1U, false);
+	else
+		return;
+	if (change == fc1xWaveChange_t::restart || channel.Pos >= channel.Length)
+	{
+		channel.Pos = 0;
+		channel.PosLo = 0;
+	}
+}
+#endif
+
 bool ModuleFile::AdvanceTick()
 {
+	const uint8_t nChannels = p_Instruments ? 128 : p_Header->nChannels;
+	// Voices stolen last tick have faded out by now, so cut them before the new row gets a chance to reuse them
+	for (uint8_t i = 0; i < nChannels; ++i)
+	{
+		auto &channel = Channels[i];
+		if (!channel.stolen)
+			continue;
+		channel.SampleData = nullptr;
+		channel.Length = 0;
+		channel.Adlib.cut();
+		channel.FadeOutVol = 0;
+		channel.leftVol = channel.rightVol = 0;
+		channel.RampLength = 0;
+		channel.Flags &= ~CHN_VOLUMERAMP;
+		channel.stolen = false;
+	}
 	if (!Tick() || !MusicTempo)
 		return false;
 	SamplesToMix = (MixSampleRate * 640U) / (MusicTempo << 8U);
 	SamplesPerTick = SamplesToMix;
 	nMixerChannels = 0;
-	const uint8_t nChannels = p_Instruments ? 128 : p_Header->nChannels;
 	for (uint8_t i = 0; i < nChannels; i++)
 	{
 		auto &channel = Channels[i];
@@ -1217,7 +1935,7 @@ bool ModuleFile::AdvanceTick()
 		channel.panning = channel.RawPanning;
 		channel.RampLength = 0;
 
-		if (channel.Period != 0 && channel.Length != 0)
+		if (channel.Period != 0 && (channel.Length != 0 || channel.Adlib.playing()))
 		{
 			uint16_t vol = channel.RawVolume;
 			if (channel.Flags & CHN_TREMOLO)
@@ -1257,6 +1975,7 @@ bool ModuleFile::AdvanceTick()
 			if ((p_Header->Flags & FILE_FLAGS_AMIGA_LIMITS) != 0)
 				clipInt<uint32_t>(period, 452, 3424);
 			period = channel.applyPitchEnvelope(period);
+			channel.applyFilter(MixSampleRate);
 			period += channel.applyVibrato(*this, period);
 			channel.applyPanbrello();
 			int8_t fractionalPeriod{0};
@@ -1264,7 +1983,10 @@ bool ModuleFile::AdvanceTick()
 			if (period <= MinPeriod || period & 0x80000000)
 			{
 				if (ModuleType == MODULE_S3M)
+				{
 					channel.Length = 0;
+					channel.Adlib.cut();
+				}
 				period = MinPeriod;
 			}
 			else if (period > MaxPeriod)
@@ -1287,6 +2009,13 @@ bool ModuleFile::AdvanceTick()
 				channel.volume = 0;
 				channel.Flags |= CHN_NOTEFADE;
 			}
+			// AdLib voices take middle C at the instrument's C4Speed to be the same as on the real chip, and apply
+			// the volume to their operators' levels, so are only panned when mixed
+			if (channel.Adlib.playing())
+			{
+				channel.Adlib.frequency(muldiv_t<uint32_t>{}(freq, opl2MiddleC, 8363U), MixSampleRate);
+				channel.Adlib.level(uint8_t(std::min<uint16_t>(channel.volume >> 1U, 63U)));
+			}
 			int32_t inc = muldiv_t<uint32_t>{}(freq, 0x10000U, MixSampleRate) + 1;
 			if (incNegative && (channel.Flags & CHN_LPINGPONG) != 0 && channel.Pos != 0)
 				inc = -inc;
@@ -1300,15 +2029,16 @@ bool ModuleFile::AdvanceTick()
 		if ((channel.increment.Value.Hi + 1) >= (int32_t)channel.LoopEnd)
 			channel.Flags &= ~CHN_LOOP;
 		channel.SampleData = ((channel.NewSampleData && channel.Length && channel.increment.iValue) ? channel.NewSampleData : nullptr);
-		if (channel.SampleData != nullptr)
+		if (channel.SampleData != nullptr || channel.Adlib.playing())
 		{
+			const uint16_t volume = channel.Adlib.playing() ? (channel.volume ? 128U : 0U) : channel.volume;
 			if (MixChannels == 2 && (channel.Flags & CHN_SURROUND) == 0)
 			{
-				channel.NewLeftVol = uint16_t(channel.volume * channel.panning) >> 8U;
-				channel.NewRightVol = (channel.volume * (256U - channel.panning)) >> 8U;
+				channel.NewLeftVol = uint16_t(volume * channel.panning) >> 8U;
+				channel.NewRightVol = (volume * (256U - channel.panning)) >> 8U;
 			}
 			else
-				channel.NewLeftVol = channel.NewRightVol = channel.volume;
+				channel.NewLeftVol = channel.NewRightVol = volume;
 
 			channel.RightRamp = channel.LeftRamp = 0U;
 			// TODO: Process ping-pong flag (pos = -pos)
@@ -1361,12 +2091,101 @@ bool ModuleFile::AdvanceTick()
 			channel.leftVol = channel.rightVol = channel.Length = 0;
 	}
 
+	limitVoices();
 	return true;
 }
 
+/*!
+ * Bounds how many voices get mixed per tick. Background voices left playing by NNAs that have faded below the
+ * audibility threshold are cut first, then if there are still more voices than the budget allows, the cheapest
+ * to lose are stolen - background voices before the song's own channels, then the quietest, then the one furthest
+ * through its volume envelope. Rather than being cut outright, which clicks, taken voices fade out over the rest
+ * of the tick and no longer count against the budget, then get cut and left free for the next NNA.
+ */
+void ModuleFile::limitVoices() noexcept
+{
+	const auto background{[this](const uint32_t index) noexcept { return index >= p_Header->nChannels; }};
+	const auto loudness{[this](const uint32_t index) noexcept
+		{ return std::max(Channels[index].NewLeftVol, Channels[index].NewRightVol); }};
+	uint32_t voices = nMixerChannels;
+
+	if (AudibilityThreshold)
+	{
+		for (uint32_t i = 0; i < nMixerChannels; ++i)
+		{
+			const auto index{MixerChannels[i]};
+			if (background(index) && loudness(index) < AudibilityThreshold)
+			{
+				stealVoice(i);
+				++CulledVoices;
+				--voices;
+			}
+		}
+	}
+
+	while (MaxVoices && voices > MaxVoices)
+	{
+		// Voices already on their way out are no longer in the running
+		uint32_t victim = nMixerChannels;
+		for (uint32_t i = 0; i < nMixerChannels; ++i)
+		{
+			const auto index{MixerChannels[i]};
+			if (Channels[index].stolen)
+				continue;
+			if (victim == nMixerChannels)
+			{
+				victim = i;
+				continue;
+			}
+			const auto current{MixerChannels[victim]};
+			if (background(index) != background(current))
+			{
+				if (background(index))
+					victim = i;
+			}
+			else if (loudness(index) != loudness(current))
+			{
+				if (loudness(index) < loudness(current))
+					victim = i;
+			}
+			else if (Channels[index].EnvVolumePos > Channels[current].EnvVolumePos)
+				victim = i;
+		}
+		stealVoice(victim);
+		++StolenVoices;
+		--voices;
+	}
+}
+
+// Starts the voice in the given slot of the mix list fading out, leaving it to be cut at the start of the next tick
+void ModuleFile::stealVoice(const uint32_t index) noexcept
+{
+	channel_t &channel = Channels[MixerChannels[index]];
+	channel.stolen = true;
+	channel.fadeOut();
+}
+
+/*!
+ * Sets up the next leg of taking a stolen voice down to silence. Ramps only step by whole volume levels, so to land
+ * on exactly nothing both sides step down together until the quieter one is silent, and then the louder one carries
+ * on alone - at most 255 frames all told. Once both sides are silent, this leaves the voice alone.
+ */
+void channel_t::fadeOut() noexcept
+{
+	const uint8_t steps = leftVol && rightVol ? std::min(leftVol, rightVol) : std::max(leftVol, rightVol);
+	LeftRamp = leftVol ? -1 : 0;
+	RightRamp = rightVol ? -1 : 0;
+	NewLeftVol = leftVol ? static_cast<uint8_t>(leftVol - steps) : 0U;
+	NewRightVol = rightVol ? static_cast<uint8_t>(rightVol - steps) : 0U;
+	RampLength = steps;
+	if (steps)
+		Flags |= CHN_VOLUMERAMP;
+	else
+		Flags &= ~(CHN_FASTVOLRAMP | CHN_VOLUMERAMP);
+}
+
 uint32_t channel_t::GetSampleCount(uint32_t samples)
 {
-	uint32_t maxSamples, sampleCount;
 	uint32_t loopStart = ((Flags & CHN_LOOP) != 0 ? LoopStart : 0);
 	int16dot16 nextIncrement = increment;
 	if (samples == 0 || increment.iValue == 0 || Length == 0)
@@ -1438,39 +2257,16 @@ uint32_t channel_t::GetSampleCount(uint32_t samples)
 	}
 	if ((Pos & 0x80000000U) || Pos >= Length)
 		return 0;
-	sampleCount = samples;
 	if (nextIncrement.iValue < 0)
 		nextIncrement.iValue = -nextIncrement.iValue;
-	maxSamples = 16384U / (nextIncrement.Value.Hi + 1U);
-	if (maxSamples < 2)
-		maxSamples = 2;
-	if (samples > maxSamples)
-		samples = maxSamples;
-	const uint32_t deltaHi = nextIncrement.Value.Hi * (samples - 1U);
-	const uint32_t deltaLo = nextIncrement.Value.Lo * (samples - 1U);
-	if (increment.iValue < 0)
-	{
-		const uint32_t posDest = Pos - deltaHi - ((deltaLo - PosLo) >> 16U);
-		if ((posDest & 0x80000000U) || posDest < loopStart)
-		{
-			sampleCount = (((Pos - loopStart) << 16U) + PosLo - 1) / nextIncrement.iValue;
-			++sampleCount;
-		}
-	}
-	else
-	{
-		const uint32_t posDest = Pos + deltaHi + ((deltaLo + PosLo) >> 16U);
-		if (posDest >= Length)
-		{
-			sampleCount = (((Length - Pos) << 16U) - PosLo - 1) / nextIncrement.iValue;
-			++sampleCount;
-		}
-	}
-	if (sampleCount <= 1U)
-		return 1;
-	if (sampleCount > samples)
-		return samples;
-	return sampleCount;
+	// The mixing functions step through at most this many samples at once so their 16.16 positions can't overflow
+	samples = std::min(samples, std::max(16384U / (nextIncrement.Value.Hi + 1U), 2U));
+	// Then stop on the first frame that reaches the end of the loop or sample being headed for, leaving the next
+	// call to wrap or stop the voice. Reads the mixing does either side of that come from the guard frames.
+	const uint64_t remaining{increment.iValue < 0 ? (uint64_t{Pos - loopStart} << 16U) + PosLo :
+		(uint64_t{Length - Pos} << 16U) - PosLo};
+	const auto step{static_cast<uint64_t>(nextIncrement.iValue)};
+	return static_cast<uint32_t>(std::clamp<uint64_t>((remaining + step - 1U) / step, 1U, samples));
 }
 
 inline void ModuleFile::FixDCOffset(int *p_DCOffsL, int *p_DCOffsR, int *buff, uint32_t samples)
@@ -1501,97 +2297,336 @@ inline void ModuleFile::FixDCOffset(int *p_DCOffsL, int *p_DCOffsR, int *buff, u
 	*p_DCOffsR = DCOffsR;
 }
 
-inline void ModuleFile::DCFixingFill(uint32_t samples)
+inline void ModuleFile::DCFixingFill(int32_t *const buffer, const uint32_t samples, int &dcOffsL, int &dcOffsR)
 {
-	int *buff = MixBuffer;
+	int *buff = buffer;
 	for (uint32_t i = 0; i < samples; i++)
 	{
 		buff[0] = 0;
 		buff[1] = 0;
 		buff += 2;
 	}
-	FixDCOffset(&DCOffsL, &DCOffsR, MixBuffer, samples);
+	FixDCOffset(&dcOffsL, &dcOffsR, buffer, samples);
 }
 
-void ModuleFile::CreateStereoMix(uint32_t count)
+uint32_t ModuleFile::GetResamplingFlag() const noexcept
 {
-	/*uint32_t Flags;*/
-	if (count == 0)
-		return;
-	/*Flags = GetResamplingFlag();*/
-	for (uint32_t i = 0; i < nMixerChannels; i++)
+	switch (Interpolation)
 	{
-		uint32_t samples = count;
-		int32_t *buff = MixBuffer;
-		channel_t * const channel = &Channels[MixerChannels[i]];
-		if (channel->SampleData == nullptr)
-			continue;
-		do
+		case moduleInterpolation_t::linear:
+			return MIX_LINEARSRC;
+		case moduleInterpolation_t::cubic:
+			return MIX_HQSRC;
+		case moduleInterpolation_t::sinc:
+			return MIX_SINCSRC;
+		default:
+			return MIX_NOSRC;
+	}
+}
+
+// AdLib voices get synthesised a block at a time in place of interpolating sample data, then mixed in as mono
+static void synthLoop(channel_t &channel, int32_t *begin, int32_t *const end, storeFn_t store) noexcept
+{
+	std::array<int32_t, filterBlockFrames> block{};
+	uint32_t leftVol{channel.leftVol};
+	uint32_t rightVol{channel.rightVol};
+	while (begin < end)
+	{
+		const auto frames{std::min<uint32_t>(filterBlockFrames, static_cast<uint32_t>(end - begin) / 2U)};
+		channel.Adlib.render(block.data(), frames);
+		for (uint32_t frame{}; frame < frames; ++frame, begin += 2U)
 		{
-			auto rampSamples = samples;
-			if (channel->RampLength > 0)
-			{
-				if (rampSamples > channel->RampLength)
-					rampSamples = channel->RampLength;
-			}
-			const auto SampleCount = channel->GetSampleCount(rampSamples);
-			if (SampleCount <= 0)
+			const int16_t sample{clipSample(block[frame])};
+			store(channel, begin, sample, sample, leftVol, rightVol);
+		}
+	}
+	channel.leftVol = leftVol;
+	channel.rightVol = rightVol;
+}
+
+void ModuleFile::MixChannel(channel_t &channel, int32_t *buff, uint32_t samples, const uint32_t flags,
+	int &dcOffsL, int &dcOffsR)
+{
+	const auto &mixFunctions = selectMixFunctionTable();
+	// Blocks never run past the end of a tick, so this is the last block of the tick when it takes the rest of it
+	const bool tickEnd = samples == SamplesToMix;
+	do
+	{
+		auto rampSamples = samples;
+		if (channel.RampLength > 0)
+		{
+			if (rampSamples > channel.RampLength)
+				rampSamples = channel.RampLength;
+		}
+		// AdLib voices play for as long as they're in the mix, so have no sample end to stop at
+		const auto SampleCount = channel.synthesised() ? rampSamples : channel.GetSampleCount(rampSamples);
+		if (SampleCount <= 0)
+		{
+			// The level a stopped voice was left at dies away on its own until the end of the tick, and only
+			// then joins the mix's offset. Merging at the end of whichever block it stopped in would round the
+			// offset differently depending on how the tick got split into blocks.
+			FixDCOffset(&channel.DCOffsL, &channel.DCOffsR, buff, samples);
+			if (tickEnd)
 			{
-				FixDCOffset(&channel->DCOffsL, &channel->DCOffsR, buff, samples);
-				DCOffsL += channel->DCOffsL;
-				DCOffsR += channel->DCOffsR;
-				channel->DCOffsL = channel->DCOffsR = 0;
-				samples = 0;
-				continue;
+				dcOffsL += channel.DCOffsL;
+				dcOffsR += channel.DCOffsR;
+				channel.DCOffsL = channel.DCOffsR = 0;
 			}
-			if (channel->RampLength == 0 && (channel->leftVol | channel->rightVol) == 0)
-				buff += SampleCount * 2;
-			else
+			samples = 0;
+			continue;
+		}
+		// AdLib voices still have to be run while silent to keep their envelopes going, and as they die away to
+		// nothing by themselves, don't need their DC offsets tracking
+		if (channel.synthesised())
+		{
+			int *BuffMax = buff + (SampleCount * 2U);
+			synthLoop(channel, buff, BuffMax, channel.RampLength ? rampMono : storeMono);
+			buff = BuffMax;
+		}
+		else if (channel.RampLength == 0 && (channel.leftVol | channel.rightVol) == 0)
+			buff += SampleCount * 2;
+		else
+		{
+			MixInterface MixFunc = mixFunctions[flags | (channel.RampLength ? MIX_RAMP : 0) |
+				(channel.filtered() ? MIX_FILTER : 0) | (channel.Sample->GetStereo() ? MIX_STEREO : 0)];
+			int *BuffMax = buff + (SampleCount * 2U);
+			channel.DCOffsR = -((BuffMax - 2U)[0]);
+			channel.DCOffsL = -((BuffMax - 2U)[1]);
+			MixFunc(&channel, buff, BuffMax);
+			channel.DCOffsR += ((BuffMax - 2U)[0]);
+			channel.DCOffsL += ((BuffMax - 2U)[1]);
+			buff = BuffMax;
+		}
+		samples -= SampleCount;
+		if (channel.RampLength != 0)
+		{
+			channel.RampLength -= SampleCount;
+			if (channel.RampLength <= 0)
 			{
-				MixInterface MixFunc = MixFunctionTable[/*Flags*/MIX_NOSRC | (channel->RampLength ? MIX_RAMP : 0) |
-					(channel->Sample->Get16Bit() ? MIX_16BIT : 0) | (channel->Sample->GetStereo() ? MIX_STEREO : 0)];
-				int *BuffMax = buff + (SampleCount * 2U);
-				channel->DCOffsR = -((BuffMax - 2U)[0]);
-				channel->DCOffsL = -((BuffMax - 2U)[1]);
-				MixFunc(channel, buff, BuffMax);
-				channel->DCOffsR += ((BuffMax - 2U)[0]);
-				channel->DCOffsL += ((BuffMax - 2U)[1]);
-				buff = BuffMax;
+				channel.RampLength = 0;
+				channel.leftVol = channel.NewLeftVol;
+				channel.rightVol = channel.NewRightVol;
+				channel.LeftRamp = channel.RightRamp = 0;
+				channel.Flags &= ~(CHN_FASTVOLRAMP | CHN_VOLUMERAMP);
+				if (channel.stolen)
+					channel.fadeOut();
 			}
-			samples -= SampleCount;
-			if (channel->RampLength != 0)
+		}
+	}
+	while (samples > 0);
+}
+
+/*!
+ * Moves a voice going forwards round a loop on through the given number of frames in one go. Doing this a call to
+ * GetSampleCount() at a time takes a call for every pass of the loop, which for short loops adds up to the bulk
+ * of working out a song's length. The wraps GetSampleCount() does keep the fraction of the position, so taking
+ * whole loops off here lands the voice exactly where those would have.
+ * @return \c false if the voice is not inside a forwards loop it can't step clean out of in one frame, leaving
+ *   it to be moved on a call to GetSampleCount() at a time
+ */
+static bool skipLoop(channel_t &channel, const uint32_t samples) noexcept
+{
+	if ((channel.Flags & (CHN_LOOP | CHN_LPINGPONG)) != CHN_LOOP || channel.increment.iValue <= 0)
+		return false;
+	const uint64_t loopStart{channel.LoopStart};
+	const uint64_t loopEnd{std::min(channel.Length, channel.LoopEnd)};
+	const auto step{static_cast<uint64_t>(channel.increment.iValue)};
+	if (channel.Pos < loopStart || channel.Pos >= loopEnd || step > (loopEnd - loopStart) << 16U)
+		return false;
+	const uint64_t loopLength{(loopEnd - loopStart) << 16U};
+	auto position{(uint64_t{channel.Pos} << 16U) + (channel.PosLo & 0xFFFFU) + (step * samples)};
+	if (position >= loopEnd << 16U)
+		position = (loopStart << 16U) + ((position - (loopStart << 16U)) % loopLength);
+	channel.Pos = static_cast<uint32_t>(position >> 16U);
+	channel.PosLo = static_cast<uint32_t>(position & 0xFFFFU);
+	return true;
+}
+
+// Moves a voice on through the given number of frames just as MixChannel() would, without mixing any of them
+static void skipChannel(channel_t &channel, uint32_t samples) noexcept
+{
+	std::array<int32_t, filterBlockFrames> block{};
+	while (samples > 0)
+	{
+		// Once any volume ramp is done with, a looping voice can be moved on to where it ends up in one go
+		if (!channel.synthesised() && channel.RampLength == 0 && (channel.leftVol | channel.rightVol) != 0 &&
+			skipLoop(channel, samples))
+			break;
+		auto rampSamples = samples;
+		if (channel.RampLength > 0 && rampSamples > channel.RampLength)
+			rampSamples = channel.RampLength;
+		const auto SampleCount = channel.synthesised() ? rampSamples : channel.GetSampleCount(rampSamples);
+		if (SampleCount <= 0)
+		{
+			// Whatever level the voice stopped at would have died away by the time anything else got played
+			channel.DCOffsL = channel.DCOffsR = 0;
+			break;
+		}
+		// AdLib voices have to be run to keep their envelopes going, so get synthesised into the void
+		if (channel.synthesised())
+		{
+			for (uint32_t frame{}; frame < SampleCount; frame += filterBlockFrames)
+				channel.Adlib.render(block.data(), std::min<uint32_t>(filterBlockFrames, SampleCount - frame));
+		}
+		// Silent voices don't move through their samples when mixed either, so once GetSampleCount() has had its
+		// go at wrapping them, the rest of the frames would leave them just where they are
+		else if (channel.RampLength == 0 && (channel.leftVol | channel.rightVol) == 0)
+			break;
+		else
+		{
+			const uint32_t position = channel.PosLo + (static_cast<uint32_t>(channel.increment.iValue) * SampleCount);
+			channel.Pos += static_cast<int32_t>(position) >> 16;
+			channel.PosLo = position & 0xFFFFU;
+		}
+		samples -= SampleCount;
+		if (channel.RampLength != 0)
+		{
+			channel.leftVol = static_cast<uint8_t>(channel.leftVol + (channel.LeftRamp * static_cast<int32_t>(SampleCount)));
+			channel.rightVol =
+				static_cast<uint8_t>(channel.rightVol + (channel.RightRamp * static_cast<int32_t>(SampleCount)));
+			channel.RampLength -= SampleCount;
+			if (channel.RampLength <= 0)
 			{
-				channel->RampLength -= SampleCount;
-				if (channel->RampLength <= 0)
-				{
-					channel->RampLength = 0;
-					channel->leftVol = channel->NewLeftVol;
-					channel->rightVol = channel->NewRightVol;
-					channel->LeftRamp = channel->RightRamp = 0;
-					channel->Flags &= ~(CHN_FASTVOLRAMP | CHN_VOLUMERAMP);
-				}
+				channel.RampLength = 0;
+				channel.leftVol = channel.NewLeftVol;
+				channel.rightVol = channel.NewRightVol;
+				channel.LeftRamp = channel.RightRamp = 0;
+				channel.Flags &= ~(CHN_FASTVOLRAMP | CHN_VOLUMERAMP);
+				if (channel.stolen)
+					channel.fadeOut();
 			}
 		}
-		while (samples > 0);
 	}
 }
 
-inline void ModuleFile::MonoFromStereo(uint32_t count)
+/*!
+ * Plays the voices of the current tick on through the given number of frames with mixing skipped, so that
+ * seeks leave notes part way through their samples exactly where playing up to the same point would have.
+ * Only the state of the voices' resonant filters is not carried along.
+ */
+void ModuleFile::skipVoices(const uint32_t samples) noexcept
 {
-	for (uint32_t i = 0; i < count; i++)
-		MixBuffer[i] = MixBuffer[i << 1U];
+	for (uint32_t i = 0; i < nMixerChannels; i++)
+	{
+		channel_t &channel = Channels[MixerChannels[i]];
+		if (channel.mixable())
+			skipChannel(channel, samples);
+	}
 }
 
-int32_t ModuleFile::Mix(uint8_t *Buffer, uint32_t BuffLen)
+void ModuleFile::CreateStereoMix(uint32_t count)
 {
-	uint32_t Count, SampleCount, Mixed = 0;
-	uint32_t SampleSize = MixBitsPerSample / 8U * MixChannels;
-	uint32_t Max = BuffLen / SampleSize;
+	if (count == 0)
+		return;
+	const uint32_t Flags = GetResamplingFlag();
+	// Only farm the voices out when there are enough of them to make waking the workers worth it
+	if (!MixThreads || nMixerChannels < MixThreads->workers() * minimumChannelsPerWorker)
+	{
+		for (uint32_t i = 0; i < nMixerChannels; i++)
+		{
+			channel_t &channel = Channels[MixerChannels[i]];
+			if (channel.mixable())
+				MixChannel(channel, MixBuffer.data(), count, Flags, DCOffsL, DCOffsR);
+		}
+		return;
+	}
 
-	if (Max == 0)
-		return -2;
-	if (NextPattern >= p_Header->nOrders)
-		return (Mixed == 0 ? -2 : Mixed * (MixBitsPerSample / 8U) * MixChannels);
+	// Worker 0 mixes straight into MixBuffer, the rest into their own accumulators.
+	// Each voice belongs to exactly one worker so no channel state is shared between threads.
+	MixThreads->run([this, count, Flags](const size_t worker, const size_t workers) noexcept
+	{
+		int32_t *buffer = MixBuffer.data();
+		int *dcOffsL = &DCOffsL;
+		int *dcOffsR = &DCOffsR;
+		if (worker != 0)
+		{
+			auto &accumulator = MixThreads->accumulator(worker);
+			std::fill_n(accumulator.buffer.begin(), count * 2U, 0);
+			accumulator.DCOffsL = accumulator.DCOffsR = 0;
+			buffer = accumulator.buffer.data();
+			dcOffsL = &accumulator.DCOffsL;
+			dcOffsR = &accumulator.DCOffsR;
+		}
+		for (size_t i = worker; i < nMixerChannels; i += workers)
+		{
+			channel_t &channel = Channels[MixerChannels[i]];
+			if (channel.mixable())
+				MixChannel(channel, buffer, count, Flags, *dcOffsL, *dcOffsR);
+		}
+	});
+
+	for (size_t worker = 1; worker < MixThreads->workers(); ++worker)
+	{
+		const auto &accumulator = MixThreads->accumulator(worker);
+		for (uint32_t i = 0; i < count * 2U; ++i)
+			MixBuffer[i] += accumulator.buffer[i];
+		DCOffsL += accumulator.DCOffsL;
+		DCOffsR += accumulator.DCOffsR;
+	}
+}
+
+// Each voice mixes into its parent channel's stem, and each stem belongs to only one worker so they can be mixed in parallel
+void ModuleFile::CreateStemMix(uint32_t count)
+{
+	if (count == 0)
+		return;
+	const uint32_t Flags = GetResamplingFlag();
+	const auto mixStems = [this, count, Flags](const size_t worker, const size_t workers) noexcept
+	{
+		for (uint32_t i = 0; i < nMixerChannels; i++)
+		{
+			channel_t &channel = Channels[MixerChannels[i]];
+			if (!channel.mixable() || channel.ParentChannel % workers != worker)
+				continue;
+			auto &stem = Stems[channel.ParentChannel];
+			MixChannel(channel, stem.buffer.data(), count, Flags, stem.DCOffsL, stem.DCOffsR);
+		}
+	};
+	if (!MixThreads || nMixerChannels < MixThreads->workers() * minimumChannelsPerWorker)
+		mixStems(0, 1);
+	else
+		MixThreads->run(mixStems);
+}
+
+inline void ModuleFile::MonoFromStereo(int32_t *const buffer, uint32_t count)
+	{ selectMixOutput().monoFromStereo(buffer, count); }
+
+uint32_t ModuleFile::ConvertOutput(uint8_t *const buffer, const int32_t *const mix, const uint32_t sampleCount,
+	const uint32_t ditherIndex, noiseShaper_t *const shaper) const noexcept
+{
+	const auto &output = selectMixOutput();
+	if (OutputFormat == moduleOutput_t::float32)
+	{
+		output.toFloat(reinterpret_cast<float *>(buffer), mix, sampleCount);
+		return sampleCount * sizeof(float);
+	}
+	else if (OutputFormat == moduleOutput_t::int24)
+	{
+		output.toInt24(buffer, mix, sampleCount);
+		return sampleCount * 3U;
+	}
+	else if (shaper)
+	{
+		mixToInt16NoiseShaped(reinterpret_cast<int16_t *>(buffer), mix, sampleCount, ditherIndex, MixChannels, *shaper);
+		return sampleCount * sizeof(int16_t);
+	}
+	else if (Dither)
+	{
+		output.toInt16Dithered(reinterpret_cast<int16_t *>(buffer), mix, sampleCount, ditherIndex);
+		return sampleCount * sizeof(int16_t);
+	}
+	output.toInt16(reinterpret_cast<int16_t *>(buffer), mix, sampleCount);
+	return sampleCount * sizeof(int16_t);
+}
+
+/*!
+ * Plays the song forward by up to the given number of sample frames, advancing ticks as needed
+ * and handing the frames between tick boundaries to mixBlock to mix and convert.
+ * @return The number of sample frames played, which is short once the song ends
+ */
+template<typename mix_t> uint32_t ModuleFile::mixBlocks(uint32_t Max, mix_t &&mixBlock)
+{
+	uint32_t Count, Mixed = 0;
 	while (Mixed < Max)
 	{
 		if (SamplesToMix == 0)
@@ -1601,31 +2636,108 @@ int32_t ModuleFile::Mix(uint8_t *Buffer, uint32_t BuffLen)
 				Max = Mixed;
 		}
 		Count = SamplesToMix;
-		if (Count > mixBufferSize)
-			Count = mixBufferSize;
+		if (Count > MixBlockSize)
+			Count = MixBlockSize;
 		if (Count > (Max - Mixed))
 			Count = (Max - Mixed);
 		if (Count == 0)
 			break;
-		SampleCount = Count;
+		mixBlock(Count);
+		// Stems all share the one dither sequence, so it only moves on once per block
+		if ((OutputFormat == moduleOutput_t::int16 && Dither) || noiseShaped())
+			DitherIndex += Count * MixChannels;
+		Mixed += Count;
+		SamplesToMix -= Count;
+	}
+	return Mixed;
+}
+
+uint32_t ModuleFile::MixFrames(uint8_t *Buffer, const uint32_t frames)
+{
+	return mixBlocks(frames, [&](const uint32_t count)
+	{
 		// Reset the sound buffer.
-		DCFixingFill(SampleCount);
+		DCFixingFill(MixBuffer.data(), count, DCOffsL, DCOffsR);
+		CreateStereoMix(count);
+		if (Effects.active())
+			Effects.process(MixBuffer.data(), count);
 		// MixOutChannels can only be one or two
-		if (MixChannels == 2)
+		if (MixChannels != 2)
+			MonoFromStereo(MixBuffer.data(), count);
+		Buffer += ConvertOutput(Buffer, MixBuffer.data(), count * MixChannels, DitherIndex,
+			noiseShaped() ? &NoiseShaper : nullptr);
+	});
+}
+
+int32_t ModuleFile::Mix(uint8_t *Buffer, uint32_t BuffLen)
+{
+	const uint32_t SampleSize = MixBitsPerSample / 8U * MixChannels;
+	const uint32_t Max = BuffLen / SampleSize;
+
+	if (Max == 0 || NextPattern >= p_Header->nOrders)
+		return -2;
+	const uint32_t Mixed = MixFrames(Buffer, Max);
+	return (Mixed == 0 ? -2 : Mixed * SampleSize);
+}
+
+// Mixes as Mix() does, but stops at the end of the current tick and only starts the next once that one is done
+int32_t ModuleFile::MixTick(uint8_t *Buffer, uint32_t BuffLen)
+{
+	const uint32_t SampleSize = MixBitsPerSample / 8U * MixChannels;
+	const uint32_t Max = BuffLen / SampleSize;
+
+	if (Max == 0 || NextPattern >= p_Header->nOrders)
+		return -2;
+	if (SamplesToMix == 0 && !AdvanceTick())
+		return -2;
+	const uint32_t Mixed = MixFrames(Buffer, std::min(Max, SamplesToMix));
+	return (Mixed == 0 ? -2 : Mixed * SampleSize);
+}
+
+// How far apart in the dither sequence the stems start - the golden ratio's fraction, which spreads them out evenly
+constexpr static uint32_t stemDitherStride{0x9E3779B9U};
+
+int32_t ModuleFile::MixStems(uint8_t *const *const buffers, uint32_t BuffLen)
+{
+	const uint32_t SampleSize = MixBitsPerSample / 8U * MixChannels;
+	const uint32_t Max = BuffLen / SampleSize;
+
+	if (Max == 0 || NextPattern >= p_Header->nOrders)
+		return -2;
+	const uint8_t nStems = stems();
+	if (!Stems)
+	{
+		// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+		Stems = make_unique_nothrow<mixAccumulator_t []>(nStems);
+		if (!Stems)
+			return -1;
+		for (uint8_t stem = 0; stem < nStems; ++stem)
 		{
-			SampleCount *= 2;
-			CreateStereoMix(Count);
-			// Reverb processing?
+			if (!Stems[stem].reserve(MixBlockSize))
+			{
+				Stems.reset();
+				return -1;
+			}
 		}
-		else
+	}
+	uint32_t offset = 0;
+	const uint32_t Mixed = mixBlocks(Max, [&](const uint32_t count)
+	{
+		for (uint8_t stem = 0; stem < nStems; ++stem)
+			DCFixingFill(Stems[stem].buffer.data(), count, Stems[stem].DCOffsL, Stems[stem].DCOffsR);
+		CreateStemMix(count);
+		uint32_t written = 0;
+		for (uint8_t stem = 0; stem < nStems; ++stem)
 		{
-			CreateStereoMix(Count);
-			// Reverb processing?
-			MonoFromStereo(Count);
+			if (MixChannels != 2)
+				MonoFromStereo(Stems[stem].buffer.data(), count);
+			// The effects and noise shaping need the whole mix, so the stems are left dry and never noise shaped.
+			// Each stem takes its dither from its own stretch of the sequence so the stems' noise doesn't add up
+			// coherently when they get mixed back together.
+			written = ConvertOutput(buffers[stem] + offset, Stems[stem].buffer.data(), count * MixChannels,
+				DitherIndex + ((stem + 1U) * stemDitherStride), nullptr);
 		}
-		Buffer += Convert32to16(Buffer, MixBuffer, SampleCount);
-		Mixed += Count;
-		SamplesToMix -= Count;
-	}
-	return (Mixed == 0 ? -2 : Mixed * (MixBitsPerSample / 8U) * MixChannels);
+		offset += written;
+	});
+	return (Mixed == 0 ? -2 : Mixed * SampleSize);
 }
@@ -3,6 +3,9 @@
 #ifndef libAudio_moduleMixer_H
 #define libAudio_moduleMixer_H
 
+#include <cstddef>
+#include <cstdint>
+#include <array>
 #include "../fixedPoint/fixedPoint.h"
 
 constexpr static inline uint16_t CHN_LOOP{0x0001U};
@@ -89,58 +92,72 @@ template<> struct muldiv_t<uint32_t> final
 	}
 };
 
-inline int32_t linearSlideUp(uint8_t slide) noexcept
+// Builds the table of 2^(slide / 192) (or 2^(slide / 768) for fine slides) multipliers for every possible slide
+// amount as raw 32.32 fixed-point numbers, using exactly the fixed64_t maths the slides used to do every tick
+template<int8_t sign, bool fine> constexpr std::array<uint64_t, 256> makeLinearSlideTable() noexcept
 {
+	constexpr fixed64_t c4{4};
 	constexpr fixed64_t c192{192};
-	constexpr fixed64_t c65536{65536};
-	return (slide / c192).pow2() * c65536;
+	std::array<uint64_t, 256> table{};
+	for (size_t slide{}; slide < table.size(); ++slide)
+	{
+		const fixed64_t amount{uint32_t(slide), 0, sign};
+		table[slide] = ((fine ? amount / c4 : amount) / c192).pow2().raw();
+	}
+	return table;
 }
 
-// Returns ((period * 65536 * 2^(slide / 192)) + 32768) / 65536 using fixed-point maths
-inline uint32_t linearSlideUp(uint32_t period, uint8_t slide) noexcept
-{
-	const fixed64_t c192(192);
-	const fixed64_t c32768(32768);
-	const fixed64_t c65536(65536);
-	return ((period * (slide / c192).pow2() * c65536) + c32768) / c65536;
-}
+constexpr static inline auto linearSlideUpTable{makeLinearSlideTable<1, false>()};
+constexpr static inline auto linearSlideDownTable{makeLinearSlideTable<-1, false>()};
+constexpr static inline auto fineLinearSlideUpTable{makeLinearSlideTable<1, true>()};
+constexpr static inline auto fineLinearSlideDownTable{makeLinearSlideTable<-1, true>()};
 
-inline int32_t linearSlideDown(uint8_t slide) noexcept
+// Returns ((period * multiplier * scale) + 32768) / 65536, rounded exactly as the fixed64_t maths this replaces
+// did - that comes out one higher than plain rounding would, and wraps at 16 bits if the product overflows
+inline uint32_t applyLinearSlide(const uint32_t period, const uint64_t multiplier, const uint32_t scale) noexcept
 {
-	constexpr fixed64_t c192{192};
-	constexpr fixed64_t c65535{65535};
-	return (fixed64_t{slide, 0, -1} / c192).pow2() * c65535;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	const uint64_t result{uint64_t{period} * multiplier * scale + (UINT64_C(1) << 47U)};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	return uint32_t(result >> 48U) + uint32_t((result >> 47U) & 1U);
 }
 
-// Returns ((period * 65535 * 2^(-slide / 192)) + 32768) / 65536 using fixed-point maths
-inline uint32_t linearSlideDown(uint32_t period, uint8_t slide) noexcept
+// Returns 2^(slide / 192) * 65536
+inline int32_t linearSlideUp(const uint8_t slide) noexcept
 {
-	const fixed64_t c192(192);
-	const fixed64_t c32768(32768);
-	const fixed64_t c65535(65535);
-	const fixed64_t c65536(65536);
-	return ((period * (fixed64_t(slide, 0, -1) / c192).pow2() * c65535) + c32768) / c65536;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	const uint64_t result{linearSlideUpTable[slide] * 65536U};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	return int32_t(uint32_t(result >> 32U) + uint32_t((result >> 31U) & 1U));
 }
 
-// Returns ((period * 65536 * 2^((slide / 4) / 192)) + 32768) / 65536 using fixed-point maths
-inline uint32_t fineLinearSlideUp(uint32_t period, uint8_t slide)
-{
-	const fixed64_t c4(4);
-	const fixed64_t c192(192);
-	const fixed64_t c32768(32768);
-	const fixed64_t c65536(65536);
-	return ((period * ((slide / c4) / c192).pow2() * c65536) + c32768) / c65536;
-}
+// Returns ((period * 65536 * 2^(slide / 192)) + 32768) / 65536
+inline uint32_t linearSlideUp(const uint32_t period, const uint8_t slide) noexcept
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	{ return applyLinearSlide(period, linearSlideUpTable[slide], 65536U); }
 
-// Returns ((period * 65535 * 2^((-slide / 4) / 192)) + 32768) / 65536 using fixed-point maths
-inline uint32_t fineLinearSlideDown(uint32_t period, uint8_t slide)
+// Returns 2^(-slide / 192) * 65535
+inline int32_t linearSlideDown(const uint8_t slide) noexcept
 {
-	const fixed64_t c4(4);
-	const fixed64_t c192(192);
-	const fixed64_t c32768(32768);
-	const fixed64_t c65535(65535);
-	const fixed64_t c65536(65536);
-	return ((period * ((fixed64_t(slide, 0, -1) / c4) / c192).pow2() * c65535) + c32768) / c65536;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	const uint64_t result{linearSlideDownTable[slide] * 65535U};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	return int32_t(uint32_t(result >> 32U) + uint32_t((result >> 31U) & 1U));
 }
 
+// Returns ((period * 65535 * 2^(-slide / 192)) + 32768) / 65536
+inline uint32_t linearSlideDown(const uint32_t period, const uint8_t slide) noexcept
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	{ return applyLinearSlide(period, linearSlideDownTable[slide], 65535U); }
+
+// Returns ((period * 65536 * 2^((slide / 4) / 192)) + 32768) / 65536
+inline uint32_t fineLinearSlideUp(const uint32_t period, const uint8_t slide) noexcept
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	{ return applyLinearSlide(period, fineLinearSlideUpTable[slide], 65536U); }
+
+// Returns ((period * 65535 * 2^((-slide / 4) / 192)) + 32768) / 65536
+inline uint32_t fineLinearSlideDown(const uint32_t period, const uint8_t slide) noexcept
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
+	{ return applyLinearSlide(period, fineLinearSlideDownTable[slide], 65535U); }
+
 #endif /*libAudio_moduleMixer_H*/
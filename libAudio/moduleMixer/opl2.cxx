@@ -0,0 +1,377 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "opl2.hxx"
+
+namespace libAudio::opl2
+{
+	// The chip stores a quarter of a sine wave as -log2(sin(x)) in 8-bit fixed point..
+	const static auto logSinTable{[]() noexcept
+	{
+		constexpr auto pi{3.14159265358979323846};
+		std::array<uint16_t, 256> table{};
+		for (size_t i{}; i < table.size(); ++i)
+			table[i] = static_cast<uint16_t>(std::lround(-std::log2(std::sin((double(i) + 0.5) * pi / 512.0)) * 256.0));
+		return table;
+	}()};
+
+	// ..and turns the sum of that and the envelope back into a linear level with this table of 2^x
+	const static auto expTable{[]() noexcept
+	{
+		std::array<uint16_t, 256> table{};
+		for (size_t i{}; i < table.size(); ++i)
+			table[i] = static_cast<uint16_t>(std::lround(std::exp2(double(255U - i) / 256.0) * 1024.0));
+		return table;
+	}()};
+
+	// The frequency multipliers, doubled so the half multiplier is a whole number
+	constexpr static std::array<uint8_t, 16> multipliers
+		{{1U, 2U, 4U, 6U, 8U, 10U, 12U, 14U, 16U, 18U, 20U, 20U, 24U, 24U, 30U, 30U}};
+	// Key scale level attenuation by the top 4 bits of the frequency number, and how much of it each KSL setting uses
+	constexpr static std::array<uint8_t, 16> keyScaleLevels
+		{{0U, 32U, 40U, 45U, 48U, 51U, 53U, 55U, 56U, 58U, 59U, 60U, 61U, 62U, 63U, 64U}};
+	constexpr static std::array<uint8_t, 4> keyScaleShifts{{8U, 1U, 2U, 0U}};
+
+	// Register 0x20's bits
+	constexpr static uint8_t tremolo{0x80U};
+	constexpr static uint8_t vibrato{0x40U};
+	constexpr static uint8_t sustaining{0x20U};
+	constexpr static uint8_t keyScaleRate{0x10U};
+
+	// Marks an attack that's fast enough for the chip to skip straight to full volume
+	constexpr static uint32_t instantAttack{std::numeric_limits<uint32_t>::max()};
+	// The tremolo's triangle wave rises for 105 steps and falls for 105, stepping every 64 samples of the chip
+	constexpr static uint32_t tremoloLength{210U};
+
+	// How far the envelope moves per sample of the chip at each of the 64 effective rates, in 16.16 fixed point
+	constexpr static uint32_t rateStep(const uint8_t rate) noexcept
+		{ return rate < 4U ? 0U : (4U + (rate & 3U)) << ((rate >> 2U) + 1U); }
+
+	inline int32_t attenuate(const uint32_t level) noexcept
+	{
+		const auto limited{std::min<uint32_t>(level, 0x1fffU)};
+		return int32_t((expTable[limited & 0xffU] << 1U) >> (limited >> 8U));
+	}
+
+	// The OPL2 scales the total level by the tracker's volume the same way OpenMPT does
+	inline uint8_t scaleLevel(const uint8_t level, const uint8_t volume) noexcept
+	{
+		if (volume >= 63U)
+			return level;
+		const auto scale{volume ? volume + 1U : 0U};
+		return uint8_t(63U - (((63U - level) * scale) / 64U));
+	}
+} // namespace libAudio::opl2
+
+using namespace libAudio::opl2;
+
+int32_t opl2Waveform(const uint8_t waveform, const uint32_t phase, const uint32_t attenuation) noexcept
+{
+	const auto level{attenuation << 3U};
+	// Which quarter of the wave the phase is in, and where in that quarter
+	const auto mirrored{phase & 0x100U};
+	const auto index{mirrored ? (phase & 0xffU) ^ 0xffU : phase & 0xffU};
+	const auto negative{phase & 0x200U};
+	switch (waveform & 3U)
+	{
+		// Sine
+		case 0U:
+		{
+			const auto value{attenuate(logSinTable[index] + level)};
+			return negative ? ~value : value;
+		}
+		// Half sine, silent for the negative half
+		case 1U:
+			return negative ? attenuate(0x1000U + level) : attenuate(logSinTable[index] + level);
+		// Absolute sine
+		case 2U:
+			return attenuate(logSinTable[index] + level);
+		// Quarter sine pulses, rising quarters only
+		default:
+			return mirrored ? attenuate(0x1000U + level) : attenuate(logSinTable[phase & 0xffU] + level);
+	}
+}
+
+void opl2Voice_t::load(const opl2Patch_t &instrument) noexcept
+{
+	patch = instrument;
+	updateOperator(0U);
+	updateOperator(1U);
+}
+
+void opl2Voice_t::keyOn() noexcept
+{
+	for (size_t index{}; index < operators.size(); ++index)
+	{
+		auto &op{operators[index]};
+		// The attack starts from wherever the envelope got to, so retriggering a voice doesn't click
+		op.phase = 0U;
+		op.stage = opl2Stage_t::attack;
+		updateEnvelopeStep(op, index);
+	}
+}
+
+void opl2Voice_t::keyOff() noexcept
+{
+	for (size_t index{}; index < operators.size(); ++index)
+	{
+		auto &op{operators[index]};
+		if (op.stage == opl2Stage_t::off)
+			continue;
+		op.stage = opl2Stage_t::release;
+		updateEnvelopeStep(op, index);
+	}
+}
+
+void opl2Voice_t::cut() noexcept
+{
+	for (auto &op : operators)
+	{
+		op.stage = opl2Stage_t::off;
+		op.envelope = opl2EnvelopeMax << opl2EnvelopePrecision;
+		op.envelopeStep = 0U;
+	}
+}
+
+/*!
+ * Picks the lowest block the frequency number fits in, which keeps the frequency as precise as it can be,
+ * the same as OpenMPT does for S3M AdLib instruments
+ */
+void opl2Voice_t::frequency(const uint32_t milliHertz, const uint32_t rate) noexcept
+{
+	uint16_t newFnum{1023U};
+	uint8_t newBlock{7U};
+	for (uint8_t octave{}; octave < 8U; ++octave)
+	{
+		const auto value{((uint64_t{milliHertz} << (20U - octave)) + (opl2ClockRate * 500U)) /
+			(uint64_t{opl2ClockRate} * 1000U)};
+		if (value < 1024U)
+		{
+			newFnum = uint16_t(value);
+			newBlock = octave;
+			break;
+		}
+	}
+	if (newFnum == fnum && newBlock == block && rate == sampleRate)
+		return;
+	fnum = newFnum;
+	block = newBlock;
+	if (rate != sampleRate)
+	{
+		sampleRate = rate;
+		clockStep = rate ? (opl2ClockRate << 16U) / rate : 0U;
+	}
+	updatePhaseIncrements();
+	updateOperator(0U);
+	updateOperator(1U);
+}
+
+void opl2Voice_t::level(const uint8_t trackerVolume) noexcept
+{
+	const auto newVolume{std::min<uint8_t>(trackerVolume, 63U)};
+	if (newVolume == volume)
+		return;
+	volume = newVolume;
+	updateOperator(0U);
+	updateOperator(1U);
+}
+
+void opl2Voice_t::updateOperator(const size_t index) noexcept
+{
+	auto &op{operators[index]};
+	const auto &settings{patch.operators[index]};
+	auto totalLevel{uint8_t(settings.level & 0x3fU)};
+	if (index == 1U || additive())
+		totalLevel = scaleLevel(totalLevel, volume);
+	op.totalLevel = uint16_t(totalLevel << 2U);
+	const auto keyScale{int32_t(keyScaleLevels[fnum >> 6U] << 2U) - ((8 - int32_t{block}) << 5)};
+	op.keyScaleLevel = uint16_t(std::max(keyScale, 0) >> keyScaleShifts[settings.level >> 6U]);
+	updateEnvelopeStep(op, index);
+}
+
+void opl2Voice_t::updatePhaseIncrements() noexcept
+{
+	for (size_t index{}; index < operators.size(); ++index)
+	{
+		auto &op{operators[index]};
+		const auto &settings{patch.operators[index]};
+		if (!sampleRate)
+		{
+			op.phaseIncrement = 0U;
+			continue;
+		}
+		int32_t frequency{fnum};
+		// The vibrato bends the frequency number by up to 1/256th of itself, half that on the inbetween steps
+		if (settings.characteristic & vibrato)
+		{
+			int32_t range{int32_t((fnum >> 7U) & 7U)};
+			if (!(vibratoPosition & 3U))
+				range = 0;
+			else if (vibratoPosition & 1U)
+				range >>= 1U;
+			range >>= 1U;
+			frequency += (vibratoPosition & 4U) ? -range : range;
+		}
+		// 10 bits of the phase index the waveform, and the chip's phase counter has 9 bits of fraction below that
+		op.phaseIncrement = uint32_t((uint64_t(uint32_t(frequency) << block) *
+			multipliers[settings.characteristic & 0x0fU] * 2048U * opl2ClockRate) / sampleRate);
+	}
+}
+
+uint8_t opl2Voice_t::effectiveRate(const size_t index, const uint8_t rate) const noexcept
+{
+	if (!rate)
+		return 0U;
+	const auto keyScale{uint8_t((block << 1U) | ((fnum >> 9U) & 1U))};
+	const auto shift{(patch.operators[index].characteristic & keyScaleRate) ? 0U : 2U};
+	return std::min<uint8_t>((rate << 2U) + (keyScale >> shift), 63U);
+}
+
+void opl2Voice_t::updateEnvelopeStep(opl2Operator_t &op, const size_t index) noexcept
+{
+	const auto &settings{patch.operators[index]};
+	uint8_t rate{};
+	switch (op.stage)
+	{
+		case opl2Stage_t::attack:
+			rate = settings.attackDecay >> 4U;
+			break;
+		case opl2Stage_t::decay:
+			rate = settings.attackDecay & 0x0fU;
+			break;
+		// Instruments that don't sustain carry on dying away at the release rate while the key is held
+		case opl2Stage_t::sustain:
+			rate = (settings.characteristic & sustaining) ? 0U : settings.sustainRelease & 0x0fU;
+			break;
+		case opl2Stage_t::release:
+			rate = settings.sustainRelease & 0x0fU;
+			break;
+		case opl2Stage_t::off:
+			break;
+	}
+	const auto effective{effectiveRate(index, rate)};
+	if (op.stage == opl2Stage_t::attack && effective >= 60U)
+		op.envelopeStep = instantAttack;
+	else
+		op.envelopeStep = uint32_t((uint64_t{rateStep(effective)} * clockStep) >> 16U);
+}
+
+void opl2Voice_t::stepEnvelope(opl2Operator_t &op, const size_t index) noexcept
+{
+	constexpr auto maximum{opl2EnvelopeMax << opl2EnvelopePrecision};
+	switch (op.stage)
+	{
+		// The attack is exponential, moving faster the quieter the operator is
+		case opl2Stage_t::attack:
+		{
+			if (op.envelopeStep == instantAttack)
+				op.envelope = 0U;
+			else
+			{
+				const auto change{((uint64_t{op.envelope} + (1U << opl2EnvelopePrecision)) * op.envelopeStep * 3U) >> 20U};
+				op.envelope = change >= op.envelope ? 0U : uint32_t(op.envelope - change);
+			}
+			if (!op.envelope)
+			{
+				op.stage = opl2Stage_t::decay;
+				updateEnvelopeStep(op, index);
+			}
+			break;
+		}
+		case opl2Stage_t::decay:
+		{
+			// Sustain level 15 is the quietest the envelope can be, rather than 45dB
+			auto sustainLevel{uint32_t(patch.operators[index].sustainRelease >> 4U)};
+			if (sustainLevel == 15U)
+				sustainLevel = 31U;
+			sustainLevel <<= 4U + opl2EnvelopePrecision;
+			op.envelope += op.envelopeStep;
+			if (op.envelope >= sustainLevel)
+			{
+				op.envelope = sustainLevel;
+				op.stage = opl2Stage_t::sustain;
+				updateEnvelopeStep(op, index);
+			}
+			break;
+		}
+		case opl2Stage_t::sustain:
+		case opl2Stage_t::release:
+			op.envelope += op.envelopeStep;
+			if (op.envelope >= maximum)
+			{
+				op.envelope = maximum;
+				op.stage = opl2Stage_t::off;
+				op.envelopeStep = 0U;
+			}
+			break;
+		case opl2Stage_t::off:
+			break;
+	}
+}
+
+/*!
+ * Runs the voice a sample of the mix at a time rather than a sample of the chip at a time, with the envelopes
+ * and LFOs stepped by how much of the chip's time each mix sample stands for. That avoids having to resample
+ * the chip's 49716Hz output, and as everything about the voice lives in it, rendering a block in one call
+ * or in several comes out exactly the same.
+ */
+void opl2Voice_t::render(int32_t *const samples, const size_t frames) noexcept
+{
+	auto &modulator{operators[0]};
+	auto &carrier{operators[1]};
+	const auto &modulatorSettings{patch.operators[0]};
+	const auto &carrierSettings{patch.operators[1]};
+	const auto feedback{uint8_t((patch.feedbackConnection >> 1U) & 7U)};
+	const bool vibratos{((modulatorSettings.characteristic | carrierSettings.characteristic) & vibrato) != 0U};
+	const auto attenuation{[](const opl2Operator_t &op, const bool tremolos, const uint32_t depth) noexcept
+	{
+		return std::min<uint32_t>((op.envelope >> opl2EnvelopePrecision) + op.totalLevel + op.keyScaleLevel +
+			(tremolos ? depth : 0U), opl2EnvelopeMax);
+	}};
+
+	for (size_t i{}; i < frames; ++i)
+	{
+		// Once the voice has died away it stays silent until the next key on
+		if (!playing())
+		{
+			std::fill(samples + i, samples + frames, 0);
+			return;
+		}
+		lfoFraction += clockStep;
+		lfoClock += lfoFraction >> 16U;
+		lfoFraction &= 0xffffU;
+		const auto tremoloPosition{(lfoClock >> 6U) % tremoloLength};
+		const auto tremoloDepth
+		{
+			(tremoloPosition < tremoloLength / 2U ? tremoloPosition : tremoloLength - tremoloPosition) >> 4U
+		};
+		const auto newVibratoPosition{uint8_t((lfoClock >> 10U) & 7U)};
+		if (newVibratoPosition != vibratoPosition)
+		{
+			vibratoPosition = newVibratoPosition;
+			if (vibratos)
+				updatePhaseIncrements();
+		}
+
+		stepEnvelope(modulator, 0U);
+		stepEnvelope(carrier, 1U);
+
+		const auto selfModulation{feedback ? (modulator.output[0] + modulator.output[1]) >> (9U - feedback) : 0};
+		const auto modulatorOutput{opl2Waveform(modulatorSettings.waveform, ((modulator.phase >> 22U) +
+			uint32_t(selfModulation)) & 0x3ffU, attenuation(modulator, modulatorSettings.characteristic & tremolo,
+			tremoloDepth))};
+		modulator.output[1] = modulator.output[0];
+		modulator.output[0] = int16_t(modulatorOutput);
+		const auto modulation{additive() ? 0 : modulatorOutput};
+		const auto carrierOutput{opl2Waveform(carrierSettings.waveform, ((carrier.phase >> 22U) +
+			uint32_t(modulation)) & 0x3ffU, attenuation(carrier, carrierSettings.characteristic & tremolo,
+			tremoloDepth))};
+
+		modulator.phase += modulator.phaseIncrement;
+		carrier.phase += carrier.phaseIncrement;
+		// Each operator puts out 13 bits, so this scales them up to the 16-bit range the samples play at
+		samples[i] = (additive() ? modulatorOutput + carrierOutput : carrierOutput) * 4;
+	}
+}
@@ -0,0 +1,118 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Synthesis of the two operator FM voices of the Yamaha YM3812 (OPL2) that S3M AdLib instruments play on
+#ifndef LIBAUDIO_MODULEMIXER_OPL2_HXX
+#define LIBAUDIO_MODULEMIXER_OPL2_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+// The rate the real chip generates samples at, which all its timings are relative to
+constexpr static inline uint32_t opl2ClockRate{49716U};
+// How many bits of fraction the envelope generator works to
+constexpr static inline uint32_t opl2EnvelopePrecision{16U};
+// Middle C in millihertz, which S3M plays AdLib instruments at for a C-4 at their C4Speed
+constexpr static inline uint32_t opl2MiddleC{261626U};
+// The envelope's attenuation runs from 0 (loudest) to this, in steps of 0.1875dB
+constexpr static inline uint32_t opl2EnvelopeMax{511U};
+
+// The registers for one operator of an AdLib instrument, as S3M stores them
+struct opl2OperatorPatch_t final
+{
+	// Register 0x20: tremolo, vibrato, sustain, key scale rate and frequency multiplier
+	uint8_t characteristic{};
+	// Register 0x40: key scale level and total level
+	uint8_t level{};
+	// Register 0x60: attack and decay rates
+	uint8_t attackDecay{};
+	// Register 0x80: sustain level and release rate
+	uint8_t sustainRelease{};
+	// Register 0xE0: waveform select
+	uint8_t waveform{};
+};
+
+// An AdLib instrument: the modulator then the carrier, and register 0xC0 for the feedback and connection
+struct opl2Patch_t final
+{
+	std::array<opl2OperatorPatch_t, 2> operators{};
+	uint8_t feedbackConnection{};
+};
+
+enum class opl2Stage_t : uint8_t
+{
+	attack,
+	decay,
+	sustain,
+	release,
+	off
+};
+
+struct opl2Operator_t final
+{
+	// The top 10 bits index the waveform, the rest are fraction
+	uint32_t phase{};
+	uint32_t phaseIncrement{};
+	// The envelope's attenuation in opl2EnvelopePrecision fixed point, and how fast the current stage moves it
+	uint32_t envelope{opl2EnvelopeMax << opl2EnvelopePrecision};
+	uint32_t envelopeStep{};
+	opl2Stage_t stage{opl2Stage_t::off};
+	// The total level after the tracker's volume, and key scale level, both in envelope steps
+	uint16_t totalLevel{};
+	uint16_t keyScaleLevel{};
+	// The last two outputs, which the modulator feeds back into itself
+	std::array<int16_t, 2> output{};
+};
+
+// One OPL2 channel playing an AdLib instrument, rendered straight out at the mix rate
+struct opl2Voice_t final
+{
+private:
+	opl2Patch_t patch{};
+	std::array<opl2Operator_t, 2> operators{};
+	uint16_t fnum{};
+	uint8_t block{};
+	// 0 to 63, as S3M volumes are
+	uint8_t volume{63U};
+	uint32_t sampleRate{};
+	// How far through a sample of the real chip's clock each output sample is, in 16.16 fixed point
+	uint32_t clockStep{};
+	// The chip's tremolo and vibrato run off its sample clock, counted here in 16.16 fixed point
+	uint32_t lfoClock{};
+	uint32_t lfoFraction{};
+	uint8_t vibratoPosition{};
+
+	void updateOperator(size_t index) noexcept;
+	void updatePhaseIncrements() noexcept;
+	void updateEnvelopeStep(opl2Operator_t &op, size_t index) noexcept;
+	[[nodiscard]] uint8_t effectiveRate(size_t index, uint8_t rate) const noexcept;
+	void stepEnvelope(opl2Operator_t &op, size_t index) noexcept;
+
+public:
+	// Sets up the voice for an instrument, which takes effect from the next key on
+	void load(const opl2Patch_t &instrument) noexcept;
+	void keyOn() noexcept;
+	void keyOff() noexcept;
+	// Stops the voice dead, as stealing it or having it play out of range does
+	void cut() noexcept;
+	// Sets the pitch in millihertz, worked out for the given mix rate
+	void frequency(uint32_t milliHertz, uint32_t rate) noexcept;
+	// Sets how loud the voice plays from 0 to 63, by raising the total level of the operators that are heard
+	void level(uint8_t trackerVolume) noexcept;
+	[[nodiscard]] bool additive() const noexcept { return patch.feedbackConnection & 1U; }
+	// The modulator is only heard on its own when the operators are connected additively
+	[[nodiscard]] bool playing() const noexcept
+	{
+		return operators[1].stage != opl2Stage_t::off ||
+			(additive() && operators[0].stage != opl2Stage_t::off);
+	}
+	[[nodiscard]] uint16_t frequencyNumber() const noexcept { return fnum; }
+	[[nodiscard]] uint8_t octave() const noexcept { return block; }
+	// Generates the next frames of the voice as mono 16-bit range samples
+	void render(int32_t *samples, size_t frames) noexcept;
+};
+
+// Looks up one of the chip's four waveforms at a 10-bit phase, attenuated by a 9-bit envelope value
+[[nodiscard]] int32_t opl2Waveform(uint8_t waveform, uint32_t phase, uint32_t attenuation) noexcept;
+
+#endif /*LIBAUDIO_MODULEMIXER_OPL2_HXX*/
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cmath>
+#include "resonantFilter.hxx"
+
+// Impulse Tracker maps the 0-127 cutoff (scaled by the filter envelope) onto a frequency exponentially from 110Hz
+uint32_t filterFrequency(const uint8_t cutoff, const int16_t modifier, const uint32_t sampleRate) noexcept
+{
+	const auto computedCutoff{double(cutoff) * double(modifier + 256)};
+	auto frequency{static_cast<uint32_t>(110.0 * std::pow(2.0, 0.25 + (computedCutoff / (24.0 * 512.0))))};
+	if (frequency < 120U)
+		frequency = 120U;
+	else if (frequency > 20000U)
+		frequency = 20000U;
+	if (frequency * 2U > sampleRate)
+		frequency = sampleRate / 2U;
+	return frequency;
+}
+
+filterCoefficients_t filterCoefficients(const filterSettings_t &settings) noexcept
+{
+	if (!settings.sampleRate)
+		return {};
+	constexpr auto pi{3.14159265358979323846};
+	const auto frequency{double(filterFrequency(settings.cutoff, settings.modifier, settings.sampleRate))};
+	// Resonance runs from 0 to 24dB of damping reduction across its 0-127 range
+	const auto damping{std::pow(10.0, -double(settings.resonance) * ((24.0 / 128.0) / 20.0))};
+	const auto ratio{double(settings.sampleRate) / (2.0 * pi * frequency)};
+	const auto d{(damping * ratio) + damping - 1.0};
+	const auto e{ratio * ratio};
+	const auto scale{double(1U << filterPrecision) / (1.0 + d + e)};
+	return
+	{
+		static_cast<int32_t>(std::lround(scale)),
+		static_cast<int32_t>(std::lround((d + e + e) * scale)),
+		static_cast<int32_t>(std::lround(-e * scale)),
+	};
+}
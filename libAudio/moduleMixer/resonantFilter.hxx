@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Impulse Tracker's resonant low-pass filter
+#ifndef LIBAUDIO_MODULEMIXER_RESONANTFILTER_HXX
+#define LIBAUDIO_MODULEMIXER_RESONANTFILTER_HXX
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+// How many bits of fraction the filter coefficients carry
+constexpr static inline uint32_t filterPrecision{24U};
+// How many bits of fraction the filter history carries. At low cutoffs the filter amplifies any rounding of its
+// history by a thousand times or more, so the history is kept at more precision than the samples themselves.
+constexpr static inline uint32_t filterHistoryPrecision{8U};
+// A cutoff of 127 with no resonance is the filter's "off" setting
+constexpr static inline uint8_t filterCutoffMax{127U};
+// The filter envelope's modifier when there is no filter envelope, which leaves the cutoff where it was set
+constexpr static inline int16_t filterModifierNone{256};
+
+// Everything the filter coefficients are worked out from, so they only get recomputed when one of these changes
+struct filterSettings_t final
+{
+	uint8_t cutoff{filterCutoffMax};
+	uint8_t resonance{};
+	// -256 to 256, scaling the cutoff from nothing at -256 up to its full value at 256
+	int16_t modifier{filterModifierNone};
+	uint32_t sampleRate{};
+
+	bool operator ==(const filterSettings_t &other) const noexcept
+	{
+		return cutoff == other.cutoff && resonance == other.resonance && modifier == other.modifier &&
+			sampleRate == other.sampleRate;
+	}
+	bool operator !=(const filterSettings_t &other) const noexcept { return !(*this == other); }
+
+	// Whether these settings actually filter anything
+	[[nodiscard]] bool active() const noexcept
+		{ return cutoff < filterCutoffMax || resonance || modifier != filterModifierNone; }
+};
+
+// The 2-pole filter's coefficients as filterPrecision fixed point: y = a0 * x + b0 * y[-1] + b1 * y[-2]
+struct filterCoefficients_t final
+{
+	int32_t a0{1 << filterPrecision};
+	int32_t b0{};
+	int32_t b1{};
+};
+
+// The filter's output history for one channel of a voice, in filterHistoryPrecision fixed point
+struct filterState_t final
+{
+	int32_t y1{};
+	int32_t y2{};
+};
+
+[[nodiscard]] uint32_t filterFrequency(uint8_t cutoff, int16_t modifier, uint32_t sampleRate) noexcept;
+[[nodiscard]] filterCoefficients_t filterCoefficients(const filterSettings_t &settings) noexcept;
+
+// Resonance can drive the output well past the range of a sample, so the history is held to twice that range
+inline int64_t clipFilterHistory(const int32_t value) noexcept
+{
+	constexpr int32_t minimum{(INT16_MIN * 2) * (1 << filterHistoryPrecision)};
+	constexpr int32_t maximum{(INT16_MAX * 2) * (1 << filterHistoryPrecision)};
+	if (value < minimum)
+		return minimum;
+	else if (value > maximum)
+		return maximum;
+	return value;
+}
+
+/*!
+ * Runs a block of frames made of channels interleaved samples through the filter in place. The recursion only
+ * runs along each channel, so the channels of a frame are independent of each other and get processed side by side.
+ */
+template<size_t channels> inline void filterBlock(int32_t *const samples, const size_t frames,
+	const filterCoefficients_t &coefficients, std::array<filterState_t, channels> &state) noexcept
+{
+	constexpr int64_t rounding{int64_t{1} << (filterPrecision - 1U)};
+	constexpr int64_t historyScale{int64_t{1} << filterHistoryPrecision};
+	constexpr int32_t outputRounding{1 << (filterHistoryPrecision - 1U)};
+	auto history{state};
+	for (size_t frame{}; frame < frames; ++frame)
+	{
+		for (size_t channel{}; channel < channels; ++channel)
+		{
+			auto &sample{samples[(frame * channels) + channel]};
+			auto &[y1, y2]{history[channel]};
+			const auto result
+			{
+				static_cast<int32_t>((sample * int64_t{coefficients.a0} * historyScale +
+					clipFilterHistory(y1) * coefficients.b0 + clipFilterHistory(y2) * coefficients.b1 + rounding) >>
+					filterPrecision)
+			};
+			y2 = y1;
+			y1 = result;
+			sample = (result + outputRounding) >> filterHistoryPrecision;
+		}
+	}
+	state = history;
+}
+
+#endif /*LIBAUDIO_MODULEMIXER_RESONANTFILTER_HXX*/
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Conversion of freshly loaded sample data into the form the mixer expects
+#ifndef LIBAUDIO_MODULEMIXER_SAMPLEPCM_HXX
+#define LIBAUDIO_MODULEMIXER_SAMPLEPCM_HXX
+
+#include <cstdint>
+#include <cstddef>
+
+/*!
+ * The mixer only ever sees 16-bit PCM, so 8-bit samples get widened as they load. Every sample also gets
+ * this many frames of padding either side, repeating its first and last frames or carrying on in to its loop,
+ * so the interpolating mixers can read their taps around the play position without checking.
+ */
+constexpr static inline size_t sampleGuard{4U};
+
+// Turns unsigned PCM into signed (and back) by flipping the sign bit of every sample
+inline void pcmFixSign8(uint8_t *const pcm, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		pcm[i] ^= 0x80U;
+}
+
+inline void pcmFixSign16(uint16_t *const pcm, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		pcm[i] ^= 0x8000U;
+}
+
+// Weaves separately stored left and right channels into count stereo frames
+inline void pcmInterleave8(uint8_t *const out, const uint8_t *const left, const uint8_t *const right,
+	const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+	{
+		out[(i * 2U) + 0U] = left[i];
+		out[(i * 2U) + 1U] = right[i];
+	}
+}
+
+inline void pcmInterleave16(uint16_t *const out, const uint16_t *const left, const uint16_t *const right,
+	const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+	{
+		out[(i * 2U) + 0U] = left[i];
+		out[(i * 2U) + 1U] = right[i];
+	}
+}
+
+// Turns signed 8-bit PCM into 16-bit by moving each sample up into the high byte
+inline void pcmWiden8(int16_t *const out, const uint8_t *const in, const size_t count) noexcept
+{
+	for (size_t i{}; i < count; ++i)
+		out[i] = static_cast<int16_t>(static_cast<int8_t>(in[i]) * 256);
+}
+
+// Fills in the guard frames either side of the frames of PCM pointed to by repeating the first and last
+inline void pcmFillGuards(int16_t *const pcm, const size_t frames, const size_t channels) noexcept
+{
+	auto *const before{pcm - (sampleGuard * channels)};
+	const auto *const last{pcm + ((frames - 1U) * channels)};
+	auto *const after{pcm + (frames * channels)};
+	for (size_t i{}; i < sampleGuard * channels; ++i)
+	{
+		before[i] = pcm[i % channels];
+		after[i] = last[i % channels];
+	}
+}
+
+/*!
+ * Unrolls the loop that plays out to the end of the sample into the guard frames after it, so reads past the end
+ * see what the voice goes on to play. A ping-pong loop gets mirrored back from the last frame instead, the
+ * pattern repeating as needed for loops shorter than the guard.
+ */
+inline void pcmUnrollLoop(int16_t *const pcm, const size_t frames, const size_t channels, const size_t loopStart,
+	const bool pingPong) noexcept
+{
+	const size_t loopLength{frames - loopStart};
+	auto *const after{pcm + (frames * channels)};
+	for (size_t frame{}; frame < sampleGuard; ++frame)
+	{
+		size_t source{loopStart + (frame % loopLength)};
+		if (pingPong)
+		{
+			const size_t phase{frame % (loopLength * 2U)};
+			source = phase < loopLength ? frames - 1U - phase : loopStart + (phase - loopLength);
+		}
+		for (size_t channel{}; channel < channels; ++channel)
+			after[(frame * channels) + channel] = pcm[(source * channels) + channel];
+	}
+}
+
+struct samplePCMFunctions_t
+{
+	void (*fixSign8)(uint8_t *pcm, size_t count) noexcept;
+	void (*fixSign16)(uint16_t *pcm, size_t count) noexcept;
+	void (*interleave8)(uint8_t *out, const uint8_t *left, const uint8_t *right, size_t count) noexcept;
+	void (*interleave16)(uint16_t *out, const uint16_t *left, const uint16_t *right, size_t count) noexcept;
+	void (*widen8)(int16_t *out, const uint8_t *in, size_t count) noexcept;
+};
+
+constexpr static samplePCMFunctions_t scalarSamplePCM
+	{pcmFixSign8, pcmFixSign16, pcmInterleave8, pcmInterleave16, pcmWiden8};
+
+#endif /*LIBAUDIO_MODULEMIXER_SAMPLEPCM_HXX*/
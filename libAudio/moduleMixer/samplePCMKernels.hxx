@@ -0,0 +1,70 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+// Vectorised sample loading kernels
+// NB: Like mixKernels.hxx, this is included once per instruction set by mixFunctionsSIMD.cxx and
+// relies on the definitions that file makes first. The vectors are treated as raw bytes here, with
+// the 32-bit lanes only mattering for picking the sign bits out, which land in the same place
+// whichever way round the 16-bit halves of a lane are.
+
+constexpr static size_t vectorBytes{lanes * sizeof(int32_t)};
+
+inline void fixSign8(uint8_t *const pcm, const size_t count) noexcept
+{
+	const auto signs{simd_t::broadcast(static_cast<int32_t>(0x80808080U))};
+	size_t i{};
+	for (; i + vectorBytes <= count; i += vectorBytes)
+	{
+		auto *const block{reinterpret_cast<int32_t *>(pcm + i)};
+		simd_t::store(block, simd_t::bitXor(simd_t::load(block), signs));
+	}
+	pcmFixSign8(pcm + i, count - i);
+}
+
+inline void fixSign16(uint16_t *const pcm, const size_t count) noexcept
+{
+	constexpr auto samplesPerVector{vectorBytes / sizeof(uint16_t)};
+	const auto signs{simd_t::broadcast(static_cast<int32_t>(0x80008000U))};
+	size_t i{};
+	for (; i + samplesPerVector <= count; i += samplesPerVector)
+	{
+		auto *const block{reinterpret_cast<int32_t *>(pcm + i)};
+		simd_t::store(block, simd_t::bitXor(simd_t::load(block), signs));
+	}
+	pcmFixSign16(pcm + i, count - i);
+}
+
+inline void interleave8(uint8_t *const out, const uint8_t *const left, const uint8_t *const right,
+	const size_t count) noexcept
+{
+	size_t i{};
+	for (; i + vectorBytes <= count; i += vectorBytes)
+		simd_t::interleave8(reinterpret_cast<int32_t *>(out + (i * 2U)),
+			simd_t::load(reinterpret_cast<const int32_t *>(left + i)),
+			simd_t::load(reinterpret_cast<const int32_t *>(right + i)));
+	pcmInterleave8(out + (i * 2U), left + i, right + i, count - i);
+}
+
+inline void interleave16(uint16_t *const out, const uint16_t *const left, const uint16_t *const right,
+	const size_t count) noexcept
+{
+	constexpr auto samplesPerVector{vectorBytes / sizeof(uint16_t)};
+	size_t i{};
+	for (; i + samplesPerVector <= count; i += samplesPerVector)
+		simd_t::interleave16(reinterpret_cast<int32_t *>(out + (i * 2U)),
+			simd_t::load(reinterpret_cast<const int32_t *>(left + i)),
+			simd_t::load(reinterpret_cast<const int32_t *>(right + i)));
+	pcmInterleave16(out + (i * 2U), left + i, right + i, count - i);
+}
+
+// Weaving a zero byte in below each sample byte gives the sample in the high byte of a 16-bit value
+inline void widen8(int16_t *const out, const uint8_t *const in, const size_t count) noexcept
+{
+	const auto zeros{simd_t::broadcast(0)};
+	size_t i{};
+	for (; i + vectorBytes <= count; i += vectorBytes)
+		simd_t::interleave8(reinterpret_cast<int32_t *>(out + i), zeros,
+			simd_t::load(reinterpret_cast<const int32_t *>(in + i)));
+	pcmWiden8(out + i, in + i, count - i);
+}
+
+constexpr samplePCMFunctions_t samplePCMFunctions{fixSign8, fixSign16, interleave8, interleave16, widen8};
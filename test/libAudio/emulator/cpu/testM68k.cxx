@@ -1633,7 +1633,7 @@ public:
 		assertEqual(cpu.readStatus(), 0x2000U);
 
 		// Register some memory for the tests to use
-		addressMap[{0x000000U, 0x800000U}] = std::make_unique<ram_t<uint32_t, 8_MiB>>();
+		mapPeripheral({0x000000U, 0x800000U}, std::make_unique<ram_t<uint32_t, 8_MiB>>());
 	}
 
 	void registerTests() final
@@ -140,10 +140,8 @@ class testYM2149 final : public testsuite
 		assertEqual(readRegister(psg, 15U), 0xffU);
 	}
 
-	void testToneWithEnvelope()
+	static void configureToneWithEnvelope(ym2149_t &psg) noexcept
 	{
-		// Set up a PSG to generate 44.1kHz audio, and configure the channels and mixer settings
-		ym2149_t psg{2_MHz, 44100};
 		// Make the test deterministic by forcing the edge states into a known state
 		psg.forceChannelStates(true);
 		// Write channel configs, A = 638, B = 0, C = 0
@@ -165,6 +163,13 @@ class testYM2149 final : public testsuite
 		writeRegister(psg, 11U, 0x28U); // fine adjust
 		writeRegister(psg, 12U, 0x00U); // rough adjust
 		writeRegister(psg, 13U, 0x0aU); // shape
+	}
+
+	void testToneWithEnvelope()
+	{
+		// Set up a PSG to generate 44.1kHz audio, and configure the channels and mixer settings
+		ym2149_t psg{2_MHz, 44100};
+		configureToneWithEnvelope(psg);
 
 		assertFalse(psg.sampleReady());
 		// Having set everything up, run for enough cycles to generate a sample
@@ -192,11 +197,36 @@ class testYM2149 final : public testsuite
 		}
 	}
 
+	void testClockCycles()
+	{
+		// Set up a PSG the same as for testToneWithEnvelope
+		ym2149_t psg{2_MHz, 44100};
+		configureToneWithEnvelope(psg);
+
+		// Check the PSG knows how long it'll be till the first sample, and that running that many cycles in one go
+		// generates the same sample as running them one at a time does
+		assertEqual(psg.cyclesTillEvent(), 45U);
+		assertTrue(psg.clockCycles(psg.cyclesTillEvent()));
+		assertTrue(psg.sampleReady());
+		assertEqual(psg.sample(), 0x2ad7);
+		assertFalse(psg.sampleReady());
+
+		// Now run through generating the rest of the samples the same way, comparing them to the baked values
+		for (const auto sample : toneSamples)
+		{
+			assertTrue(psg.clockCycles(psg.cyclesTillEvent()));
+			assertTrue(psg.sampleReady());
+			assertEqual(psg.sample(), sample);
+			assertFalse(psg.sampleReady());
+		}
+	}
+
 public:
 	void registerTests() final
 	{
 		CXX_TEST(testRegisterIO)
 		CXX_TEST(testToneWithEnvelope)
+		CXX_TEST(testClockCycles)
 	}
 };
 
@@ -42,11 +42,63 @@ class testClockManager final : public testsuite
 		}
 	}
 
+	void testCyclesTillAdvance()
+	{
+		clockManager_t manager{32_MHz, 2457600};
+		clockManager_t reference{manager};
+		// Run a good few cycles, checking the manager predicts where the next few advancements land every cycle
+		for ([[maybe_unused]] const auto cycle : substrate::indexSequence_t{1024U})
+		{
+			for (const auto advances : substrate::indexSequence_t{1U, 4U})
+			{
+				clockManager_t probe{reference};
+				uint32_t cycles{0U};
+				for (size_t advanced{0U}; advanced < advances; cycles++)
+				{
+					if (probe.advanceCycle())
+						++advanced;
+				}
+				assertEqual(manager.cyclesTillAdvance(static_cast<uint32_t>(advances)), cycles);
+			}
+			assertEqual(manager.advanceCycle(), reference.advanceCycle());
+		}
+
+		// A manager with no target clock never advances
+		const clockManager_t invalidManager{};
+		assertEqual(invalidManager.cyclesTillAdvance(), UINT32_MAX);
+	}
+
+	void testAdvanceCycles()
+	{
+		clockManager_t manager{32_MHz, 2457600};
+		clockManager_t reference{manager};
+		// Advance by spans of increasing length, checking they advance the same as running each cycle does
+		for (const auto span : substrate::indexSequence_t{256U})
+		{
+			uint32_t advanced{0U};
+			for ([[maybe_unused]] const auto cycle : substrate::indexSequence_t{span})
+			{
+				if (reference.advanceCycle())
+					++advanced;
+			}
+			assertEqual(manager.advanceCycles(static_cast<uint32_t>(span)), advanced);
+			assertEqual(manager.cyclesTillAdvance(), reference.cyclesTillAdvance());
+		}
+
+		// A manager that runs at the base frequency advances every cycle
+		clockManager_t wholeManager{32_MHz, 32_MHz};
+		assertEqual(wholeManager.cyclesTillAdvance(), 1U);
+		assertEqual(wholeManager.advanceCycles(100U), 100U);
+		assertEqual(wholeManager.cyclesTillAdvance(3U), 3U);
+	}
+
 public:
 	void registerTests() final
 	{
 		CXX_TEST(testWholeRatio)
 		CXX_TEST(testFractionalRatio)
+		CXX_TEST(testCyclesTillAdvance)
+		CXX_TEST(testAdvanceCycles)
 	}
 };
 
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <crunch++.h>
+#include "emulator/memoryMap.hxx"
+#include "emulator/ram.hxx"
+#include "emulator/unitsHelpers.hxx"
+
+// A single register that reads back the last byte written to it in every byte of the access
+struct ioRegister_t final : public peripheral_t<uint32_t>
+{
+	uint8_t value{};
+
+	void readAddress(const uint32_t, substrate::span<uint8_t> data) const noexcept override
+	{
+		for (auto &byte : data)
+			byte = value;
+	}
+
+	void writeAddress(const uint32_t, const substrate::span<uint8_t> &data) noexcept override
+		{ value = data[0]; }
+};
+
+// A block of memory that only offers some of itself for direct access, so has to be accessed through the peripheral
+struct shortMemory_t final : public peripheral_t<uint32_t>
+{
+	std::array<uint8_t, 64U> memory{};
+	mutable uint32_t accesses{0U};
+
+	void readAddress(const uint32_t address, substrate::span<uint8_t> data) const noexcept override
+	{
+		++accesses;
+		for (size_t offset{}; offset < data.size(); ++offset)
+			data[offset] = memory[address + offset];
+	}
+
+	void writeAddress(const uint32_t address, const substrate::span<uint8_t> &data) noexcept override
+	{
+		++accesses;
+		for (size_t offset{}; offset < data.size(); ++offset)
+			memory[address + offset] = data[offset];
+	}
+
+	[[nodiscard]] substrate::span<uint8_t> directMemory() noexcept override { return {memory.data(), 16U}; }
+};
+
+class testMemoryMap final : public testsuite, memoryMap_t<uint32_t, 0x00ffffffU>
+{
+private:
+	ioRegister_t *registerA{nullptr};
+	ioRegister_t *registerB{nullptr};
+	shortMemory_t *shortMemory{nullptr};
+
+	void testRAM()
+	{
+		// Check accesses work all through RAM, including ones that straddle a page boundary
+		writeAddress(0x000000U, uint32_t{0x01234567U});
+		writeAddress(0x000ffeU, uint32_t{0x89abcdefU});
+		writeAddress(0x0ffffcU, uint32_t{0xfedcba98U});
+		assertEqual(readAddress<uint32_t>(0x000000U), 0x01234567U);
+		assertEqual(readAddress<uint32_t>(0x000ffeU), 0x89abcdefU);
+		assertEqual(readAddress<uint16_t>(0x001000U), 0xcdefU);
+		assertEqual(readAddress<uint8_t>(0x000fffU), 0xabU);
+		assertEqual(readAddress<uint32_t>(0x0ffffcU), 0xfedcba98U);
+		// Addresses past the end of the 24-bit bus wrap back round into RAM
+		assertEqual(readAddress<uint32_t>(0xff000000U), 0x01234567U);
+	}
+
+	void testUnmapped()
+	{
+		// Addresses nothing is mapped to read as 0 and swallow writes
+		writeAddress(0x100000U, uint32_t{0xffffffffU});
+		assertEqual(readAddress<uint32_t>(0x100000U), 0U);
+		assertEqual(readAddress<uint16_t>(0x800000U), 0U);
+		// Including the parts of pages that a peripheral is only mapped into some of
+		writeAddress(0xff8804U, uint8_t{0x5aU});
+		assertEqual(readAddress<uint8_t>(0xff8804U), 0U);
+		assertEqual(readAddress<uint8_t>(0xfffa40U), 0U);
+		assertEqual(registerA->value, 0U);
+	}
+
+	void testSharedPage()
+	{
+		// Both registers live in the same page, so check they each only see their own accesses
+		writeAddress(0xff8800U, uint8_t{0x12U});
+		writeAddress(0xff8900U, uint8_t{0x34U});
+		assertEqual(registerA->value, 0x12U);
+		assertEqual(registerB->value, 0x34U);
+		assertEqual(readAddress<uint8_t>(0xff8802U), 0x12U);
+		assertEqual(readAddress<uint16_t>(0xff8920U), 0x3434U);
+		assertEqual(readAddress<uint8_t>(0xff8a00U), 0U);
+	}
+
+	void testRemap()
+	{
+		// Mapping something new over a range already in use replaces what was there
+		auto *const replacement{mapPeripheral({0xff8800U, 0xff8804U}, std::make_unique<ioRegister_t>())};
+		writeAddress(0xff8800U, uint8_t{0x56U});
+		assertEqual(replacement->value, 0x56U);
+		assertEqual(readAddress<uint8_t>(0xff8900U), registerB->value);
+		// The old register is gone, so put the pointer to it right for the other tests
+		registerA = replacement;
+	}
+
+	void testLookup()
+	{
+		// Peripherals are only found by the exact range they were mapped with
+		assertTrue(peripheral({0xff8900U, 0xff8926U}) == registerB);
+		assertTrue(peripheral({0xff8800U, 0xff8804U}) == registerA);
+		assertNull(peripheral({0xff8900U, 0xff8904U}));
+		assertNull(peripheral({0x100000U, 0x200000U}));
+	}
+
+	void testShortDirectMemory()
+	{
+		// The peripheral's direct memory doesn't cover its whole range, so every access must go through it
+		writeAddress(0x200000U, uint32_t{0x01234567U});
+		writeAddress(0x20003eU, uint16_t{0x89abU});
+		assertEqual(shortMemory->accesses, 2U);
+		assertEqual(shortMemory->memory[0], 0x01U);
+		assertEqual(shortMemory->memory[3], 0x67U);
+		assertEqual(shortMemory->memory[62], 0x89U);
+		assertEqual(shortMemory->memory[63], 0xabU);
+		assertEqual(readAddress<uint32_t>(0x200000U), 0x01234567U);
+		assertEqual(readAddress<int16_t>(0x20003eU), int16_t(0x89abU));
+		assertEqual(readAddress<uint8_t>(0x200001U), 0x23U);
+		assertEqual(shortMemory->accesses, 5U);
+	}
+
+public:
+	CRUNCH_VIS testMemoryMap() noexcept : testsuite{}, memoryMap_t<uint32_t, 0x00ffffffU>{}
+	{
+		mapPeripheral({0x000000U, 0x100000U}, std::make_unique<ram_t<uint32_t, 1_MiB>>());
+		registerA = mapPeripheral({0xff8800U, 0xff8804U}, std::make_unique<ioRegister_t>());
+		registerB = mapPeripheral({0xff8900U, 0xff8926U}, std::make_unique<ioRegister_t>());
+		mapPeripheral({0xfffa00U, 0xfffa40U}, std::make_unique<ioRegister_t>());
+		shortMemory = mapPeripheral({0x200000U, 0x200040U}, std::make_unique<shortMemory_t>());
+	}
+
+	void registerTests() final
+	{
+		CXX_TEST(testRAM)
+		CXX_TEST(testUnmapped)
+		CXX_TEST(testSharedPage)
+		CXX_TEST(testRemap)
+		CXX_TEST(testLookup)
+		CXX_TEST(testShortDirectMemory)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testMemoryMap>();
+}
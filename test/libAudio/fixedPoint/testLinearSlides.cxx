@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <crunch++.h>
+#include "fixedPoint/fixedPoint.h"
+#include "moduleMixer/moduleMixer.h"
+
+class testLinearSlides final : public testsuite
+{
+private:
+	using slide_t = uint32_t (*)(uint32_t, uint8_t) noexcept;
+	using slideGrid_t = std::array<std::array<uint32_t, 7>, 9>;
+
+	// Periods from the bottom of the range, through the ones modules actually use, up to where the result wraps
+	constexpr static std::array<uint32_t, 9> periods{{0U, 1U, 113U, 428U, 1712U, 6848U, 65535U, 1048576U, 4294967295U}};
+	constexpr static std::array<uint8_t, 7> slides{{0U, 1U, 15U, 64U, 128U, 192U, 255U}};
+
+	// These are the values the fixed64_t maths the slide tables replaced gave, recorded from it
+	constexpr static std::array<int32_t, 256> slideUpMultipliers
+	{{
+		65536, 65773, 66011, 66250, 66489, 66730, 66971, 67213,
+		67456, 67700, 67945, 68191, 68438, 68685, 68933, 69183,
+		69433, 69684, 69936, 70189, 70443, 70698, 70953, 71210,
+		71468, 71726, 71985, 72246, 72507, 72769, 73032, 73297,
+		73562, 73828, 74095, 74363, 74632, 74902, 75172, 75444,
+		75717, 75991, 76266, 76542, 76819, 77096, 77375, 77655,
+		77936, 78218, 78501, 78785, 79069, 79355, 79642, 79930,
+		80220, 80510, 80801, 81093, 81386, 81681, 81976, 82273,
+		82570, 82869, 83169, 83469, 83771, 84074, 84378, 84683,
+		84990, 85297, 85606, 85915, 86226, 86538, 86851, 87165,
+		87480, 87796, 88114, 88433, 88752, 89073, 89396, 89719,
+		90043, 90369, 90696, 91024, 91353, 91684, 92015, 92348,
+		92682, 93017, 93354, 93691, 94030, 94370, 94711, 95054,
+		95398, 95743, 96089, 96436, 96785, 97135, 97487, 97839,
+		98193, 98548, 98905, 99262, 99621, 99982, 100343, 100706,
+		101070, 101436, 101803, 102171, 102540, 102911, 103283, 103657,
+		104032, 104408, 104786, 105165, 105545, 105927, 106310, 106694,
+		107080, 107468, 107856, 108246, 108638, 109031, 109425, 109821,
+		110218, 110617, 111017, 111418, 111821, 112226, 112631, 113039,
+		113448, 113858, 114270, 114683, 115098, 115514, 115932, 116351,
+		116772, 117194, 117618, 118043, 118470, 118899, 119329, 119760,
+		120194, 120628, 121065, 121502, 121942, 122383, 122825, 123270,
+		123715, 124163, 124612, 125063, 125515, 125969, 126425, 126882,
+		127341, 127801, 128263, 128727, 129193, 129660, 130129, 130600,
+		131072, 131546, 132022, 132499, 132978, 133459, 133942, 134427,
+		134913, 135401, 135890, 136382, 136875, 137370, 137867, 138366,
+		138866, 139368, 139872, 140378, 140886, 141395, 141907, 142420,
+		142935, 143452, 143971, 144491, 145014, 145539, 146065, 146593,
+		147123, 147655, 148189, 148725, 149263, 149803, 150345, 150889,
+		151434, 151982, 152532, 153083, 153637, 154193, 154750, 155310,
+		155872, 156435, 157001, 157569, 158139, 158711, 159285, 159861,
+		160439, 161019, 161602, 162186, 162773, 163361, 163952, 164545
+	}};
+
+	constexpr static std::array<int32_t, 256> slideDownMultipliers
+	{{
+		65535, 65299, 65064, 64829, 64595, 64363, 64131, 63900,
+		63669, 63440, 63211, 62984, 62757, 62530, 62305, 62081,
+		61857, 61634, 61412, 61190, 60970, 60750, 60531, 60313,
+		60096, 59879, 59664, 59449, 59234, 59021, 58808, 58596,
+		58385, 58175, 57965, 57756, 57548, 57341, 57134, 56928,
+		56723, 56519, 56315, 56112, 55910, 55708, 55507, 55307,
+		55108, 54910, 54712, 54515, 54318, 54122, 53927, 53733,
+		53539, 53346, 53154, 52963, 52772, 52582, 52392, 52203,
+		52015, 51828, 51641, 51455, 51269, 51085, 50901, 50717,
+		50534, 50352, 50171, 49990, 49810, 49630, 49452, 49273,
+		49096, 48919, 48743, 48567, 48392, 48218, 48044, 47871,
+		47698, 47526, 47355, 47184, 47014, 46845, 46676, 46508,
+		46340, 46173, 46007, 45841, 45676, 45511, 45347, 45184,
+		45021, 44859, 44697, 44536, 44376, 44216, 44056, 43898,
+		43739, 43582, 43425, 43268, 43112, 42957, 42802, 42648,
+		42494, 42341, 42188, 42036, 41885, 41734, 41584, 41434,
+		41284, 41136, 40987, 40840, 40693, 40546, 40400, 40254,
+		40109, 39965, 39821, 39677, 39534, 39392, 39250, 39108,
+		38967, 38827, 38687, 38548, 38409, 38270, 38132, 37995,
+		37858, 37722, 37586, 37450, 37315, 37181, 37047, 36913,
+		36780, 36648, 36516, 36384, 36253, 36122, 35992, 35862,
+		35733, 35604, 35476, 35348, 35221, 35094, 34968, 34842,
+		34716, 34591, 34466, 34342, 34218, 34095, 33972, 33850,
+		33728, 33606, 33485, 33364, 33244, 33124, 33005, 32886,
+		32768, 32649, 32532, 32415, 32298, 32181, 32065, 31950,
+		31835, 31720, 31606, 31492, 31378, 31265, 31153, 31040,
+		30928, 30817, 30706, 30595, 30485, 30375, 30266, 30157,
+		30048, 29940, 29832, 29724, 29617, 29510, 29404, 29298,
+		29193, 29087, 28983, 28878, 28774, 28670, 28567, 28464,
+		28361, 28259, 28157, 28056, 27955, 27854, 27754, 27654,
+		27554, 27455, 27356, 27257, 27159, 27061, 26964, 26866,
+		26770, 26673, 26577, 26481, 26386, 26291, 26196, 26102
+	}};
+
+	constexpr static slideGrid_t slideUpPeriods
+	{{
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{2U, 2U, 2U, 2U, 2U, 2U, 3U}},
+		{{114U, 114U, 120U, 143U, 180U, 226U, 284U}},
+		{{429U, 430U, 452U, 540U, 680U, 856U, 1075U}},
+		{{1713U, 1719U, 1808U, 2157U, 2718U, 3424U, 4299U}},
+		{{6849U, 6873U, 7230U, 8628U, 10871U, 13696U, 17194U}},
+		{{65536U, 237U, 3646U, 17033U, 38495U, 65534U, 33471U}},
+		{{1U, 3793U, 58349U, 10403U, 26111U, 0U, 11285U}},
+		{{65536U, 1425U, 49959U, 12175U, 59975U, 65523U, 17464U}}
+	}};
+
+	constexpr static slideGrid_t slideDownPeriods
+	{{
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{113U, 113U, 108U, 90U, 72U, 57U, 46U}},
+		{{428U, 427U, 406U, 340U, 270U, 214U, 171U}},
+		{{1712U, 1706U, 1622U, 1359U, 1079U, 856U, 682U}},
+		{{6848U, 6824U, 6487U, 5436U, 4314U, 3424U, 2728U}},
+		{{65535U, 65298U, 62080U, 52015U, 41284U, 32768U, 26102U}},
+		{{65521U, 61742U, 10249U, 45811U, 5192U, 65529U, 24411U}},
+		{{65536U, 54786U, 33978U, 10748U, 30343U, 32772U, 42112U}}
+	}};
+
+	constexpr static slideGrid_t fineSlideUpPeriods
+	{{
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{2U, 2U, 2U, 2U, 2U, 2U, 2U}},
+		{{114U, 114U, 115U, 120U, 127U, 135U, 143U}},
+		{{429U, 429U, 434U, 454U, 481U, 509U, 539U}},
+		{{1713U, 1714U, 1736U, 1814U, 1922U, 2036U, 2156U}},
+		{{6849U, 6855U, 6942U, 7256U, 7687U, 8144U, 8621U}},
+		{{65536U, 59U, 893U, 3896U, 8025U, 12399U, 16959U}},
+		{{1U, 947U, 14293U, 62352U, 62875U, 1791U, 9212U}},
+		{{65536U, 11481U, 17117U, 63785U, 44087U, 57497U, 45673U}}
+	}};
+
+	constexpr static slideGrid_t fineSlideDownPeriods
+	{{
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{1U, 1U, 1U, 1U, 1U, 1U, 1U}},
+		{{113U, 113U, 112U, 107U, 101U, 96U, 90U}},
+		{{428U, 428U, 423U, 404U, 382U, 360U, 341U}},
+		{{1712U, 1711U, 1689U, 1616U, 1526U, 1440U, 1361U}},
+		{{6848U, 6842U, 6756U, 6464U, 6101U, 5759U, 5441U}},
+		{{65535U, 65475U, 64653U, 61856U, 58385U, 55108U, 52062U}},
+		{{65521U, 64575U, 51421U, 6669U, 16657U, 29763U, 46563U}},
+		{{65536U, 57609U, 50051U, 52632U, 3114U, 9605U, 8567U}}
+	}};
+	void checkSlide(const slide_t slide, const slideGrid_t &expected)
+	{
+		for (size_t period{}; period < periods.size(); ++period)
+		{
+			for (size_t amount{}; amount < slides.size(); ++amount)
+				assertEqual(slide(periods[period], slides[amount]), expected[period][amount]);
+		}
+	}
+
+	void testLinearSlideUp()
+	{
+		for (size_t slide{}; slide < slideUpMultipliers.size(); ++slide)
+			assertEqual(linearSlideUp(uint8_t(slide)), slideUpMultipliers[slide]);
+		checkSlide(linearSlideUp, slideUpPeriods);
+	}
+
+	void testLinearSlideDown()
+	{
+		for (size_t slide{}; slide < slideDownMultipliers.size(); ++slide)
+			assertEqual(linearSlideDown(uint8_t(slide)), slideDownMultipliers[slide]);
+		checkSlide(linearSlideDown, slideDownPeriods);
+	}
+
+	void testFineLinearSlideUp() { checkSlide(fineLinearSlideUp, fineSlideUpPeriods); }
+	void testFineLinearSlideDown() { checkSlide(fineLinearSlideDown, fineSlideDownPeriods); }
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testLinearSlideUp)
+		CXX_TEST(testLinearSlideDown)
+		CXX_TEST(testFineLinearSlideUp)
+		CXX_TEST(testFineLinearSlideDown)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testLinearSlides>();
+}
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <crunch++.h>
+#include "genericModule/genericModule.h"
+
+using envelopeNodes_t = std::array<envelopeNode_t, 25>;
+
+class testModuleEnvelope final : public testsuite
+{
+private:
+	// Works out the envelope's value at a tick the way the mixer used to every time it applied one, by finding the
+	// first node at or past the tick and interpolating from the one before it
+	static uint8_t interpolate(const envelopeNodes_t &nodes, const uint8_t count, const uint16_t tick)
+	{
+		uint8_t node{};
+		while (node + 1U < count && tick > nodes[node].Tick)
+			++node;
+		if (tick >= nodes[node].Tick)
+			return nodes[node].Value;
+		const uint16_t startTick{node ? nodes[node - 1U].Tick : uint16_t{}};
+		const uint8_t startValue{node ? nodes[node - 1U].Value : uint8_t{}};
+		if (nodes[node].Tick <= startTick || tick <= startTick)
+			return startValue;
+		const int32_t delta{(tick - startTick) * (int16_t(nodes[node].Value) - startValue)};
+		return uint8_t(startValue + (delta / (nodes[node].Tick - startTick)));
+	}
+
+	void checkEnvelope(const envelopeNodes_t &nodes, const uint8_t count)
+	{
+		const ModuleEnvelope envelope{envelopeType_t::volume, 0x01U, nodes, count};
+		for (uint32_t tick{}; tick <= std::numeric_limits<uint16_t>::max(); ++tick)
+			assertEqual(envelope.Apply(uint16_t(tick)), interpolate(nodes, count, uint16_t(tick)));
+	}
+
+	void testOrderedNodes()
+	{
+		const envelopeNodes_t nodes{{{64U, 0U}, {32U, 10U}, {0U, 30U}}};
+		const ModuleEnvelope envelope{envelopeType_t::volume, 0x01U, nodes, 3U};
+		assertEqual(envelope.Apply(0U), 64U);
+		assertEqual(envelope.Apply(5U), 48U);
+		assertEqual(envelope.Apply(10U), 32U);
+		assertEqual(envelope.Apply(20U), 16U);
+		assertEqual(envelope.Apply(29U), 2U);
+		assertEqual(envelope.Apply(30U), 0U);
+		assertEqual(envelope.Apply(1000U), 0U);
+		assertEqual(envelope.GetLastTick(), 30U);
+		checkEnvelope(nodes, 3U);
+	}
+
+	void testUnorderedNodes()
+	{
+		// The furthest node isn't the last one, so the table must still reach it
+		const envelopeNodes_t nodes{{{0U, 0U}, {64U, 20U}, {32U, 10U}, {8U, 40U}}};
+		const ModuleEnvelope envelope{envelopeType_t::volume, 0x01U, nodes, 4U};
+		assertEqual(envelope.Apply(10U), 32U);
+		assertEqual(envelope.Apply(15U), 48U);
+		assertEqual(envelope.Apply(20U), 64U);
+		assertEqual(envelope.Apply(30U), 16U);
+		assertEqual(envelope.Apply(40U), 8U);
+		checkEnvelope(nodes, 4U);
+	}
+
+	void testSingleNode()
+	{
+		const envelopeNodes_t nodes{{{40U, 5U}}};
+		const ModuleEnvelope envelope{envelopeType_t::volume, 0x01U, nodes, 1U};
+		assertEqual(envelope.Apply(0U), 0U);
+		assertEqual(envelope.Apply(1U), 8U);
+		assertEqual(envelope.Apply(5U), 40U);
+		assertEqual(envelope.Apply(6U), 40U);
+		checkEnvelope(nodes, 1U);
+	}
+
+	void testLongEnvelopes()
+	{
+		// Either side of how far an envelope can run and still get a table, then as far as a node can possibly be
+		checkEnvelope({{{64U, 0U}, {0U, 9999U}}}, 2U);
+		checkEnvelope({{{64U, 0U}, {0U, 10000U}}}, 2U);
+		const envelopeNodes_t nodes{{{64U, 0U}, {16U, 100U}, {0U, 65535U}}};
+		const ModuleEnvelope envelope{envelopeType_t::volume, 0x01U, nodes, 3U};
+		assertEqual(envelope.Apply(50U), 40U);
+		assertEqual(envelope.Apply(32818U), 8U);
+		assertEqual(envelope.Apply(65535U), 0U);
+		checkEnvelope(nodes, 3U);
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testOrderedNodes)
+		CXX_TEST(testUnorderedNodes)
+		CXX_TEST(testSingleNode)
+		CXX_TEST(testLongEnvelopes)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testModuleEnvelope>();
+}
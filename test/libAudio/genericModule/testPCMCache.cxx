@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <string_view>
+#include <crunch++.h>
+#include "genericModule/pcmCache.hxx"
+
+class testPCMCache final : public testsuite
+{
+private:
+	constexpr static pcmFileID_t fileA{UINT64_C(0x0123456789ABCDEF), 1024U};
+	constexpr static pcmFileID_t fileB{UINT64_C(0xFEDCBA9876543210), 1024U};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays,modernize-avoid-c-arrays,hicpp-avoid-c-arrays)
+	static pcmPtr_t makePCM(const size_t bytes) { return pcmPtr_t{new uint8_t[bytes]{}}; }
+
+	void testIdentify()
+	{
+		// Check the identity is the xxHash64 of the file, through each of the tail lengths and the 32 byte stripes
+		const std::string_view empty{};
+		assertEqual(pcmCache_t::identify(empty.data(), empty.size()).hash, UINT64_C(0xEF46DB3751D8E999));
+		const std::string_view a{"a"};
+		assertEqual(pcmCache_t::identify(a.data(), a.size()).hash, UINT64_C(0xD24EC4F1A98C6E5B));
+		const std::string_view abc{"abc"};
+		assertEqual(pcmCache_t::identify(abc.data(), abc.size()).hash, UINT64_C(0x44BC2CF5AD770999));
+		const std::string_view stripe{"Nobody inspects the spammish repetition"};
+		assertEqual(pcmCache_t::identify(stripe.data(), stripe.size()).hash, UINT64_C(0xFBCEA83C8A378BF1));
+		const std::string_view multiStripe
+		{
+			"abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrst"
+			"nopqrstu"
+		};
+		assertEqual(pcmCache_t::identify(multiStripe.data(), multiStripe.size()).hash, UINT64_C(0xBAFC02122DED1D21));
+
+		std::array<uint8_t, 37> data{};
+		for (size_t i{}; i < data.size(); ++i)
+			data[i] = static_cast<uint8_t>(i * 7U);
+		const auto id{pcmCache_t::identify(data.data(), data.size())};
+		assertEqual(id.length, data.size());
+		assertTrue(pcmCache_t::identify(data.data(), data.size()) == id);
+		// Changing the trailing byte that doesn't fill a whole word must still change the identity
+		data[36] ^= 1U;
+		assertFalse(pcmCache_t::identify(data.data(), data.size()) == id);
+		data[36] ^= 1U;
+		data[3] ^= 0x80U;
+		assertFalse(pcmCache_t::identify(data.data(), data.size()) == id);
+		data[3] ^= 0x80U;
+		assertFalse(pcmCache_t::identify(data.data(), data.size() - 1U) == id);
+	}
+
+	void testFindInsert()
+	{
+		pcmCache_t cache{4096U};
+		assertNull(cache.find(fileA, 0U, 1024U).get());
+		const auto pcm{makePCM(1024U)};
+		cache.insert(fileA, 0U, pcm, 1024U);
+		assertEqual(cache.used(), 1024U);
+		assertTrue(cache.find(fileA, 0U, 1024U) == pcm);
+		assertNull(cache.find(fileA, 1U, 1024U).get());
+		assertNull(cache.find(fileB, 0U, 1024U).get());
+		// Inserting the same sample again must not account for it twice
+		cache.insert(fileA, 0U, makePCM(1024U), 1024U);
+		assertEqual(cache.used(), 1024U);
+		assertTrue(cache.find(fileA, 0U, 1024U) == pcm);
+		// Asking for a different amount of PCM than the cache holds must not hand back the cached PCM
+		assertNull(cache.find(fileA, 0U, 512U).get());
+		// And inserting the sample at that size replaces what was there
+		const auto resized{makePCM(512U)};
+		cache.insert(fileA, 0U, resized, 512U);
+		assertEqual(cache.used(), 512U);
+		assertTrue(cache.find(fileA, 0U, 512U) == resized);
+		assertNull(cache.find(fileA, 0U, 1024U).get());
+		cache.clear();
+		assertEqual(cache.used(), 0U);
+		assertNull(cache.find(fileA, 0U, 1024U).get());
+	}
+
+	void testEviction()
+	{
+		pcmCache_t cache{3072U};
+		const auto pcm0{makePCM(1024U)};
+		cache.insert(fileA, 0U, pcm0, 1024U);
+		cache.insert(fileA, 1U, makePCM(1024U), 1024U);
+		cache.insert(fileA, 2U, makePCM(1024U), 1024U);
+		assertEqual(cache.used(), 3072U);
+		// Touch sample 0 so sample 1 becomes the least recently used
+		assertNotNull(cache.find(fileA, 0U, 1024U).get());
+		cache.insert(fileB, 0U, makePCM(1024U), 1024U);
+		assertEqual(cache.used(), 3072U);
+		assertNull(cache.find(fileA, 1U, 1024U).get());
+		assertTrue(cache.find(fileA, 0U, 1024U) == pcm0);
+		assertNotNull(cache.find(fileA, 2U, 1024U).get());
+		assertNotNull(cache.find(fileB, 0U, 1024U).get());
+
+		// Something bigger than the whole budget is never cached
+		cache.insert(fileB, 1U, makePCM(4096U), 4096U);
+		assertNull(cache.find(fileB, 1U, 1024U).get());
+		assertEqual(cache.used(), 3072U);
+
+		// Shrinking the budget evicts, but PCM still in use stays valid for its users
+		cache.budget(1024U);
+		assertEqual(cache.budget(), 1024U);
+		assertEqual(cache.used(), 1024U);
+		assertNull(cache.find(fileA, 0U, 1024U).get());
+		assertEqual(pcm0.use_count(), 1);
+		assertEqual(pcm0[1023], 0U);
+	}
+
+	void testDisabled()
+	{
+		pcmCache_t cache{0U};
+		cache.insert(fileA, 0U, makePCM(16U), 16U);
+		assertEqual(cache.used(), 0U);
+		assertNull(cache.find(fileA, 0U, 16U).get());
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testIdentify)
+		CXX_TEST(testFindInsert)
+		CXX_TEST(testEviction)
+		CXX_TEST(testDisabled)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testPCMCache>();
+}
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <crunch++.h>
+#include "genericModule/renderCache.hxx"
+
+class testRenderCache final : public testsuite
+{
+private:
+	constexpr static pcmFileID_t file{UINT64_C(0x0123456789ABCDEF), 1024U};
+
+	static renderKey_t makeKey(const moduleOutput_t format = moduleOutput_t::int16) noexcept
+		{ return {file, 44100U, 2U, format, false, moduleInterpolation_t::none, 0U, 0U}; }
+
+	// A slow sweep, so it stays compressible while still exercising every byte of each sample
+	static std::vector<uint8_t> makeOutput(const size_t frames, const uint32_t frameSize)
+	{
+		std::vector<uint8_t> output(frames * frameSize);
+		for (size_t i{}; i < output.size(); ++i)
+			output[i] = static_cast<uint8_t>((i / frameSize) + (i % frameSize));
+		return output;
+	}
+
+	static renderedSongPtr_t makeSong(const renderKey_t &key, const size_t bytes)
+	{
+		renderCapture_t capture{key, false, bytes};
+		const auto output{makeOutput(bytes / key.frameSize(), key.frameSize())};
+		if (!capture.append(output.data(), output.size()))
+			return nullptr;
+		return capture.finish();
+	}
+
+	void checkRoundTrip(const renderKey_t &key, const bool compress)
+	{
+		// An odd number of frames so the last read comes up short
+		const auto output{makeOutput(10007U, key.frameSize())};
+		renderCapture_t capture{key, compress, output.size() * 2U};
+		assertTrue(capture.valid());
+		// Capture in uneven pieces the way the mixer's output arrives
+		for (size_t offset{}; offset < output.size(); offset += key.frameSize() * 333U)
+		{
+			const auto bytes{std::min<size_t>(key.frameSize() * 333U, output.size() - offset)};
+			assertTrue(capture.append(output.data() + offset, bytes));
+		}
+		const auto song{capture.finish()};
+		assertNotNull(song.get());
+		assertEqual(song->length, output.size());
+		assertTrue(song->key == key);
+
+		renderReader_t reader{song};
+		assertTrue(reader.valid());
+		std::vector<uint8_t> replay{};
+		std::array<uint8_t, 4099> buffer{};
+		int64_t result{};
+		while ((result = reader.read(buffer.data(), static_cast<uint32_t>(buffer.size()))) > 0)
+		{
+			// Reads must only ever hand back whole frames
+			assertEqual(static_cast<uint64_t>(result) % key.frameSize(), 0U);
+			replay.insert(replay.end(), buffer.begin(), buffer.begin() + result);
+			assertEqual(reader.position(), replay.size() / key.frameSize());
+		}
+		assertEqual(result, -2);
+		assertEqual(replay.size(), output.size());
+		assertTrue(replay == output);
+	}
+
+	void testKey()
+	{
+		const auto key{makeKey()};
+		assertEqual(key.frameSize(), 4U);
+		assertEqual(makeKey(moduleOutput_t::int24).frameSize(), 6U);
+		assertEqual(makeKey(moduleOutput_t::float32).frameSize(), 8U);
+		auto other{key};
+		other.interpolation = moduleInterpolation_t::cubic;
+		assertTrue(other != key);
+		other = key;
+		other.voiceLimit = 32U;
+		assertTrue(other != key);
+		other = key;
+		other.file.hash ^= 1U;
+		assertTrue(other != key);
+		other = key;
+		other.effects.noiseShaping = true;
+		assertTrue(other != key);
+	}
+
+	void testRoundTrip()
+	{
+		checkRoundTrip(makeKey(), false);
+		checkRoundTrip(makeKey(moduleOutput_t::int24), false);
+		checkRoundTrip(makeKey(moduleOutput_t::float32), false);
+	}
+
+	// Compression is only available with FLAC support built in, otherwise the capture must fall back to storing as-is
+	void testCompressedRoundTrip()
+	{
+		checkRoundTrip(makeKey(), true);
+		checkRoundTrip(makeKey(moduleOutput_t::int24), true);
+		checkRoundTrip(makeKey(moduleOutput_t::float32), true);
+	}
+
+	void testCaptureBudget()
+	{
+		const auto key{makeKey()};
+		const auto output{makeOutput(1024U, key.frameSize())};
+		renderCapture_t capture{key, false, output.size() - 1U};
+		assertFalse(capture.append(output.data(), output.size()));
+	}
+
+	void testFindInsert()
+	{
+		renderCache_t cache{65536U};
+		const auto key{makeKey()};
+		assertNull(cache.find(key).get());
+		const auto song{makeSong(key, 4096U)};
+		assertNotNull(song.get());
+		cache.insert(song);
+		assertEqual(cache.used(), 4096U);
+		assertTrue(cache.find(key) == song);
+		// A change to any mixer setting must miss
+		auto other{key};
+		other.sampleRate = 48000U;
+		assertNull(cache.find(other).get());
+		other = key;
+		other.dither = true;
+		assertNull(cache.find(other).get());
+		// Inserting the same song again must not account for it twice
+		cache.insert(makeSong(key, 4096U));
+		assertEqual(cache.used(), 4096U);
+		cache.clear();
+		assertEqual(cache.used(), 0U);
+		assertNull(cache.find(key).get());
+	}
+
+	void testEviction()
+	{
+		renderCache_t cache{8192U};
+		auto keyA{makeKey()};
+		auto keyB{makeKey()};
+		keyB.audibilityThreshold = 1U;
+		auto keyC{makeKey()};
+		keyC.channels = 1U;
+		const auto songA{makeSong(keyA, 4096U)};
+		cache.insert(songA);
+		cache.insert(makeSong(keyB, 4096U));
+		// Touch A so B becomes the least recently used
+		assertNotNull(cache.find(keyA).get());
+		cache.insert(makeSong(keyC, 4096U));
+		assertEqual(cache.used(), 8192U);
+		assertNull(cache.find(keyB).get());
+		assertTrue(cache.find(keyA) == songA);
+		assertNotNull(cache.find(keyC).get());
+
+		// Shrinking the budget evicts, but a song still being played stays valid for its reader
+		cache.budget(0U);
+		assertEqual(cache.used(), 0U);
+		assertEqual(songA.use_count(), 1);
+		renderReader_t reader{songA};
+		std::array<uint8_t, 4096> buffer{};
+		assertEqual(reader.read(buffer.data(), static_cast<uint32_t>(buffer.size())), 4096);
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testKey)
+		CXX_TEST(testRoundTrip)
+		CXX_TEST(testCompressedRoundTrip)
+		CXX_TEST(testCaptureBudget)
+		CXX_TEST(testFindInsert)
+		CXX_TEST(testEviction)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testRenderCache>();
+}
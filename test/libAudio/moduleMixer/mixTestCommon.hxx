@@ -0,0 +1,55 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#ifndef MIX_TEST_COMMON__HXX
+#define MIX_TEST_COMMON__HXX
+
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include "genericModule/genericModule.h"
+#include "moduleMixer/samplePCM.hxx"
+
+// Lays PCM out the way the loaders do, with the guard frames either side, returning where the sample data starts
+inline const uint8_t *padPCM(std::vector<int16_t> &buffer, const std::vector<int16_t> &pcm, const size_t channels)
+{
+	const size_t guard{sampleGuard * channels};
+	buffer.assign(pcm.size() + (guard * 2U), 0);
+	std::copy(pcm.begin(), pcm.end(), buffer.begin() + guard);
+	pcmFillGuards(buffer.data() + guard, pcm.size() / channels, channels);
+	return reinterpret_cast<const uint8_t *>(buffer.data() + guard);
+}
+
+// A sample which only knows its format and length, as that's all the mixing functions care about
+struct testSample_t final : public ModuleSample
+{
+private:
+	uint32_t _length;
+	bool _stereo;
+
+public:
+	testSample_t(const uint32_t length, const bool isStereo) noexcept : ModuleSample{0U, 1U},
+		_length{length}, _stereo{isStereo} { }
+
+	[[nodiscard]] uint32_t GetLength() final { return _length; }
+	[[nodiscard]] uint32_t GetLoopStart() final { return 0U; }
+	[[nodiscard]] uint32_t GetLoopEnd() final { return 0U; }
+	[[nodiscard]] uint32_t GetSustainLoopBegin() final { return 0U; }
+	[[nodiscard]] uint32_t GetSustainLoopEnd() final { return 0U; }
+	[[nodiscard]] uint8_t GetFineTune() final { return 0U; }
+	[[nodiscard]] uint32_t GetC4Speed() final { return 8363U; }
+	[[nodiscard]] uint8_t GetVolume() final { return 64U; }
+	[[nodiscard]] uint8_t GetSampleVolume() final { return 64U; }
+	[[nodiscard]] uint8_t GetVibratoSpeed() final { return 0U; }
+	[[nodiscard]] uint8_t GetVibratoDepth() final { return 0U; }
+	[[nodiscard]] uint8_t GetVibratoType() final { return 0U; }
+	[[nodiscard]] uint8_t GetVibratoRate() final { return 0U; }
+	[[nodiscard]] uint16_t GetPanning() final { return 128U; }
+	[[nodiscard]] bool Get16Bit() final { return true; }
+	[[nodiscard]] bool GetStereo() final { return _stereo; }
+	[[nodiscard]] bool GetLooped() final { return false; }
+	[[nodiscard]] bool GetSustainLooped() final { return false; }
+	[[nodiscard]] bool GetBidiLoop() final { return false; }
+	[[nodiscard]] bool GetPanned() final { return false; }
+};
+
+#endif /*MIX_TEST_COMMON__HXX*/
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <vector>
+#include <crunch++.h>
+#include "moduleMixer/fc1x.hxx"
+
+class testFC1x final : public testsuite
+{
+private:
+	// Lays each macro out in its own 64 bytes, with the rest of each read as the end of the macro
+	static fixedVector_t<uint8_t> macros(const std::initializer_list<std::initializer_list<uint8_t>> data)
+	{
+		fixedVector_t<uint8_t> result{data.size() * fc1xMacroLength};
+		std::fill(result.begin(), result.end(), 0xe1U);
+		size_t offset{};
+		for (const auto &macro : data)
+		{
+			std::copy(macro.begin(), macro.end(), result.begin() + offset);
+			offset += fc1xMacroLength;
+		}
+		return result;
+	}
+
+	static fc1xSong_t song(const std::initializer_list<std::initializer_list<uint8_t>> frequencyMacros,
+		const std::initializer_list<std::initializer_list<uint8_t>> volumeMacros)
+	{
+		fc1xSong_t result{};
+		result.frequencyMacros = macros(frequencyMacros);
+		result.volumeMacros = macros(volumeMacros);
+		return result;
+	}
+
+	// Plays the voice on for the given number of ticks, noting down the period and volume of each
+	static std::vector<uint16_t> periods(fc1xVoice_t &voice, const fc1xSong_t &song, const size_t ticks)
+	{
+		std::vector<uint16_t> result{};
+		for (size_t i{}; i < ticks; ++i)
+		{
+			voice.tick(song);
+			result.push_back(voice.period());
+		}
+		return result;
+	}
+
+	static std::vector<uint8_t> volumes(fc1xVoice_t &voice, const fc1xSong_t &song, const size_t ticks)
+	{
+		std::vector<uint8_t> result{};
+		for (size_t i{}; i < ticks; ++i)
+		{
+			voice.tick(song);
+			result.push_back(voice.volume());
+		}
+		return result;
+	}
+
+	void testNote()
+	{
+		const auto fc{song({{0xe2U, 0x0aU, 0x00U, 0xe1U}}, {{1U, 0U, 0U, 0U, 0U, 64U, 0xe1U}})};
+		fc1xVoice_t voice{};
+		assertFalse(voice.playing());
+		assertEqual(voice.period(), 0U);
+		voice.play(fc, 24U, 0U);
+		assertTrue(voice.playing());
+		voice.tick(fc);
+		assertEqual(voice.period(), 428U);
+		assertEqual(voice.volume(), 64U);
+		assertEqual(voice.wave(), 10U);
+		// The wave change is handed over once, and the note holds from there
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::restart);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::none);
+		voice.tick(fc);
+		assertEqual(voice.period(), 428U);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::none);
+	}
+
+	void testUnknownInstrument()
+	{
+		const auto fc{song({{0x00U}}, {{1U, 0U, 0U, 0U, 0U, 64U}})};
+		fc1xVoice_t voice{};
+		voice.play(fc, 24U, 1U);
+		voice.tick(fc);
+		assertFalse(voice.playing());
+		assertEqual(voice.period(), 0U);
+		assertEqual(voice.volume(), 0U);
+	}
+
+	void testArpeggio()
+	{
+		// An octave up, then a fixed note, then back round to the note played
+		const auto fc{song({{0x00U, 0x0cU, 0x87U, 0xe0U, 0x00U}}, {{1U, 0U, 0U, 0U, 0U, 64U}})};
+		fc1xVoice_t voice{};
+		voice.play(fc, 24U, 0U);
+		const std::vector<uint16_t> expected{428U, 214U, 1140U, 428U, 214U, 1140U};
+		assertTrue(periods(voice, fc, expected.size()) == expected);
+	}
+
+	void testFrequencyCommands()
+	{
+		const auto fc
+		{
+			song(
+				{
+					// Sustains for 2 ticks, changes wave without restarting it, then jumps to the next macro
+					{0xe2U, 0x0bU, 0x00U, 0xe8U, 0x02U, 0xe4U, 0x0cU, 0x0cU, 0xe7U, 0x01U},
+					{0xe3U, 0x00U, 0x00U, 0x18U, 0xe1U}
+				},
+				{{1U, 0U, 0U, 0U, 0U, 64U}}
+			)
+		};
+		fc1xVoice_t voice{};
+		voice.play(fc, 24U, 0U);
+		voice.tick(fc);
+		assertEqual(voice.period(), 428U);
+		assertEqual(voice.wave(), 11U);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::restart);
+		voice.tick(fc);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::none);
+		voice.tick(fc);
+		voice.tick(fc);
+		assertEqual(voice.period(), 428U);
+		voice.tick(fc);
+		assertEqual(voice.period(), 214U);
+		assertEqual(voice.wave(), 12U);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::change);
+		// The jump runs the new macro on the same tick, which takes the note past the top of the period range
+		voice.tick(fc);
+		assertEqual(voice.period(), fc1xMinPeriod);
+	}
+
+	void testSamplePack()
+	{
+		// Picks sub-sample 5 out of the pack in sample 3, then changes to a plain wave
+		const auto fc{song({{0xe9U, 0x03U, 0x05U, 0xe8U, 0x01U, 0xe4U, 0x0aU, 0xe1U}}, {{1U, 0U, 0U, 0U, 0U, 64U}})};
+		fc1xVoice_t voice{};
+		assertEqual(voice.subSample(), fc1xNoSubSample);
+		voice.play(fc, 24U, 0U);
+		voice.tick(fc);
+		assertEqual(voice.period(), 428U);
+		assertEqual(voice.wave(), 3U);
+		assertEqual(voice.subSample(), 5U);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::restart);
+		voice.tick(fc);
+		voice.tick(fc);
+		assertEqual(voice.wave(), 10U);
+		assertEqual(voice.subSample(), fc1xNoSubSample);
+		assertTrue(voice.takeWaveChange() == fc1xWaveChange_t::change);
+	}
+
+	void testVolumeMacro()
+	{
+		// Steps every other tick, holding for 2 ticks part way through
+		const auto fc{song({{0x00U}}, {{2U, 0U, 0U, 0U, 0U, 64U, 32U, 0xe8U, 0x02U, 16U, 0xe1U}})};
+		fc1xVoice_t voice{};
+		voice.play(fc, 24U, 0U);
+		const std::vector<uint8_t> expected{64U, 64U, 32U, 32U, 32U, 32U, 32U, 32U, 16U, 16U, 16U};
+		assertTrue(volumes(voice, fc, expected.size()) == expected);
+	}
+
+	void testVolumeSlide()
+	{
+		const auto fc{song({{0x00U}}, {{1U, 0U, 0U, 0U, 0U, 10U, 0xeaU, 0x03U, 0x04U, 0xe0U, 0x05U}})};
+		fc1xVoice_t voice{};
+		voice.play(fc, 24U, 0U);
+		const std::vector<uint8_t> expected{10U, 10U, 13U, 13U, 16U, 16U, 19U, 19U, 22U, 10U};
+		assertTrue(volumes(voice, fc, expected.size()) == expected);
+	}
+
+	void testVibrato()
+	{
+		// Speed 1, depth 2 and a tick of delay, played in the top octave and then the one under it
+		const auto fc{song({{0x00U}}, {{1U, 0U, 1U, 2U, 1U, 64U}})};
+		fc1xVoice_t voice{};
+		voice.play(fc, 36U, 0U);
+		const std::vector<uint16_t> top{214U, 215U, 216U, 215U, 214U, 213U, 212U, 213U};
+		assertTrue(periods(voice, fc, top.size()) == top);
+		voice.play(fc, 24U, 0U);
+		const std::vector<uint16_t> lower{428U, 430U, 432U, 430U, 428U, 426U, 424U, 426U};
+		assertTrue(periods(voice, fc, lower.size()) == lower);
+	}
+
+	void testPatternRow()
+	{
+		auto fc{song({{0x00U}}, {{1U, 0U, 0U, 0U, 0U, 64U}, {1U, 0U, 0U, 0U, 0U, 32U}})};
+		fc1xVoice_t voice{};
+		// The step's transposes move both the note and the instrument, and portamento comes from the row after
+		voice.row(fc, 12U, 0x82U, 0x02U, {0U, 12, -1});
+		const std::vector<uint16_t> up{426U, 426U, 424U, 424U, 422U};
+		assertTrue(periods(voice, fc, up.size()) == up);
+		assertEqual(voice.volume(), 32U);
+		// Rows without a note leave the voice to carry on
+		voice.row(fc, 0U, 0x00U, 0x00U, {});
+		voice.tick(fc);
+		assertEqual(voice.period(), 422U);
+		// Portamento down, then a new note that stops it
+		voice.row(fc, 24U, 0x80U, 0x21U, {});
+		const std::vector<uint16_t> down{429U, 429U, 430U};
+		assertTrue(periods(voice, fc, down.size()) == down);
+		assertEqual(voice.volume(), 64U);
+		voice.row(fc, 24U, 0x00U, 0x00U, {});
+		const std::vector<uint16_t> held{428U, 428U, 428U};
+		assertTrue(periods(voice, fc, held.size()) == held);
+	}
+
+	void testBuiltinWaves()
+	{
+		assertEqual(fc1xBuiltinWaveLength(0U), 32U);
+		assertEqual(fc1xBuiltinWaveLength(32U), 16U);
+		assertEqual(fc1xBuiltinWaveLength(40U), 32U);
+		assertEqual(fc1xBuiltinWaveLength(46U), 48U);
+		assertEqual(fc1xBuiltinWaveLength(fc1xBuiltinWaves), 0U);
+		assertNull(fc1xBuiltinWave(fc1xBuiltinWaves));
+
+		const std::array<int8_t, 32U> triangle
+		{{
+			-64, -64, -48, -40, -32, -24, -16, -8, 0, -8, -16, -24, -32, -40, -48, -56,
+			63, 55, 47, 39, 31, 23, 15, 7, -1, 7, 15, 23, 31, 39, 47, 55
+		}};
+		assertTrue(std::equal(triangle.begin(), triangle.end(), fc1xBuiltinWave(0U)));
+		// Each of the next waves takes one more byte of the triangle's second half down
+		const auto *wave{fc1xBuiltinWave(2U)};
+		assertEqual(wave[15], -56);
+		assertEqual(wave[16], -64);
+		assertEqual(wave[17], -72);
+		assertEqual(wave[18], 47);
+		wave = fc1xBuiltinWave(16U);
+		assertEqual(wave[0], -64);
+		assertEqual(wave[24], -128);
+		assertEqual(wave[31], -72);
+		// Then its first half, to the bottom
+		wave = fc1xBuiltinWave(31U);
+		assertEqual(wave[14], -128);
+		assertEqual(wave[15], -56);
+		assertEqual(wave[16], -64);
+
+		// The pulses get wider a byte a wave
+		wave = fc1xBuiltinWave(32U);
+		assertEqual(wave[0], -128);
+		assertEqual(wave[1], 127);
+		wave = fc1xBuiltinWave(39U);
+		assertEqual(wave[7], -128);
+		assertEqual(wave[8], 127);
+		assertEqual(wave[15], 127);
+		// And the sawtooths rise evenly from the bottom
+		wave = fc1xBuiltinWave(40U);
+		assertEqual(wave[0], -128);
+		assertEqual(wave[1], -120);
+		assertEqual(wave[31], 120);
+		wave = fc1xBuiltinWave(41U);
+		assertEqual(wave[1], -112);
+		assertEqual(wave[15], 112);
+		// The last wave starts 1296 bytes in, straight after the one before it
+		assertTrue(fc1xBuiltinWave(46U) == fc1xBuiltinWave(45U) + fc1xBuiltinWaveLength(45U));
+		assertTrue(fc1xBuiltinWave(46U) == fc1xBuiltinWave(0U) + 1296U);
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testNote)
+		CXX_TEST(testUnknownInstrument)
+		CXX_TEST(testArpeggio)
+		CXX_TEST(testFrequencyCommands)
+		CXX_TEST(testSamplePack)
+		CXX_TEST(testVolumeMacro)
+		CXX_TEST(testVolumeSlide)
+		CXX_TEST(testVibrato)
+		CXX_TEST(testPatternRow)
+		CXX_TEST(testBuiltinWaves)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testFC1x>();
+}
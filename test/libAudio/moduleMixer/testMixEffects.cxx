@@ -0,0 +1,217 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <crunch++.h>
+#include "libAudio.hxx"
+#include "moduleMixer/mixEffects.hxx"
+
+constexpr static uint32_t sampleRate{44100U};
+
+class testMixEffects final : public testsuite
+{
+private:
+	// Stereo frames of a sine wave at the given frequency, at half of full scale in the mix buffer's 28 bits
+	static std::vector<int32_t> makeTone(const size_t frames, const double frequency, const bool leftOnly = false)
+	{
+		constexpr auto pi{3.14159265358979323846};
+		std::vector<int32_t> tone(frames * 2U);
+		for (size_t i{}; i < frames; ++i)
+		{
+			const auto sample{static_cast<int32_t>(std::lround(
+				std::sin((2.0 * pi * frequency * double(i)) / sampleRate) * double(0x04000000)))};
+			tone[i * 2U] = sample;
+			tone[(i * 2U) + 1U] = leftOnly ? 0 : sample;
+		}
+		return tone;
+	}
+
+	static double power(const std::vector<int32_t> &frames, const size_t channel, const size_t from)
+	{
+		double total{};
+		for (size_t i{from}; i < frames.size() / 2U; ++i)
+			total += double(frames[(i * 2U) + channel]) * double(frames[(i * 2U) + channel]);
+		return total;
+	}
+
+	void testInactive()
+	{
+		mixEffects_t effects{};
+		assertFalse(effects.active());
+		// Noise shaping isn't one of the effects run over the mix
+		moduleEffects_t settings{};
+		settings.noiseShaping = true;
+		assertTrue(effects.configure(settings, sampleRate));
+		assertFalse(effects.active());
+
+		// Not knowing the sample rate yet, the effects must leave the mix alone even when turned on
+		mixEffects_t unconfigured{};
+		settings.bassDepth = 100U;
+		assertTrue(unconfigured.configure(settings, 0U));
+		assertTrue(unconfigured.active());
+		auto mix{makeTone(1000U, 440.0)};
+		const auto original{mix};
+		unconfigured.process(mix.data(), 1000U);
+		assertTrue(mix == original);
+	}
+
+	void testClamping()
+	{
+		mixEffects_t effects{};
+		moduleEffects_t settings{};
+		settings.reverbDepth = 255U;
+		settings.reverbRoomSize = 200U;
+		settings.surroundDepth = 101U;
+		settings.surroundDelay = 1U;
+		settings.bassDepth = 150U;
+		settings.bassCutoff = 250U;
+		assertTrue(effects.configure(settings, sampleRate));
+		const auto &clamped{effects.effects()};
+		assertEqual(clamped.reverbDepth, 100U);
+		assertEqual(clamped.reverbRoomSize, 100U);
+		assertEqual(clamped.surroundDepth, 100U);
+		assertEqual(clamped.surroundDelay, 5U);
+		assertEqual(clamped.bassDepth, 100U);
+		assertEqual(clamped.bassCutoff, 200U);
+
+		settings.surroundDelay = 200U;
+		settings.bassCutoff = 0U;
+		assertTrue(effects.configure(settings, sampleRate));
+		assertEqual(effects.effects().surroundDelay, 40U);
+		assertEqual(effects.effects().bassCutoff, 20U);
+	}
+
+	// However the mix is split up into calls, the effects have to come out exactly the same
+	void testSplitBlocks()
+	{
+		moduleEffects_t settings{};
+		settings.reverbDepth = 60U;
+		settings.reverbRoomSize = 80U;
+		settings.surroundDepth = 70U;
+		settings.surroundDelay = 15U;
+		settings.bassDepth = 50U;
+		settings.bassCutoff = 120U;
+		auto whole{makeTone(5000U, 220.0, true)};
+		auto split{whole};
+
+		mixEffects_t wholeEffects{};
+		assertTrue(wholeEffects.configure(settings, sampleRate));
+		wholeEffects.process(whole.data(), 5000U);
+		mixEffects_t splitEffects{};
+		assertTrue(splitEffects.configure(settings, sampleRate));
+		for (size_t offset{}; offset < 5000U; offset += 333U)
+			splitEffects.process(split.data() + (offset * 2U), std::min<size_t>(333U, 5000U - offset));
+		assertTrue(whole == split);
+
+		// And resetting has to put the effects back as they were when first configured
+		auto again{makeTone(5000U, 220.0, true)};
+		wholeEffects.reset();
+		wholeEffects.process(again.data(), 5000U);
+		assertTrue(again == whole);
+	}
+
+	void testBass()
+	{
+		moduleEffects_t settings{};
+		settings.bassDepth = 100U;
+		settings.bassCutoff = 100U;
+		// The effect has to boost a tone well under the cutoff far more than one well over it
+		std::array<double, 2> gains{};
+		for (const auto &[index, frequency] : std::array<std::pair<size_t, double>, 2>{{{0U, 40.0}, {1U, 4000.0}}})
+		{
+			mixEffects_t effects{};
+			assertTrue(effects.configure(settings, sampleRate));
+			auto mix{makeTone(sampleRate / 2U, frequency)};
+			const auto original{mix};
+			effects.process(mix.data(), mix.size() / 2U);
+			// Skip the filters settling in
+			gains[index] = power(mix, 0U, 4096U) / power(original, 0U, 4096U);
+		}
+		assertTrue(gains[0] > 2.5);
+		assertTrue(gains[1] < 1.1);
+	}
+
+	void testSurround()
+	{
+		moduleEffects_t settings{};
+		settings.surroundDepth = 100U;
+		settings.surroundDelay = 10U;
+		constexpr size_t delay{(sampleRate * 10U) / 1000U};
+
+		// With nothing different between the channels, there's nothing to put in the rear
+		mixEffects_t effects{};
+		assertTrue(effects.configure(settings, sampleRate));
+		auto centre{makeTone(4096U, 1000.0)};
+		const auto original{centre};
+		effects.process(centre.data(), 4096U);
+		assertTrue(centre == original);
+
+		// Something only in the left channel gets put in the rear out of phase, and only once the delay is up
+		effects.reset();
+		auto left{makeTone(4096U, 1000.0, true)};
+		const auto leftOriginal{left};
+		effects.process(left.data(), 4096U);
+		for (size_t i{}; i < delay; ++i)
+		{
+			assertEqual(left[i * 2U], leftOriginal[i * 2U]);
+			assertEqual(left[(i * 2U) + 1U], 0);
+		}
+		double correlation{};
+		for (size_t i{delay + 1024U}; i < 4096U; ++i)
+		{
+			const auto rear{left[i * 2U] - leftOriginal[i * 2U]};
+			assertEqual(left[(i * 2U) + 1U], -rear);
+			correlation += double(rear) * double(leftOriginal[(i - delay) * 2U]);
+		}
+		assertTrue(correlation > 0.0);
+	}
+
+	void testReverb()
+	{
+		moduleEffects_t settings{};
+		settings.reverbDepth = 100U;
+		settings.reverbRoomSize = 50U;
+		mixEffects_t effects{};
+		assertTrue(effects.configure(settings, sampleRate));
+
+		// A burst of tone followed by silence has to leave a tail that dies away
+		auto mix{makeTone(sampleRate, 500.0)};
+		std::fill(mix.begin() + 4096, mix.end(), 0);
+		effects.process(mix.data(), sampleRate);
+		const auto blockPower{[&](const size_t from)
+		{
+			double total{};
+			for (size_t i{from}; i < from + 4096U; ++i)
+				total += double(mix[i * 2U]) * double(mix[i * 2U]);
+			return total;
+		}};
+		const auto early{blockPower(4096U)};
+		const auto late{blockPower(sampleRate - 4096U)};
+		assertTrue(early > 0.0);
+		assertTrue(late < early / 100.0);
+		// The two channels' reverb is decorrelated by the stereo spread
+		bool differs{false};
+		for (size_t i{4096U}; i < 8192U; ++i)
+			differs = differs || mix[i * 2U] != mix[(i * 2U) + 1U];
+		assertTrue(differs);
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testInactive)
+		CXX_TEST(testClamping)
+		CXX_TEST(testSplitBlocks)
+		CXX_TEST(testBass)
+		CXX_TEST(testSurround)
+		CXX_TEST(testReverb)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testMixEffects>();
+}
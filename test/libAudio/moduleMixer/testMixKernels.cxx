@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <crunch++.h>
+#include "libAudio.hxx"
+#include "genericModule/genericModule.h"
+#include "cpuFeatures.hxx"
+#include "moduleMixer/mixFunctions.h"
+#include "moduleMixer/mixFunctionTables.h"
+#include "moduleMixer/mixFunctionsSIMD.hxx"
+#include "mixTestCommon.hxx"
+
+using libAudio::cpuFeatures;
+
+struct mixScenario_t
+{
+	int32_t increment;
+	uint32_t position;
+	uint32_t frames;
+	uint32_t length;
+	uint8_t leftVol;
+	uint8_t rightVol;
+	int16_t leftRamp;
+	int16_t rightRamp;
+};
+
+constexpr static uint32_t sampleFrames{4096U};
+
+// A resonant low-pass with unity gain at DC (0.125 + 1.75 - 0.875), so the filtered mix rings and overshoots
+constexpr static filterCoefficients_t filterSettings{0x00200000, 0x01C00000, -0x00E00000};
+
+// Covers unity, up and down sampling, reverse playback, block remainders and reads off both ends of the sample,
+// both into the guard frames and, for loops which end early, clamped to the loop end
+constexpr static std::array<mixScenario_t, 13> scenarios
+{{
+	{0x10000, 100U, 64U, sampleFrames, 64U, 64U, 0, 0},
+	{0x08000, 2000U, 67U, sampleFrames, 255U, 3U, -3, 2},
+	{0x1C3A7, 0U, 33U, sampleFrames, 17U, 200U, 5, -7},
+	{0x03F00, 4090U, 17U, sampleFrames, 128U, 128U, 1, 1},
+	{0x00001, 1U, 9U, sampleFrames, 90U, 10U, 0, 0},
+	{-0x0C000, 4000U, 41U, sampleFrames, 40U, 80U, -1, 1},
+	{-0x10000, 10U, 23U, sampleFrames, 255U, 255U, 0, 0},
+	{0x4A2F1, 3U, 15U, sampleFrames, 66U, 77U, 2, -2},
+	{0x0E000, 512U, 1U, sampleFrames, 12U, 34U, 1, 1},
+	{0x12345, 1234U, 511U, sampleFrames, 250U, 5U, -1, 3},
+	{0x10000, 980U, 64U, 1000U, 64U, 64U, 0, 0},
+	{0x03F00, 2040U, 37U, 2048U, 200U, 100U, 1, -1},
+	{-0x08000, 20U, 45U, 100U, 30U, 60U, 0, 0},
+}};
+
+class testMixKernels final : public testsuite
+{
+private:
+	std::vector<int16_t> monoBuffer{};
+	std::vector<int16_t> stereoBuffer{};
+	const uint8_t *monoPCM{};
+	const uint8_t *stereoPCM{};
+
+	void fillPCM()
+	{
+		// Stereo samples need twice the data, and use full scale values to exercise clipping
+		std::vector<int16_t> pcm(sampleFrames * 2U);
+		uint32_t seed{0x1234567U};
+		for (size_t i{}; i < pcm.size(); ++i)
+		{
+			seed = seed * 1103515245U + 12345U;
+			pcm[i] = static_cast<int16_t>(seed >> 8U);
+			// Make every so often a run of full scale alternating samples so the filters overshoot
+			if ((i & 0xFFU) < 16U)
+				pcm[i] = (i & 1U) ? INT16_MAX : INT16_MIN;
+		}
+		stereoPCM = padPCM(stereoBuffer, pcm, 2U);
+		pcm.resize(sampleFrames);
+		monoPCM = padPCM(monoBuffer, pcm, 1U);
+	}
+
+	void checkTable(const mixFunctionTable_t *const table)
+	{
+		assertNotNull(table);
+		fillPCM();
+		for (uint32_t flags{}; flags < table->size(); ++flags)
+		{
+			const auto scalarKernel{MixFunctionTable[flags]};
+			const auto vectorKernel{(*table)[flags]};
+			assertNotNull(scalarKernel);
+			assertNotNull(vectorKernel);
+			const bool isStereo{(flags & MIX_STEREO) != 0U};
+			testSample_t sample{sampleFrames, isStereo};
+			const auto *const sampleData{isStereo ? stereoPCM : monoPCM};
+
+			for (const auto &scenario : scenarios)
+			{
+				channel_t scalarChannel{};
+				scalarChannel.Sample = &sample;
+				scalarChannel.SampleData = sampleData;
+				scalarChannel.Length = scenario.length;
+				scalarChannel.Pos = scenario.position;
+				scalarChannel.PosLo = 0x1234U;
+				scalarChannel.increment.iValue = scenario.increment;
+				scalarChannel.leftVol = scenario.leftVol;
+				scalarChannel.rightVol = scenario.rightVol;
+				scalarChannel.LeftRamp = scenario.leftRamp;
+				scalarChannel.RightRamp = scenario.rightRamp;
+				// Start the filters part way through ringing, with each channel in a different state
+				scalarChannel.FilterCoefficients = filterSettings;
+				scalarChannel.FilterState = {{{1000 * 256, -500 * 256}, {-3000 * 256, 2500 * 256}}};
+				channel_t vectorChannel{scalarChannel};
+
+				// Start the buffers with something in them so we check the kernels accumulate
+				std::vector<int32_t> scalarBuffer(scenario.frames * 2U, 0x5A5A);
+				std::vector<int32_t> vectorBuffer{scalarBuffer};
+				scalarKernel(&scalarChannel, scalarBuffer.data(), scalarBuffer.data() + scalarBuffer.size());
+				vectorKernel(&vectorChannel, vectorBuffer.data(), vectorBuffer.data() + vectorBuffer.size());
+
+				for (size_t i{}; i < scalarBuffer.size(); ++i)
+					assertEqual(vectorBuffer[i], scalarBuffer[i]);
+				assertEqual(vectorChannel.Pos, scalarChannel.Pos);
+				assertEqual(vectorChannel.PosLo, scalarChannel.PosLo);
+				assertEqual(vectorChannel.leftVol, scalarChannel.leftVol);
+				assertEqual(vectorChannel.rightVol, scalarChannel.rightVol);
+				for (size_t i{}; i < scalarChannel.FilterState.size(); ++i)
+				{
+					assertEqual(vectorChannel.FilterState[i].y1, scalarChannel.FilterState[i].y1);
+					assertEqual(vectorChannel.FilterState[i].y2, scalarChannel.FilterState[i].y2);
+				}
+			}
+		}
+	}
+
+	void testSSE2()
+	{
+		if (!cpuFeatures().sse2)
+			skip("SSE2 not available");
+		checkTable(mixFunctionTableSSE2());
+	}
+
+	void testSSE41()
+	{
+		if (!cpuFeatures().sse41)
+			skip("SSE4.1 not available");
+		checkTable(mixFunctionTableSSE41());
+	}
+
+	void testAVX2()
+	{
+		if (!cpuFeatures().avx2)
+			skip("AVX2 not available");
+		checkTable(mixFunctionTableAVX2());
+	}
+
+	void testNEON()
+	{
+		if (!cpuFeatures().neon)
+			skip("NEON not available");
+		checkTable(mixFunctionTableNEON());
+	}
+
+	void testSelection()
+	{
+		const auto &table{selectMixFunctionTable()};
+		// Whichever table gets picked, it must fill every slot the scalar table does
+		for (size_t flags{}; flags < table.size(); ++flags)
+			assertTrue((table[flags] == nullptr) == (MixFunctionTable[flags] == nullptr));
+		assertTrue(&table == &selectMixFunctionTable());
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testSSE2)
+		CXX_TEST(testSSE41)
+		CXX_TEST(testAVX2)
+		CXX_TEST(testNEON)
+		CXX_TEST(testSelection)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testMixKernels>();
+}
@@ -0,0 +1,222 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <cstdlib>
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <crunch++.h>
+#include "cpuFeatures.hxx"
+#include "moduleMixer/mixOutput.hxx"
+#include "moduleMixer/mixFunctionsSIMD.hxx"
+
+using libAudio::cpuFeatures;
+
+// An odd length so every kernel has to deal with a remainder
+constexpr static size_t mixSamples{1027U};
+
+class testMixOutput final : public testsuite
+{
+private:
+	std::vector<int32_t> mix{};
+
+	void fillMix()
+	{
+		mix.resize(mixSamples);
+		uint32_t seed{0x89ABCDEFU};
+		for (auto &sample : mix)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			// Spread the samples to well beyond the clipping range on both sides
+			sample = static_cast<int32_t>(seed) >> 2;
+		}
+		mix[0] = INT32_MIN;
+		mix[1] = INT32_MAX;
+		mix[2] = mixSampleMin;
+		mix[3] = mixSampleMax;
+		mix[4] = 0;
+	}
+
+	void checkOutput(const mixOutputFunctions_t *const output)
+	{
+		assertNotNull(output);
+		fillMix();
+
+		std::vector<int16_t> scalarInt16(mixSamples);
+		std::vector<int16_t> vectorInt16(mixSamples);
+		scalarMixOutput.toInt16(scalarInt16.data(), mix.data(), mixSamples);
+		output->toInt16(vectorInt16.data(), mix.data(), mixSamples);
+		for (size_t i{}; i < mixSamples; ++i)
+			assertEqual(vectorInt16[i], scalarInt16[i]);
+
+		// Use a dither index that wraps part way through to check the counter handling
+		scalarMixOutput.toInt16Dithered(scalarInt16.data(), mix.data(), mixSamples, 0xFFFFFF00U);
+		output->toInt16Dithered(vectorInt16.data(), mix.data(), mixSamples, 0xFFFFFF00U);
+		for (size_t i{}; i < mixSamples; ++i)
+			assertEqual(vectorInt16[i], scalarInt16[i]);
+
+		std::vector<uint8_t> scalarInt24(mixSamples * 3U);
+		std::vector<uint8_t> vectorInt24(mixSamples * 3U);
+		scalarMixOutput.toInt24(scalarInt24.data(), mix.data(), mixSamples);
+		output->toInt24(vectorInt24.data(), mix.data(), mixSamples);
+		for (size_t i{}; i < scalarInt24.size(); ++i)
+			assertEqual(vectorInt24[i], scalarInt24[i]);
+
+		std::vector<float> scalarFloat(mixSamples);
+		std::vector<float> vectorFloat(mixSamples);
+		scalarMixOutput.toFloat(scalarFloat.data(), mix.data(), mixSamples);
+		output->toFloat(vectorFloat.data(), mix.data(), mixSamples);
+		// The conversion is a single rounding followed by a power of 2 scale, so this must be exact
+		for (size_t i{}; i < mixSamples; ++i)
+			assertEqual(vectorFloat[i], scalarFloat[i]);
+
+		// The downmix works in place on a buffer of stereo frames, so treat the mix as mixSamples / 2 frames
+		auto scalarMono{mix};
+		auto vectorMono{mix};
+		constexpr auto frames{mixSamples / 2U};
+		scalarMixOutput.monoFromStereo(scalarMono.data(), frames);
+		output->monoFromStereo(vectorMono.data(), frames);
+		for (size_t i{}; i < frames; ++i)
+			assertEqual(vectorMono[i], scalarMono[i]);
+	}
+
+	void testScalarFormats()
+	{
+		const std::array<int32_t, 6> mixed{{INT32_MAX, INT32_MIN, mixSampleMax, -0x08000000, 0x00012FFF, -1}};
+		std::array<int16_t, 6> int16{};
+		scalarMixOutput.toInt16(int16.data(), mixed.data(), mixed.size());
+		const std::array<int16_t, 6> expectedInt16{{32767, -32768, 32767, -32768, 18, -1}};
+		for (size_t i{}; i < int16.size(); ++i)
+			assertEqual(int16[i], expectedInt16[i]);
+
+		std::array<int32_t, 6> stereo{{1000, 3000, -7, -8, INT32_MAX, INT32_MAX}};
+		scalarMixOutput.monoFromStereo(stereo.data(), 3U);
+		assertEqual(stereo[0], 2000);
+		assertEqual(stereo[1], -8);
+		assertEqual(stereo[2], INT32_MAX - 1);
+
+		const std::array<int32_t, 4> samples{{mixSampleMax, -0x08000000, 0x00123450, -16}};
+		std::array<uint8_t, 12> int24{};
+		scalarMixOutput.toInt24(int24.data(), samples.data(), samples.size());
+		const std::array<uint8_t, 12> expectedInt24
+			{{0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80, 0x45, 0x23, 0x01, 0xFF, 0xFF, 0xFF}};
+		for (size_t i{}; i < int24.size(); ++i)
+			assertEqual(int24[i], expectedInt24[i]);
+
+		std::array<float, 4> floats{};
+		scalarMixOutput.toFloat(floats.data(), samples.data(), samples.size());
+		assertEqual(floats[1], -1.0F);
+		assertEqual(floats[3], -16.0F / 134217728.0F);
+	}
+
+	void testDitherShape()
+	{
+		// TPDF dither should stay within +/-1 output LSB and average out to nothing
+		int64_t total{};
+		int32_t minimum{0};
+		int32_t maximum{0};
+		for (uint32_t i{}; i < 65536U; ++i)
+		{
+			const auto dither{tpdfDither(i)};
+			total += dither;
+			minimum = std::min(minimum, dither);
+			maximum = std::max(maximum, dither);
+		}
+		assertTrue(minimum >= -0x0FFF);
+		assertTrue(maximum <= 0x0FFF);
+		assertTrue(minimum < -0x0C00);
+		assertTrue(maximum > 0x0C00);
+		assertTrue(total / 65536 > -64 && total / 65536 < 64);
+	}
+
+	void testNoiseShaping()
+	{
+		// A quiet, slow ramp per channel that sits between output steps most of the time
+		constexpr size_t frames{8192U};
+		std::vector<int32_t> input(frames * 2U);
+		for (size_t i{}; i < frames; ++i)
+		{
+			input[i * 2U] = 0x00012345 + static_cast<int32_t>(i * 3U);
+			input[(i * 2U) + 1U] = -0x00003A00 - static_cast<int32_t>(i * 5U);
+		}
+		std::vector<int16_t> output(input.size());
+		noiseShaper_t shaper{};
+		// Split the conversion up to check the error feedback carries across calls
+		mixToInt16NoiseShaped(output.data(), input.data(), 1001U * 2U, 0U, 2U, shaper);
+		mixToInt16NoiseShaped(output.data() + 2002U, input.data() + 2002U, input.size() - 2002U, 2002U, 2U, shaper);
+
+		std::vector<int16_t> whole(input.size());
+		noiseShaper_t wholeShaper{};
+		mixToInt16NoiseShaped(whole.data(), input.data(), input.size(), 0U, 2U, wholeShaper);
+		assertTrue(whole == output);
+
+		// The shaped error has nothing at DC, so its running total per channel stays within a few LSBs of 0
+		// rather than wandering off as a random walk. The error of any one sample is at most 4 times that of
+		// the dithered rounding, which is itself within 2 LSBs.
+		std::array<int64_t, 2> total{};
+		for (size_t i{}; i < input.size(); ++i)
+		{
+			const auto error{(int32_t{output[i]} * 4096) - input[i]};
+			assertTrue(std::abs(error) <= 8 * 4096);
+			total[i % 2U] += error;
+			assertTrue(std::abs(total[i % 2U]) <= 4 * 4096);
+		}
+
+		// Clipping must not throw the feedback off for what comes after
+		std::array<int32_t, 64> loud{};
+		loud.fill(INT32_MAX);
+		std::fill(loud.begin() + 32, loud.end(), 0x00010000);
+		std::array<int16_t, 64> clipped{};
+		noiseShaper_t clipShaper{};
+		mixToInt16NoiseShaped(clipped.data(), loud.data(), loud.size(), 0U, 1U, clipShaper);
+		assertEqual(clipped[0], 32767);
+		for (size_t i{40U}; i < clipped.size(); ++i)
+			assertTrue(clipped[i] >= 14 && clipped[i] <= 18);
+	}
+
+	void testSSE2()
+	{
+		if (!cpuFeatures().sse2)
+			skip("SSE2 not available");
+		checkOutput(mixOutputSSE2());
+	}
+
+	void testSSE41()
+	{
+		if (!cpuFeatures().sse41)
+			skip("SSE4.1 not available");
+		checkOutput(mixOutputSSE41());
+	}
+
+	void testAVX2()
+	{
+		if (!cpuFeatures().avx2)
+			skip("AVX2 not available");
+		checkOutput(mixOutputAVX2());
+	}
+
+	void testNEON()
+	{
+		if (!cpuFeatures().neon)
+			skip("NEON not available");
+		checkOutput(mixOutputNEON());
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testScalarFormats)
+		CXX_TEST(testDitherShape)
+		CXX_TEST(testNoiseShaping)
+		CXX_TEST(testSSE2)
+		CXX_TEST(testSSE41)
+		CXX_TEST(testAVX2)
+		CXX_TEST(testNEON)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testMixOutput>();
+}
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <crunch++.h>
+#include "libAudio.hxx"
+#include "genericModule/genericModule.h"
+#include "moduleMixer/mixFunctions.h"
+#include "moduleMixer/mixFunctionTables.h"
+#include "moduleMixer/mixFunctionsSIMD.hxx"
+#include "moduleMixer/mixThreads.hxx"
+#include "mixTestCommon.hxx"
+
+constexpr static uint32_t sampleFrames{4096U};
+constexpr static uint32_t voices{37U};
+constexpr static uint32_t mixFrames{mixBufferSize};
+
+class testMixThreads final : public testsuite
+{
+private:
+	std::vector<int16_t> buffer{};
+	const uint8_t *pcm{};
+	testSample_t sample{sampleFrames, false};
+
+	void fillPCM()
+	{
+		std::vector<int16_t> data(sampleFrames);
+		uint32_t seed{0x2468ACEU};
+		for (auto &value : data)
+		{
+			seed = seed * 1103515245U + 12345U;
+			value = static_cast<int16_t>(seed >> 8U);
+		}
+		pcm = padPCM(buffer, data, 1U);
+	}
+
+	// Builds a spread of voices at different pitches, volumes and positions, some of them ramping
+	std::vector<channel_t> makeVoices()
+	{
+		std::vector<channel_t> channels(voices);
+		for (uint32_t i{}; i < voices; ++i)
+		{
+			auto &channel{channels[i]};
+			channel.Sample = &sample;
+			channel.SampleData = pcm;
+			channel.Length = sampleFrames;
+			channel.Pos = (i * 97U) % 2048U;
+			channel.increment.iValue = 0x4000 + static_cast<int32_t>(i * 0x0731U);
+			channel.leftVol = (i * 29U) & 0xFFU;
+			channel.rightVol = 255U - channel.leftVol;
+			channel.LeftRamp = (i & 1U) ? 1 : 0;
+			channel.RightRamp = (i & 2U) ? -1 : 0;
+		}
+		return channels;
+	}
+
+	static void mixVoice(channel_t &channel, int32_t *const buffer)
+	{
+		const auto flags{MIX_LINEARSRC | (channel.LeftRamp || channel.RightRamp ? MIX_RAMP : 0U)};
+		selectMixFunctionTable()[flags](&channel, buffer, buffer + (mixFrames * 2U));
+	}
+
+	void testWorkers()
+	{
+		mixThreads_t threads{4U, mixFrames};
+		assertEqual(threads.workers(), 4U);
+		// Run lots of jobs back to back to make sure no worker ever misses or repeats one
+		for (size_t job{}; job < 256U; ++job)
+		{
+			std::array<std::atomic<uint32_t>, 4> runs{};
+			threads.run([&](const size_t worker, const size_t workers) noexcept
+			{
+				if (workers == 4U && worker < runs.size())
+					++runs[worker];
+			});
+			for (const auto &count : runs)
+				assertEqual(count.load(), 1U);
+		}
+	}
+
+	void testSingleWorker()
+	{
+		mixThreads_t threads{1U, mixFrames};
+		assertEqual(threads.workers(), 1U);
+		size_t calls{};
+		threads.run([&](const size_t worker, const size_t workers) noexcept
+		{
+			if (worker == 0U && workers == 1U)
+				++calls;
+		});
+		assertEqual(calls, 1U);
+	}
+
+	// Changing the mix block size must leave every accumulator able to hold a block, and never shrink one
+	void testReserve()
+	{
+		mixThreads_t threads{3U, 64U};
+		for (size_t worker{1U}; worker < threads.workers(); ++worker)
+			assertEqual(threads.accumulator(worker).buffer.size(), 128U);
+		assertTrue(threads.reserve(mixFrames));
+		for (size_t worker{1U}; worker < threads.workers(); ++worker)
+			assertEqual(threads.accumulator(worker).buffer.size(), mixFrames * 2U);
+		assertTrue(threads.reserve(16U));
+		for (size_t worker{1U}; worker < threads.workers(); ++worker)
+			assertEqual(threads.accumulator(worker).buffer.size(), mixFrames * 2U);
+	}
+
+	void testDeterministicMix()
+	{
+		fillPCM();
+		auto serialVoices{makeVoices()};
+		std::vector<int32_t> serialBuffer(mixFrames * 2U, 0x1234);
+		for (auto &channel : serialVoices)
+			mixVoice(channel, serialBuffer.data());
+
+		// Split the voices up the same way CreateStereoMix does and check the reduction matches exactly
+		for (size_t workers{2U}; workers <= 8U; ++workers)
+		{
+			auto threadedVoices{makeVoices()};
+			std::vector<int32_t> buffer(mixFrames * 2U, 0x1234);
+			mixThreads_t threads{workers, mixFrames};
+			threads.run([&](const size_t worker, const size_t totalWorkers) noexcept
+			{
+				int32_t *target{buffer.data()};
+				if (worker != 0U)
+				{
+					auto &accumulator{threads.accumulator(worker)};
+					std::fill(accumulator.buffer.begin(), accumulator.buffer.end(), 0);
+					target = accumulator.buffer.data();
+				}
+				for (size_t i{worker}; i < threadedVoices.size(); i += totalWorkers)
+					mixVoice(threadedVoices[i], target);
+			});
+			for (size_t worker{1U}; worker < threads.workers(); ++worker)
+			{
+				const auto &accumulator{threads.accumulator(worker)};
+				for (size_t i{}; i < buffer.size(); ++i)
+					buffer[i] += accumulator.buffer[i];
+			}
+
+			for (size_t i{}; i < buffer.size(); ++i)
+				assertEqual(buffer[i], serialBuffer[i]);
+			for (size_t i{}; i < voices; ++i)
+			{
+				assertEqual(threadedVoices[i].Pos, serialVoices[i].Pos);
+				assertEqual(threadedVoices[i].PosLo, serialVoices[i].PosLo);
+			}
+		}
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testWorkers)
+		CXX_TEST(testSingleWorker)
+		CXX_TEST(testReserve)
+		CXX_TEST(testDeterministicMix)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testMixThreads>();
+}
@@ -0,0 +1,495 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+#ifndef _WINDOWS
+#include <unistd.h>
+#else
+#include <io.h>
+#endif
+#include <substrate/fd>
+#include <crunch++.h>
+#include "libAudio.h"
+#include "libAudio.hxx"
+
+using substrate::fd_t;
+
+// One cell of a MOD pattern, with the Amiga period of the note to play
+struct modCell_t final
+{
+	uint8_t sample{};
+	uint16_t period{};
+	uint8_t effect{};
+	uint8_t param{};
+};
+
+constexpr static size_t modChannels{4U};
+constexpr static size_t modRows{64U};
+using modPattern_t = std::array<std::array<modCell_t, modChannels>, modRows>;
+
+constexpr static const char *modFileName{"modulePlayback.mod"};
+constexpr static const char *itFileName{"modulePlayback.it"};
+// At the default speed of 6 and tempo of 125, every tick is 882 frames long at 44.1kHz
+constexpr static size_t tickFrames{882U};
+constexpr static size_t rowFrames{tickFrames * 6U};
+constexpr static size_t patternFrames{rowFrames * modRows};
+
+class testModulePlayback final : public testsuite
+{
+private:
+	// Writes out a 4 channel M.K. module playing each of the patterns given once, in order
+	static bool writeMOD(const std::vector<modPattern_t> &patterns, const std::vector<std::vector<int8_t>> &samples)
+	{
+		std::vector<uint8_t> data(20U + (31U * 30U) + 2U + 128U + 4U);
+		for (size_t i{}; i < samples.size(); ++i)
+		{
+			auto *const header{data.data() + 20U + (i * 30U)};
+			const auto length{samples[i].size() / 2U};
+			header[22] = uint8_t(length >> 8U);
+			header[23] = uint8_t(length);
+			// Full volume, with a loop length of 1 word meaning no loop
+			header[25] = 64U;
+			header[29] = 1U;
+		}
+		auto *const song{data.data() + 20U + (31U * 30U)};
+		song[0] = uint8_t(patterns.size());
+		song[1] = 127U;
+		for (size_t i{}; i < patterns.size(); ++i)
+			song[2U + i] = uint8_t(i);
+		std::memcpy(song + 130U, "M.K.", 4U);
+
+		for (const auto &pattern : patterns)
+		{
+			for (const auto &row : pattern)
+			{
+				for (const auto &cell : row)
+				{
+					data.push_back(uint8_t((cell.sample & 0xF0U) | (cell.period >> 8U)));
+					data.push_back(uint8_t(cell.period));
+					data.push_back(uint8_t(((cell.sample & 0x0FU) << 4U) | cell.effect));
+					data.push_back(cell.param);
+				}
+			}
+		}
+		for (const auto &sample : samples)
+			data.insert(data.end(), sample.begin(), sample.end());
+
+		fd_t file{modFileName, O_WRONLY | O_CREAT | O_TRUNC, substrate::normalMode};
+		return file.valid() && file.write(data.data(), data.size());
+	}
+
+	// A few hundred milliseconds of a sawtooth, which ends long before the next note on the channel does
+	static std::vector<int8_t> sawtooth(const size_t length, const uint8_t step)
+	{
+		std::vector<int8_t> sample(length);
+		for (size_t i{}; i < length; ++i)
+			sample[i] = int8_t(uint8_t(i * step));
+		return sample;
+	}
+
+	// A short song of 3 patterns where every note has finished playing by the time the next starts
+	static bool writeSong()
+	{
+		std::vector<modPattern_t> patterns(3U);
+		for (size_t pattern{}; pattern < patterns.size(); ++pattern)
+		{
+			for (size_t row{}; row < modRows; row += 32U)
+			{
+				for (size_t channel{}; channel < modChannels; ++channel)
+				{
+					const auto period{uint16_t(428U - (pattern * 40U) - (channel * 20U))};
+					patterns[pattern][row][channel] = {uint8_t(1U + (channel % 2U)), period, 0xCU,
+						uint8_t(64U - (channel * 12U))};
+				}
+			}
+		}
+		return writeMOD(patterns, {sawtooth(2000U, 3U), sawtooth(1600U, 5U)});
+	}
+
+	// Writes out a single channel IT module playing a looped sample on its one instrument, which leaves each note
+	// playing in the background when the next starts. Each note is given as the row it starts on and its volume.
+	// The one pattern gets played as many times over as there are orders asked for.
+	static bool writeIT(const std::vector<std::pair<uint8_t, uint8_t>> &notes, const uint8_t orders = 1U)
+	{
+		const auto orderCount{uint16_t(orders + 1U)};
+		const size_t headerLength{0xC0U + orderCount + (3U * 4U)};
+		constexpr size_t instrumentLength{554U};
+		constexpr size_t sampleLength{80U};
+		constexpr uint16_t rows{32U};
+		const auto pcm{sawtooth(1024U, 7U)};
+
+		// The pattern starts with its 8 byte header, filled in once the packed rows are done
+		std::vector<uint8_t> pattern(8U);
+		uint16_t row{};
+		for (const auto &[noteRow, volume] : notes)
+		{
+			for (; row < noteRow; ++row)
+				pattern.push_back(0U);
+			// Channel 1 gets a C-5 on instrument 1 at the note's volume, then the row ends
+			pattern.insert(pattern.end(), {0x81U, 0x07U, 60U, 1U, volume, 0U});
+			++row;
+		}
+		for (; row < rows; ++row)
+			pattern.push_back(0U);
+		const auto packedLength{uint16_t(pattern.size() - 8U)};
+		pattern[0] = uint8_t(packedLength);
+		pattern[1] = uint8_t(packedLength >> 8U);
+		pattern[2] = uint8_t(rows);
+
+		const auto put16{[](uint8_t *const dest, const uint16_t value)
+			{ dest[0] = uint8_t(value); dest[1] = uint8_t(value >> 8U); }};
+		const auto put32{[&](uint8_t *const dest, const uint32_t value)
+			{ put16(dest, uint16_t(value)); put16(dest + 2U, uint16_t(value >> 16U)); }};
+		const auto instrumentOffset{uint32_t(headerLength)};
+		const auto sampleOffset{uint32_t(instrumentOffset + instrumentLength)};
+		const auto patternOffset{uint32_t(sampleOffset + sampleLength)};
+		const auto pcmOffset{uint32_t(patternOffset + pattern.size())};
+
+		std::vector<uint8_t> data(patternOffset);
+		auto *const header{data.data()};
+		std::memcpy(header, "IMPM", 4U);
+		put16(header + 0x20U, orderCount);
+		put16(header + 0x22U, 1U);
+		put16(header + 0x24U, 1U);
+		put16(header + 0x26U, 1U);
+		put16(header + 0x28U, 0x0214U);
+		put16(header + 0x2AU, 0x0214U);
+		// Stereo, with instruments
+		put16(header + 0x2CU, 0x0005U);
+		header[0x30U] = 128U;
+		header[0x31U] = 48U;
+		header[0x32U] = 6U;
+		header[0x33U] = 125U;
+		header[0x34U] = 128U;
+		// Only the first channel is enabled, and the order list ends after the pattern's been played enough times
+		std::memset(header + 0x40U, 160U, 64U);
+		header[0x40U] = 32U;
+		std::memset(header + 0x80U, 64U, 64U);
+		header[0xC0U + orders] = 255U;
+		put32(header + 0xC0U + orderCount, instrumentOffset);
+		put32(header + 0xC4U + orderCount, sampleOffset);
+		put32(header + 0xC8U + orderCount, patternOffset);
+
+		// NNA continue, full volume and no default panning, with every note mapped to itself on sample 1
+		auto *const instrument{data.data() + instrumentOffset};
+		std::memcpy(instrument, "IMPI", 4U);
+		instrument[0x11U] = 1U;
+		instrument[0x18U] = 128U;
+		instrument[0x19U] = 128U;
+		for (uint8_t note{}; note < 120U; ++note)
+		{
+			instrument[0x40U + (note * 2U)] = note;
+			instrument[0x41U + (note * 2U)] = 1U;
+		}
+
+		// An 8-bit signed sample looped from end to end, so the notes never stop by themselves
+		auto *const sample{data.data() + sampleOffset};
+		std::memcpy(sample, "IMPS", 4U);
+		sample[0x11U] = 64U;
+		sample[0x12U] = 0x11U;
+		sample[0x13U] = 64U;
+		sample[0x2EU] = 0x01U;
+		put32(sample + 0x30U, uint32_t(pcm.size()));
+		put32(sample + 0x38U, uint32_t(pcm.size()));
+		put32(sample + 0x3CU, 8363U);
+		put32(sample + 0x48U, pcmOffset);
+
+		data.insert(data.end(), pattern.begin(), pattern.end());
+		data.insert(data.end(), pcm.begin(), pcm.end());
+		fd_t file{itFileName, O_WRONLY | O_CREAT | O_TRUNC, substrate::normalMode};
+		return file.valid() && file.write(data.data(), data.size());
+	}
+
+	static moduleFile_t *openSong()
+	{
+		// Have the mixer set up, but leave the playback to us
+		ExternalPlayback = 1U;
+		return static_cast<moduleFile_t *>(static_cast<audioFile_t *>(modOpenR(modFileName)));
+	}
+
+	static moduleFile_t *openIT()
+	{
+		ExternalPlayback = 1U;
+		return static_cast<moduleFile_t *>(static_cast<audioFile_t *>(itOpenR(itFileName)));
+	}
+
+	// Renders everything left of the song as stereo in the given sample type, 16-bit unless asked otherwise
+	template<typename sample_t = int16_t> static std::vector<sample_t> render(moduleFile_t &file)
+	{
+		std::vector<sample_t> result{};
+		std::array<sample_t, 2048U> buffer{};
+		while (true)
+		{
+			const auto bytes{file.fillBuffer(buffer.data(), sizeof(buffer))};
+			if (bytes <= 0)
+				break;
+			result.insert(result.end(), buffer.begin(), buffer.begin() + (bytes / int64_t(sizeof(sample_t))));
+		}
+		return result;
+	}
+
+	// Renders up to the given number of frames of each stem as stereo, appending them to what's already there
+	template<typename sample_t> static void renderStems(moduleFile_t &file, std::vector<std::vector<sample_t>> &stems,
+		const size_t frames = SIZE_MAX)
+	{
+		stems.resize(file.stems());
+		std::vector<std::array<sample_t, 2048U>> buffers(stems.size());
+		std::vector<void *> pointers{};
+		for (auto &buffer : buffers)
+			pointers.push_back(buffer.data());
+		for (size_t frame{}; frame < frames;)
+		{
+			const auto length{uint32_t(std::min<size_t>(frames - frame, 1024U) * 2U * sizeof(sample_t))};
+			const auto bytes{file.fillStems(pointers.data(), length)};
+			if (bytes <= 0)
+				break;
+			const auto samples{size_t(bytes) / sizeof(sample_t)};
+			for (size_t stem{}; stem < stems.size(); ++stem)
+				stems[stem].insert(stems[stem].end(), buffers[stem].begin(), buffers[stem].begin() + int64_t(samples));
+			frame += samples / 2U;
+		}
+	}
+
+	static bool silent(const std::vector<int16_t>::const_iterator begin, const std::vector<int16_t>::const_iterator end)
+		{ return std::all_of(begin, end, [](const int16_t sample) { return sample == 0; }); }
+
+	// Mixing stops part way through the song's last row, so only check up to the start of it
+	void checkSeek(const std::vector<int16_t> &song, moduleFile_t &file, const size_t frame)
+	{
+		const auto tail{render(file)};
+		const auto end{((patternFrames * 3U) - rowFrames) * 2U};
+		assertTrue(tail.size() >= end - (frame * 2U));
+		assertTrue(std::equal(tail.begin(), tail.begin() + int64_t(end - (frame * 2U)), song.begin() + int64_t(frame * 2U)));
+	}
+
+	void testSeek()
+	{
+		assertTrue(writeSong());
+		auto *const file{openSong()};
+		assertNotNull(file);
+		const auto song{render(*file)};
+		assertTrue(song.size() >= ((patternFrames * 3U) - rowFrames) * 2U);
+
+		// Seeking to the start of a row must play on exactly as if the song had been played through to it
+		assertTrue(file->seek(1U, 0U));
+		checkSeek(song, *file, patternFrames);
+		assertTrue(file->seek(2U, 16U));
+		checkSeek(song, *file, (patternFrames * 2U) + (rowFrames * 16U));
+		// As must seeking to a time part way through a tick, including going back to an earlier point
+		assertTrue(file->seek(10000U));
+		checkSeek(song, *file, 441000U);
+		assertTrue(file->seek(1010U));
+		checkSeek(song, *file, 44541U);
+		// Notes still playing at the point seeked to must carry on from where they had got to
+		assertTrue(file->seek(7700U));
+		checkSeek(song, *file, 339570U);
+		// Rows and times the song never gets to must be turned down
+		assertFalse(file->seek(3U, 0U));
+		assertFalse(file->seek(60000U));
+		audioCloseFile(file);
+	}
+
+	void testSeekBackgroundVoices()
+	{
+		// Every note carries on in the background once the next starts, so going into the second order there are
+		// voices playing on channels beyond the pattern's one, and seeking there must bring those back too
+		assertTrue(writeIT({{0U, 64U}, {8U, 48U}, {16U, 32U}, {24U, 16U}}, 2U));
+		auto *const file{openIT()};
+		assertNotNull(file);
+		const auto song{render(*file)};
+		constexpr auto orderFrames{rowFrames * 32U};
+		const auto end{((orderFrames * 2U) - rowFrames) * 2U};
+		assertTrue(song.size() >= end);
+
+		assertTrue(file->seek(1U, 0U));
+		const auto tail{render(*file)};
+		assertTrue(tail.size() >= end - (orderFrames * 2U));
+		assertTrue(std::equal(tail.begin(), tail.begin() + int64_t(end - (orderFrames * 2U)),
+			song.begin() + int64_t(orderFrames * 2U)));
+		audioCloseFile(file);
+	}
+
+	void testVoiceLimit()
+	{
+		assertTrue(writeSong());
+		auto *const reference{openSong()};
+		assertNotNull(reference);
+		assertEqual(reference->stems(), 4U);
+		std::vector<std::vector<int16_t>> expected{};
+		renderStems(*reference, expected);
+		audioCloseFile(reference);
+
+		auto *const file{openSong()};
+		assertNotNull(file);
+		assertTrue(file->voiceLimit(2U));
+		std::vector<std::vector<int16_t>> stems{};
+		renderStems(*file, stems);
+		assertEqual(stems.size(), 4U);
+		// The two quietest channels lose out every time all four start a note, and being taken on the very tick
+		// their notes start, never get heard. The other two play on as if there were no limit at all.
+		assertTrue(stems[0] == expected[0]);
+		assertTrue(stems[1] == expected[1]);
+		assertFalse(silent(expected[2].begin(), expected[2].end()));
+		assertTrue(silent(stems[2].begin(), stems[2].end()));
+		assertTrue(silent(stems[3].begin(), stems[3].end()));
+		assertEqual(file->stolenVoices(), 12U);
+		assertEqual(file->culledVoices(), 0U);
+		audioCloseFile(file);
+	}
+
+	void testStolenVoiceFade()
+	{
+		assertTrue(writeSong());
+		auto *const reference{openSong()};
+		assertNotNull(reference);
+		std::vector<std::vector<int16_t>> expected{};
+		renderStems(*reference, expected);
+		audioCloseFile(reference);
+
+		// Bring the limit in two ticks into the song, while every channel's first note is still sounding
+		auto *const file{openSong()};
+		assertNotNull(file);
+		std::vector<std::vector<int16_t>> stems{};
+		renderStems(*file, stems, tickFrames * 2U);
+		assertTrue(file->voiceLimit(2U));
+		renderStems(*file, stems);
+		assertEqual(stems.size(), 4U);
+		// Where mixing stops at the end of the song depends on how it was asked for, so this is only roughly as long
+		assertTrue(stems[3].size() > (tickFrames * 2U * 2U) + (255U * 2U));
+		assertTrue(stems[3].size() <= expected[3].size());
+
+		const auto limited{stems[3].begin() + int64_t(tickFrames * 2U * 2U)};
+		const auto fadeEnd{limited + (255 * 2)};
+		assertTrue(std::equal(stems[3].begin(), limited, expected[3].begin()));
+		assertFalse(silent(expected[3].begin() + (limited - stems[3].begin()), expected[3].end()));
+		// Rather than stopping dead, the voice must die away, never getting any louder than it would have been
+		assertFalse(silent(limited, limited + 16));
+		for (auto sample{limited}; sample != fadeEnd; ++sample)
+		{
+			const auto original{expected[3][size_t(sample - stems[3].begin())]};
+			assertTrue(std::abs(*sample) <= std::abs(original));
+			assertTrue((*sample >= 0) == (original >= 0) || *sample == 0);
+		}
+		// And then be gone for good
+		assertTrue(silent(fadeEnd, stems[3].end()));
+		assertEqual(file->stolenVoices(), 12U);
+		audioCloseFile(file);
+	}
+
+	void testCulledVoices()
+	{
+		// Each note gets left to play on in the background by the next, with quieter notes following louder ones
+		assertTrue(writeIT({{0U, 64U}, {8U, 16U}, {16U, 64U}, {24U, 16U}}));
+		auto *const unlimited{openIT()};
+		assertNotNull(unlimited);
+		const auto song{render(*unlimited)};
+		assertEqual(unlimited->culledVoices(), 0U);
+		assertEqual(unlimited->stolenVoices(), 0U);
+		audioCloseFile(unlimited);
+
+		// With the threshold above anything a voice can reach, every background voice gets culled on its first tick
+		auto *const culled{openIT()};
+		assertNotNull(culled);
+		assertTrue(culled->audibilityThreshold(255U));
+		const auto culledSong{render(*culled)};
+		assertEqual(culled->culledVoices(), 3U);
+		assertEqual(culled->stolenVoices(), 0U);
+		audioCloseFile(culled);
+		assertTrue(culledSong.size() == song.size());
+		assertFalse(culledSong == song);
+
+		// Limiting the song to one voice must take the background voices before the channel's own, even when
+		// they are the louder ones, which leaves exactly what culling them does
+		auto *const limited{openIT()};
+		assertNotNull(limited);
+		assertTrue(limited->voiceLimit(1U));
+		const auto limitedSong{render(*limited)};
+		assertEqual(limited->stolenVoices(), 3U);
+		assertEqual(limited->culledVoices(), 0U);
+		audioCloseFile(limited);
+		assertTrue(limitedSong == culledSong);
+	}
+
+	void testStemsSumToMix()
+	{
+		assertTrue(writeSong());
+		auto *const file{openSong()};
+		assertNotNull(file);
+		assertTrue(file->outputFormat(moduleOutput_t::float32));
+		const auto song{render<float>(*file)};
+		audioCloseFile(file);
+
+		auto *const stemFile{openSong()};
+		assertNotNull(stemFile);
+		assertTrue(stemFile->outputFormat(moduleOutput_t::float32));
+		std::vector<std::vector<float>> stems{};
+		renderStems(*stemFile, stems);
+		audioCloseFile(stemFile);
+		assertEqual(stems.size(), 4U);
+
+		// With no dither, the stems must add back up to the mix. Float output keeps every bit of the mix, so the
+		// only difference allowed is the rounding of the sum and of each stem's own DC offset fix.
+		const auto end{((patternFrames * 3U) - rowFrames) * 2U};
+		assertTrue(song.size() >= end);
+		for (const auto &stem : stems)
+			assertTrue(stem.size() >= end);
+		for (size_t sample{}; sample < end; ++sample)
+		{
+			float sum{};
+			for (const auto &stem : stems)
+				sum += stem[sample];
+			assertTrue(std::fabs(sum - song[sample]) < 1e-5F);
+		}
+	}
+
+	void testStemDither()
+	{
+		assertTrue(writeSong());
+		auto *const file{openSong()};
+		assertNotNull(file);
+		assertTrue(file->outputFormat(moduleOutput_t::int16, true));
+		assertTrue(file->voiceLimit(2U));
+		std::vector<std::vector<int16_t>> stems{};
+		renderStems(*file, stems);
+		audioCloseFile(file);
+		assertEqual(stems.size(), 4U);
+
+		// The two channels that never get a voice are nothing but dither, which must differ from stem to stem
+		// or it'd add up coherently when the stems are mixed back together
+		assertFalse(silent(stems[2].begin(), stems[2].end()));
+		assertFalse(silent(stems[3].begin(), stems[3].end()));
+		assertFalse(stems[2] == stems[3]);
+		assertTrue(std::all_of(stems[2].begin(), stems[2].end(), [](const int16_t sample) { return std::abs(sample) <= 1; }));
+		assertTrue(std::all_of(stems[3].begin(), stems[3].end(), [](const int16_t sample) { return std::abs(sample) <= 1; }));
+	}
+
+public:
+	~testModulePlayback()
+	{
+		unlink(modFileName);
+		unlink(itFileName);
+	}
+
+	void registerTests() final
+	{
+		CXX_TEST(testSeek)
+		CXX_TEST(testSeekBackgroundVoices)
+		CXX_TEST(testVoiceLimit)
+		CXX_TEST(testStolenVoiceFade)
+		CXX_TEST(testCulledVoices)
+		CXX_TEST(testStemsSumToMix)
+		CXX_TEST(testStemDither)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testModulePlayback>();
+}
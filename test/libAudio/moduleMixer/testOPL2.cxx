@@ -0,0 +1,162 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <crunch++.h>
+#include "moduleMixer/opl2.hxx"
+
+constexpr static uint32_t sampleRate{44100U};
+
+class testOPL2 final : public testsuite
+{
+private:
+	// A plain sine wave on the carrier that attacks instantly, holds while the key is down and releases quickly,
+	// with the modulator never getting past silence as its attack rate is 0
+	static opl2Patch_t sinePatch() noexcept
+	{
+		opl2Patch_t patch{};
+		patch.operators[1].characteristic = 0x21U;
+		patch.operators[1].attackDecay = 0xf0U;
+		patch.operators[1].sustainRelease = 0x0fU;
+		return patch;
+	}
+
+	static int32_t peak(const std::vector<int32_t> &samples)
+	{
+		int32_t result{};
+		for (const auto sample : samples)
+			result = std::max(result, std::abs(sample));
+		return result;
+	}
+
+	void testWaveforms()
+	{
+		// The loudest the sine gets, at the top of each half of the wave
+		assertEqual(opl2Waveform(0U, 0x0ffU, 0U), 4084);
+		assertEqual(opl2Waveform(0U, 0x2ffU, 0U), -4085);
+		// 32 envelope steps are 6dB, halving the level, and the quietest the envelope goes is silence
+		assertEqual(opl2Waveform(0U, 0x0ffU, 32U), 2042);
+		assertEqual(opl2Waveform(0U, 0x0ffU, opl2EnvelopeMax), 0);
+		// The half sine is silent for the negative half, and the absolute sine folds it positive
+		assertEqual(opl2Waveform(1U, 0x2ffU, 0U), 0);
+		assertEqual(opl2Waveform(2U, 0x2ffU, 0U), 4084);
+		// The quarter sine is silent for the falling quarters
+		assertEqual(opl2Waveform(3U, 0x0ffU, 0U), 4084);
+		assertEqual(opl2Waveform(3U, 0x100U, 0U), 0);
+		assertEqual(opl2Waveform(3U, 0x3ffU, 0U), 0);
+	}
+
+	void testFrequency()
+	{
+		opl2Voice_t voice{};
+		voice.frequency(440000U, sampleRate);
+		assertEqual(voice.frequencyNumber(), 580U);
+		assertEqual(voice.octave(), 4U);
+		// Anything too high for the chip to play sticks at the top of its range
+		voice.frequency(10000000U, sampleRate);
+		assertEqual(voice.frequencyNumber(), 1023U);
+		assertEqual(voice.octave(), 7U);
+	}
+
+	void testPitch()
+	{
+		opl2Voice_t voice{};
+		voice.load(sinePatch());
+		voice.frequency(440000U, sampleRate);
+		assertFalse(voice.playing());
+		voice.keyOn();
+		assertTrue(voice.playing());
+		std::vector<int32_t> samples(sampleRate);
+		voice.render(samples.data(), samples.size());
+		size_t crossings{};
+		for (size_t i{1U}; i < samples.size(); ++i)
+			crossings += samples[i - 1U] < 0 && samples[i] >= 0 ? 1U : 0U;
+		assertTrue(crossings >= 438U && crossings <= 442U);
+		assertTrue(peak(samples) >= 4084 * 4);
+	}
+
+	void testRelease()
+	{
+		opl2Voice_t voice{};
+		voice.load(sinePatch());
+		voice.frequency(440000U, sampleRate);
+		voice.keyOn();
+		std::vector<int32_t> samples(4096U);
+		voice.render(samples.data(), samples.size());
+		// Holding the key keeps the sustaining voice going..
+		assertTrue(voice.playing());
+		voice.keyOff();
+		// ..and letting go of it lets the voice die away until it's done
+		voice.render(samples.data(), samples.size());
+		assertFalse(voice.playing());
+		voice.render(samples.data(), samples.size());
+		assertEqual(peak(samples), 0);
+
+		voice.keyOn();
+		assertTrue(voice.playing());
+		voice.cut();
+		assertFalse(voice.playing());
+	}
+
+	// With feedback, vibrato and tremolo all running, however the voice is split up into calls has to come out the same
+	void testSplitRender()
+	{
+		opl2Patch_t patch{};
+		patch.operators[0] = {0xe2U, 0x10U, 0x84U, 0x44U, 0x01U};
+		patch.operators[1] = {0xe1U, 0x00U, 0xa3U, 0x35U, 0x02U};
+		patch.feedbackConnection = 0x0aU;
+		std::vector<int32_t> whole(20000U);
+		std::vector<int32_t> split(20000U);
+
+		opl2Voice_t wholeVoice{};
+		wholeVoice.load(patch);
+		wholeVoice.frequency(261625U, sampleRate);
+		wholeVoice.keyOn();
+		wholeVoice.render(whole.data(), whole.size());
+		opl2Voice_t splitVoice{};
+		splitVoice.load(patch);
+		splitVoice.frequency(261625U, sampleRate);
+		splitVoice.keyOn();
+		for (size_t offset{}; offset < split.size(); offset += 333U)
+			splitVoice.render(split.data() + offset, std::min<size_t>(333U, split.size() - offset));
+		assertTrue(whole == split);
+		assertTrue(peak(whole) > 0);
+	}
+
+	void testVolume()
+	{
+		std::vector<int32_t> loud(4096U);
+		std::vector<int32_t> quiet(4096U);
+		for (auto &[volume, samples] : std::array<std::pair<uint8_t, std::vector<int32_t> *>, 2>{{{63U, &loud}, {31U, &quiet}}})
+		{
+			opl2Voice_t voice{};
+			voice.load(sinePatch());
+			voice.level(volume);
+			voice.frequency(440000U, sampleRate);
+			voice.keyOn();
+			voice.render(samples->data(), samples->size());
+		}
+		// Half the tracker volume raises the carrier's total level by 32 steps, which is 24dB
+		assertTrue(peak(quiet) * 15 < peak(loud));
+		assertTrue(peak(quiet) * 17 > peak(loud));
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testWaveforms)
+		CXX_TEST(testFrequency)
+		CXX_TEST(testPitch)
+		CXX_TEST(testRelease)
+		CXX_TEST(testSplitRender)
+		CXX_TEST(testVolume)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testOPL2>();
+}
@@ -0,0 +1,210 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <cmath>
+#include <array>
+#include <vector>
+#include <crunch++.h>
+#include "libAudio.hxx"
+#include "genericModule/genericModule.h"
+#include "moduleMixer/resonantFilter.hxx"
+#include "moduleMixer/mixFunctions.h"
+#include "moduleMixer/mixFunctionTables.h"
+#include "mixTestCommon.hxx"
+
+constexpr static uint32_t sampleRate{44100U};
+constexpr static uint32_t sampleFrames{4096U};
+
+class testResonantFilter final : public testsuite
+{
+private:
+	static std::vector<int32_t> makeSignal(const size_t samples)
+	{
+		std::vector<int32_t> signal(samples);
+		uint32_t seed{0x600DF00DU};
+		for (auto &sample : signal)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			sample = static_cast<int16_t>(seed >> 16U);
+		}
+		return signal;
+	}
+
+	void testFrequency()
+	{
+		// 110Hz * 2^(0.25 + cutoff / 24) with the envelope all the way up, as Impulse Tracker computes it
+		assertEqual(filterFrequency(127U, filterModifierNone, sampleRate), 5123U);
+		assertEqual(filterFrequency(64U, filterModifierNone, sampleRate), 830U);
+		assertEqual(filterFrequency(0U, filterModifierNone, sampleRate), 130U);
+		// The envelope at its centre halves the cutoff, and at the bottom removes it entirely
+		assertEqual(filterFrequency(127U, 0, sampleRate), 818U);
+		assertEqual(filterFrequency(127U, -256, sampleRate), 130U);
+		// Never above the Nyquist frequency
+		assertEqual(filterFrequency(127U, filterModifierNone, 8000U), 4000U);
+	}
+
+	void testCoefficients()
+	{
+		for (uint32_t cutoff{}; cutoff <= filterCutoffMax; ++cutoff)
+		{
+			for (uint32_t resonance{}; resonance <= 127U; resonance += 9U)
+			{
+				const filterSettings_t settings{uint8_t(cutoff), uint8_t(resonance), filterModifierNone, sampleRate};
+				const auto coefficients{filterCoefficients(settings)};
+				// A low-pass filter has to pass DC through untouched
+				const auto gain{int64_t{coefficients.a0} + coefficients.b0 + coefficients.b1};
+				assertTrue(std::abs(gain - (int64_t{1} << filterPrecision)) <= 2);
+				assertTrue(coefficients.a0 > 0);
+				assertTrue(coefficients.b1 < 0);
+			}
+		}
+
+		filterSettings_t settings{};
+		assertFalse(settings.active());
+		settings.resonance = 1U;
+		assertTrue(settings.active());
+		settings = {};
+		settings.modifier = 0;
+		assertTrue(settings.active());
+	}
+
+	// Check the fixed point filter tracks the same filter run in double precision
+	void testReference()
+	{
+		constexpr auto pi{3.14159265358979323846};
+		for (const auto &[cutoff, resonance] : std::array<std::pair<uint8_t, uint8_t>, 4>
+			{{{100U, 0U}, {64U, 64U}, {30U, 120U}, {127U, 127U}}})
+		{
+			const filterSettings_t settings{cutoff, resonance, filterModifierNone, sampleRate};
+			const auto frequency{double(filterFrequency(cutoff, filterModifierNone, sampleRate))};
+			const auto damping{std::pow(10.0, -double(resonance) * ((24.0 / 128.0) / 20.0))};
+			const auto ratio{double(sampleRate) / (2.0 * pi * frequency)};
+			const auto d{(damping * ratio) + damping - 1.0};
+			const auto e{ratio * ratio};
+
+			// Keep the signal quiet enough that the resonance doesn't hit the history clipping
+			auto signal{makeSignal(2048U)};
+			for (auto &sample : signal)
+				sample /= 16;
+			const auto input{signal};
+			std::array<filterState_t, 1> state{};
+			filterBlock(signal.data(), signal.size(), filterCoefficients(settings), state);
+
+			double y1{};
+			double y2{};
+			for (size_t i{}; i < input.size(); ++i)
+			{
+				const auto y{(double(input[i]) + ((d + e + e) * y1) - (e * y2)) / (1.0 + d + e)};
+				y2 = y1;
+				y1 = y;
+				assertTrue(std::abs(double(signal[i]) - y) <= 2.0);
+			}
+		}
+	}
+
+	// A stereo block has to filter each channel exactly as a mono block would, however the frames are split up
+	void testStereoBlocks()
+	{
+		const filterSettings_t settings{40U, 90U, 100, sampleRate};
+		const auto coefficients{filterCoefficients(settings)};
+		const auto left{makeSignal(1000U)};
+		auto right{left};
+		for (auto &sample : right)
+			sample = -sample / 3;
+
+		auto monoLeft{left};
+		auto monoRight{right};
+		std::array<filterState_t, 1> leftState{};
+		std::array<filterState_t, 1> rightState{};
+		filterBlock(monoLeft.data(), monoLeft.size(), coefficients, leftState);
+		filterBlock(monoRight.data(), monoRight.size(), coefficients, rightState);
+
+		std::vector<int32_t> frames(left.size() * 2U);
+		for (size_t i{}; i < left.size(); ++i)
+		{
+			frames[i * 2U] = left[i];
+			frames[(i * 2U) + 1U] = right[i];
+		}
+		std::array<filterState_t, 2> state{};
+		for (size_t offset{}; offset < left.size(); offset += 333U)
+		{
+			const auto count{std::min<size_t>(333U, left.size() - offset)};
+			filterBlock(frames.data() + (offset * 2U), count, coefficients, state);
+		}
+		for (size_t i{}; i < left.size(); ++i)
+		{
+			assertEqual(frames[i * 2U], monoLeft[i]);
+			assertEqual(frames[(i * 2U) + 1U], monoRight[i]);
+		}
+		assertEqual(state[0].y1, leftState[0].y1);
+		assertEqual(state[1].y2, rightState[0].y2);
+	}
+
+	// A stereo sample with the same data in both channels must mix through the filter exactly like a mono one
+	void testStereoMix()
+	{
+		auto signal{makeSignal(sampleFrames)};
+		std::vector<int16_t> mono(signal.begin(), signal.end());
+		std::vector<int16_t> stereo(sampleFrames * 2U);
+		for (size_t i{}; i < sampleFrames; ++i)
+			stereo[i * 2U] = stereo[(i * 2U) + 1U] = mono[i];
+		std::vector<int16_t> monoBuffer{};
+		std::vector<int16_t> stereoBuffer{};
+		testSample_t monoSample{sampleFrames, false};
+		testSample_t stereoSample{sampleFrames, true};
+
+		for (const uint32_t interpolation : {MIX_NOSRC, MIX_LINEARSRC, MIX_HQSRC, MIX_SINCSRC})
+		{
+			channel_t monoChannel{};
+			monoChannel.Sample = &monoSample;
+			monoChannel.SampleData = padPCM(monoBuffer, mono, 1U);
+			monoChannel.Length = sampleFrames;
+			monoChannel.Pos = 10U;
+			monoChannel.increment.iValue = 0x0D37F;
+			monoChannel.leftVol = monoChannel.rightVol = 128U;
+			monoChannel.FilterSettings = {20U, 100U, filterModifierNone, sampleRate};
+			monoChannel.FilterCoefficients = filterCoefficients(monoChannel.FilterSettings);
+			channel_t stereoChannel{monoChannel};
+			stereoChannel.Sample = &stereoSample;
+			stereoChannel.SampleData = padPCM(stereoBuffer, stereo, 2U);
+
+			// Long enough to cross several filter blocks and end part way through one
+			std::vector<int32_t> monoMix(201U * 2U);
+			std::vector<int32_t> stereoMix(monoMix.size());
+			MixFunctionTable[MIX_FILTER | interpolation](&monoChannel, monoMix.data(), monoMix.data() + monoMix.size());
+			MixFunctionTable[MIX_FILTER | MIX_STEREO | interpolation](&stereoChannel, stereoMix.data(),
+				stereoMix.data() + stereoMix.size());
+			// Mono samples are mixed at twice the volume of each channel of a stereo one
+			for (size_t i{}; i < monoMix.size(); ++i)
+				assertEqual(stereoMix[i] * 2, monoMix[i]);
+			assertEqual(stereoChannel.Pos, monoChannel.Pos);
+			assertEqual(stereoChannel.PosLo, monoChannel.PosLo);
+			assertEqual(stereoChannel.FilterState[0].y1, monoChannel.FilterState[0].y1);
+			assertEqual(stereoChannel.FilterState[1].y1, monoChannel.FilterState[0].y1);
+
+			// Filtering has to actually have done something
+			channel_t plainChannel{monoChannel};
+			plainChannel.Pos = 10U;
+			plainChannel.PosLo = 0U;
+			std::vector<int32_t> plainMix(monoMix.size());
+			MixFunctionTable[interpolation](&plainChannel, plainMix.data(), plainMix.data() + plainMix.size());
+			assertTrue(plainMix != monoMix);
+		}
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testFrequency)
+		CXX_TEST(testCoefficients)
+		CXX_TEST(testReference)
+		CXX_TEST(testStereoBlocks)
+		CXX_TEST(testStereoMix)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testResonantFilter>();
+}
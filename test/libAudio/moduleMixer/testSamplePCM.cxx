@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: BSD-3-Clause
+// SPDX-FileCopyrightText: 2025 Rachel Mant <git@dragonmux.network>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <crunch++.h>
+#include "cpuFeatures.hxx"
+#include "moduleMixer/samplePCM.hxx"
+#include "moduleMixer/mixFunctionsSIMD.hxx"
+
+using libAudio::cpuFeatures;
+
+// An odd length so every kernel has to deal with a remainder
+constexpr static size_t pcmSamples{1027U};
+
+class testSamplePCM final : public testsuite
+{
+private:
+	template<typename T> static std::vector<T> makePCM(uint32_t seed)
+	{
+		std::vector<T> pcm(pcmSamples * 2U);
+		for (auto &sample : pcm)
+		{
+			seed = seed * 1664525U + 1013904223U;
+			sample = static_cast<T>(seed >> 16U);
+		}
+		return pcm;
+	}
+
+	template<typename T> void checkFixSign(void (*const scalar)(T *, size_t) noexcept,
+		void (*const vector)(T *, size_t) noexcept)
+	{
+		auto scalarPCM{makePCM<T>(0x13579BDFU)};
+		auto vectorPCM{scalarPCM};
+		// Start one sample in so the vector kernel also sees a misaligned buffer
+		scalar(scalarPCM.data() + 1U, pcmSamples);
+		vector(vectorPCM.data() + 1U, pcmSamples);
+		for (size_t i{}; i < scalarPCM.size(); ++i)
+			assertEqual(vectorPCM[i], scalarPCM[i]);
+	}
+
+	template<typename T> void checkInterleave(void (*const scalar)(T *, const T *, const T *, size_t) noexcept,
+		void (*const vector)(T *, const T *, const T *, size_t) noexcept)
+	{
+		const auto pcm{makePCM<T>(0x2468ACE0U)};
+		std::vector<T> scalarFrames(pcmSamples * 2U);
+		std::vector<T> vectorFrames(pcmSamples * 2U);
+		scalar(scalarFrames.data(), pcm.data(), pcm.data() + pcmSamples, pcmSamples);
+		vector(vectorFrames.data(), pcm.data(), pcm.data() + pcmSamples, pcmSamples);
+		for (size_t i{}; i < scalarFrames.size(); ++i)
+			assertEqual(vectorFrames[i], scalarFrames[i]);
+	}
+
+	void checkWiden(void (*const vector)(int16_t *, const uint8_t *, size_t) noexcept)
+	{
+		const auto pcm{makePCM<uint8_t>(0x0F1E2D3CU)};
+		std::vector<int16_t> scalarPCM(pcmSamples, 0x5A5A);
+		std::vector<int16_t> vectorPCM(pcmSamples, 0x5A5A);
+		scalarSamplePCM.widen8(scalarPCM.data(), pcm.data() + 1U, pcmSamples - 1U);
+		vector(vectorPCM.data(), pcm.data() + 1U, pcmSamples - 1U);
+		for (size_t i{}; i < scalarPCM.size(); ++i)
+			assertEqual(vectorPCM[i], scalarPCM[i]);
+	}
+
+	void checkPCM(const samplePCMFunctions_t *const functions)
+	{
+		assertNotNull(functions);
+		checkFixSign(scalarSamplePCM.fixSign8, functions->fixSign8);
+		checkFixSign(scalarSamplePCM.fixSign16, functions->fixSign16);
+		checkInterleave(scalarSamplePCM.interleave8, functions->interleave8);
+		checkInterleave(scalarSamplePCM.interleave16, functions->interleave16);
+		checkWiden(functions->widen8);
+	}
+
+	void testScalar()
+	{
+		std::array<uint8_t, 4> pcm8{{0x00U, 0x7FU, 0x80U, 0xFFU}};
+		scalarSamplePCM.fixSign8(pcm8.data(), pcm8.size());
+		assertEqual(pcm8[0], 0x80U);
+		assertEqual(pcm8[1], 0xFFU);
+		assertEqual(pcm8[2], 0x00U);
+		assertEqual(pcm8[3], 0x7FU);
+
+		std::array<uint16_t, 3> pcm16{{0x0000U, 0x8001U, 0x7FFFU}};
+		scalarSamplePCM.fixSign16(pcm16.data(), pcm16.size());
+		assertEqual(pcm16[0], 0x8000U);
+		assertEqual(pcm16[1], 0x0001U);
+		assertEqual(pcm16[2], 0xFFFFU);
+
+		const std::array<uint16_t, 6> planar{{1U, 2U, 3U, 4U, 5U, 6U}};
+		std::array<uint16_t, 6> frames{};
+		scalarSamplePCM.interleave16(frames.data(), planar.data(), planar.data() + 3U, 3U);
+		const std::array<uint16_t, 6> expected{{1U, 4U, 2U, 5U, 3U, 6U}};
+		for (size_t i{}; i < frames.size(); ++i)
+			assertEqual(frames[i], expected[i]);
+
+		const std::array<uint8_t, 4> narrow{{0x00U, 0x01U, 0x7FU, 0x80U}};
+		std::array<int16_t, 4> wide{};
+		scalarSamplePCM.widen8(wide.data(), narrow.data(), narrow.size());
+		assertEqual(wide[0], 0);
+		assertEqual(wide[1], 256);
+		assertEqual(wide[2], 32512);
+		assertEqual(wide[3], -32768);
+	}
+
+	void testGuards()
+	{
+		// Two stereo frames with the guards either side, which must repeat the first and last frames
+		std::array<int16_t, (sampleGuard * 4U) + 4U> pcm{};
+		auto *const frames{pcm.data() + (sampleGuard * 2U)};
+		frames[0] = 1;
+		frames[1] = -2;
+		frames[2] = 3;
+		frames[3] = -4;
+		pcmFillGuards(frames, 2U, 2U);
+		for (size_t i{}; i < sampleGuard; ++i)
+		{
+			assertEqual(pcm[i * 2U], 1);
+			assertEqual(pcm[(i * 2U) + 1U], -2);
+			assertEqual(frames[4U + (i * 2U)], 3);
+			assertEqual(frames[5U + (i * 2U)], -4);
+		}
+	}
+
+	void testLoopGuards()
+	{
+		// A forward loop over the last 3 of 5 stereo frames carries on round in to the guard frames
+		std::array<int16_t, (sampleGuard * 4U) + 10U> pcm{};
+		auto *const frames{pcm.data() + (sampleGuard * 2U)};
+		for (size_t i{}; i < 10U; ++i)
+			frames[i] = static_cast<int16_t>(i + 1U);
+		pcmUnrollLoop(frames, 5U, 2U, 2U, false);
+		const std::array<int16_t, sampleGuard * 2U> forward{{5, 6, 7, 8, 9, 10, 5, 6}};
+		assertTrue(std::equal(forward.begin(), forward.end(), frames + 10U));
+
+		// A ping-pong loop mirrors back from the last frame, bouncing off the loop start when that's close
+		pcmUnrollLoop(frames, 5U, 2U, 2U, true);
+		const std::array<int16_t, sampleGuard * 2U> pingPong{{9, 10, 7, 8, 5, 6, 5, 6}};
+		assertTrue(std::equal(pingPong.begin(), pingPong.end(), frames + 10U));
+
+		// And a single frame loop just repeats, which in mono must leave the frames before it alone
+		std::array<int16_t, (sampleGuard * 2U) + 3U> mono{};
+		auto *const monoFrames{mono.data() + sampleGuard};
+		monoFrames[0] = 1;
+		monoFrames[1] = 2;
+		monoFrames[2] = 3;
+		pcmFillGuards(monoFrames, 3U, 1U);
+		pcmUnrollLoop(monoFrames, 3U, 1U, 2U, true);
+		for (size_t i{}; i < sampleGuard; ++i)
+		{
+			assertEqual(mono[i], 1);
+			assertEqual(monoFrames[3U + i], 3);
+		}
+		assertEqual(monoFrames[1], 2);
+	}
+
+	void testSSE2()
+	{
+		if (!cpuFeatures().sse2)
+			skip("SSE2 not available");
+		checkPCM(samplePCMSSE2());
+	}
+
+	void testSSE41()
+	{
+		if (!cpuFeatures().sse41)
+			skip("SSE4.1 not available");
+		checkPCM(samplePCMSSE41());
+	}
+
+	void testAVX2()
+	{
+		if (!cpuFeatures().avx2)
+			skip("AVX2 not available");
+		checkPCM(samplePCMAVX2());
+	}
+
+	void testNEON()
+	{
+		if (!cpuFeatures().neon)
+			skip("NEON not available");
+		checkPCM(samplePCMNEON());
+	}
+
+public:
+	void registerTests() final
+	{
+		CXX_TEST(testScalar)
+		CXX_TEST(testGuards)
+		CXX_TEST(testLoopGuards)
+		CXX_TEST(testSSE2)
+		CXX_TEST(testSSE41)
+		CXX_TEST(testAVX2)
+		CXX_TEST(testNEON)
+	}
+};
+
+CRUNCH_API void registerCXXTests() noexcept;
+void registerCXXTests() noexcept
+{
+	registerTestClasses<testSamplePCM>();
+}